@@ -19,9 +19,77 @@
 DEBUG_CHANNEL(kernel32file);
 #endif
 
+/* Small files are copied in 64 KB pieces. Large ones use up to 8 MB per
+   buffer, so each I/O request does more work. */
+#define COPY_SMALL_BUFFER_SIZE  0x10000
+#define COPY_LARGE_BUFFER_MIN   0x100000
+#define COPY_LARGE_BUFFER_MAX   0x800000
+#define COPY_LARGE_FILE_SIZE    0x1000000
+
+/* Number of buffers in flight. While one of them is being written, the
+   others are being read. */
+#define COPY_BUFFER_COUNT       4
+
+typedef struct _COPY_BUFFER
+{
+    HANDLE Event;
+    PUCHAR Buffer;
+    LARGE_INTEGER ByteOffset;
+    ULONG Length;
+    IO_STATUS_BLOCK IoStatusBlock;
+    NTSTATUS Status;
+} COPY_BUFFER, *PCOPY_BUFFER;
+
 /* FUNCTIONS ****************************************************************/
 
 
+static NTSTATUS
+CopyWaitForBuffer(PCOPY_BUFFER CopyBuffer)
+{
+    if (CopyBuffer->Status == STATUS_PENDING)
+    {
+        NtWaitForSingleObject(CopyBuffer->Event, FALSE, NULL);
+        CopyBuffer->Status = CopyBuffer->IoStatusBlock.Status;
+    }
+
+    return CopyBuffer->Status;
+}
+
+static VOID
+CopyStartRead(PCOPY_BUFFER CopyBuffer,
+              HANDLE FileHandleSource,
+              PLARGE_INTEGER ReadOffset,
+              ULONG BufferSize)
+{
+    CopyBuffer->ByteOffset = *ReadOffset;
+    CopyBuffer->IoStatusBlock.Information = 0;
+    CopyBuffer->Status = NtReadFile(FileHandleSource,
+                                    CopyBuffer->Event,
+                                    NULL,
+                                    NULL,
+                                    &CopyBuffer->IoStatusBlock,
+                                    CopyBuffer->Buffer,
+                                    BufferSize,
+                                    &CopyBuffer->ByteOffset,
+                                    NULL);
+    ReadOffset->QuadPart += BufferSize;
+}
+
+static ULONG
+CopyBufferSize(LARGE_INTEGER SourceFileSize)
+{
+    ULONGLONG BufferSize;
+
+    if (SourceFileSize.QuadPart < COPY_LARGE_FILE_SIZE)
+        return COPY_SMALL_BUFFER_SIZE;
+
+    /* Aim for a few dozen requests per file */
+    BufferSize = (SourceFileSize.QuadPart / 32) & ~((ULONGLONG)COPY_SMALL_BUFFER_SIZE - 1);
+    BufferSize = max(BufferSize, COPY_LARGE_BUFFER_MIN);
+    BufferSize = min(BufferSize, COPY_LARGE_BUFFER_MAX);
+    return (ULONG)BufferSize;
+}
+
 static NTSTATUS
 CopyLoop (
     HANDLE			FileHandleSource,
@@ -30,128 +98,249 @@ CopyLoop (
     LPPROGRESS_ROUTINE	lpProgressRoutine,
     LPVOID			lpData,
     BOOL			*pbCancel,
-    BOOL                 *KeepDest
+    BOOL                 *KeepDest,
+    BOOL                 Unbuffered
 )
 {
     NTSTATUS errCode;
     IO_STATUS_BLOCK IoStatusBlock;
+    COPY_BUFFER CopyBuffers[COPY_BUFFER_COUNT];
+    PCOPY_BUFFER Current, Previous = NULL;
     UCHAR *lpBuffer = NULL;
-    SIZE_T RegionSize = 0x10000;
-    LARGE_INTEGER BytesCopied;
+    SIZE_T RegionSize;
+    ULONG BufferSize, WriteLength, SectorSize = PAGE_SIZE, i;
+    LARGE_INTEGER BytesCopied, ReadOffset;
+    FILE_ALLOCATION_INFORMATION FileAllocation;
+    FILE_END_OF_FILE_INFORMATION FileEndOfFile;
+    FILE_FS_SIZE_INFORMATION FileFsSize;
     DWORD CallbackReason;
     DWORD ProgressResult;
     BOOL EndOfFileFound;
+    BOOL ShortRead;
+    BOOL ReportProgress;
 
     *KeepDest = FALSE;
-    errCode = NtAllocateVirtualMemory(NtCurrentProcess(),
-                                      (PVOID *)&lpBuffer,
-                                      0,
-                                      &RegionSize,
-                                      MEM_RESERVE | MEM_COMMIT,
-                                      PAGE_READWRITE);
+
+    /* Reserve the space up front, a full disk shows up before anything
+       is copied and the file doesn't get fragmented by growing */
+    FileAllocation.AllocationSize = SourceFileSize;
+    errCode = NtSetInformationFile(FileHandleDest,
+                                   &IoStatusBlock,
+                                   &FileAllocation,
+                                   sizeof(FILE_ALLOCATION_INFORMATION),
+                                   FileAllocationInformation);
+    if (errCode == STATUS_DISK_FULL)
+    {
+        WARN("Not enough space on dest\n");
+        return errCode;
+    }
+
+    /* Unbuffered writes have to be whole sectors */
+    if (Unbuffered)
+    {
+        errCode = NtQueryVolumeInformationFile(FileHandleDest,
+                                               &IoStatusBlock,
+                                               &FileFsSize,
+                                               sizeof(FILE_FS_SIZE_INFORMATION),
+                                               FileFsSizeInformation);
+        if (NT_SUCCESS(errCode) && FileFsSize.BytesPerSector > SectorSize)
+            SectorSize = FileFsSize.BytesPerSector;
+    }
+
+    /* Settle for smaller buffers when memory is tight */
+    for (BufferSize = CopyBufferSize(SourceFileSize); ; BufferSize /= 2)
+    {
+        RegionSize = (SIZE_T)BufferSize * COPY_BUFFER_COUNT;
+        errCode = NtAllocateVirtualMemory(NtCurrentProcess(),
+                                          (PVOID *)&lpBuffer,
+                                          0,
+                                          &RegionSize,
+                                          MEM_RESERVE | MEM_COMMIT,
+                                          PAGE_READWRITE);
+        if (NT_SUCCESS(errCode) || BufferSize <= COPY_SMALL_BUFFER_SIZE)
+            break;
+    }
+
+    if (!NT_SUCCESS(errCode))
+    {
+        TRACE("Error 0x%08x allocating buffer of %lu bytes\n", errCode, RegionSize);
+        return errCode;
+    }
+
+    RtlZeroMemory(CopyBuffers, sizeof(CopyBuffers));
+    for (i = 0; i < COPY_BUFFER_COUNT && NT_SUCCESS(errCode); i++)
+    {
+        CopyBuffers[i].Buffer = lpBuffer + i * BufferSize;
+        CopyBuffers[i].Status = STATUS_SUCCESS;
+        errCode = NtCreateEvent(&CopyBuffers[i].Event,
+                                EVENT_ALL_ACCESS,
+                                NULL,
+                                NotificationEvent,
+                                FALSE);
+    }
+
+    BytesCopied.QuadPart = 0;
+    ReadOffset.QuadPart = 0;
+    EndOfFileFound = FALSE;
+    ShortRead = FALSE;
+    ReportProgress = TRUE;
+    CallbackReason = CALLBACK_STREAM_SWITCH;
 
     if (NT_SUCCESS(errCode))
     {
-        BytesCopied.QuadPart = 0;
-        EndOfFileFound = FALSE;
-        CallbackReason = CALLBACK_STREAM_SWITCH;
-        while (! EndOfFileFound &&
-                NT_SUCCESS(errCode) &&
-                (NULL == pbCancel || ! *pbCancel))
+        /* Get a read going for every buffer */
+        for (i = 0; i < COPY_BUFFER_COUNT; i++)
+            CopyStartRead(&CopyBuffers[i], FileHandleSource, &ReadOffset, BufferSize);
+    }
+
+    /* The reads complete in the order of the buffers. Each buffer is
+       written as soon as its data is in, and refilled once that write
+       is done. Progress is reported per written buffer. */
+    for (i = 0; NT_SUCCESS(errCode); i = (i + 1) % COPY_BUFFER_COUNT)
+    {
+        if (NULL != lpProgressRoutine && ReportProgress)
         {
-            if (NULL != lpProgressRoutine)
+            ProgressResult = (*lpProgressRoutine)(SourceFileSize,
+                                                  BytesCopied,
+                                                  SourceFileSize,
+                                                  BytesCopied,
+                                                  0,
+                                                  CallbackReason,
+                                                  FileHandleSource,
+                                                  FileHandleDest,
+                                                  lpData);
+            switch (ProgressResult)
             {
-                ProgressResult = (*lpProgressRoutine)(SourceFileSize,
-                                                      BytesCopied,
-                                                      SourceFileSize,
-                                                      BytesCopied,
-                                                      0,
-                                                      CallbackReason,
-                                                      FileHandleSource,
-                                                      FileHandleDest,
-                                                      lpData);
-                switch (ProgressResult)
-                {
-                case PROGRESS_CANCEL:
-                    TRACE("Progress callback requested cancel\n");
-                    errCode = STATUS_REQUEST_ABORTED;
-                    break;
-                case PROGRESS_STOP:
-                    TRACE("Progress callback requested stop\n");
-                    errCode = STATUS_REQUEST_ABORTED;
-                    *KeepDest = TRUE;
-                    break;
-                case PROGRESS_QUIET:
-                    lpProgressRoutine = NULL;
-                    break;
-                case PROGRESS_CONTINUE:
-                default:
-                    break;
-                }
-                CallbackReason = CALLBACK_CHUNK_FINISHED;
+            case PROGRESS_CANCEL:
+                TRACE("Progress callback requested cancel\n");
+                errCode = STATUS_REQUEST_ABORTED;
+                break;
+            case PROGRESS_STOP:
+                TRACE("Progress callback requested stop\n");
+                errCode = STATUS_REQUEST_ABORTED;
+                *KeepDest = TRUE;
+                break;
+            case PROGRESS_QUIET:
+                lpProgressRoutine = NULL;
+                break;
+            case PROGRESS_CONTINUE:
+            default:
+                break;
             }
-            if (NT_SUCCESS(errCode))
+            CallbackReason = CALLBACK_CHUNK_FINISHED;
+        }
+        ReportProgress = FALSE;
+
+        if (!NT_SUCCESS(errCode) || EndOfFileFound)
+            break;
+
+        if (NULL != pbCancel && *pbCancel)
+        {
+            TRACE("User requested cancel\n");
+            errCode = STATUS_REQUEST_ABORTED;
+            break;
+        }
+
+        Current = &CopyBuffers[i];
+        errCode = CopyWaitForBuffer(Current);
+        if (STATUS_END_OF_FILE == errCode ||
+            (NT_SUCCESS(errCode) && Current->IoStatusBlock.Information == 0))
+        {
+            EndOfFileFound = TRUE;
+            errCode = STATUS_SUCCESS;
+        }
+        else if (!NT_SUCCESS(errCode))
+        {
+            WARN("Error 0x%08x reading from source\n", errCode);
+            break;
+        }
+        else if (ShortRead)
+        {
+            /* The reads are queued at fixed offsets, so data after a short
+               read would leave a hole in dest */
+            WARN("Short read from source before the end of the file\n");
+            errCode = STATUS_UNEXPECTED_IO_ERROR;
+            break;
+        }
+        else
+        {
+            Current->Length = (ULONG)Current->IoStatusBlock.Information;
+            ShortRead = (Current->Length < BufferSize);
+            WriteLength = Current->Length;
+            if (Unbuffered)
             {
-                errCode = NtReadFile(FileHandleSource,
-                                     NULL,
-                                     NULL,
-                                     NULL,
-                                     (PIO_STATUS_BLOCK)&IoStatusBlock,
-                                     lpBuffer,
-                                     RegionSize,
-                                     NULL,
-                                     NULL);
-                if (NT_SUCCESS(errCode) && (NULL == pbCancel || ! *pbCancel))
-                {
-                    errCode = NtWriteFile(FileHandleDest,
-                                          NULL,
-                                          NULL,
+                /* The tail is cut off again once everything is written */
+                WriteLength = ROUND_UP(WriteLength, SectorSize);
+                RtlZeroMemory(Current->Buffer + Current->Length, WriteLength - Current->Length);
+            }
+
+            Current->Status = NtWriteFile(FileHandleDest,
+                                          Current->Event,
                                           NULL,
-                                          (PIO_STATUS_BLOCK)&IoStatusBlock,
-                                          lpBuffer,
-                                          IoStatusBlock.Information,
                                           NULL,
+                                          &Current->IoStatusBlock,
+                                          Current->Buffer,
+                                          WriteLength,
+                                          &Current->ByteOffset,
                                           NULL);
-                    if (NT_SUCCESS(errCode))
-                    {
-                        BytesCopied.QuadPart += IoStatusBlock.Information;
-                    }
-                    else
-                    {
-                        WARN("Error 0x%08x reading writing to dest\n", errCode);
-                    }
-                }
-                else if (!NT_SUCCESS(errCode))
-                {
-                    if (STATUS_END_OF_FILE == errCode)
-                    {
-                        EndOfFileFound = TRUE;
-                        errCode = STATUS_SUCCESS;
-                    }
-                    else
-                    {
-                        WARN("Error 0x%08x reading from source\n", errCode);
-                    }
-                }
+            if (!NT_SUCCESS(Current->Status))
+            {
+                errCode = Current->Status;
+                WARN("Error 0x%08x writing to dest\n", errCode);
+                break;
             }
         }
 
-        if (! EndOfFileFound && (NULL != pbCancel && *pbCancel))
+        /* Finish the write before this one, then start reading into its
+           buffer again, while the new write is going on */
+        if (NULL != Previous)
         {
-            TRACE("User requested cancel\n");
-            errCode = STATUS_REQUEST_ABORTED;
+            errCode = CopyWaitForBuffer(Previous);
+            if (!NT_SUCCESS(errCode))
+            {
+                WARN("Error 0x%08x writing to dest\n", errCode);
+                break;
+            }
+
+            BytesCopied.QuadPart += Previous->Length;
+            ReportProgress = TRUE;
+            if (!EndOfFileFound)
+                CopyStartRead(Previous, FileHandleSource, &ReadOffset, BufferSize);
         }
 
-        NtFreeVirtualMemory(NtCurrentProcess(),
-                            (PVOID *)&lpBuffer,
-                            &RegionSize,
-                            MEM_RELEASE);
+        Previous = EndOfFileFound ? NULL : Current;
     }
-    else
+
+    /* Nothing may be left in flight when the buffers go away */
+    for (i = 0; i < COPY_BUFFER_COUNT; i++)
     {
-        TRACE("Error 0x%08x allocating buffer of %lu bytes\n", errCode, RegionSize);
+        if (CopyBuffers[i].Event == NULL)
+            continue;
+
+        CopyWaitForBuffer(&CopyBuffers[i]);
+        NtClose(CopyBuffers[i].Event);
     }
 
+    if (NT_SUCCESS(errCode) && Unbuffered)
+    {
+        FileEndOfFile.EndOfFile = BytesCopied;
+        errCode = NtSetInformationFile(FileHandleDest,
+                                       &IoStatusBlock,
+                                       &FileEndOfFile,
+                                       sizeof(FILE_END_OF_FILE_INFORMATION),
+                                       FileEndOfFileInformation);
+        if (!NT_SUCCESS(errCode))
+        {
+            WARN("Error 0x%08x setting the size of dest\n", errCode);
+        }
+    }
+
+    RegionSize = 0;
+    NtFreeVirtualMemory(NtCurrentProcess(),
+                        (PVOID *)&lpBuffer,
+                        &RegionSize,
+                        MEM_RELEASE);
+
     return errCode;
 }
 
@@ -209,14 +398,20 @@ BasepCopyFileExW(IN LPCWSTR lpExistingFileName,
     FILE_BASIC_INFORMATION FileBasic;
     BOOL RC = FALSE;
     BOOL KeepDestOnError = FALSE;
+    BOOL Unbuffered = (dwCopyFlags & COPY_FILE_NO_BUFFERING) != 0;
     DWORD SystemError;
+    DWORD FileFlags;
+
+    /* CopyLoop keeps several reads and writes going at once */
+    FileFlags = FILE_FLAG_OVERLAPPED;
+    FileFlags |= Unbuffered ? FILE_FLAG_NO_BUFFERING : FILE_FLAG_SEQUENTIAL_SCAN;
 
     FileHandleSource = CreateFileW(lpExistingFileName,
                                    GENERIC_READ,
                                    FILE_SHARE_READ | FILE_SHARE_WRITE,
                                    NULL,
                                    OPEN_EXISTING,
-                                   FILE_ATTRIBUTE_NORMAL|FILE_FLAG_NO_BUFFERING,
+                                   FILE_ATTRIBUTE_NORMAL | FileFlags,
                                    NULL);
     if (INVALID_HANDLE_VALUE != FileHandleSource)
     {
@@ -247,8 +442,8 @@ BasepCopyFileExW(IN LPCWSTR lpExistingFileName,
                                              GENERIC_WRITE,
                                              FILE_SHARE_WRITE,
                                              NULL,
-                                             dwCopyFlags ? CREATE_NEW : CREATE_ALWAYS,
-                                             FileBasic.FileAttributes,
+                                             (dwCopyFlags & COPY_FILE_FAIL_IF_EXISTS) ? CREATE_NEW : CREATE_ALWAYS,
+                                             FileBasic.FileAttributes | FileFlags,
                                              NULL);
                 if (INVALID_HANDLE_VALUE != FileHandleDest)
                 {
@@ -258,7 +453,8 @@ BasepCopyFileExW(IN LPCWSTR lpExistingFileName,
                                        lpProgressRoutine,
                                        lpData,
                                        pbCancel,
-                                       &KeepDestOnError);
+                                       &KeepDestOnError,
+                                       Unbuffered);
                     if (!NT_SUCCESS(errCode))
                     {
                         BaseSetLastNTError(errCode);
@@ -2295,6 +2295,32 @@ WSPSetSockOpt(
               AFD_DbgPrint(MIN_TRACE,("Setting send buf to %x is not implemented yet\n", optval));
               return 0;
 
+           case SO_RCVBUF:
+              if (optlen < sizeof(DWORD))
+              {
+                  *lpErrno = WSAEFAULT;
+                  return SOCKET_ERROR;
+              }
+
+              if (SetSocketInformation(Socket,
+                                       AFD_INFO_RECEIVE_WINDOW_SIZE,
+                                       NULL,
+                                       (PULONG)optval,
+                                       NULL) != 0)
+              {
+                  *lpErrno = WSAENOBUFS;
+                  return SOCKET_ERROR;
+              }
+
+              /* AFD keeps the window of a connected socket, so read back
+                 the size actually in use */
+              GetSocketInformation(Socket,
+                                   AFD_INFO_RECEIVE_WINDOW_SIZE,
+                                   NULL,
+                                   &Socket->SharedData.SizeOfRecvBuffer,
+                                   NULL);
+              return 0;
+
            case SO_SNDTIMEO:
               if (optlen < sizeof(DWORD))
               {
@@ -281,16 +281,7 @@ MakeSocketIntoConnection(PAFD_FCB FCB) {
 
     FCB->State = SOCKET_STATE_CONNECTED;
 
-    Status = TdiReceive( &FCB->ReceiveIrp.InFlightRequest,
-                         FCB->Connection.Object,
-                         TDI_RECEIVE_NORMAL,
-                         FCB->Recv.Window,
-                         FCB->Recv.Size,
-                         &FCB->ReceiveIrp.Iosb,
-                         ReceiveComplete,
-                         FCB );
-
-   if( Status == STATUS_PENDING ) Status = STATUS_SUCCESS;
+    Status = StartStreamReceive( FCB );
 
    FCB->PollState |= AFD_EVENT_CONNECT | AFD_EVENT_SEND;
    FCB->PollStatus[FD_CONNECT_BIT] = STATUS_SUCCESS;
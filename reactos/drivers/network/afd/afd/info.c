@@ -55,7 +55,7 @@ AfdGetInfo( PDEVICE_OBJECT DeviceObject, PIRP Irp,
         break;
 
     case AFD_INFO_RECEIVE_CONTENT_SIZE:
-        InfoReq->Information.Ulong = FCB->Recv.Content - FCB->Recv.BytesUsed;
+        InfoReq->Information.Ulong = RecvBytesAvailable(FCB);
         break;
 
         case AFD_INFO_SENDS_IN_PROGRESS:
@@ -124,6 +124,16 @@ AfdSetInfo( PDEVICE_OBJECT DeviceObject, PIRP Irp,
                 FCB->OobInline = InfoReq->Information.Boolean;
                 break;
             case AFD_INFO_RECEIVE_WINDOW_SIZE:
+                if (FCB->RecvSegmentCount || !InfoReq->Information.Ulong)
+                {
+                    /* The transport is receiving into the current window so
+                     * it can't be swapped out on a connected socket. Like a
+                     * zero size, that keeps the window as it is. The caller
+                     * reads the size back to see what it got */
+                    AFD_DbgPrint(MIN_TRACE,("Keeping the receive window at %u bytes\n", FCB->Recv.Size));
+                    break;
+                }
+
                 NewBuffer = ExAllocatePool(PagedPool, InfoReq->Information.Ulong);
                 if (NewBuffer)
                 {
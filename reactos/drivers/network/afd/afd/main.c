@@ -348,6 +348,7 @@ AfdCreateSocket(PDEVICE_OBJECT DeviceObject, PIRP Irp,
 
     InitializeListHead( &FCB->DatagramList );
     InitializeListHead( &FCB->PendingConnections );
+    InitializeListHead( &FCB->PollWaiters );
 
     AFD_DbgPrint(MID_TRACE,("%p: Checking command channel\n", FCB));
 
@@ -429,6 +430,7 @@ AfdCleanupSocket(PDEVICE_OBJECT DeviceObject, PIRP Irp,
     }
 
     KillSelectsForFCB( FCB->DeviceExt, FileObject, FALSE );
+    ClearPollSet( FCB );
 
     return UnlockAndMaybeComplete(FCB, STATUS_SUCCESS, Irp, 0);
 }
@@ -467,6 +469,8 @@ AfdCloseSocket(PDEVICE_OBJECT DeviceObject, PIRP Irp,
         }
     }
 
+    CancelStreamReceive( FCB );
+
     KillSelectsForFCB( FCB->DeviceExt, FileObject, FALSE );
 
     ASSERT(IsListEmpty(&FCB->PendingIrpList[FUNCTION_CONNECT]));
@@ -490,6 +494,8 @@ AfdCloseSocket(PDEVICE_OBJECT DeviceObject, PIRP Irp,
 
     SocketStateUnlock( FCB );
 
+    FreePollSet( FCB );
+
     if( FCB->EventSelect )
         ObDereferenceObject( FCB->EventSelect );
 
@@ -719,13 +725,11 @@ AfdDisconnect(PDEVICE_OBJECT DeviceObject, PIRP Irp,
         /* Mark that we can't issue another receive request */
         FCB->TdiReceiveClosed = TRUE;
 
-        /* Try to cancel a pending TDI receive IRP if there was one in progress */
-        if (FCB->ReceiveIrp.InFlightRequest)
-            IoCancelIrp(FCB->ReceiveIrp.InFlightRequest);
+        /* Try to cancel the pending TDI receive IRPs if there are any in progress */
+        CancelStreamReceive(FCB);
 
         /* Discard any pending data */
-        FCB->Recv.Content = 0;
-        FCB->Recv.BytesUsed = 0;
+        DiscardStreamReceiveData(FCB);
 
         /* Mark us as overread to complete future reads with an error */
         FCB->Overread = TRUE;
@@ -896,6 +900,12 @@ AfdDispatch(PDEVICE_OBJECT DeviceObject, PIRP Irp)
         case IOCTL_AFD_ENUM_NETWORK_EVENTS:
             return AfdEnumEvents( DeviceObject, Irp, IrpSp );
 
+        case IOCTL_AFD_POLL_SET_CONTROL:
+            return AfdPollSetControl( DeviceObject, Irp, IrpSp );
+
+        case IOCTL_AFD_POLL_SET_WAIT:
+            return AfdPollSetWait( DeviceObject, Irp, IrpSp );
+
         case IOCTL_AFD_RECV_DATAGRAM:
             return AfdPacketSocketReadData( DeviceObject, Irp, IrpSp );
 
@@ -1192,6 +1202,11 @@ AfdCancelHandler(PDEVICE_OBJECT DeviceObject,
             DbgPrint("WARNING!!! IRP cancellation race could lead to a process hang! (IOCTL_AFD_SELECT)\n");
             return;
 
+        case IOCTL_AFD_POLL_SET_WAIT:
+            CancelPollSetWait(FCB, Irp);
+            SocketStateUnlock(FCB);
+            return;
+
         case IOCTL_AFD_DISCONNECT:
             Function = FUNCTION_DISCONNECT;
             break;
@@ -10,84 +10,204 @@
 
 #include "afd.h"
 
+#define NEXT_RECV_SEGMENT(FCB, i) (((i) + 1) % (FCB)->RecvSegmentCount)
+
+UINT RecvBytesAvailable( PAFD_FCB FCB )
+{
+    UINT i, Index, BytesAvailable = 0;
+    PAFD_RECV_SEGMENT Segment;
+
+    if (!FCB->RecvSegmentCount)
+        return FCB->Recv.Content - FCB->Recv.BytesUsed;
+
+    /* Only the run of ready segments starting at the head can be read */
+    Index = FCB->RecvHead;
+    for (i = 0; i < FCB->RecvSegmentCount; i++)
+    {
+        Segment = &FCB->RecvSegments[Index];
+        if (Segment->State != AFD_RECV_SEGMENT_READY)
+            break;
+
+        BytesAvailable += Segment->Content - Segment->BytesUsed;
+        Index = NEXT_RECV_SEGMENT(FCB, Index);
+    }
+
+    return BytesAvailable;
+}
+
 static VOID RefillSocketBuffer( PAFD_FCB FCB )
 {
-    /* Make sure nothing's in flight first */
-    if (FCB->ReceiveIrp.InFlightRequest) return;
+    PAFD_RECV_SEGMENT Segment;
+    UINT Index;
+
+    /* Keep every idle segment posted to the transport. Segments are posted
+     * in ring order so that they are filled in the order they are read. */
+    while (!FCB->TdiReceiveClosed)
+    {
+        Index = FCB->RecvTail;
+        Segment = &FCB->RecvSegments[Index];
+        if (Segment->State != AFD_RECV_SEGMENT_IDLE)
+            break;
+
+        AFD_DbgPrint(MID_TRACE,("Replenishing segment %u\n", Index));
+
+        /* The receive may complete before TdiReceive returns, so the
+         * segment must look posted before the call is made */
+        Segment->Content = 0;
+        Segment->BytesUsed = 0;
+        Segment->State = AFD_RECV_SEGMENT_PENDING;
+        FCB->RecvTail = NEXT_RECV_SEGMENT(FCB, Index);
+
+        TdiReceive( &Segment->Request.InFlightRequest,
+                    FCB->Connection.Object,
+                    TDI_RECEIVE_NORMAL,
+                    FCB->Recv.Window + Segment->Offset,
+                    Segment->Size,
+                    &Segment->Request.Iosb,
+                    ReceiveComplete,
+                    FCB );
+
+        if (!Segment->Request.InFlightRequest &&
+            Segment->State == AFD_RECV_SEGMENT_PENDING)
+        {
+            /* The request never reached the transport, try again later */
+            Segment->State = AFD_RECV_SEGMENT_IDLE;
+            FCB->RecvTail = Index;
+            break;
+        }
+    }
+}
+
+static VOID ReleaseRecvSegment( PAFD_FCB FCB )
+{
+    PAFD_RECV_SEGMENT Segment = &FCB->RecvSegments[FCB->RecvHead];
+
+    ASSERT(Segment->State == AFD_RECV_SEGMENT_READY);
+    ASSERT(Segment->BytesUsed == Segment->Content);
 
-    /* Now ensure that receive is still allowed */
-    if (FCB->TdiReceiveClosed) return;
+    Segment->State = AFD_RECV_SEGMENT_IDLE;
+    Segment->Content = 0;
+    Segment->BytesUsed = 0;
+    FCB->RecvHead = NEXT_RECV_SEGMENT(FCB, FCB->RecvHead);
+}
+
+static VOID HandleReceiveComplete( PAFD_FCB FCB )
+{
+    PAFD_RECV_SEGMENT Segment;
 
-    /* Check if the buffer is full */
-    if (FCB->Recv.Content == FCB->Recv.Size)
+    /* Completions may be delivered out of order, but their results must be
+     * applied in the order the segments were posted */
+    for (;;)
     {
-        /* If there are bytes used, we can solve this problem */
-        if (FCB->Recv.BytesUsed != 0)
+        Segment = &FCB->RecvSegments[FCB->RecvReady];
+        if (Segment->State != AFD_RECV_SEGMENT_COMPLETE)
+            break;
+
+        FCB->RecvReady = NEXT_RECV_SEGMENT(FCB, FCB->RecvReady);
+
+        /* We got closed while the receive was in progress */
+        if (FCB->TdiReceiveClosed)
         {
-            /* Reposition the unused portion to the beginning of the receive window */
-            RtlMoveMemory(FCB->Recv.Window,
-                          FCB->Recv.Window + FCB->Recv.BytesUsed,
-                          FCB->Recv.Content - FCB->Recv.BytesUsed);
+            /* The received data is discarded */
+            Segment->State = AFD_RECV_SEGMENT_IDLE;
+            continue;
+        }
+
+        FCB->LastReceiveStatus = Segment->Request.Iosb.Status;
 
-            FCB->Recv.Content -= FCB->Recv.BytesUsed;
-            FCB->Recv.BytesUsed = 0;
+        /* Receive successful */
+        if (Segment->Request.Iosb.Status == STATUS_SUCCESS &&
+            Segment->Request.Iosb.Information != 0)
+        {
+            Segment->Content = (UINT)Segment->Request.Iosb.Information;
+            Segment->BytesUsed = 0;
+            ASSERT(Segment->Content <= Segment->Size);
+            Segment->State = AFD_RECV_SEGMENT_READY;
         }
+        /* Graceful closure or failure with no data (unexpected closure) */
         else
         {
-            /* No space in the buffer to receive */
-            return;
+            /* Previously received data remains intact */
+            FCB->TdiReceiveClosed = TRUE;
+            Segment->State = AFD_RECV_SEGMENT_IDLE;
         }
     }
 
-    AFD_DbgPrint(MID_TRACE,("Replenishing buffer\n"));
-
-    TdiReceive( &FCB->ReceiveIrp.InFlightRequest,
-                FCB->Connection.Object,
-                TDI_RECEIVE_NORMAL,
-                FCB->Recv.Window + FCB->Recv.Content,
-                FCB->Recv.Size - FCB->Recv.Content,
-                &FCB->ReceiveIrp.Iosb,
-                ReceiveComplete,
-                FCB );
+    /* Issue more receive IRPs to keep the buffer well stocked */
+    RefillSocketBuffer(FCB);
 }
 
-static VOID HandleReceiveComplete( PAFD_FCB FCB, NTSTATUS Status, ULONG_PTR Information )
+NTSTATUS StartStreamReceive( PAFD_FCB FCB )
 {
-    FCB->LastReceiveStatus = Status;
+    PAFD_RECV_SEGMENT Segment;
+    UINT i, SegmentSize;
 
-    /* We got closed while the receive was in progress */
-    if (FCB->TdiReceiveClosed)
+    /* The receive window (SO_RCVBUF) decides how deep the pipeline is */
+    FCB->RecvSegmentCount = MIN(AFD_MAX_RECV_SEGMENTS,
+                                FCB->Recv.Size / AFD_MIN_RECV_SEGMENT_SIZE);
+    if (!FCB->RecvSegmentCount)
+        FCB->RecvSegmentCount = 1;
+
+    SegmentSize = FCB->Recv.Size / FCB->RecvSegmentCount;
+
+    for (i = 0; i < FCB->RecvSegmentCount; i++)
     {
-        /* The received data is discarded */
+        Segment = &FCB->RecvSegments[i];
+        RtlZeroMemory(Segment, sizeof(*Segment));
+        Segment->State = AFD_RECV_SEGMENT_IDLE;
+        Segment->Offset = i * SegmentSize;
+        Segment->Size = (i == FCB->RecvSegmentCount - 1) ?
+                        FCB->Recv.Size - Segment->Offset : SegmentSize;
     }
-    /* Receive successful */
-    else if (Status == STATUS_SUCCESS)
+
+    FCB->RecvHead = FCB->RecvReady = FCB->RecvTail = 0;
+
+    RefillSocketBuffer(FCB);
+
+    if (!FCB->TdiReceiveClosed &&
+        FCB->RecvSegments[0].State == AFD_RECV_SEGMENT_IDLE)
     {
-        FCB->Recv.Content += Information;
-        ASSERT(FCB->Recv.Content <= FCB->Recv.Size);
+        return STATUS_INSUFFICIENT_RESOURCES;
+    }
 
-        /* Check for graceful closure */
-        if (Information == 0)
-        {
-            /* Receive is closed */
-            FCB->TdiReceiveClosed = TRUE;
-        }
-        else
+    return STATUS_SUCCESS;
+}
+
+VOID CancelStreamReceive( PAFD_FCB FCB )
+{
+    UINT i;
+
+    for (i = 0; i < FCB->RecvSegmentCount; i++)
+    {
+        if (FCB->RecvSegments[i].Request.InFlightRequest)
         {
-            /* Issue another receive IRP to keep the buffer well stocked */
-            RefillSocketBuffer(FCB);
+            AFD_DbgPrint(MID_TRACE,("Cancelling receive segment %u (%p)\n",
+                                    i, FCB->RecvSegments[i].Request.InFlightRequest));
+            IoCancelIrp(FCB->RecvSegments[i].Request.InFlightRequest);
         }
     }
-    /* Receive failed with no data (unexpected closure) */
-    else
+}
+
+VOID DiscardStreamReceiveData( PAFD_FCB FCB )
+{
+    PAFD_RECV_SEGMENT Segment;
+
+    /* Drop everything the application has not read yet. Receives still
+     * in flight are discarded when they complete. */
+    while (FCB->RecvSegmentCount &&
+           FCB->RecvSegments[FCB->RecvHead].State == AFD_RECV_SEGMENT_READY)
     {
-        /* Previously received data remains intact */
-        FCB->TdiReceiveClosed = TRUE;
+        Segment = &FCB->RecvSegments[FCB->RecvHead];
+        Segment->BytesUsed = Segment->Content;
+        ReleaseRecvSegment(FCB);
     }
+
+    FCB->Recv.Content = 0;
+    FCB->Recv.BytesUsed = 0;
 }
 
 static BOOLEAN CantReadMore( PAFD_FCB FCB ) {
-    UINT BytesAvailable = FCB->Recv.Content - FCB->Recv.BytesUsed;
+    UINT BytesAvailable = RecvBytesAvailable(FCB);
 
     return !BytesAvailable && FCB->TdiReceiveClosed;
 }
@@ -95,9 +215,10 @@ static BOOLEAN CantReadMore( PAFD_FCB FCB ) {
 static NTSTATUS TryToSatisfyRecvRequestFromBuffer( PAFD_FCB FCB,
                                                    PAFD_RECV_INFO RecvReq,
                                                    PUINT TotalBytesCopied ) {
-    UINT i, BytesToCopy = 0, FcbBytesCopied = FCB->Recv.BytesUsed,
-        BytesAvailable =
-        FCB->Recv.Content - FCB->Recv.BytesUsed;
+    UINT i, BytesToCopy = 0, BufferBytesCopied, SegmentIndex, SegmentBytesUsed,
+        BytesAvailable = RecvBytesAvailable(FCB);
+    BOOLEAN Peek = (RecvReq->TdiFlags & TDI_RECEIVE_PEEK) != 0;
+    PAFD_RECV_SEGMENT Segment;
     PAFD_MAPBUF Map;
     *TotalBytesCopied = 0;
 
@@ -109,6 +230,10 @@ static NTSTATUS TryToSatisfyRecvRequestFromBuffer( PAFD_FCB FCB,
 
     Map = (PAFD_MAPBUF)(RecvReq->BufferArray + RecvReq->BufferCount);
 
+    SegmentIndex = FCB->RecvHead;
+    Segment = &FCB->RecvSegments[SegmentIndex];
+    SegmentBytesUsed = Segment->BytesUsed;
+
     AFD_DbgPrint(MID_TRACE,("Buffer Count: %u @ %p\n",
                             RecvReq->BufferCount,
                             RecvReq->BufferArray));
@@ -117,32 +242,52 @@ static NTSTATUS TryToSatisfyRecvRequestFromBuffer( PAFD_FCB FCB,
              BytesAvailable &&
              i < RecvReq->BufferCount;
          i++ ) {
-        BytesToCopy =
-            MIN( RecvReq->BufferArray[i].len, BytesAvailable );
+        if( !Map[i].Mdl ) continue;
+
+        Map[i].BufferAddress = MmMapLockedPages( Map[i].Mdl, KernelMode );
+        BufferBytesCopied = 0;
+
+        /* A user buffer may take data from several segments */
+        while( BytesAvailable &&
+               BufferBytesCopied < RecvReq->BufferArray[i].len ) {
+            if( SegmentBytesUsed == Segment->Content ) {
+                /* This segment is drained, continue with the next one */
+                if( !Peek ) ReleaseRecvSegment( FCB );
+                SegmentIndex = NEXT_RECV_SEGMENT(FCB, SegmentIndex);
+                Segment = &FCB->RecvSegments[SegmentIndex];
+                SegmentBytesUsed = Segment->BytesUsed;
+                ASSERT(Segment->State == AFD_RECV_SEGMENT_READY);
+            }
 
-        if( Map[i].Mdl ) {
-            Map[i].BufferAddress = MmMapLockedPages( Map[i].Mdl, KernelMode );
+            BytesToCopy =
+                MIN( RecvReq->BufferArray[i].len - BufferBytesCopied,
+                     Segment->Content - SegmentBytesUsed );
 
-            AFD_DbgPrint(MID_TRACE,("Buffer %u: %p:%u\n",
+            AFD_DbgPrint(MID_TRACE,("Buffer %u: %p:%u from segment %u\n",
                                     i,
                                     Map[i].BufferAddress,
-                                    BytesToCopy));
+                                    BytesToCopy,
+                                    SegmentIndex));
 
-            RtlCopyMemory( Map[i].BufferAddress,
-                           FCB->Recv.Window + FcbBytesCopied,
+            RtlCopyMemory( (PCHAR)Map[i].BufferAddress + BufferBytesCopied,
+                           FCB->Recv.Window + Segment->Offset + SegmentBytesUsed,
                            BytesToCopy );
 
-            MmUnmapLockedPages( Map[i].BufferAddress, Map[i].Mdl );
-
             *TotalBytesCopied += BytesToCopy;
-            FcbBytesCopied += BytesToCopy;
+            BufferBytesCopied += BytesToCopy;
+            SegmentBytesUsed += BytesToCopy;
             BytesAvailable -= BytesToCopy;
 
-            if (!(RecvReq->TdiFlags & TDI_RECEIVE_PEEK))
-                FCB->Recv.BytesUsed += BytesToCopy;
+            if( !Peek ) Segment->BytesUsed = SegmentBytesUsed;
         }
+
+        MmUnmapLockedPages( Map[i].BufferAddress, Map[i].Mdl );
     }
 
+    /* Give a fully drained head segment back to the transport */
+    if( !Peek && Segment->BytesUsed == Segment->Content )
+        ReleaseRecvSegment( FCB );
+
     /* Issue another receive IRP to keep the buffer well stocked */
     RefillSocketBuffer(FCB);
 
@@ -160,7 +305,7 @@ static NTSTATUS ReceiveActivity( PAFD_FCB FCB, PIRP Irp ) {
     AFD_DbgPrint(MID_TRACE,("%p %p\n", FCB, Irp));
 
     AFD_DbgPrint(MID_TRACE,("FCB %p Receive data waiting %u\n",
-                            FCB, FCB->Recv.Content));
+                            FCB, RecvBytesAvailable(FCB)));
 
     if( CantReadMore( FCB ) ) {
         /* Success here means that we got an EOF.  Complete a pending read
@@ -199,8 +344,7 @@ static NTSTATUS ReceiveActivity( PAFD_FCB FCB, PIRP Irp ) {
         /* XXX Not implemented yet */
 
         AFD_DbgPrint(MID_TRACE,("FCB %p Receive data waiting %u\n",
-                                FCB, FCB->Recv.Content));
-        /*OskitDumpBuffer( FCB->Recv.Window, FCB->Recv.Content );*/
+                                FCB, RecvBytesAvailable(FCB)));
 
         /* Try to clear some requests */
         while( !IsListEmpty( &FCB->PendingIrpList[FUNCTION_RECV] ) ) {
@@ -237,7 +381,7 @@ static NTSTATUS ReceiveActivity( PAFD_FCB FCB, PIRP Irp ) {
         }
     }
 
-    if( FCB->Recv.Content - FCB->Recv.BytesUsed &&
+    if( RecvBytesAvailable(FCB) &&
         IsListEmpty(&FCB->PendingIrpList[FUNCTION_RECV]) ) {
         FCB->PollState |= AFD_EVENT_RECEIVE;
         FCB->PollStatus[FD_READ_BIT] = STATUS_SUCCESS;
@@ -283,6 +427,8 @@ NTSTATUS NTAPI ReceiveComplete
     PIRP NextIrp;
     PAFD_RECV_INFO RecvReq;
     PIO_STACK_LOCATION NextIrpSp;
+    PAFD_RECV_SEGMENT Segment = NULL;
+    UINT i;
 
     UNREFERENCED_PARAMETER(DeviceObject);
 
@@ -291,8 +437,23 @@ NTSTATUS NTAPI ReceiveComplete
     if( !SocketAcquireStateLock( FCB ) )
         return STATUS_FILE_CLOSED;
 
-    ASSERT(FCB->ReceiveIrp.InFlightRequest == Irp);
-    FCB->ReceiveIrp.InFlightRequest = NULL;
+    for( i = 0; i < FCB->RecvSegmentCount; i++ ) {
+        if( FCB->RecvSegments[i].Request.InFlightRequest == Irp ) {
+            Segment = &FCB->RecvSegments[i];
+            break;
+        }
+    }
+
+    ASSERT(Segment);
+    if( !Segment ) {
+        SocketStateUnlock( FCB );
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    Segment->Request.InFlightRequest = NULL;
+    Segment->Request.Iosb.Status = Irp->IoStatus.Status;
+    Segment->Request.Iosb.Information = Irp->IoStatus.Information;
+    Segment->State = AFD_RECV_SEGMENT_COMPLETE;
 
     if( FCB->State == SOCKET_STATE_CLOSED ) {
         /* Cleanup our IRP queue because the FCB is being destroyed */
@@ -316,7 +477,7 @@ NTSTATUS NTAPI ReceiveComplete
         return STATUS_INVALID_PARAMETER;
     }
 
-    HandleReceiveComplete( FCB, Irp->IoStatus.Status, Irp->IoStatus.Information );
+    HandleReceiveComplete( FCB );
 
     ReceiveActivity( FCB, NULL );
 
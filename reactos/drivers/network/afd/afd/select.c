@@ -68,6 +68,8 @@ VOID SignalSocket(
     {
         KeCancelTimer( &Poll->Timer );
         RemoveEntryList( &Poll->ListEntry );
+        for( i = 0; i < Poll->WaiterCount; i++ )
+            RemoveEntryList( &Poll->Waiters[i].ListEntry );
         ExFreePool( Poll );
     }
 
@@ -122,42 +124,153 @@ static VOID NTAPI SelectTimeout( PKDPC Dpc,
     AFD_DbgPrint(MID_TRACE,("Timeout\n"));
 }
 
+/* * * NOTE ALWAYS CALLED AT DISPATCH_LEVEL * * */
+static VOID RemovePollSetEntry( PAFD_POLL_SET_ENTRY Entry ) {
+    RemoveEntryList( &Entry->Waiter.ListEntry );
+    RemoveEntryList( &Entry->ListEntry );
+    if( Entry->Ready ) {
+        RemoveEntryList( &Entry->ReadyEntry );
+        Entry->Ready = FALSE;
+    }
+    Entry->Set->EntryCount--;
+}
+
+static VOID FreePollSetEntries( PLIST_ENTRY DeadEntries ) {
+    PLIST_ENTRY ListEntry;
+    PAFD_POLL_SET_ENTRY Entry;
+
+    while( !IsListEmpty( DeadEntries ) ) {
+        ListEntry = RemoveHeadList( DeadEntries );
+        Entry = CONTAINING_RECORD(ListEntry, AFD_POLL_SET_ENTRY, ListEntry);
+        ObDereferenceObject( Entry->FileObject );
+        ExFreePool( Entry );
+    }
+}
+
+/* * * NOTE ALWAYS CALLED AT DISPATCH_LEVEL * * */
+static ULONG HarvestPollSet( PAFD_POLL_SET Set,
+                             PAFD_POLL_SET_EVENT Events,
+                             ULONG MaxEvents ) {
+    PLIST_ENTRY ListEntry;
+    PAFD_POLL_SET_ENTRY Entry;
+    PAFD_FCB FCB;
+    LIST_ENTRY Reported;
+    ULONG Count = 0, Ready;
+
+    InitializeListHead( &Reported );
+
+    ListEntry = Set->ReadyList.Flink;
+    while( ListEntry != &Set->ReadyList && Count < MaxEvents ) {
+        Entry = CONTAINING_RECORD(ListEntry, AFD_POLL_SET_ENTRY, ReadyEntry);
+        ListEntry = ListEntry->Flink;
+
+        FCB = Entry->FileObject->FsContext;
+        Ready = Entry->Events & FCB->PollState;
+
+        RemoveEntryList( &Entry->ReadyEntry );
+
+        /* Level triggered: the entry stays ready until its state clears */
+        if( !Ready ) {
+            Entry->Ready = FALSE;
+            continue;
+        }
+
+        Events[Count].Context = Entry->Context;
+        Events[Count].Handle = Entry->Handle;
+        Events[Count].Events = Ready;
+        Count++;
+
+        InsertTailList( &Reported, &Entry->ReadyEntry );
+    }
+
+    /* Requeue what we reported behind what we didn't get to */
+    while( !IsListEmpty( &Reported ) ) {
+        ListEntry = RemoveHeadList( &Reported );
+        InsertTailList( &Set->ReadyList, ListEntry );
+    }
+
+    return Count;
+}
+
+/* * * NOTE ALWAYS CALLED AT DISPATCH_LEVEL * * */
+static VOID CompletePollSetWait( PAFD_POLL_SET Set,
+                                 ULONG EventCount,
+                                 NTSTATUS Status ) {
+    PIRP Irp = Set->WaitIrp;
+    PAFD_POLL_SET_WAIT_INFO WaitReq = Irp->AssociatedIrp.SystemBuffer;
+
+    AFD_DbgPrint(MID_TRACE,("Completing set wait %p (Status %x Events %u)\n",
+                            Irp, Status, EventCount));
+
+    Set->WaitIrp = NULL;
+    KeCancelTimer( &Set->Timer );
+
+    WaitReq->EventCount = EventCount;
+    Irp->IoStatus.Status = Status;
+    Irp->IoStatus.Information =
+        FIELD_OFFSET(AFD_POLL_SET_WAIT_INFO, Events) +
+        EventCount * sizeof(AFD_POLL_SET_EVENT);
+    (void)IoSetCancelRoutine(Irp, NULL);
+    IoCompleteRequest( Irp, IO_NETWORK_INCREMENT );
+}
+
+/* * * NOTE ALWAYS CALLED AT DISPATCH_LEVEL * * */
+static BOOLEAN SatisfyPollSetWait( PAFD_POLL_SET Set ) {
+    PAFD_POLL_SET_WAIT_INFO WaitReq = Set->WaitIrp->AssociatedIrp.SystemBuffer;
+    ULONG Count;
+
+    Count = HarvestPollSet( Set, WaitReq->Events, Set->WaitMaxEvents );
+    if( !Count ) return FALSE;
+
+    CompletePollSetWait( Set, Count, STATUS_SUCCESS );
+    return TRUE;
+}
+
 VOID KillSelectsForFCB( PAFD_DEVICE_EXTENSION DeviceExt,
                         PFILE_OBJECT FileObject,
                         BOOLEAN OnlyExclusive ) {
     KIRQL OldIrql;
     PLIST_ENTRY ListEntry;
+    PAFD_POLL_WAITER Waiter;
     PAFD_ACTIVE_POLL Poll;
-    PIRP Irp;
     PAFD_POLL_INFO PollReq;
-    PAFD_HANDLE HandleArray;
-    UINT i;
+    PAFD_FCB FCB = FileObject->FsContext;
+    LIST_ENTRY DeadEntries;
 
     AFD_DbgPrint(MID_TRACE,("Killing selects that refer to %p\n", FileObject));
 
+    InitializeListHead( &DeadEntries );
+
     KeAcquireSpinLock( &DeviceExt->Lock, &OldIrql );
 
-    ListEntry = DeviceExt->Polls.Flink;
-    while ( ListEntry != &DeviceExt->Polls ) {
-        Poll = CONTAINING_RECORD(ListEntry, AFD_ACTIVE_POLL, ListEntry);
+    ListEntry = FCB->PollWaiters.Flink;
+    while ( ListEntry != &FCB->PollWaiters ) {
+        Waiter = CONTAINING_RECORD(ListEntry, AFD_POLL_WAITER, ListEntry);
         ListEntry = ListEntry->Flink;
-        Irp = Poll->Irp;
-        PollReq = Irp->AssociatedIrp.SystemBuffer;
-        HandleArray = AFD_HANDLES(PollReq);
 
-        for( i = 0; i < PollReq->HandleCount; i++ ) {
-            AFD_DbgPrint(MAX_TRACE,("Req: %u, This %p\n",
-                                    HandleArray[i].Handle, FileObject));
-            if( (PVOID)HandleArray[i].Handle == FileObject &&
-                (!OnlyExclusive || (OnlyExclusive && Poll->Exclusive)) ) {
-                ZeroEvents( PollReq->Handles, PollReq->HandleCount );
-                SignalSocket( Poll, NULL, PollReq, STATUS_CANCELLED );
-            }
+        if( Waiter->SetEntry ) {
+            /* The socket is going away, take it out of the interest set */
+            if( OnlyExclusive ) continue;
+            RemovePollSetEntry( Waiter->SetEntry );
+            InsertTailList( &DeadEntries, &Waiter->SetEntry->ListEntry );
+            continue;
         }
+
+        Poll = Waiter->Poll;
+        if( OnlyExclusive && !Poll->Exclusive ) continue;
+
+        PollReq = Poll->Irp->AssociatedIrp.SystemBuffer;
+        ZeroEvents( PollReq->Handles, PollReq->HandleCount );
+        SignalSocket( Poll, NULL, PollReq, STATUS_CANCELLED );
+
+        /* The poll unlinked all of its waiters, start over */
+        ListEntry = FCB->PollWaiters.Flink;
     }
 
     KeReleaseSpinLock( &DeviceExt->Lock, OldIrql );
 
+    FreePollSetEntries( &DeadEntries );
+
     AFD_DbgPrint(MID_TRACE,("Done\n"));
 }
 
@@ -228,12 +341,30 @@ AfdSelect( PDEVICE_OBJECT DeviceObject, PIRP Irp,
 
        PAFD_ACTIVE_POLL Poll = NULL;
 
-       Poll = ExAllocatePool( NonPagedPool, sizeof(AFD_ACTIVE_POLL) );
+       Poll = ExAllocatePool( NonPagedPool,
+                              FIELD_OFFSET(AFD_ACTIVE_POLL, Waiters) +
+                              PollReq->HandleCount * sizeof(AFD_POLL_WAITER) );
 
        if (Poll){
           Poll->Irp = Irp;
           Poll->DeviceExt = DeviceExt;
           Poll->Exclusive = Exclusive;
+          Poll->WaiterCount = PollReq->HandleCount;
+
+          for( i = 0; i < PollReq->HandleCount; i++ ) {
+              Poll->Waiters[i].Poll = Poll;
+              Poll->Waiters[i].SetEntry = NULL;
+              Poll->Waiters[i].Index = i;
+
+              if( !AFD_HANDLES(PollReq)[i].Handle ) {
+                  InitializeListHead( &Poll->Waiters[i].ListEntry );
+                  continue;
+              }
+
+              FileObject = (PFILE_OBJECT)AFD_HANDLES(PollReq)[i].Handle;
+              FCB = FileObject->FsContext;
+              InsertTailList( &FCB->PollWaiters, &Poll->Waiters[i].ListEntry );
+          }
 
           KeInitializeTimerEx( &Poll->Timer, NotificationTimer );
 
@@ -400,7 +531,9 @@ static BOOLEAN UpdatePollWithFCB( PAFD_ACTIVE_POLL Poll, PFILE_OBJECT FileObject
 
 VOID PollReeval( PAFD_DEVICE_EXTENSION DeviceExt, PFILE_OBJECT FileObject ) {
     PAFD_ACTIVE_POLL Poll = NULL;
-    PLIST_ENTRY ThePollEnt = NULL;
+    PAFD_POLL_WAITER Waiter;
+    PAFD_POLL_SET_ENTRY SetEntry;
+    PLIST_ENTRY ListEntry;
     PAFD_FCB FCB;
     KIRQL OldIrql;
     PAFD_POLL_INFO PollReq;
@@ -418,20 +551,39 @@ VOID PollReeval( PAFD_DEVICE_EXTENSION DeviceExt, PFILE_OBJECT FileObject ) {
         return;
     }
 
-    /* Now signal normal select irps */
-    ThePollEnt = DeviceExt->Polls.Flink;
+    /* Now signal normal select irps and interest sets waiting on this socket */
+    ListEntry = FCB->PollWaiters.Flink;
+
+    while( ListEntry != &FCB->PollWaiters ) {
+        Waiter = CONTAINING_RECORD( ListEntry, AFD_POLL_WAITER, ListEntry );
+        ListEntry = ListEntry->Flink;
 
-    while( ThePollEnt != &DeviceExt->Polls ) {
-        Poll = CONTAINING_RECORD( ThePollEnt, AFD_ACTIVE_POLL, ListEntry );
+        if( Waiter->SetEntry ) {
+            SetEntry = Waiter->SetEntry;
+            if( !SetEntry->Ready && (SetEntry->Events & FCB->PollState) ) {
+                AFD_DbgPrint(MID_TRACE,("Readying set entry %p\n", SetEntry));
+                SetEntry->Ready = TRUE;
+                InsertTailList( &SetEntry->Set->ReadyList, &SetEntry->ReadyEntry );
+                if( SetEntry->Set->WaitIrp )
+                    SatisfyPollSetWait( SetEntry->Set );
+            }
+            continue;
+        }
+
+        Poll = Waiter->Poll;
         PollReq = Poll->Irp->AssociatedIrp.SystemBuffer;
         AFD_DbgPrint(MID_TRACE,("Checking poll %p\n", Poll));
 
-        if( UpdatePollWithFCB( Poll, FileObject ) ) {
-            ThePollEnt = ThePollEnt->Flink;
-            AFD_DbgPrint(MID_TRACE,("Signalling socket\n"));
-            SignalSocket( Poll, NULL, PollReq, STATUS_SUCCESS );
-        } else
-            ThePollEnt = ThePollEnt->Flink;
+        if( !(PollReq->Handles[Waiter->Index].Events & FCB->PollState) )
+            continue;
+
+        /* Report every socket of the poll that is ready, not just this one */
+        UpdatePollWithFCB( Poll, FileObject );
+        AFD_DbgPrint(MID_TRACE,("Signalling socket\n"));
+        SignalSocket( Poll, NULL, PollReq, STATUS_SUCCESS );
+
+        /* The poll unlinked all of its waiters, start over */
+        ListEntry = FCB->PollWaiters.Flink;
     }
 
     KeReleaseSpinLock( &DeviceExt->Lock, OldIrql );
@@ -447,3 +599,310 @@ VOID PollReeval( PAFD_DEVICE_EXTENSION DeviceExt, PFILE_OBJECT FileObject ) {
 
     AFD_DbgPrint(MID_TRACE,("Leaving\n"));
 }
+
+static KDEFERRED_ROUTINE PollSetTimeout;
+static VOID NTAPI PollSetTimeout( PKDPC Dpc,
+                                  PVOID DeferredContext,
+                                  PVOID SystemArgument1,
+                                  PVOID SystemArgument2 ) {
+    PAFD_POLL_SET Set = DeferredContext;
+    KIRQL OldIrql;
+
+    UNREFERENCED_PARAMETER(Dpc);
+    UNREFERENCED_PARAMETER(SystemArgument1);
+    UNREFERENCED_PARAMETER(SystemArgument2);
+
+    KeAcquireSpinLock( &Set->DeviceExt->Lock, &OldIrql );
+    /* The DPC may have been queued by the timer of a wait that completed
+     * in the meantime. Setting the timer for the next wait resets its
+     * state, so only a signaled timer belongs to the current wait */
+    if( Set->WaitIrp && KeReadStateTimer( &Set->Timer ) )
+        CompletePollSetWait( Set, 0, STATUS_TIMEOUT );
+    KeReleaseSpinLock( &Set->DeviceExt->Lock, OldIrql );
+}
+
+static PAFD_POLL_SET GetPollSet( PAFD_FCB FCB ) {
+    PAFD_POLL_SET Set = FCB->PollSet;
+
+    if( Set ) return Set;
+
+    Set = ExAllocatePool( NonPagedPool, sizeof(AFD_POLL_SET) );
+    if( !Set ) return NULL;
+
+    InitializeListHead( &Set->Entries );
+    InitializeListHead( &Set->ReadyList );
+    Set->EntryCount = 0;
+    Set->WaitIrp = NULL;
+    Set->WaitMaxEvents = 0;
+    Set->DeviceExt = FCB->DeviceExt;
+    KeInitializeTimerEx( &Set->Timer, NotificationTimer );
+    KeInitializeDpc( &Set->TimeoutDpc, PollSetTimeout, Set );
+
+    FCB->PollSet = Set;
+
+    return Set;
+}
+
+/* * * NOTE ALWAYS CALLED AT DISPATCH_LEVEL * * */
+static PAFD_POLL_SET_ENTRY FindPollSetEntry( PAFD_POLL_SET Set,
+                                             PAFD_FCB SocketFCB ) {
+    PLIST_ENTRY ListEntry;
+    PAFD_POLL_WAITER Waiter;
+
+    /* A socket has far fewer waiters than a set has entries */
+    for( ListEntry = SocketFCB->PollWaiters.Flink;
+         ListEntry != &SocketFCB->PollWaiters;
+         ListEntry = ListEntry->Flink ) {
+        Waiter = CONTAINING_RECORD(ListEntry, AFD_POLL_WAITER, ListEntry);
+        if( Waiter->SetEntry && Waiter->SetEntry->Set == Set )
+            return Waiter->SetEntry;
+    }
+
+    return NULL;
+}
+
+NTSTATUS NTAPI
+AfdPollSetControl( PDEVICE_OBJECT DeviceObject, PIRP Irp,
+                   PIO_STACK_LOCATION IrpSp ) {
+    PFILE_OBJECT FileObject = IrpSp->FileObject;
+    PAFD_FCB FCB = FileObject->FsContext;
+    PAFD_POLL_SET_CONTROL_INFO ControlReq = Irp->AssociatedIrp.SystemBuffer;
+    PAFD_DEVICE_EXTENSION DeviceExt = DeviceObject->DeviceExtension;
+    PFILE_OBJECT SocketObject;
+    PAFD_FCB SocketFCB;
+    PAFD_POLL_SET Set;
+    PAFD_POLL_SET_ENTRY Entry, NewEntry = NULL;
+    LIST_ENTRY DeadEntries;
+    KIRQL OldIrql;
+    NTSTATUS Status;
+
+    if( !SocketAcquireStateLock( FCB ) ) return LostSocket( Irp );
+
+    if( IrpSp->Parameters.DeviceIoControl.InputBufferLength < sizeof(*ControlReq) )
+        return UnlockAndMaybeComplete( FCB, STATUS_INVALID_PARAMETER, Irp, 0 );
+
+    AFD_DbgPrint(MID_TRACE,("Called (Operation %u Handle %x Events %x)\n",
+                            ControlReq->Operation,
+                            ControlReq->Handle,
+                            ControlReq->Events));
+
+    Set = GetPollSet( FCB );
+    if( !Set )
+        return UnlockAndMaybeComplete( FCB, STATUS_NO_MEMORY, Irp, 0 );
+
+    Status = ObReferenceObjectByHandle( (HANDLE)ControlReq->Handle,
+                                        0,
+                                        *IoFileObjectType,
+                                        Irp->RequestorMode,
+                                        (PVOID *)&SocketObject,
+                                        NULL );
+    if( !NT_SUCCESS(Status) )
+        return UnlockAndMaybeComplete( FCB, Status, Irp, 0 );
+
+    /* Only AFD sockets can be watched, and a set can't watch itself */
+    if( SocketObject->DeviceObject != DeviceObject ||
+        SocketObject == FileObject ||
+        !SocketObject->FsContext ) {
+        ObDereferenceObject( SocketObject );
+        return UnlockAndMaybeComplete( FCB, STATUS_INVALID_HANDLE, Irp, 0 );
+    }
+
+    SocketFCB = SocketObject->FsContext;
+
+    if( ControlReq->Operation == AFD_POLL_SET_ADD ) {
+        NewEntry = ExAllocatePool( NonPagedPool, sizeof(AFD_POLL_SET_ENTRY) );
+        if( !NewEntry ) {
+            ObDereferenceObject( SocketObject );
+            return UnlockAndMaybeComplete( FCB, STATUS_NO_MEMORY, Irp, 0 );
+        }
+    }
+
+    InitializeListHead( &DeadEntries );
+
+    KeAcquireSpinLock( &DeviceExt->Lock, &OldIrql );
+
+    Entry = FindPollSetEntry( Set, SocketFCB );
+
+    switch( ControlReq->Operation ) {
+    case AFD_POLL_SET_ADD:
+        if( Entry ) {
+            Status = STATUS_OBJECT_NAME_COLLISION;
+            break;
+        }
+
+        Entry = NewEntry;
+        NewEntry = NULL;
+
+        Entry->Set = Set;
+        Entry->FileObject = SocketObject;
+        Entry->Handle = ControlReq->Handle;
+        Entry->Events = ControlReq->Events;
+        Entry->Context = ControlReq->Context;
+        Entry->Ready = FALSE;
+        Entry->Waiter.Poll = NULL;
+        Entry->Waiter.SetEntry = Entry;
+        Entry->Waiter.Index = 0;
+
+        InsertTailList( &Set->Entries, &Entry->ListEntry );
+        InsertTailList( &SocketFCB->PollWaiters, &Entry->Waiter.ListEntry );
+        Set->EntryCount++;
+
+        /* The entry holds on to the socket until it is removed */
+        SocketObject = NULL;
+        Status = STATUS_SUCCESS;
+        break;
+
+    case AFD_POLL_SET_MODIFY:
+        if( !Entry ) {
+            Status = STATUS_NOT_FOUND;
+            break;
+        }
+
+        Entry->Events = ControlReq->Events;
+        Entry->Context = ControlReq->Context;
+        Status = STATUS_SUCCESS;
+        break;
+
+    case AFD_POLL_SET_REMOVE:
+        if( !Entry ) {
+            Status = STATUS_NOT_FOUND;
+            break;
+        }
+
+        RemovePollSetEntry( Entry );
+        InsertTailList( &DeadEntries, &Entry->ListEntry );
+        Entry = NULL;
+        Status = STATUS_SUCCESS;
+        break;
+
+    default:
+        Status = STATUS_INVALID_PARAMETER;
+        break;
+    }
+
+    if( NT_SUCCESS(Status) && Entry && !Entry->Ready &&
+        (Entry->Events & SocketFCB->PollState) ) {
+        Entry->Ready = TRUE;
+        InsertTailList( &Set->ReadyList, &Entry->ReadyEntry );
+        if( Set->WaitIrp )
+            SatisfyPollSetWait( Set );
+    }
+
+    KeReleaseSpinLock( &DeviceExt->Lock, OldIrql );
+
+    FreePollSetEntries( &DeadEntries );
+    if( NewEntry ) ExFreePool( NewEntry );
+    if( SocketObject ) ObDereferenceObject( SocketObject );
+
+    return UnlockAndMaybeComplete( FCB, Status, Irp, 0 );
+}
+
+NTSTATUS NTAPI
+AfdPollSetWait( PDEVICE_OBJECT DeviceObject, PIRP Irp,
+                PIO_STACK_LOCATION IrpSp ) {
+    PFILE_OBJECT FileObject = IrpSp->FileObject;
+    PAFD_FCB FCB = FileObject->FsContext;
+    PAFD_POLL_SET_WAIT_INFO WaitReq = Irp->AssociatedIrp.SystemBuffer;
+    PAFD_DEVICE_EXTENSION DeviceExt = DeviceObject->DeviceExtension;
+    ULONG OutputLength = IrpSp->Parameters.DeviceIoControl.OutputBufferLength;
+    ULONG MaxEvents;
+    PAFD_POLL_SET Set;
+    KIRQL OldIrql;
+    NTSTATUS Status;
+
+    if( !SocketAcquireStateLock( FCB ) ) return LostSocket( Irp );
+
+    if( IrpSp->Parameters.DeviceIoControl.InputBufferLength <
+        FIELD_OFFSET(AFD_POLL_SET_WAIT_INFO, Events) ||
+        OutputLength < FIELD_OFFSET(AFD_POLL_SET_WAIT_INFO, Events) )
+        return UnlockAndMaybeComplete( FCB, STATUS_INVALID_PARAMETER, Irp, 0 );
+
+    MaxEvents = (OutputLength - FIELD_OFFSET(AFD_POLL_SET_WAIT_INFO, Events)) /
+                sizeof(AFD_POLL_SET_EVENT);
+    if( WaitReq->EventCount < MaxEvents ) MaxEvents = WaitReq->EventCount;
+
+    if( !MaxEvents )
+        return UnlockAndMaybeComplete( FCB, STATUS_INVALID_PARAMETER, Irp, 0 );
+
+    AFD_DbgPrint(MID_TRACE,("Called (MaxEvents %u Timeout %d)\n",
+                            MaxEvents, (INT)(WaitReq->Timeout.QuadPart)));
+
+    Set = GetPollSet( FCB );
+    if( !Set )
+        return UnlockAndMaybeComplete( FCB, STATUS_NO_MEMORY, Irp, 0 );
+
+    KeAcquireSpinLock( &DeviceExt->Lock, &OldIrql );
+
+    if( Set->WaitIrp ) {
+        KeReleaseSpinLock( &DeviceExt->Lock, OldIrql );
+        return UnlockAndMaybeComplete( FCB, STATUS_DEVICE_BUSY, Irp, 0 );
+    }
+
+    Set->WaitIrp = Irp;
+    Set->WaitMaxEvents = MaxEvents;
+
+    if( SatisfyPollSetWait( Set ) ) {
+        Status = STATUS_SUCCESS;
+    } else {
+        Status = STATUS_PENDING;
+        IoMarkIrpPending( Irp );
+        (void)IoSetCancelRoutine(Irp, AfdCancelHandler);
+        KeSetTimer( &Set->Timer, WaitReq->Timeout, &Set->TimeoutDpc );
+    }
+
+    KeReleaseSpinLock( &DeviceExt->Lock, OldIrql );
+
+    SocketStateUnlock( FCB );
+
+    AFD_DbgPrint(MID_TRACE,("Returning %x\n", Status));
+
+    return Status;
+}
+
+VOID CancelPollSetWait( PAFD_FCB FCB, PIRP Irp ) {
+    KIRQL OldIrql;
+
+    KeAcquireSpinLock( &FCB->DeviceExt->Lock, &OldIrql );
+    if( FCB->PollSet && FCB->PollSet->WaitIrp == Irp )
+        CompletePollSetWait( FCB->PollSet, 0, STATUS_CANCELLED );
+    KeReleaseSpinLock( &FCB->DeviceExt->Lock, OldIrql );
+}
+
+VOID ClearPollSet( PAFD_FCB FCB ) {
+    PAFD_POLL_SET Set = FCB->PollSet;
+    PAFD_POLL_SET_ENTRY Entry;
+    LIST_ENTRY DeadEntries;
+    KIRQL OldIrql;
+
+    if( !Set ) return;
+
+    InitializeListHead( &DeadEntries );
+
+    KeAcquireSpinLock( &FCB->DeviceExt->Lock, &OldIrql );
+
+    if( Set->WaitIrp )
+        CompletePollSetWait( Set, 0, STATUS_CANCELLED );
+
+    while( !IsListEmpty( &Set->Entries ) ) {
+        Entry = CONTAINING_RECORD(Set->Entries.Flink, AFD_POLL_SET_ENTRY, ListEntry);
+        RemovePollSetEntry( Entry );
+        InsertTailList( &DeadEntries, &Entry->ListEntry );
+    }
+
+    KeReleaseSpinLock( &FCB->DeviceExt->Lock, OldIrql );
+
+    FreePollSetEntries( &DeadEntries );
+}
+
+VOID FreePollSet( PAFD_FCB FCB ) {
+    if( !FCB->PollSet ) return;
+
+    ClearPollSet( FCB );
+
+    /* Make sure a timeout that already fired is done with the set */
+    KeCancelTimer( &FCB->PollSet->Timer );
+    KeFlushQueuedDpcs();
+
+    ExFreePool( FCB->PollSet );
+    FCB->PollSet = NULL;
+}
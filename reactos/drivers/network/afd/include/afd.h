@@ -102,6 +102,17 @@ typedef struct IPADDR_ENTRY {
 
 #define IN_FLIGHT_REQUESTS              5
 
+/* Stream receive windows are split into up to this many segments, each
+ * with its own TDI receive in flight, so the transport always has a
+ * buffer to complete into while the previous one is being drained */
+#define AFD_MAX_RECV_SEGMENTS           4
+#define AFD_MIN_RECV_SEGMENT_SIZE       0x1000
+
+#define AFD_RECV_SEGMENT_IDLE           0 /* Not posted, holds no data */
+#define AFD_RECV_SEGMENT_PENDING        1 /* TDI receive in flight */
+#define AFD_RECV_SEGMENT_COMPLETE       2 /* TDI receive done, not processed yet */
+#define AFD_RECV_SEGMENT_READY          3 /* Holds data for the application */
+
 #define EXTRA_LOCK_BUFFERS              2 /* Number of extra buffers needed
 					   * for ancillary data on packet
 					   * requests. */
@@ -123,6 +134,15 @@ typedef struct _AFD_DEVICE_EXTENSION {
     KSPIN_LOCK Lock;
 } AFD_DEVICE_EXTENSION, *PAFD_DEVICE_EXTENSION;
 
+/* Hangs a pending select or an interest set entry off the FCB it waits
+ * on, so a state change only has to look at the waiters of that socket */
+typedef struct _AFD_POLL_WAITER {
+    LIST_ENTRY ListEntry;
+    struct _AFD_ACTIVE_POLL *Poll;
+    struct _AFD_POLL_SET_ENTRY *SetEntry;
+    UINT Index;
+} AFD_POLL_WAITER, *PAFD_POLL_WAITER;
+
 typedef struct _AFD_ACTIVE_POLL {
     LIST_ENTRY ListEntry;
     PIRP Irp;
@@ -131,8 +151,33 @@ typedef struct _AFD_ACTIVE_POLL {
     KTIMER Timer;
     PKEVENT EventObject;
     BOOLEAN Exclusive;
+    UINT WaiterCount;
+    AFD_POLL_WAITER Waiters[1];
 } AFD_ACTIVE_POLL, *PAFD_ACTIVE_POLL;
 
+typedef struct _AFD_POLL_SET {
+    LIST_ENTRY Entries;
+    LIST_ENTRY ReadyList;
+    UINT EntryCount;
+    PIRP WaitIrp;
+    ULONG WaitMaxEvents;
+    PAFD_DEVICE_EXTENSION DeviceExt;
+    KDPC TimeoutDpc;
+    KTIMER Timer;
+} AFD_POLL_SET, *PAFD_POLL_SET;
+
+typedef struct _AFD_POLL_SET_ENTRY {
+    LIST_ENTRY ListEntry;
+    LIST_ENTRY ReadyEntry;
+    AFD_POLL_WAITER Waiter;
+    PAFD_POLL_SET Set;
+    PFILE_OBJECT FileObject;
+    SOCKET Handle;
+    ULONG Events;
+    PVOID Context;
+    BOOLEAN Ready;
+} AFD_POLL_SET_ENTRY, *PAFD_POLL_SET_ENTRY;
+
 typedef struct _IRP_LIST {
     LIST_ENTRY ListEntry;
     PIRP Irp;
@@ -162,6 +207,13 @@ typedef struct _AFD_DATA_WINDOW {
     UINT BytesUsed, Size, Content;
 } AFD_DATA_WINDOW, *PAFD_DATA_WINDOW;
 
+typedef struct _AFD_RECV_SEGMENT {
+    AFD_IN_FLIGHT_REQUEST Request;
+    UINT State;
+    UINT Offset, Size;
+    UINT BytesUsed, Content;
+} AFD_RECV_SEGMENT, *PAFD_RECV_SEGMENT;
+
 typedef struct _AFD_STORED_DATAGRAM {
     LIST_ENTRY ListEntry;
     UINT Len;
@@ -187,6 +239,8 @@ typedef struct _AFD_FCB {
     AFD_TDI_OBJECT AddressFile, Connection;
     AFD_IN_FLIGHT_REQUEST ConnectIrp, ListenIrp, ReceiveIrp, SendIrp, DisconnectIrp;
     AFD_DATA_WINDOW Send, Recv;
+    AFD_RECV_SEGMENT RecvSegments[AFD_MAX_RECV_SEGMENTS];
+    UINT RecvSegmentCount, RecvHead, RecvReady, RecvTail;
     KMUTEX Mutex;
     PKEVENT EventSelect;
     DWORD EventSelectTriggers;
@@ -195,6 +249,8 @@ typedef struct _AFD_FCB {
     PVOID Context;
     DWORD PollState;
     NTSTATUS PollStatus[FD_MAX_EVENTS];
+    LIST_ENTRY PollWaiters;
+    PAFD_POLL_SET PollSet;
     NTSTATUS LastReceiveStatus;
     UINT ContextSize;
     PVOID ConnectData;
@@ -322,6 +378,11 @@ IO_COMPLETION_ROUTINE ReceiveComplete;
 
 IO_COMPLETION_ROUTINE PacketSocketRecvComplete;
 
+NTSTATUS StartStreamReceive( PAFD_FCB FCB );
+VOID CancelStreamReceive( PAFD_FCB FCB );
+VOID DiscardStreamReceiveData( PAFD_FCB FCB );
+UINT RecvBytesAvailable( PAFD_FCB FCB );
+
 NTSTATUS NTAPI
 AfdConnectedSocketReadData(PDEVICE_OBJECT DeviceObject, PIRP Irp, PIO_STACK_LOCATION IrpSp, BOOLEAN Short);
 NTSTATUS NTAPI
@@ -347,6 +408,15 @@ VOID ZeroEvents( PAFD_HANDLE HandleArray,
 VOID SignalSocket(
    PAFD_ACTIVE_POLL Poll OPTIONAL, PIRP _Irp OPTIONAL,
    PAFD_POLL_INFO PollReq, NTSTATUS Status);
+NTSTATUS NTAPI
+AfdPollSetControl( PDEVICE_OBJECT DeviceObject, PIRP Irp,
+		   PIO_STACK_LOCATION IrpSp );
+NTSTATUS NTAPI
+AfdPollSetWait( PDEVICE_OBJECT DeviceObject, PIRP Irp,
+		PIO_STACK_LOCATION IrpSp );
+VOID CancelPollSetWait( PAFD_FCB FCB, PIRP Irp );
+VOID ClearPollSet( PAFD_FCB FCB );
+VOID FreePollSet( PAFD_FCB FCB );
 
 /* tdi.c */
 
@@ -550,6 +550,8 @@ MiniSendComplete(
 
         NDIS_PER_PACKET_INFO_FROM_PACKET(Packet,
                                          ScatterGatherListPacketInfo) = NULL;
+
+        ProRestorePacket(Packet);
     }
 
     (*AdapterBinding->ProtocolBinding->Chars.SendCompleteHandler)(
@@ -26,6 +26,16 @@ typedef struct _DMA_CONTEXT {
     PNDIS_PACKET Packet;
 } DMA_CONTEXT, *PDMA_CONTEXT;
 
+/* Set in NdisPacketFlags while a packet is sent from a coalesced copy */
+#define fPACKET_COALESCED 0x01
+
+typedef struct _COALESCED_PACKET {
+    PNDIS_BUFFER Head;    /* The packet's own buffer chain */
+    PNDIS_BUFFER Tail;
+    PMDL Mdl;             /* Describes Data */
+    UCHAR Data[1];
+} COALESCED_PACKET, *PCOALESCED_PACKET;
+
 PNET_PNP_EVENT
 ProSetupPnPEvent(
     NET_PNP_EVENT_CODE EventCode,
@@ -356,6 +366,91 @@ ProReset(
     return MiniReset(AdapterBinding->Adapter);
 }
 
+static NDIS_STATUS
+proCoalescePacket(PNDIS_PACKET Packet, UINT PacketLength)
+/*
+ * FUNCTION: Replaces the buffer chain of a packet by a single buffer
+ *           holding a copy of its data
+ * ARGUMENTS:
+ *     Packet       = Pointer to NDIS packet descriptor
+ *     PacketLength = Total length of the packet
+ * NOTES:
+ *     The scatter/gather list is built from the first MDL only, and the
+ *     miniports using it expect the frame in one piece. ProRestorePacket
+ *     puts the original chain back
+ */
+{
+    PCOALESCED_PACKET Coalesced;
+    PNDIS_BUFFER NdisBuffer;
+    PUCHAR Data;
+    PVOID Va;
+    UINT Length;
+
+    Coalesced = ExAllocatePool(NonPagedPool,
+                               FIELD_OFFSET(COALESCED_PACKET, Data[PacketLength]));
+    if (!Coalesced) {
+        NDIS_DbgPrint(MIN_TRACE, ("Insufficient resources\n"));
+        return NDIS_STATUS_RESOURCES;
+    }
+
+    Data = Coalesced->Data;
+    for (NdisBuffer = Packet->Private.Head; NdisBuffer; NdisBuffer = NdisBuffer->Next)
+    {
+        NdisQueryBufferSafe(NdisBuffer, &Va, &Length, NormalPagePriority);
+        if (!Va) {
+            NDIS_DbgPrint(MIN_TRACE, ("Unable to map a packet buffer\n"));
+            ExFreePool(Coalesced);
+            return NDIS_STATUS_RESOURCES;
+        }
+
+        RtlCopyMemory(Data, Va, Length);
+        Data += Length;
+    }
+
+    Coalesced->Mdl = IoAllocateMdl(Coalesced->Data, PacketLength, FALSE, FALSE, NULL);
+    if (!Coalesced->Mdl) {
+        NDIS_DbgPrint(MIN_TRACE, ("Insufficient resources\n"));
+        ExFreePool(Coalesced);
+        return NDIS_STATUS_RESOURCES;
+    }
+
+    MmBuildMdlForNonPagedPool(Coalesced->Mdl);
+
+    Coalesced->Head = Packet->Private.Head;
+    Coalesced->Tail = Packet->Private.Tail;
+    Packet->Private.Head = Packet->Private.Tail = Coalesced->Mdl;
+    Packet->Private.ValidCounts = FALSE;
+    Packet->Private.NdisPacketFlags |= fPACKET_COALESCED;
+
+    return NDIS_STATUS_SUCCESS;
+}
+
+VOID
+ProRestorePacket(PNDIS_PACKET Packet)
+/*
+ * FUNCTION: Gives a packet sent from a coalesced copy its buffers back
+ * ARGUMENTS:
+ *     Packet = Pointer to NDIS packet descriptor
+ */
+{
+    PCOALESCED_PACKET Coalesced;
+
+    if (!(Packet->Private.NdisPacketFlags & fPACKET_COALESCED))
+        return;
+
+    Coalesced = CONTAINING_RECORD(MmGetMdlVirtualAddress(Packet->Private.Head),
+                                  COALESCED_PACKET,
+                                  Data);
+
+    Packet->Private.Head = Coalesced->Head;
+    Packet->Private.Tail = Coalesced->Tail;
+    Packet->Private.ValidCounts = FALSE;
+    Packet->Private.NdisPacketFlags &= ~fPACKET_COALESCED;
+
+    IoFreeMdl(Coalesced->Mdl);
+    ExFreePool(Coalesced);
+}
+
 VOID NTAPI
 ScatterGatherSendPacket(
    IN PDEVICE_OBJECT DeviceObject,
@@ -480,7 +575,7 @@ ProSend(
   PNDIS_BUFFER NdisBuffer;
   PDMA_CONTEXT Context;
   NDIS_STATUS NdisStatus;
-  UINT PacketLength;
+  UINT PacketLength, BufferCount;
   KIRQL OldIrql;
 
   NDIS_DbgPrint(MAX_TRACE, ("Called.\n"));
@@ -523,13 +618,22 @@ ProSend(
 
             NdisQueryPacket(Packet,
                             NULL,
+                            &BufferCount,
                             NULL,
-                            &NdisBuffer,
                             &PacketLength);
 
+            if (BufferCount > 1) {
+                NdisStatus = proCoalescePacket(Packet, PacketLength);
+                if (NdisStatus != NDIS_STATUS_SUCCESS)
+                    return NdisStatus;
+            }
+
+            NdisBuffer = Packet->Private.Head;
+
             Context = ExAllocatePool(NonPagedPool, sizeof(DMA_CONTEXT));
             if (!Context) {
                 NDIS_DbgPrint(MIN_TRACE, ("Insufficient resources\n"));
+                ProRestorePacket(Packet);
                 return NDIS_STATUS_RESOURCES;
             }
 
@@ -554,6 +658,8 @@ ProSend(
 
             if (!NT_SUCCESS(NdisStatus)) {
                 NDIS_DbgPrint(MIN_TRACE, ("GetScatterGatherList failed! (%x)\n", NdisStatus));
+                ExFreePool(Context);
+                ProRestorePacket(Packet);
                 return NdisStatus;
             }
 
@@ -570,61 +676,74 @@ ProSendPackets(
     IN  NDIS_HANDLE     NdisBindingHandle,
     IN  PPNDIS_PACKET   PacketArray,
     IN  UINT            NumberOfPackets)
+/*
+ * FUNCTION: Forwards a request to send several packets to an NDIS miniport
+ * ARGUMENTS:
+ *     NdisBindingHandle = Adapter binding handle
+ *     PacketArray       = Array of pointers to NDIS packet descriptors
+ *     NumberOfPackets   = Number of packets in the array
+ * NOTES:
+ *     Every packet is completed through the protocol's send complete handler
+ */
 {
-    PADAPTER_BINDING AdapterBinding = NdisBindingHandle;
+    PADAPTER_BINDING AdapterBinding = GET_ADAPTER_BINDING(NdisBindingHandle);
     PLOGICAL_ADAPTER Adapter = AdapterBinding->Adapter;
-    KIRQL RaiseOldIrql;
+    BOOLEAN SendAll;
+    KIRQL OldIrql;
     NDIS_STATUS NdisStatus;
     UINT i;
 
-    if(Adapter->NdisMiniportBlock.DriverHandle->MiniportCharacteristics.SendPacketsHandler)
+    NDIS_DbgPrint(MAX_TRACE, ("Called.\n"));
+
+    ASSERT(KeGetCurrentIrql() <= DISPATCH_LEVEL);
+
+    /*
+     * Only a deserialized miniport can take the whole array at once, and
+     * only if none of the packets has to be looped back or mapped for DMA
+     * and nothing is queued ahead of them
+     */
+    SendAll = Adapter->NdisMiniportBlock.DriverHandle->MiniportCharacteristics.SendPacketsHandler &&
+              (Adapter->NdisMiniportBlock.Flags & NDIS_ATTRIBUTE_DESERIALIZE) &&
+              Adapter->NdisMiniportBlock.ScatterGatherListSize == 0 &&
+              !MiniIsBusy(Adapter, NdisWorkItemSend);
+
+    for (i = 0; i < NumberOfPackets; i++)
     {
-       if(Adapter->NdisMiniportBlock.Flags & NDIS_ATTRIBUTE_DESERIALIZE)
-       {
-          (*Adapter->NdisMiniportBlock.DriverHandle->MiniportCharacteristics.SendPacketsHandler)(
-           Adapter->NdisMiniportBlock.MiniportAdapterContext, PacketArray, NumberOfPackets);
-       }
-       else
-       {
-          /* SendPackets is called at DISPATCH_LEVEL for all serialized miniports */
-          KeRaiseIrql(DISPATCH_LEVEL, &RaiseOldIrql);
-          (*Adapter->NdisMiniportBlock.DriverHandle->MiniportCharacteristics.SendPacketsHandler)(
-           Adapter->NdisMiniportBlock.MiniportAdapterContext, PacketArray, NumberOfPackets);
-          KeLowerIrql(RaiseOldIrql);
-          for (i = 0; i < NumberOfPackets; i++)
-          {
-             NdisStatus = NDIS_GET_PACKET_STATUS(PacketArray[i]);
-             if (NdisStatus != NDIS_STATUS_PENDING)
-                 MiniSendComplete(Adapter, PacketArray[i], NdisStatus);
-          }
-       }
-     }
-     else
-     {
-       if(Adapter->NdisMiniportBlock.Flags & NDIS_ATTRIBUTE_DESERIALIZE)
-       {  
-          for (i = 0; i < NumberOfPackets; i++)
-          {
-             NdisStatus = (*Adapter->NdisMiniportBlock.DriverHandle->MiniportCharacteristics.SendHandler)(
-                           Adapter->NdisMiniportBlock.MiniportAdapterContext, PacketArray[i], PacketArray[i]->Private.Flags);
-             if (NdisStatus != NDIS_STATUS_PENDING)
-                 MiniSendComplete(Adapter, PacketArray[i], NdisStatus);
-          }
-       }
-       else
-       {
-         /* Send is called at DISPATCH_LEVEL for all serialized miniports */
-         KeRaiseIrql(DISPATCH_LEVEL, &RaiseOldIrql);
-         for (i = 0; i < NumberOfPackets; i++)
-         {
-            NdisStatus = (*Adapter->NdisMiniportBlock.DriverHandle->MiniportCharacteristics.SendHandler)(
-                           Adapter->NdisMiniportBlock.MiniportAdapterContext, PacketArray[i], PacketArray[i]->Private.Flags);
-            if (NdisStatus != NDIS_STATUS_PENDING)
-                MiniSendComplete(Adapter, PacketArray[i], NdisStatus);
-         }
-         KeLowerIrql(RaiseOldIrql);
-       }
-     }
+        /* MiniSendComplete finds the binding through this */
+        PacketArray[i]->Reserved[1] = (ULONG_PTR)NdisBindingHandle;
+
+        if (SendAll &&
+            (Adapter->NdisMiniportBlock.MacOptions & NDIS_MAC_OPTION_NO_LOOPBACK) &&
+            MiniAdapterHasAddress(Adapter, PacketArray[i]))
+        {
+            SendAll = FALSE;
+        }
+    }
+
+    if (SendAll)
+    {
+        NDIS_DbgPrint(MAX_TRACE, ("Calling miniport's SendPackets handler\n"));
+        (*Adapter->NdisMiniportBlock.DriverHandle->MiniportCharacteristics.SendPacketsHandler)(
+         Adapter->NdisMiniportBlock.MiniportAdapterContext, PacketArray, NumberOfPackets);
+        return;
+    }
+
+    /* Everything else takes the same path as a single send */
+    for (i = 0; i < NumberOfPackets; i++)
+    {
+        NdisStatus = ProSend(NdisBindingHandle, PacketArray[i]);
+        if (NdisStatus == NDIS_STATUS_PENDING)
+            continue;
+
+        /* Nothing was mapped for a packet that didn't pend, so this can't
+           go through MiniSendComplete */
+        KeRaiseIrql(DISPATCH_LEVEL, &OldIrql);
+        (*AdapterBinding->ProtocolBinding->Chars.SendCompleteHandler)(
+            AdapterBinding->NdisOpenBlock.ProtocolBindingContext,
+            PacketArray[i],
+            NdisStatus);
+        KeLowerIrql(OldIrql);
+    }
 }
 
 NDIS_STATUS NTAPI
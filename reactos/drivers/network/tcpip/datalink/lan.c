@@ -300,7 +300,18 @@ VOID NTAPI ProtocolSendComplete(
  *     Status         = Status of the operation
  */
 {
+    PNDIS_PACKET NdisPacket = PC(Packet)->Context;
+    PNDIS_BUFFER HeaderBuffer;
+
+    /* Give the borrowed buffers back to the IP packet before freeing the
+     * link header that was chained in front of them */
+    NdisUnchainBufferAtFront(Packet, &HeaderBuffer);
+    HeaderBuffer->Next = NULL;
+    NdisReinitializePacket(Packet);
+    NdisChainBufferAtFront(Packet, HeaderBuffer);
     FreeNdisPacket(Packet);
+
+    (*PC(NdisPacket)->DLComplete)(PC(NdisPacket)->Context, NdisPacket, Status);
 }
 
 VOID LanReceiveWorker( PVOID Context ) {
@@ -939,63 +950,50 @@ VOID NTAPI ProtocolBindAdapter(
 }
 
 
-VOID LANTransmit(
-    PVOID Context,
+static PNDIS_PACKET LANBuildFrame(
+    PLAN_ADAPTER Adapter,
     PNDIS_PACKET NdisPacket,
-    UINT Offset,
     PVOID LinkAddress,
     USHORT Type)
 /*
- * FUNCTION: Transmits a packet
+ * FUNCTION: Puts a link header in front of a packet from the IP layer
  * ARGUMENTS:
- *     Context     = Pointer to context information (LAN_ADAPTER)
+ *     Adapter     = Pointer to the LAN_ADAPTER to send on
  *     NdisPacket  = Pointer to NDIS packet to send
- *     Offset      = Offset in packet where data starts
  *     LinkAddress = Pointer to link address of destination (NULL = broadcast)
  *     Type        = LAN protocol type (LAN_PROTO_*)
+ * RETURNS:
+ *     Frame to pass to NDIS, or NULL if NdisPacket has been completed
+ *     with an error
+ * NOTES:
+ *     The frame chains the buffers of NdisPacket behind the header
+ *     instead of copying them. NdisPacket is completed together with
+ *     the frame in ProtocolSendComplete
  */
 {
     NDIS_STATUS NdisStatus;
     PETH_HEADER EHeader;
-    PCHAR Data, OldData;
-    UINT Size, OldSize;
-    PLAN_ADAPTER Adapter = (PLAN_ADAPTER)Context;
-    KIRQL OldIrql;
+    PNDIS_BUFFER Buffer;
+    PCHAR Data;
+    UINT Size, PacketLength;
     PNDIS_PACKET XmitPacket;
     PIP_INTERFACE Interface = Adapter->Context;
 
-    TI_DbgPrint(DEBUG_DATALINK,
-		("Called( NdisPacket %x, Offset %d, Adapter %x )\n",
-		 NdisPacket, Offset, Adapter));
-
     if (Adapter->State != LAN_STATE_STARTED) {
         (*PC(NdisPacket)->DLComplete)(PC(NdisPacket)->Context, NdisPacket, NDIS_STATUS_NOT_ACCEPTED);
-        return;
+        return NULL;
     }
 
-    TI_DbgPrint(DEBUG_DATALINK,
-		("Adapter Address [%02x %02x %02x %02x %02x %02x]\n",
-		 Adapter->HWAddress[0] & 0xff,
-		 Adapter->HWAddress[1] & 0xff,
-		 Adapter->HWAddress[2] & 0xff,
-		 Adapter->HWAddress[3] & 0xff,
-		 Adapter->HWAddress[4] & 0xff,
-		 Adapter->HWAddress[5] & 0xff));
-
-    GetDataPtr( NdisPacket, 0, &OldData, &OldSize );
+    NdisQueryPacket(NdisPacket, NULL, NULL, &Buffer, &PacketLength);
 
-    NdisStatus = AllocatePacketWithBuffer(&XmitPacket, NULL, OldSize + Adapter->HeaderSize);
+    NdisStatus = AllocatePacketWithBuffer(&XmitPacket, NULL, Adapter->HeaderSize);
     if (NdisStatus != NDIS_STATUS_SUCCESS) {
         (*PC(NdisPacket)->DLComplete)(PC(NdisPacket)->Context, NdisPacket, NDIS_STATUS_RESOURCES);
-        return;
+        return NULL;
     }
 
     GetDataPtr(XmitPacket, 0, &Data, &Size);
 
-    RtlCopyMemory(Data + Adapter->HeaderSize, OldData, OldSize);
-
-    (*PC(NdisPacket)->DLComplete)(PC(NdisPacket)->Context, NdisPacket, NDIS_STATUS_SUCCESS);
-
     switch (Adapter->Media) {
         case NdisMedium802_3:
             EHeader = (PETH_HEADER)Data;
@@ -1022,7 +1020,9 @@ VOID LANTransmit(
                     break;
                 default:
                     ASSERT(FALSE);
-                    return;
+                    FreeNdisPacket(XmitPacket);
+                    (*PC(NdisPacket)->DLComplete)(PC(NdisPacket)->Context, NdisPacket, NDIS_STATUS_NOT_ACCEPTED);
+                    return NULL;
             }
             break;
 
@@ -1044,29 +1044,123 @@ VOID LANTransmit(
 		   ((PCHAR)LinkAddress)[5] & 0xff));
 	}
 
+    /* Chain the payload behind our header. NDIS copies the frame into one
+     * buffer for miniports which use scatter/gather DMA */
+    NdisChainBufferAtBack(XmitPacket, Buffer);
+    PC(XmitPacket)->Context = NdisPacket;
+
+    Size += PacketLength;
+
     if (Adapter->MTU < Size) {
         /* This is NOT a pointer. MSDN explicitly says so. */
-        NDIS_PER_PACKET_INFO_FROM_PACKET(NdisPacket,
+        NDIS_PER_PACKET_INFO_FROM_PACKET(XmitPacket,
                                          TcpLargeSendPacketInfo) = (PVOID)((ULONG_PTR)Adapter->MTU);
     }
 
     /* Update interface stats */
     Interface->Stats.OutBytes += Size;
 
-	TcpipAcquireSpinLock( &Adapter->Lock, &OldIrql );
-	TI_DbgPrint(MID_TRACE, ("NdisSend\n"));
-	NdisSend(&NdisStatus, Adapter->NdisHandle, XmitPacket);
-	TI_DbgPrint(MID_TRACE, ("NdisSend %s\n",
-				NdisStatus == NDIS_STATUS_PENDING ?
-				"Pending" : "Complete"));
-	TcpipReleaseSpinLock( &Adapter->Lock, OldIrql );
-
-	/* I had a talk with vizzini: these really ought to be here.
-	 * we're supposed to see these completed by ndis *only* when
-	 * status_pending is returned.  Note that this is different from
-	 * the situation with IRPs. */
-        if (NdisStatus != NDIS_STATUS_PENDING)
-            ProtocolSendComplete((NDIS_HANDLE)Context, XmitPacket, NdisStatus);
+    return XmitPacket;
+}
+
+VOID LANTransmit(
+    PVOID Context,
+    PNDIS_PACKET NdisPacket,
+    UINT Offset,
+    PVOID LinkAddress,
+    USHORT Type)
+/*
+ * FUNCTION: Transmits a packet
+ * ARGUMENTS:
+ *     Context     = Pointer to context information (LAN_ADAPTER)
+ *     NdisPacket  = Pointer to NDIS packet to send
+ *     Offset      = Offset in packet where data starts
+ *     LinkAddress = Pointer to link address of destination (NULL = broadcast)
+ *     Type        = LAN protocol type (LAN_PROTO_*)
+ */
+{
+    NDIS_STATUS NdisStatus;
+    PLAN_ADAPTER Adapter = (PLAN_ADAPTER)Context;
+    KIRQL OldIrql;
+    PNDIS_PACKET XmitPacket;
+
+    TI_DbgPrint(DEBUG_DATALINK,
+		("Called( NdisPacket %x, Offset %d, Adapter %x )\n",
+		 NdisPacket, Offset, Adapter));
+
+    TI_DbgPrint(DEBUG_DATALINK,
+		("Adapter Address [%02x %02x %02x %02x %02x %02x]\n",
+		 Adapter->HWAddress[0] & 0xff,
+		 Adapter->HWAddress[1] & 0xff,
+		 Adapter->HWAddress[2] & 0xff,
+		 Adapter->HWAddress[3] & 0xff,
+		 Adapter->HWAddress[4] & 0xff,
+		 Adapter->HWAddress[5] & 0xff));
+
+    XmitPacket = LANBuildFrame(Adapter, NdisPacket, LinkAddress, Type);
+    if (!XmitPacket)
+        return;
+
+    TcpipAcquireSpinLock( &Adapter->Lock, &OldIrql );
+    TI_DbgPrint(MID_TRACE, ("NdisSend\n"));
+    NdisSend(&NdisStatus, Adapter->NdisHandle, XmitPacket);
+    TI_DbgPrint(MID_TRACE, ("NdisSend %s\n",
+                            NdisStatus == NDIS_STATUS_PENDING ?
+                            "Pending" : "Complete"));
+    TcpipReleaseSpinLock( &Adapter->Lock, OldIrql );
+
+    /* I had a talk with vizzini: these really ought to be here.
+     * we're supposed to see these completed by ndis *only* when
+     * status_pending is returned.  Note that this is different from
+     * the situation with IRPs. */
+    if (NdisStatus != NDIS_STATUS_PENDING)
+        ProtocolSendComplete((NDIS_HANDLE)Context, XmitPacket, NdisStatus);
+}
+
+VOID LANTransmitPackets(
+    PVOID Context,
+    PNDIS_PACKET *NdisPackets,
+    UINT PacketCount,
+    PVOID LinkAddress,
+    USHORT Type)
+/*
+ * FUNCTION: Transmits several packets to the same destination
+ * ARGUMENTS:
+ *     Context     = Pointer to context information (LAN_ADAPTER)
+ *     NdisPackets = Array of NDIS packets to send
+ *     PacketCount = Number of packets in the array
+ *     LinkAddress = Pointer to link address of destination (NULL = broadcast)
+ *     Type        = LAN protocol type (LAN_PROTO_*)
+ * NOTES:
+ *     Frames go down in NdisSendPackets calls of up to MaxSendPackets
+ *     each. NDIS completes every one of them through ProtocolSendComplete
+ */
+{
+    PLAN_ADAPTER Adapter = (PLAN_ADAPTER)Context;
+    PNDIS_PACKET XmitPackets[NB_SEND_BATCH];
+    UINT XmitCount = 0, MaxCount, i;
+
+    TI_DbgPrint(DEBUG_DATALINK,
+		("Called( PacketCount %d, Adapter %x )\n",
+		 PacketCount, Adapter));
+
+    MaxCount = min(max(Adapter->MaxSendPackets, 1), NB_SEND_BATCH);
+
+    for (i = 0; i < PacketCount; i++) {
+        XmitPackets[XmitCount] = LANBuildFrame(Adapter, NdisPackets[i], LinkAddress, Type);
+        if (XmitPackets[XmitCount])
+            XmitCount++;
+
+        if (XmitCount == MaxCount || (i == PacketCount - 1 && XmitCount)) {
+            /* Unlike NdisSend, NDIS may call ProtocolSendComplete before
+             * NdisSendPackets returns, and completing a packet can start
+             * the next transmit. So the adapter lock is not held here */
+            TI_DbgPrint(MID_TRACE, ("NdisSendPackets (%d)\n", XmitCount));
+            NdisSendPackets(Adapter->NdisHandle, XmitPackets, XmitCount);
+
+            XmitCount = 0;
+        }
+    }
 }
 
 static NTSTATUS
@@ -1337,6 +1431,7 @@ BOOLEAN BindAdapter(
     BindInfo.Address       = (PUCHAR)&Adapter->HWAddress;
     BindInfo.AddressLength = Adapter->HWAddressLength;
     BindInfo.Transmit      = LANTransmit;
+    BindInfo.TransmitPackets = LANTransmitPackets;
 
     IF = IPCreateInterface(&BindInfo);
 
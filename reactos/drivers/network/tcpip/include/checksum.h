@@ -15,6 +15,12 @@ ULONG ChecksumCompute(
     UINT Count,
     ULONG Seed);
 
+ULONG ChecksumCopy(
+    PVOID Destination,
+    CONST VOID *Source,
+    UINT Count,
+    ULONG Seed);
+
 unsigned int
 csum_partial(
   const unsigned char * buff,
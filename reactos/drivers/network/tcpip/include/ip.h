@@ -122,6 +122,14 @@ typedef VOID (*LL_TRANSMIT_ROUTINE)(
     PVOID LinkAddress,
     USHORT Type);
 
+/* Link layer transmit prototype for several packets to the same destination */
+typedef VOID (*LL_TRANSMIT_PACKETS_ROUTINE)(
+    PVOID Context,
+    PNDIS_PACKET *NdisPackets,
+    UINT PacketCount,
+    PVOID LinkAddress,
+    USHORT Type);
+
 /* Link layer to IP binding information */
 typedef struct _LLIP_BIND_INFO {
     PVOID Context;                /* Pointer to link layer context information */
@@ -130,6 +138,7 @@ typedef struct _LLIP_BIND_INFO {
     PUCHAR Address;               /* Pointer to interface address */
     UINT  AddressLength;          /* Length of address in bytes */
     LL_TRANSMIT_ROUTINE Transmit; /* Transmit function for this interface */
+    LL_TRANSMIT_PACKETS_ROUTINE TransmitPackets; /* Batch transmit function (optional) */
 } LLIP_BIND_INFO, *PLLIP_BIND_INFO;
 
 typedef struct _SEND_RECV_STATS {
@@ -166,6 +175,7 @@ typedef struct _IP_INTERFACE {
     UINT  AddressLength;          /* Length of address in bytes */
     UINT  Index;                  /* Index of adapter (used to add ip addr) */
     LL_TRANSMIT_ROUTINE Transmit; /* Pointer to transmit function */
+    LL_TRANSMIT_PACKETS_ROUTINE TransmitPackets; /* Pointer to batch transmit function (optional) */
     PVOID TCPContext;             /* TCP Content for this interface */
     SEND_RECV_STATS Stats;        /* Send/Receive statistics */
 } IP_INTERFACE, *PIP_INTERFACE;
@@ -9,6 +9,8 @@
 
 #define NB_HASHMASK 0xF /* Hash mask for neighbor cache */
 
+#define NB_SEND_BATCH 16 /* Queued packets handed to the link layer at once */
+
 typedef VOID (*PNEIGHBOR_PACKET_COMPLETE)
     ( PVOID Context, PNDIS_PACKET Packet, NDIS_STATUS Status );
 
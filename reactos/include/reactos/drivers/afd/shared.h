@@ -59,6 +59,30 @@ typedef struct _AFD_POLL_INFO {
     AFD_HANDLE			        Handles[1];
 } AFD_POLL_INFO, *PAFD_POLL_INFO;
 
+/* Persistent interest sets (ReactOS extension) */
+#define AFD_POLL_SET_ADD                0
+#define AFD_POLL_SET_MODIFY             1
+#define AFD_POLL_SET_REMOVE             2
+
+typedef struct _AFD_POLL_SET_CONTROL_INFO {
+    ULONG				Operation;
+    SOCKET				Handle;
+    ULONG				Events;
+    PVOID				Context;
+} AFD_POLL_SET_CONTROL_INFO, *PAFD_POLL_SET_CONTROL_INFO;
+
+typedef struct _AFD_POLL_SET_EVENT {
+    PVOID				Context;
+    SOCKET				Handle;
+    ULONG				Events;
+} AFD_POLL_SET_EVENT, *PAFD_POLL_SET_EVENT;
+
+typedef struct _AFD_POLL_SET_WAIT_INFO {
+    LARGE_INTEGER		        Timeout;
+    ULONG				EventCount;
+    AFD_POLL_SET_EVENT		        Events[1];
+} AFD_POLL_SET_WAIT_INFO, *PAFD_POLL_SET_WAIT_INFO;
+
 typedef struct _AFD_ACCEPT_DATA {
     ULONG				UseSAN;
     ULONG				SequenceNumber;
@@ -261,6 +285,8 @@ typedef struct _AFD_TDI_HANDLE_DATA
 #define AFD_DEFER_ACCEPT		35
 #define AFD_GET_PENDING_CONNECT_DATA	41
 #define AFD_VALIDATE_GROUP		42
+#define AFD_POLL_SET_CONTROL		60
+#define AFD_POLL_SET_WAIT		61
 
 /* AFD IOCTLs */
 
@@ -336,6 +362,10 @@ typedef struct _AFD_TDI_HANDLE_DATA
   _AFD_CONTROL_CODE(AFD_ENUM_NETWORK_EVENTS, METHOD_NEITHER)
 #define IOCTL_AFD_VALIDATE_GROUP \
   _AFD_CONTROL_CODE(AFD_VALIDATE_GROUP, METHOD_NEITHER)
+#define IOCTL_AFD_POLL_SET_CONTROL \
+  _AFD_CONTROL_CODE(AFD_POLL_SET_CONTROL, METHOD_BUFFERED )
+#define IOCTL_AFD_POLL_SET_WAIT \
+  _AFD_CONTROL_CODE(AFD_POLL_SET_WAIT, METHOD_BUFFERED )
 
 typedef struct _AFD_SOCKET_INFORMATION {
     BOOL CommandChannel;
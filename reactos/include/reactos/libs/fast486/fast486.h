@@ -36,6 +36,11 @@
 #define FAST486_NUM_DBG_REGS    6
 #define FAST486_NUM_FPU_REGS    8
 
+#define FAST486_CODE_CACHE_PAGES    16
+#define FAST486_CODE_PAGE_SIZE      4096
+#define FAST486_CODE_PAGE_EMPTY     0xFFFFFFFF
+#define FAST486_TLB_SIZE            512
+
 #define FAST486_CR0_PE  (1 << 0)
 #define FAST486_CR0_MP  (1 << 1)
 #define FAST486_CR0_EM  (1 << 2)
@@ -185,6 +190,15 @@ VOID
     ULONG Size
 );
 
+typedef
+PVOID
+(NTAPI *FAST486_MEM_MAP_PROC)
+(
+    PFAST486_STATE State,
+    ULONG Address,
+    BOOLEAN Write
+);
+
 typedef
 VOID
 (NTAPI *FAST486_IO_READ_PROC)
@@ -468,10 +482,26 @@ typedef union _FAST486_FPU_CONTROL_REG
     };
 } FAST486_FPU_CONTROL_REG, *PFAST486_FPU_CONTROL_REG;
 
+typedef struct _FAST486_CODE_PAGE
+{
+    ULONG Address;
+    UCHAR Data[FAST486_CODE_PAGE_SIZE];
+} FAST486_CODE_PAGE, *PFAST486_CODE_PAGE;
+
+typedef struct _FAST486_TLB_ENTRY
+{
+    ULONG ReadTag;
+    ULONG WriteTag;
+    ULONG Address;
+    PUCHAR ReadPointer;
+    PUCHAR WritePointer;
+} FAST486_TLB_ENTRY, *PFAST486_TLB_ENTRY;
+
 struct _FAST486_STATE
 {
     FAST486_MEM_READ_PROC MemReadCallback;
     FAST486_MEM_WRITE_PROC MemWriteCallback;
+    FAST486_MEM_MAP_PROC MemMapCallback;
     FAST486_IO_READ_PROC IoReadCallback;
     FAST486_IO_WRITE_PROC IoWriteCallback;
     FAST486_IDLE_PROC IdleCallback;
@@ -492,7 +522,10 @@ struct _FAST486_STATE
     FAST486_SEG_REGS SegmentOverride;
     FAST486_INT_STATUS IntStatus;
     UCHAR PendingIntNum;
-    PULONG Tlb;
+    PFAST486_TLB_ENTRY Tlb;
+    PFAST486_CODE_PAGE CodeCache;
+    PFAST486_CODE_PAGE CodePage;
+    ULONG CodePageTag;
 #ifndef FAST486_NO_FPU
     FAST486_FPU_DATA_REG FpuRegisters[FAST486_NUM_FPU_REGS];
     FAST486_FPU_STATUS_REG FpuStatus;
@@ -508,17 +541,27 @@ NTAPI
 Fast486Initialize(PFAST486_STATE         State,
                   FAST486_MEM_READ_PROC  MemReadCallback,
                   FAST486_MEM_WRITE_PROC MemWriteCallback,
+                  FAST486_MEM_MAP_PROC   MemMapCallback,
                   FAST486_IO_READ_PROC   IoReadCallback,
                   FAST486_IO_WRITE_PROC  IoWriteCallback,
                   FAST486_IDLE_PROC      IdleCallback,
                   FAST486_BOP_PROC       BopCallback,
                   FAST486_INT_ACK_PROC   IntAckCallback,
-                  PULONG                 Tlb);
+                  PFAST486_TLB_ENTRY     Tlb,
+                  PFAST486_CODE_PAGE     CodeCache);
 
 VOID
 NTAPI
 Fast486Reset(PFAST486_STATE State);
 
+VOID
+NTAPI
+Fast486InvalidateCache(PFAST486_STATE State, ULONG Address, ULONG Size);
+
+VOID
+NTAPI
+Fast486FlushTlb(PFAST486_STATE State);
+
 VOID
 NTAPI
 Fast486Continue(PFAST486_STATE State);
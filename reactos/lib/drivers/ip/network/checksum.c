@@ -11,6 +11,10 @@
 
 #include "precomp.h"
 
+#if defined(_M_AMD64)
+#include <emmintrin.h>
+#endif
+
 
 ULONG ChecksumFold(
   ULONG Sum)
@@ -24,6 +28,66 @@ ULONG ChecksumFold(
   return Sum;
 }
 
+#if defined(_M_AMD64)
+/*
+ * SSE2 is architectural on x64 and the kernel may use the XMM registers
+ * freely, so sum 16 bytes per step: split each block into two pairs of
+ * 32-bit words and add them into 64-bit lanes. A lane can't overflow for
+ * any buffer we will ever see, so the carries only need folding once.
+ */
+static ULONG ChecksumComputeSse2(
+  PUCHAR Data,
+  UINT Count,
+  ULONGLONG Sum)
+{
+  __m128i Zero = _mm_setzero_si128();
+  __m128i Acc0 = _mm_setzero_si128();
+  __m128i Acc1 = _mm_setzero_si128();
+  __m128i Block;
+  ULONGLONG Lanes[2];
+
+  while (Count >= 32)
+    {
+      Block = _mm_loadu_si128((__m128i *)Data);
+      Acc0 = _mm_add_epi64(Acc0, _mm_unpacklo_epi32(Block, Zero));
+      Acc1 = _mm_add_epi64(Acc1, _mm_unpackhi_epi32(Block, Zero));
+      Block = _mm_loadu_si128((__m128i *)(Data + 16));
+      Acc0 = _mm_add_epi64(Acc0, _mm_unpacklo_epi32(Block, Zero));
+      Acc1 = _mm_add_epi64(Acc1, _mm_unpackhi_epi32(Block, Zero));
+      Data += 32;
+      Count -= 32;
+    }
+
+  _mm_storeu_si128((__m128i *)Lanes, _mm_add_epi64(Acc0, Acc1));
+  Sum += Lanes[0];
+  Sum += Lanes[1];
+
+  while (Count >= 4)
+    {
+      Sum += *(PULONG)Data;
+      Data += 4;
+      Count -= 4;
+    }
+
+  if (Count >= 2)
+    {
+      Sum += *(PUSHORT)Data;
+      Data += 2;
+      Count -= 2;
+    }
+
+  /* Add left-over byte, if any */
+  if (Count > 0)
+    Sum += *Data;
+
+  /* Fold 64-bit sum to 32 bits */
+  Sum = (Sum & 0xFFFFFFFF) + (Sum >> 32);
+  Sum = (Sum & 0xFFFFFFFF) + (Sum >> 32);
+
+  return (ULONG)Sum;
+}
+#endif
+
 ULONG ChecksumCompute(
   PVOID Data,
   UINT Count,
@@ -35,25 +99,129 @@ ULONG ChecksumCompute(
  *     Count = Number of bytes in buffer
  *     Seed  = Previously calculated checksum (if any)
  * RETURNS:
- *     Checksum of buffer
+ *     Checksum of buffer, not folded
+ * NOTES:
+ *     The one's complement sum doesn't care how the words are grouped,
+ *     so adding 32-bit words and folding the carries back in gives the
+ *     same result as the RFC 1071 16-bit loop
  */
 {
-  register ULONG Sum = Seed;
+#if defined(_M_IX86)
+  return csum_partial(Data, Count, Seed);
+#elif defined(_M_AMD64)
+  return ChecksumComputeSse2(Data, Count, Seed);
+#else
+  ULONGLONG Sum = Seed;
+  PUCHAR Buffer = Data;
+
+  while (Count >= 16)
+    {
+      Sum += ((PULONG)Buffer)[0];
+      Sum += ((PULONG)Buffer)[1];
+      Sum += ((PULONG)Buffer)[2];
+      Sum += ((PULONG)Buffer)[3];
+      Buffer += 16;
+      Count -= 16;
+    }
 
-  while (Count > 1)
+  while (Count >= 4)
     {
-      Sum += *(PUSHORT)Data;
+      Sum += *(PULONG)Buffer;
+      Buffer += 4;
+      Count -= 4;
+    }
+
+  if (Count >= 2)
+    {
+      Sum += *(PUSHORT)Buffer;
+      Buffer += 2;
       Count -= 2;
-      Data = (PVOID)((ULONG_PTR) Data + 2);
     }
 
   /* Add left-over byte, if any */
   if (Count > 0)
+    Sum += *Buffer;
+
+  /* Fold 64-bit sum to 32 bits */
+  Sum = (Sum & 0xFFFFFFFF) + (Sum >> 32);
+  Sum = (Sum & 0xFFFFFFFF) + (Sum >> 32);
+
+  return (ULONG)Sum;
+#endif
+}
+
+ULONG ChecksumCopy(
+  PVOID Destination,
+  CONST VOID *Source,
+  UINT Count,
+  ULONG Seed)
+/*
+ * FUNCTION: Copy a buffer and calculate its checksum in the same pass
+ * ARGUMENTS:
+ *     Destination = Pointer to destination buffer
+ *     Source      = Pointer to buffer with data
+ *     Count       = Number of bytes to copy
+ *     Seed        = Previously calculated checksum (if any)
+ * RETURNS:
+ *     Checksum of buffer, not folded
+ */
+{
+  ULONGLONG Sum = Seed;
+  PUCHAR Dst = Destination;
+  CONST UCHAR *Src = Source;
+  ULONG Word0, Word1, Word2, Word3;
+
+  while (Count >= 16)
     {
-      Sum += *(PUCHAR)Data;
+      Word0 = ((PULONG)Src)[0];
+      Word1 = ((PULONG)Src)[1];
+      Word2 = ((PULONG)Src)[2];
+      Word3 = ((PULONG)Src)[3];
+      ((PULONG)Dst)[0] = Word0;
+      ((PULONG)Dst)[1] = Word1;
+      ((PULONG)Dst)[2] = Word2;
+      ((PULONG)Dst)[3] = Word3;
+      Sum += Word0;
+      Sum += Word1;
+      Sum += Word2;
+      Sum += Word3;
+      Src += 16;
+      Dst += 16;
+      Count -= 16;
     }
 
-  return Sum;
+  while (Count >= 4)
+    {
+      Word0 = *(PULONG)Src;
+      *(PULONG)Dst = Word0;
+      Sum += Word0;
+      Src += 4;
+      Dst += 4;
+      Count -= 4;
+    }
+
+  if (Count >= 2)
+    {
+      Word0 = *(PUSHORT)Src;
+      *(PUSHORT)Dst = (USHORT)Word0;
+      Sum += Word0;
+      Src += 2;
+      Dst += 2;
+      Count -= 2;
+    }
+
+  /* Add left-over byte, if any */
+  if (Count > 0)
+    {
+      *Dst = *Src;
+      Sum += *Src;
+    }
+
+  /* Fold 64-bit sum to 32 bits */
+  Sum = (Sum & 0xFFFFFFFF) + (Sum >> 32);
+  Sum = (Sum & 0xFFFFFFFF) + (Sum >> 32);
+
+  return (ULONG)Sum;
 }
 
 ULONG
@@ -62,44 +230,19 @@ UDPv4ChecksumCalculate(
   PUCHAR PacketBuffer,
   ULONG DataLength)
 {
-  ULONG Sum = 0;
-  USHORT TmpSum;
-  ULONG i;
-  BOOLEAN Pad;
-
-  /* Pad the data if needed */
-  Pad = (DataLength & 1);
-  if (Pad)
-      DataLength++;
-
-  /* Add from the UDP header and data */
-  for (i = 0; i < DataLength; i += 2)
-  {
-       TmpSum = ((PacketBuffer[i] << 8) & 0xFF00) +
-                ((Pad && i == DataLength - 2) ? 0 : (PacketBuffer[i+1] & 0x00FF));
-       Sum += TmpSum;
-  }
-
-  /* Add the source address */
-  for (i = 0; i < sizeof(IPv4_RAW_ADDRESS); i += 2)
-  {
-       TmpSum = ((((PUCHAR)&IPHeader->SrcAddr)[i] << 8) & 0xFF00) +
-                (((PUCHAR)&IPHeader->SrcAddr)[i+1] & 0x00FF);
-       Sum += TmpSum;
-  }
-
-  /* Add the destination address */
-  for (i = 0; i < sizeof(IPv4_RAW_ADDRESS); i += 2)
-  {
-       TmpSum = ((((PUCHAR)&IPHeader->DstAddr)[i] << 8) & 0xFF00) +
-                (((PUCHAR)&IPHeader->DstAddr)[i+1] & 0x00FF);
-       Sum += TmpSum;
-  }
+  ULONG Sum;
+
+  /* Sum the UDP header and data, an odd trailing byte is padded with zero */
+  Sum = ChecksumCompute(PacketBuffer, DataLength, 0);
+
+  /* Add the source and destination addresses */
+  Sum = ChecksumCompute(&IPHeader->SrcAddr, sizeof(IPv4_RAW_ADDRESS), Sum);
+  Sum = ChecksumCompute(&IPHeader->DstAddr, sizeof(IPv4_RAW_ADDRESS), Sum);
 
   /* Add the proto number and length */
-  Sum += IPPROTO_UDP + (DataLength - (Pad ? 1 : 0));
+  Sum = ChecksumFold(Sum) + WH2N(IPPROTO_UDP) + WH2N((USHORT)DataLength);
 
-  /* Fold the checksum and return the one's complement */
-  return ~ChecksumFold(Sum);
+  /* The sum is in network order, fold it and return the one's complement
+   * in host order */
+  return ~(ULONG)WN2H((USHORT)ChecksumFold(Sum));
 }
-
@@ -218,6 +218,7 @@ PIP_INTERFACE IPCreateInterface(
     IF->Address       = BindInfo->Address;
     IF->AddressLength = BindInfo->AddressLength;
     IF->Transmit      = BindInfo->Transmit;
+    IF->TransmitPackets = BindInfo->TransmitPackets;
 
 	IF->Unicast.Type = IP_ADDRESS_V4;
 	IF->PointToPoint.Type = IP_ADDRESS_V4;
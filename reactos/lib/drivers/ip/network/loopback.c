@@ -109,6 +109,7 @@ NDIS_STATUS LoopRegisterAdapter(
   BindInfo.Address = NULL;
   BindInfo.AddressLength = 0;
   BindInfo.Transmit = LoopTransmit;
+  BindInfo.TransmitPackets = NULL;
 
   Loopback = IPCreateInterface(&BindInfo);
   if (!Loopback) return NDIS_STATUS_RESOURCES;
@@ -28,6 +28,9 @@ VOID NBCompleteSend( PVOID Context,
 VOID NBSendPackets( PNEIGHBOR_CACHE_ENTRY NCE ) {
     PLIST_ENTRY PacketEntry;
     PNEIGHBOR_PACKET Packet;
+    PNDIS_PACKET NdisPackets[NB_SEND_BATCH];
+    UINT PacketCount, i;
+    KIRQL OldIrql;
     UINT HashValue;
 
     ASSERT(!(NCE->State & NUD_INCOMPLETE));
@@ -38,27 +41,52 @@ VOID NBSendPackets( PNEIGHBOR_CACHE_ENTRY NCE ) {
     HashValue ^= HashValue >> 4;
     HashValue &= NB_HASHMASK;
 
-    /* Send any waiting packets */
-    while ((PacketEntry = ExInterlockedRemoveHeadList(&NCE->PacketQueue,
-                                              &NeighborCache[HashValue].Lock)) != NULL)
+    /* Send any waiting packets, a batch at a time so the link layer
+     * can give them to the miniport in a single call */
+    do
     {
-	Packet = CONTAINING_RECORD( PacketEntry, NEIGHBOR_PACKET, Next );
+        PacketCount = 0;
 
-	TI_DbgPrint
-	    (MID_TRACE,
-	     ("PacketEntry: %x, NdisPacket %x\n",
-	      PacketEntry, Packet->Packet));
+        TcpipAcquireSpinLock(&NeighborCache[HashValue].Lock, &OldIrql);
+        while (PacketCount < NB_SEND_BATCH && !IsListEmpty(&NCE->PacketQueue))
+        {
+            PacketEntry = RemoveHeadList(&NCE->PacketQueue);
+            Packet = CONTAINING_RECORD( PacketEntry, NEIGHBOR_PACKET, Next );
 
-	PC(Packet->Packet)->DLComplete = NBCompleteSend;
-	PC(Packet->Packet)->Context  = Packet;
+            TI_DbgPrint
+                (MID_TRACE,
+                 ("PacketEntry: %x, NdisPacket %x\n",
+                  PacketEntry, Packet->Packet));
 
-	NCE->Interface->Transmit
-	    ( NCE->Interface->Context,
-	      Packet->Packet,
-	      0,
-	      NCE->LinkAddress,
-	      LAN_PROTO_IPv4 );
-    }
+            PC(Packet->Packet)->DLComplete = NBCompleteSend;
+            PC(Packet->Packet)->Context  = Packet;
+
+            NdisPackets[PacketCount++] = Packet->Packet;
+        }
+        TcpipReleaseSpinLock(&NeighborCache[HashValue].Lock, OldIrql);
+
+        if (PacketCount > 1 && NCE->Interface->TransmitPackets)
+        {
+            NCE->Interface->TransmitPackets
+                ( NCE->Interface->Context,
+                  NdisPackets,
+                  PacketCount,
+                  NCE->LinkAddress,
+                  LAN_PROTO_IPv4 );
+        }
+        else
+        {
+            for (i = 0; i < PacketCount; i++)
+            {
+                NCE->Interface->Transmit
+                    ( NCE->Interface->Context,
+                      NdisPackets[i],
+                      0,
+                      NCE->LinkAddress,
+                      LAN_PROTO_IPv4 );
+            }
+        }
+    } while (PacketCount == NB_SEND_BATCH);
 }
 
 /* Must be called with table lock acquired */
@@ -43,8 +43,16 @@ typedef ULONG_PTR mem_ptr_t;
 /* Endianness */
 #define BYTE_ORDER LITTLE_ENDIAN
 
-/* Checksum calculation algorithm choice */
-#define LWIP_CHKSUM_ALGORITHM 3
+/* Checksum calculation: use the IP library's word-at-a-time routines so
+ * lwIP and the rest of the stack share one implementation */
+ULONG ChecksumFold(ULONG Sum);
+ULONG ChecksumCompute(PVOID Data, UINT Count, ULONG Seed);
+ULONG ChecksumCopy(PVOID Destination, CONST VOID *Source, UINT Count, ULONG Seed);
+
+#define LWIP_CHKSUM(dataptr, len) \
+    ((u16_t)ChecksumFold(ChecksumCompute((dataptr), (len), 0)))
+#define LWIP_CHKSUM_COPY(dst, src, len) \
+    ((u16_t)ChecksumFold(ChecksumCopy((dst), (src), (len), 0)))
 
 /* Diagnostics */
 #define LWIP_PLATFORM_DIAG(x) (DbgPrint x)
@@ -1060,13 +1060,34 @@
 #define LWIP_TCP_TIMESTAMPS             0
 #endif
 
+/**
+ * LWIP_WND_SCALE==1: support the TCP window scale option (RFC 1323).
+ * When enabled, TCP_WND and TCP_SND_BUF may exceed 0xffff and
+ * TCP_RCV_SCALE must be set to the shift count announced to the peer.
+ */
+#ifndef LWIP_WND_SCALE
+#define LWIP_WND_SCALE                  0
+#endif
+
+/**
+ * TCP_RCV_SCALE: the shift count announced in the window scale option
+ * of our SYN segments. (TCP_WND >> TCP_RCV_SCALE) must fit in an u16_t.
+ */
+#ifndef TCP_RCV_SCALE
+#define TCP_RCV_SCALE                   0
+#endif
+
 /**
  * TCP_WND_UPDATE_THRESHOLD: difference in window to trigger an
  * explicit window update
  */
 #ifndef TCP_WND_UPDATE_THRESHOLD
+#if LWIP_WND_SCALE
+#define TCP_WND_UPDATE_THRESHOLD   LWIP_MIN((TCP_WND / 4), (TCP_MSS * 4))
+#else
 #define TCP_WND_UPDATE_THRESHOLD   (TCP_WND / 4)
 #endif
+#endif
 
 /**
  * LWIP_EVENT_API and LWIP_CALLBACK_API: Only one of these should be set to 1.
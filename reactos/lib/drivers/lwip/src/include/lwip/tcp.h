@@ -48,6 +48,16 @@ extern "C" {
 
 struct tcp_pcb;
 
+/** Type used for TCP window and send buffer sizes: with window scaling
+ * (RFC 1323) enabled, these no longer fit in 16 bits. */
+#if LWIP_WND_SCALE
+typedef u32_t tcpwnd_size_t;
+#define TCPWNDSIZE_F U32_F
+#else
+typedef u16_t tcpwnd_size_t;
+#define TCPWNDSIZE_F U16_F
+#endif
+
 /** Function prototype for tcp accept callback functions. Called when a new
  * connection can be accepted on a listening pcb.
  *
@@ -174,15 +184,16 @@ struct tcp_pcb {
   /* ports are in host byte order */
   u16_t remote_port;
   
-  u8_t flags;
-#define TF_ACK_DELAY   ((u8_t)0x01U)   /* Delayed ACK. */
-#define TF_ACK_NOW     ((u8_t)0x02U)   /* Immediate ACK. */
-#define TF_INFR        ((u8_t)0x04U)   /* In fast recovery. */
-#define TF_TIMESTAMP   ((u8_t)0x08U)   /* Timestamp option enabled */
-#define TF_RXCLOSED    ((u8_t)0x10U)   /* rx closed by tcp_shutdown */
-#define TF_FIN         ((u8_t)0x20U)   /* Connection was closed locally (FIN segment enqueued). */
-#define TF_NODELAY     ((u8_t)0x40U)   /* Disable Nagle algorithm */
-#define TF_NAGLEMEMERR ((u8_t)0x80U)   /* nagle enabled, memerr, try to output to prevent delayed ACK to happen */
+  u16_t flags;
+#define TF_ACK_DELAY   ((u16_t)0x0001U)   /* Delayed ACK. */
+#define TF_ACK_NOW     ((u16_t)0x0002U)   /* Immediate ACK. */
+#define TF_INFR        ((u16_t)0x0004U)   /* In fast recovery. */
+#define TF_TIMESTAMP   ((u16_t)0x0008U)   /* Timestamp option enabled */
+#define TF_RXCLOSED    ((u16_t)0x0010U)   /* rx closed by tcp_shutdown */
+#define TF_FIN         ((u16_t)0x0020U)   /* Connection was closed locally (FIN segment enqueued). */
+#define TF_NODELAY     ((u16_t)0x0040U)   /* Disable Nagle algorithm */
+#define TF_NAGLEMEMERR ((u16_t)0x0080U)   /* nagle enabled, memerr, try to output to prevent delayed ACK to happen */
+#define TF_WND_SCALE   ((u16_t)0x0100U)   /* Window scale option enabled */
 
   /* the rest of the fields are in host byte order
      as we have to do some math with them */
@@ -194,8 +205,8 @@ struct tcp_pcb {
 
   /* receiver variables */
   u32_t rcv_nxt;   /* next seqno expected */
-  u16_t rcv_wnd;   /* receiver window available */
-  u16_t rcv_ann_wnd; /* receiver window to announce */
+  tcpwnd_size_t rcv_wnd;   /* receiver window available */
+  tcpwnd_size_t rcv_ann_wnd; /* receiver window to announce */
   u32_t rcv_ann_right_edge; /* announced right edge of window */
 
   /* Retransmission timer. */
@@ -216,20 +227,20 @@ struct tcp_pcb {
   u32_t lastack; /* Highest acknowledged seqno. */
 
   /* congestion avoidance/control variables */
-  u16_t cwnd;
-  u16_t ssthresh;
+  tcpwnd_size_t cwnd;
+  tcpwnd_size_t ssthresh;
 
   /* sender variables */
   u32_t snd_nxt;   /* next new seqno to be sent */
   u32_t snd_wl1, snd_wl2; /* Sequence and acknowledgement numbers of last
                              window update. */
   u32_t snd_lbb;       /* Sequence number of next byte to be buffered. */
-  u16_t snd_wnd;   /* sender window */
-  u16_t snd_wnd_max; /* the maximum sender window announced by the remote host */
+  tcpwnd_size_t snd_wnd;   /* sender window */
+  tcpwnd_size_t snd_wnd_max; /* the maximum sender window announced by the remote host */
 
-  u16_t acked;
+  tcpwnd_size_t acked;
 
-  u16_t snd_buf;   /* Available buffer space for sending (in bytes). */
+  tcpwnd_size_t snd_buf;   /* Available buffer space for sending (in bytes). */
 #define TCP_SNDQUEUELEN_OVERFLOW (0xffffU-3)
   u16_t snd_queuelen; /* Available buffer space for sending (in tcp_segs). */
 
@@ -279,6 +290,11 @@ struct tcp_pcb {
 
   /* KEEPALIVE counter */
   u8_t keep_cnt_sent;
+
+#if LWIP_WND_SCALE
+  u8_t snd_scale; /* shift applied to windows announced by the remote host */
+  u8_t rcv_scale; /* shift applied to windows we announce */
+#endif /* LWIP_WND_SCALE */
 };
 
 struct tcp_pcb_listen {  
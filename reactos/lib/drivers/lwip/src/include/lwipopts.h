@@ -64,10 +64,21 @@
  * add support for other transport mediums */
 #define TCP_MSS                         1460
 
-#define TCP_WND                         0xFFFF
+/* Window scaling (RFC 1323) lets us announce more than 64 KB of receive
+ * window, which is needed to keep a link with real latency busy. The
+ * window in our SYN is still limited to 0xFFFF and only opened up once
+ * the remote host agrees to scaling. */
+#define LWIP_WND_SCALE                  1
+
+#define TCP_RCV_SCALE                   3
+
+#define TCP_WND                         (256 * 1024)
 
 #define TCP_SND_BUF                     TCP_WND
 
+/* Checksum outgoing TCP data while tcp_write() copies it in */
+#define LWIP_CHECKSUM_ON_COPY           1
+
 #define TCP_MAXRTX                      8
 
 #define TCP_SYNMAXRTX                   4
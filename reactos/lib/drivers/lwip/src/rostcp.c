@@ -512,9 +512,16 @@ LibTCPSendCallback(void *arg)
         SendFlags |= TCP_WRITE_FLAG_MORE;
     }
 
+    /* tcp_write takes at most 64 KB, the caller sends the rest later */
+    if (SendLength > 0xFFFF)
+    {
+        SendLength = 0xFFFF;
+        SendFlags |= TCP_WRITE_FLAG_MORE;
+    }
+
     msg->Output.Send.Error = tcp_write(pcb,
                                        msg->Input.Send.Data,
-                                       SendLength,
+                                       (u16_t)SendLength,
                                        SendFlags);
     if (msg->Output.Send.Error == ERR_OK)
     {
@@ -533,7 +540,7 @@ done:
 }
 
 err_t
-LibTCPSend(PCONNECTION_ENDPOINT Connection, void *const dataptr, const u16_t len, u32_t *sent, const int safe)
+LibTCPSend(PCONNECTION_ENDPOINT Connection, void *const dataptr, const u32_t len, u32_t *sent, const int safe)
 {
     err_t ret;
     struct lwip_callback_msg *msg;
@@ -160,6 +160,226 @@ Fast486WriteMemory(PFAST486_STATE State,
     return Fast486WriteLinearMemory(State, LinearAddress, Buffer, Size);
 }
 
+static
+BOOLEAN
+Fast486TranslatePage(PFAST486_STATE State,
+                     ULONG LinearAddress,
+                     BOOLEAN Write,
+                     PFAST486_TLB_ENTRY Entry)
+{
+    ULONG Tag = Fast486GetTlbTag(State, LinearAddress);
+    ULONG PhysicalAddress = PAGE_ALIGN(LinearAddress);
+    BOOLEAN Writeable = TRUE;
+
+    /* Check if paging is enabled */
+    if (State->ControlRegisters[FAST486_REG_CR0] & FAST486_CR0_PG)
+    {
+        FAST486_PAGE_TABLE TableEntry;
+        BOOLEAN User = ((Tag & TLB_TAG_USER) != 0);
+
+        /* Get the table entry */
+        TableEntry.Value = Fast486GetPageTableEntry(State, PhysicalAddress, FALSE);
+
+        /* Read-only pages can be written by the supervisor, unless WP is set */
+        Writeable = TableEntry.Writeable
+                    || (!User && !(State->ControlRegisters[FAST486_REG_CR0] & FAST486_CR0_WP));
+
+        if (!TableEntry.Present
+            || (!TableEntry.Usermode && User)
+            || (Write && !Writeable))
+        {
+            /* Exception */
+            State->ControlRegisters[FAST486_REG_CR2] = LinearAddress;
+            Fast486ExceptionWithErrorCode(State,
+                                          FAST486_EXCEPTION_PF,
+                                          (TableEntry.Present ? PAGE_FAULT_PRESENT : 0)
+                                          | (Write ? PAGE_FAULT_WRITE : 0)
+                                          | (User ? PAGE_FAULT_USER : 0));
+            return FALSE;
+        }
+
+        if (Write && !TableEntry.Dirty)
+        {
+            /* Walk the tables again, this time marking the page as dirty */
+            TableEntry.Value = Fast486GetPageTableEntry(State, PhysicalAddress, TRUE);
+        }
+
+        /* Writes must not hit the TLB before the page is dirty */
+        if (!TableEntry.Dirty) Writeable = FALSE;
+
+        PhysicalAddress = TableEntry.Address << 12;
+    }
+
+    /* Fill the entry, the host decides which pages are accessed directly */
+    Entry->ReadTag = Tag;
+    Entry->WriteTag = Writeable ? Tag : INVALID_TLB_FIELD;
+    Entry->Address = PhysicalAddress;
+    Entry->ReadPointer = (PUCHAR)State->MemMapCallback(State, PhysicalAddress, FALSE);
+    Entry->WritePointer = Writeable
+                          ? (PUCHAR)State->MemMapCallback(State, PhysicalAddress, TRUE)
+                          : NULL;
+
+    return TRUE;
+}
+
+static
+PFAST486_TLB_ENTRY
+Fast486GetTlbEntry(PFAST486_STATE State,
+                   ULONG LinearAddress,
+                   BOOLEAN Write,
+                   PFAST486_TLB_ENTRY Scratch)
+{
+    PFAST486_TLB_ENTRY Entry = Scratch;
+
+    if (State->Tlb != NULL)
+    {
+        ULONG Tag = Fast486GetTlbTag(State, LinearAddress);
+
+        /* The TLB is direct mapped, get the entry for this page */
+        Entry = &State->Tlb[(LinearAddress >> 12) % FAST486_TLB_SIZE];
+        if ((Write ? Entry->WriteTag : Entry->ReadTag) == Tag) return Entry;
+    }
+
+    /* Walk the page tables and replace whatever was cached there */
+    if (!Fast486TranslatePage(State, LinearAddress, Write, Entry)) return NULL;
+
+    return Entry;
+}
+
+BOOLEAN
+Fast486ReadLinearMemorySlow(PFAST486_STATE State,
+                            ULONG LinearAddress,
+                            PVOID Buffer,
+                            ULONG Size)
+{
+    FAST486_TLB_ENTRY Scratch;
+    PFAST486_TLB_ENTRY Entry;
+
+    while (Size > 0)
+    {
+        ULONG PageOffset = PAGE_OFFSET(LinearAddress);
+        ULONG PageLength = min(Size, PAGE_SIZE - PageOffset);
+
+        /* Get the translation of this page */
+        Entry = Fast486GetTlbEntry(State, LinearAddress, FALSE, &Scratch);
+        if (Entry == NULL)
+        {
+            /* Exception occurred */
+            return FALSE;
+        }
+
+        /* Read the memory */
+        if (Entry->ReadPointer != NULL)
+        {
+            RtlCopyMemory(Buffer, &Entry->ReadPointer[PageOffset], PageLength);
+        }
+        else
+        {
+            State->MemReadCallback(State,
+                                   Entry->Address | PageOffset,
+                                   Buffer,
+                                   PageLength);
+        }
+
+        Buffer = (PVOID)((ULONG_PTR)Buffer + PageLength);
+        LinearAddress += PageLength;
+        Size -= PageLength;
+    }
+
+    return TRUE;
+}
+
+BOOLEAN
+Fast486WriteLinearMemorySlow(PFAST486_STATE State,
+                             ULONG LinearAddress,
+                             PVOID Buffer,
+                             ULONG Size)
+{
+    FAST486_TLB_ENTRY Scratch;
+    PFAST486_TLB_ENTRY Entry;
+
+    while (Size > 0)
+    {
+        ULONG PageOffset = PAGE_OFFSET(LinearAddress);
+        ULONG PageLength = min(Size, PAGE_SIZE - PageOffset);
+
+        /* Get the translation of this page */
+        Entry = Fast486GetTlbEntry(State, LinearAddress, TRUE, &Scratch);
+        if (Entry == NULL)
+        {
+            /* Exception occurred */
+            return FALSE;
+        }
+
+        /* Write the memory */
+        if (Entry->WritePointer != NULL)
+        {
+            RtlCopyMemory(&Entry->WritePointer[PageOffset], Buffer, PageLength);
+        }
+        else
+        {
+            State->MemWriteCallback(State,
+                                    Entry->Address | PageOffset,
+                                    Buffer,
+                                    PageLength);
+        }
+
+        /* Keep the code cache coherent */
+        Fast486UpdateCodeCache(State, Entry->Address | PageOffset, PageLength);
+
+        Buffer = (PVOID)((ULONG_PTR)Buffer + PageLength);
+        LinearAddress += PageLength;
+        Size -= PageLength;
+    }
+
+    return TRUE;
+}
+
+BOOLEAN
+Fast486LoadCodePage(PFAST486_STATE State,
+                    ULONG LinearAddress)
+{
+    ULONG PhysicalAddress = PAGE_ALIGN(LinearAddress);
+    INT Cpl = Fast486GetCurrentPrivLevel(State);
+    PFAST486_CODE_PAGE CodePage;
+
+    /* Check if paging is enabled */
+    if (State->ControlRegisters[FAST486_REG_CR0] & FAST486_CR0_PG)
+    {
+        FAST486_PAGE_TABLE TableEntry;
+
+        /* Get the table entry */
+        TableEntry.Value = Fast486GetPageTableEntry(State, PhysicalAddress, FALSE);
+
+        /* Page faults are raised by the regular fetch */
+        if (!TableEntry.Present || (!TableEntry.Usermode && (Cpl > 0))) return FALSE;
+
+        PhysicalAddress = TableEntry.Address << 12;
+    }
+
+    /* The last page can't be read in one piece, it wraps around */
+    if (PhysicalAddress == PAGE_ALIGN(0xFFFFFFFF)) return FALSE;
+
+    /* The cache is direct mapped, get the entry for this page */
+    CodePage = &State->CodeCache[(PhysicalAddress >> 12) % FAST486_CODE_CACHE_PAGES];
+
+    if (CodePage->Address != PhysicalAddress)
+    {
+        /* Replace whatever was cached there */
+        State->MemReadCallback(State, PhysicalAddress, CodePage->Data, PAGE_SIZE);
+        CodePage->Address = PhysicalAddress;
+    }
+
+    /*
+     * Remember the translation. The tag includes the CPL,
+     * since the user/supervisor check above depends on it.
+     */
+    State->CodePage = CodePage;
+    State->CodePageTag = PAGE_ALIGN(LinearAddress) | Cpl;
+
+    return TRUE;
+}
+
 BOOLEAN
 Fast486InterruptInternal(PFAST486_STATE State,
                          USHORT SegmentSelector,
@@ -198,6 +418,9 @@ Fast486InterruptInternal(PFAST486_STATE State,
                 return FALSE;
             }
 
+            /* The new stack is checked against the new privilege level */
+            State->Cpl = GET_SEGMENT_RPL(SegmentSelector);
+
             /* Check the new (higher) privilege level */
             switch (GET_SEGMENT_RPL(SegmentSelector))
             {
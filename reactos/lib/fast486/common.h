@@ -69,6 +69,11 @@ if (State->PrefixFlags & FAST486_PREFIX_LOCK)\
 #define GET_ADDR_PDE(x) ((x) >> 22)
 #define GET_ADDR_PTE(x) (((x) >> 12) & 0x3FF)
 #define INVALID_TLB_FIELD 0xFFFFFFFF
+#define TLB_TAG_USER      1
+
+#define PAGE_FAULT_PRESENT  (1 << 0)
+#define PAGE_FAULT_WRITE    (1 << 1)
+#define PAGE_FAULT_USER     (1 << 2)
 
 #ifndef PAGE_SIZE
 #define PAGE_SIZE   4096
@@ -153,6 +158,31 @@ Fast486WriteMemory
     ULONG Size
 );
 
+BOOLEAN
+Fast486ReadLinearMemorySlow
+(
+    PFAST486_STATE State,
+    ULONG LinearAddress,
+    PVOID Buffer,
+    ULONG Size
+);
+
+BOOLEAN
+Fast486WriteLinearMemorySlow
+(
+    PFAST486_STATE State,
+    ULONG LinearAddress,
+    PVOID Buffer,
+    ULONG Size
+);
+
+BOOLEAN
+Fast486LoadCodePage
+(
+    PFAST486_STATE State,
+    ULONG LinearAddress
+);
+
 BOOLEAN
 Fast486InterruptInternal
 (
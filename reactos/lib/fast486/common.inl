@@ -44,13 +44,6 @@ Fast486GetPageTableEntry(PFAST486_STATE State,
     FAST486_PAGE_TABLE TableEntry;
     ULONG PageDirectory = State->ControlRegisters[FAST486_REG_CR3];
 
-    if ((State->Tlb != NULL)
-        && (State->Tlb[VirtualAddress >> 12] != INVALID_TLB_FIELD))
-    {
-        /* Return the cached entry */
-        return State->Tlb[VirtualAddress >> 12];
-    }
-
     /* Read the directory entry */
     State->MemReadCallback(State,
                            PageDirectory + PdeIndex * sizeof(ULONG),
@@ -83,13 +76,12 @@ Fast486GetPageTableEntry(PFAST486_STATE State,
     /* Make sure it is present */
     if (!TableEntry.Present) return 0;
 
-    if (MarkAsDirty) TableEntry.Dirty = TRUE;
-
-    /* Was the table entry accessed before? */
-    if (!TableEntry.Accessed)
+    /* Was the table entry accessed (or written to, if needed) before? */
+    if (!TableEntry.Accessed || (MarkAsDirty && !TableEntry.Dirty))
     {
         /* Well, it is now */
         TableEntry.Accessed = TRUE;
+        if (MarkAsDirty) TableEntry.Dirty = TRUE;
 
         /* Write back the table entry */
         State->MemWriteCallback(State,
@@ -106,16 +98,23 @@ Fast486GetPageTableEntry(PFAST486_STATE State,
     TableEntry.Writeable &= DirectoryEntry.Writeable;
     TableEntry.Usermode &= DirectoryEntry.Usermode;
 
-    if (State->Tlb != NULL)
-    {
-        /* Set the TLB entry */
-        State->Tlb[VirtualAddress >> 12] = TableEntry.Value;
-    }
-
     /* Return the table entry */
     return TableEntry.Value;
 }
 
+FORCEINLINE
+ULONG
+Fast486GetTlbTag(PFAST486_STATE State,
+                 ULONG LinearAddress)
+{
+    /*
+     * TLB entries are filled either for supervisor or for user mode
+     * accesses, since the page permissions depend on it
+     */
+    return PAGE_ALIGN(LinearAddress)
+           | ((Fast486GetCurrentPrivLevel(State) > 0) ? TLB_TAG_USER : 0);
+}
+
 FORCEINLINE
 BOOLEAN
 Fast486ReadLinearMemory(PFAST486_STATE State,
@@ -123,65 +122,80 @@ Fast486ReadLinearMemory(PFAST486_STATE State,
                         PVOID Buffer,
                         ULONG Size)
 {
-    /* Check if paging is enabled */
-    if (State->ControlRegisters[FAST486_REG_CR0] & FAST486_CR0_PG)
+    if (State->Tlb != NULL)
     {
-        ULONG Page;
-        FAST486_PAGE_TABLE TableEntry;
-        INT Cpl = Fast486GetCurrentPrivLevel(State);
-        ULONG BufferOffset = 0;
-
-        for (Page = PAGE_ALIGN(LinearAddress);
-             Page <= PAGE_ALIGN(LinearAddress + Size - 1);
-             Page += PAGE_SIZE)
-        {
-            ULONG PageOffset = 0, PageLength = PAGE_SIZE;
+        PFAST486_TLB_ENTRY Entry = &State->Tlb[(LinearAddress >> 12) % FAST486_TLB_SIZE];
 
-            /* Get the table entry */
-            TableEntry.Value = Fast486GetPageTableEntry(State, Page, FALSE);
+        /* Check for a TLB hit on a page which can be read directly */
+        if ((Entry->ReadTag == Fast486GetTlbTag(State, LinearAddress))
+            && (Entry->ReadPointer != NULL)
+            && ((PAGE_OFFSET(LinearAddress) + Size) <= PAGE_SIZE))
+        {
+            PUCHAR Pointer = &Entry->ReadPointer[PAGE_OFFSET(LinearAddress)];
 
-            if (!TableEntry.Present || (!TableEntry.Usermode && (Cpl > 0)))
+            /* Aligned accesses are a single load */
+            if (Size == sizeof(UCHAR))
             {
-                /* Exception */
-                Fast486ExceptionWithErrorCode(State,
-                                              FAST486_EXCEPTION_PF,
-                                              TableEntry.Value & 0x07);
-                return FALSE;
+                *(PUCHAR)Buffer = *Pointer;
             }
-
-            /* Check if this is the first page */
-            if (Page == PAGE_ALIGN(LinearAddress))
+            else if ((Size == sizeof(USHORT)) && !(LinearAddress & (sizeof(USHORT) - 1)))
             {
-                /* Start reading from the offset from the beginning of the page */
-                PageOffset = PAGE_OFFSET(LinearAddress);
-                PageLength -= PageOffset;
+                *(PUSHORT)Buffer = *(PUSHORT)Pointer;
             }
-
-            /* Check if this is the last page */
-            if (Page == PAGE_ALIGN(LinearAddress + Size - 1))
+            else if ((Size == sizeof(ULONG)) && !(LinearAddress & (sizeof(ULONG) - 1)))
             {
-                /* Read only a part of the page */
-                PageLength = PAGE_OFFSET(LinearAddress + Size - 1) - PageOffset + 1;
+                *(PULONG)Buffer = *(PULONG)Pointer;
+            }
+            else
+            {
+                RtlCopyMemory(Buffer, Pointer, Size);
             }
 
-            /* Read the memory */
-            State->MemReadCallback(State,
-                                   (TableEntry.Address << 12) | PageOffset,
-                                   (PVOID)((ULONG_PTR)Buffer + BufferOffset),
-                                   PageLength);
-
-            BufferOffset += PageLength;
+            return TRUE;
         }
     }
-    else
+
+    /* Translate the address and read the memory the long way */
+    return Fast486ReadLinearMemorySlow(State, LinearAddress, Buffer, Size);
+}
+
+FORCEINLINE
+VOID
+Fast486UpdateCodeCache(PFAST486_STATE State,
+                       ULONG PhysicalAddress,
+                       ULONG Size)
+{
+    ULONG Page = PAGE_ALIGN(PhysicalAddress);
+    ULONG Offset = PAGE_OFFSET(PhysicalAddress);
+    ULONG Length;
+    PFAST486_CODE_PAGE CodePage;
+
+    if (State->CodeCache == NULL) return;
+
+    while (Size > 0)
     {
-        /* Read the memory */
-        State->MemReadCallback(State, LinearAddress, Buffer, Size);
-    }
+        Length = min(Size, PAGE_SIZE - Offset);
+        CodePage = &State->CodeCache[(Page >> 12) % FAST486_CODE_CACHE_PAGES];
 
-    return TRUE;
+        if (CodePage->Address == Page)
+        {
+            /*
+             * Read back what actually got written, since the memory
+             * callback is free to ignore writes (ROM, for example)
+             */
+            State->MemReadCallback(State,
+                                   Page | Offset,
+                                   &CodePage->Data[Offset],
+                                   Length);
+        }
+
+        Page += PAGE_SIZE;
+        Offset = 0;
+        Size -= Length;
+    }
 }
 
+
 FORCEINLINE
 BOOLEAN
 Fast486WriteLinearMemory(PFAST486_STATE State,
@@ -189,65 +203,54 @@ Fast486WriteLinearMemory(PFAST486_STATE State,
                          PVOID Buffer,
                          ULONG Size)
 {
-    /* Check if paging is enabled */
-    if (State->ControlRegisters[FAST486_REG_CR0] & FAST486_CR0_PG)
+    if (State->Tlb != NULL)
     {
-        ULONG Page;
-        FAST486_PAGE_TABLE TableEntry;
-        INT Cpl = Fast486GetCurrentPrivLevel(State);
-        ULONG BufferOffset = 0;
-
-        for (Page = PAGE_ALIGN(LinearAddress);
-             Page <= PAGE_ALIGN(LinearAddress + Size - 1);
-             Page += PAGE_SIZE)
-        {
-            ULONG PageOffset = 0, PageLength = PAGE_SIZE;
+        PFAST486_TLB_ENTRY Entry = &State->Tlb[(LinearAddress >> 12) % FAST486_TLB_SIZE];
 
-            /* Get the table entry */
-            TableEntry.Value = Fast486GetPageTableEntry(State, Page, TRUE);
+        /* Check for a TLB hit on a page which can be written directly */
+        if ((Entry->WriteTag == Fast486GetTlbTag(State, LinearAddress))
+            && (Entry->WritePointer != NULL)
+            && ((PAGE_OFFSET(LinearAddress) + Size) <= PAGE_SIZE))
+        {
+            ULONG Offset = PAGE_OFFSET(LinearAddress);
+            PUCHAR Pointer = &Entry->WritePointer[Offset];
 
-            if ((!TableEntry.Present || (!TableEntry.Usermode && (Cpl > 0)))
-                || ((State->ControlRegisters[FAST486_REG_CR0] & FAST486_CR0_WP)
-                && !TableEntry.Writeable))
+            /* Aligned accesses are a single store */
+            if (Size == sizeof(UCHAR))
             {
-                /* Exception */
-                Fast486ExceptionWithErrorCode(State,
-                                              FAST486_EXCEPTION_PF,
-                                              TableEntry.Value & 0x07);
-                return FALSE;
+                *Pointer = *(PUCHAR)Buffer;
             }
-
-            /* Check if this is the first page */
-            if (Page == PAGE_ALIGN(LinearAddress))
+            else if ((Size == sizeof(USHORT)) && !(LinearAddress & (sizeof(USHORT) - 1)))
             {
-                /* Start writing from the offset from the beginning of the page */
-                PageOffset = PAGE_OFFSET(LinearAddress);
-                PageLength -= PageOffset;
+                *(PUSHORT)Pointer = *(PUSHORT)Buffer;
             }
-
-            /* Check if this is the last page */
-            if (Page == PAGE_ALIGN(LinearAddress + Size - 1))
+            else if ((Size == sizeof(ULONG)) && !(LinearAddress & (sizeof(ULONG) - 1)))
             {
-                /* Write only a part of the page */
-                PageLength = PAGE_OFFSET(LinearAddress + Size - 1) - PageOffset + 1;
+                *(PULONG)Pointer = *(PULONG)Buffer;
+            }
+            else
+            {
+                RtlCopyMemory(Pointer, Buffer, Size);
             }
 
-            /* Write the memory */
-            State->MemWriteCallback(State,
-                                    (TableEntry.Address << 12) | PageOffset,
-                                    (PVOID)((ULONG_PTR)Buffer + BufferOffset),
-                                    PageLength);
+            /* Keep the code cache coherent, a direct write always sticks */
+            if (State->CodeCache != NULL)
+            {
+                PFAST486_CODE_PAGE CodePage;
 
-            BufferOffset += PageLength;
+                CodePage = &State->CodeCache[(Entry->Address >> 12) % FAST486_CODE_CACHE_PAGES];
+                if (CodePage->Address == Entry->Address)
+                {
+                    RtlCopyMemory(&CodePage->Data[Offset], Buffer, Size);
+                }
+            }
+
+            return TRUE;
         }
     }
-    else
-    {
-        /* Write the memory */
-        State->MemWriteCallback(State, LinearAddress, Buffer, Size);
-    }
 
-    return TRUE;
+    /* Translate the address and write the memory the long way */
+    return Fast486WriteLinearMemorySlow(State, LinearAddress, Buffer, Size);
 }
 
 FORCEINLINE
@@ -599,6 +602,42 @@ Fast486LoadSegment(PFAST486_STATE State,
     return TRUE;
 }
 
+FORCEINLINE
+BOOLEAN
+Fast486FetchCached(PFAST486_STATE State,
+                   ULONG Offset,
+                   PVOID Data,
+                   ULONG Size)
+{
+    PFAST486_SEG_REG CachedDescriptor = &State->SegmentRegs[FAST486_REG_CS];
+    ULONG LinearAddress = CachedDescriptor->Base + Offset;
+
+    if (State->CodeCache == NULL) return FALSE;
+
+    /* Leave anything unusual to the regular path, which raises the exceptions */
+    if ((Offset + Size - 1) > CachedDescriptor->Limit) return FALSE;
+    if (PAGE_OFFSET(LinearAddress) > (PAGE_SIZE - Size)) return FALSE;
+
+    if ((State->ControlRegisters[FAST486_REG_CR0] & FAST486_CR0_PE)
+        && (!CachedDescriptor->Present
+        || !CachedDescriptor->Executable
+        || (Fast486GetCurrentPrivLevel(State) > CachedDescriptor->Dpl)))
+    {
+        return FALSE;
+    }
+
+    /* Check if the page differs from the last one */
+    if ((State->CodePage == NULL)
+        || (State->CodePageTag != (PAGE_ALIGN(LinearAddress)
+                                   | Fast486GetCurrentPrivLevel(State))))
+    {
+        if (!Fast486LoadCodePage(State, LinearAddress)) return FALSE;
+    }
+
+    RtlCopyMemory(Data, &State->CodePage->Data[PAGE_OFFSET(LinearAddress)], Size);
+    return TRUE;
+}
+
 FORCEINLINE
 BOOLEAN
 Fast486FetchByte(PFAST486_STATE State,
@@ -609,14 +648,19 @@ Fast486FetchByte(PFAST486_STATE State,
     /* Get the cached descriptor of CS */
     CachedDescriptor = &State->SegmentRegs[FAST486_REG_CS];
 
-    /* Read from memory */
-    if (!Fast486ReadMemory(State,
-                           FAST486_REG_CS,
-                           (CachedDescriptor->Size) ? State->InstPtr.Long
-                                                    : State->InstPtr.LowWord,
-                           TRUE,
-                           Data,
-                           sizeof(UCHAR)))
+    /* Read from the code cache, or from memory if that fails */
+    if (!Fast486FetchCached(State,
+                            (CachedDescriptor->Size) ? State->InstPtr.Long
+                                                     : State->InstPtr.LowWord,
+                            Data,
+                            sizeof(UCHAR))
+        && !Fast486ReadMemory(State,
+                              FAST486_REG_CS,
+                              (CachedDescriptor->Size) ? State->InstPtr.Long
+                                                       : State->InstPtr.LowWord,
+                              TRUE,
+                              Data,
+                              sizeof(UCHAR)))
     {
         /* Exception occurred during instruction fetch */
         return FALSE;
@@ -639,15 +683,20 @@ Fast486FetchWord(PFAST486_STATE State,
     /* Get the cached descriptor of CS */
     CachedDescriptor = &State->SegmentRegs[FAST486_REG_CS];
 
-    /* Read from memory */
+    /* Read from the code cache, or from memory if that fails */
     // FIXME: Fix byte order on big-endian machines
-    if (!Fast486ReadMemory(State,
-                           FAST486_REG_CS,
-                           (CachedDescriptor->Size) ? State->InstPtr.Long
-                                                    : State->InstPtr.LowWord,
-                           TRUE,
-                           Data,
-                           sizeof(USHORT)))
+    if (!Fast486FetchCached(State,
+                            (CachedDescriptor->Size) ? State->InstPtr.Long
+                                                     : State->InstPtr.LowWord,
+                            Data,
+                            sizeof(USHORT))
+        && !Fast486ReadMemory(State,
+                              FAST486_REG_CS,
+                              (CachedDescriptor->Size) ? State->InstPtr.Long
+                                                       : State->InstPtr.LowWord,
+                              TRUE,
+                              Data,
+                              sizeof(USHORT)))
     {
         /* Exception occurred during instruction fetch */
         return FALSE;
@@ -670,15 +719,20 @@ Fast486FetchDword(PFAST486_STATE State,
     /* Get the cached descriptor of CS */
     CachedDescriptor = &State->SegmentRegs[FAST486_REG_CS];
 
-    /* Read from memory */
+    /* Read from the code cache, or from memory if that fails */
     // FIXME: Fix byte order on big-endian machines
-    if (!Fast486ReadMemory(State,
-                           FAST486_REG_CS,
-                           (CachedDescriptor->Size) ? State->InstPtr.Long
-                                                    : State->InstPtr.LowWord,
-                           TRUE,
-                           Data,
-                           sizeof(ULONG)))
+    if (!Fast486FetchCached(State,
+                            (CachedDescriptor->Size) ? State->InstPtr.Long
+                                                     : State->InstPtr.LowWord,
+                            Data,
+                            sizeof(ULONG))
+        && !Fast486ReadMemory(State,
+                              FAST486_REG_CS,
+                              (CachedDescriptor->Size) ? State->InstPtr.Long
+                                                       : State->InstPtr.LowWord,
+                              TRUE,
+                              Data,
+                              sizeof(ULONG)))
     {
         /* Exception occurred during instruction fetch */
         return FALSE;
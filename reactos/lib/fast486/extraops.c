@@ -711,6 +711,10 @@ FAST486_OPCODE_HANDLER(Fast486ExtOpcodeLoadControlReg)
     /* Load a value to the control register */
     State->ControlRegisters[ModRegRm.Register] = Value;
 
+    /* The code page and the TLB may be mapped differently now */
+    State->CodePage = NULL;
+    Fast486FlushTlb(State);
+
     /* Return success */
     return TRUE;
 }
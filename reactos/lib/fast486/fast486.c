@@ -141,7 +141,7 @@ Fast486MemReadCallback(PFAST486_STATE State, ULONG Address, PVOID Buffer, ULONG
 {
     UNREFERENCED_PARAMETER(State);
 
-    RtlMoveMemory(Buffer, (PVOID)Address, Size);
+    RtlMoveMemory(Buffer, (PVOID)(ULONG_PTR)Address, Size);
 }
 
 static VOID
@@ -150,7 +150,19 @@ Fast486MemWriteCallback(PFAST486_STATE State, ULONG Address, PVOID Buffer, ULONG
 {
     UNREFERENCED_PARAMETER(State);
 
-    RtlMoveMemory((PVOID)Address, Buffer, Size);
+    RtlMoveMemory((PVOID)(ULONG_PTR)Address, Buffer, Size);
+}
+
+static PVOID
+NTAPI
+Fast486MemMapCallback(PFAST486_STATE State, ULONG Address, BOOLEAN Write)
+{
+    UNREFERENCED_PARAMETER(State);
+    UNREFERENCED_PARAMETER(Address);
+    UNREFERENCED_PARAMETER(Write);
+
+    /* Always go through the memory callbacks */
+    return NULL;
 }
 
 static VOID
@@ -207,24 +219,28 @@ NTAPI
 Fast486Initialize(PFAST486_STATE         State,
                   FAST486_MEM_READ_PROC  MemReadCallback,
                   FAST486_MEM_WRITE_PROC MemWriteCallback,
+                  FAST486_MEM_MAP_PROC   MemMapCallback,
                   FAST486_IO_READ_PROC   IoReadCallback,
                   FAST486_IO_WRITE_PROC  IoWriteCallback,
                   FAST486_IDLE_PROC      IdleCallback,
                   FAST486_BOP_PROC       BopCallback,
                   FAST486_INT_ACK_PROC   IntAckCallback,
-                  PULONG                 Tlb)
+                  PFAST486_TLB_ENTRY     Tlb,
+                  PFAST486_CODE_PAGE     CodeCache)
 {
     /* Set the callbacks (or use default ones if some are NULL) */
     State->MemReadCallback  = (MemReadCallback  ? MemReadCallback  : Fast486MemReadCallback );
     State->MemWriteCallback = (MemWriteCallback ? MemWriteCallback : Fast486MemWriteCallback);
+    State->MemMapCallback   = (MemMapCallback   ? MemMapCallback   : Fast486MemMapCallback  );
     State->IoReadCallback   = (IoReadCallback   ? IoReadCallback   : Fast486IoReadCallback  );
     State->IoWriteCallback  = (IoWriteCallback  ? IoWriteCallback  : Fast486IoWriteCallback );
     State->IdleCallback     = (IdleCallback     ? IdleCallback     : Fast486IdleCallback    );
     State->BopCallback      = (BopCallback      ? BopCallback      : Fast486BopCallback     );
     State->IntAckCallback   = (IntAckCallback   ? IntAckCallback   : Fast486IntAckCallback  );
 
-    /* Set the TLB (if given) */
+    /* Set the TLB and the code cache (if given) */
     State->Tlb = Tlb;
+    State->CodeCache = CodeCache;
 
     /* Reset the CPU */
     Fast486Reset(State);
@@ -238,12 +254,14 @@ Fast486Reset(PFAST486_STATE State)
 
     FAST486_MEM_READ_PROC  MemReadCallback  = State->MemReadCallback;
     FAST486_MEM_WRITE_PROC MemWriteCallback = State->MemWriteCallback;
+    FAST486_MEM_MAP_PROC   MemMapCallback   = State->MemMapCallback;
     FAST486_IO_READ_PROC   IoReadCallback   = State->IoReadCallback;
     FAST486_IO_WRITE_PROC  IoWriteCallback  = State->IoWriteCallback;
     FAST486_IDLE_PROC      IdleCallback     = State->IdleCallback;
     FAST486_BOP_PROC       BopCallback      = State->BopCallback;
     FAST486_INT_ACK_PROC   IntAckCallback   = State->IntAckCallback;
-    PULONG                 Tlb              = State->Tlb;
+    PFAST486_TLB_ENTRY     Tlb              = State->Tlb;
+    PFAST486_CODE_PAGE     CodeCache        = State->CodeCache;
 
     /* Clear the entire structure */
     RtlZeroMemory(State, sizeof(*State));
@@ -289,15 +307,63 @@ Fast486Reset(PFAST486_STATE State)
     State->FpuTag = 0xFFFF;
 #endif
 
-    /* Restore the callbacks and TLB */
+    /* Restore the callbacks, TLB and code cache */
     State->MemReadCallback  = MemReadCallback;
     State->MemWriteCallback = MemWriteCallback;
+    State->MemMapCallback   = MemMapCallback;
     State->IoReadCallback   = IoReadCallback;
     State->IoWriteCallback  = IoWriteCallback;
     State->IdleCallback     = IdleCallback;
     State->BopCallback      = BopCallback;
     State->IntAckCallback   = IntAckCallback;
     State->Tlb              = Tlb;
+    State->CodeCache        = CodeCache;
+
+    /* Nothing is cached yet */
+    Fast486InvalidateCache(State, 0, 0xFFFFFFFF);
+    Fast486FlushTlb(State);
+}
+
+VOID
+NTAPI
+Fast486InvalidateCache(PFAST486_STATE State, ULONG Address, ULONG Size)
+{
+    ULONGLONG End = (ULONGLONG)Address + Size;
+    ULONG i;
+
+    /* Forget the current code page in any case */
+    State->CodePage = NULL;
+
+    if (State->CodeCache == NULL || Size == 0) return;
+
+    for (i = 0; i < FAST486_CODE_CACHE_PAGES; i++)
+    {
+        PFAST486_CODE_PAGE CodePage = &State->CodeCache[i];
+
+        if (CodePage->Address == FAST486_CODE_PAGE_EMPTY) continue;
+
+        /* Check if the page overlaps the range */
+        if (((ULONGLONG)CodePage->Address + PAGE_SIZE > Address)
+            && (CodePage->Address < End))
+        {
+            CodePage->Address = FAST486_CODE_PAGE_EMPTY;
+        }
+    }
+}
+
+VOID
+NTAPI
+Fast486FlushTlb(PFAST486_STATE State)
+{
+    ULONG i;
+
+    if (State->Tlb == NULL) return;
+
+    for (i = 0; i < FAST486_TLB_SIZE; i++)
+    {
+        State->Tlb[i].ReadTag = INVALID_TLB_FIELD;
+        State->Tlb[i].WriteTag = INVALID_TLB_FIELD;
+    }
 }
 
 VOID
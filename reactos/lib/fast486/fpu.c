@@ -511,7 +511,7 @@ FAST486_OPCODE_HANDLER(Fast486FpuOpcodeDB)
     else
     {
         /* Only a few of these instructions have any meaning on a 487 */
-        switch ((ModRegRm.SecondRegister << 3) | ModRegRm.Register)
+        switch ((ModRegRm.Register << 3) | ModRegRm.SecondRegister)
         {
             /* FCLEX */
             case 0x22:
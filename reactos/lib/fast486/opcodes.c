@@ -3798,7 +3798,7 @@ FAST486_OPCODE_HANDLER(Fast486OpcodeImulModrmImm)
         Product = (LONGLONG)Multiplicand * (LONGLONG)Multiplier;
 
         /* Check for carry/overflow */
-        State->Flags.Cf = State->Flags.Of = ((Product < MINLONG) || (Product > MAXLONG));
+        State->Flags.Cf = State->Flags.Of = ((Product < -2147483648LL) || (Product > 2147483647LL));
 
         /* Write-back the result */
         return Fast486WriteModrmDwordOperands(State,
@@ -3825,7 +3825,7 @@ FAST486_OPCODE_HANDLER(Fast486OpcodeImulModrmImm)
         Product = (LONG)Multiplicand * (LONG)Multiplier;
 
         /* Check for carry/overflow */
-        State->Flags.Cf = State->Flags.Of = ((Product < MINSHORT) || (Product > MAXSHORT));
+        State->Flags.Cf = State->Flags.Of = ((Product < -32768) || (Product > 32767));
 
         /* Write-back the result */
         return Fast486WriteModrmWordOperands(State,
@@ -4788,17 +4788,6 @@ FAST486_OPCODE_HANDLER(Fast486OpcodeIret)
             return TRUE;
         }
 
-        /* Load the new CS */
-        if (!Fast486LoadSegment(State, FAST486_REG_CS, CodeSel))
-        {
-            /* Exception occurred */
-            return FALSE;
-        }
-
-        /* Set EIP */
-        if (Size) State->InstPtr.Long = InstPtr;
-        else State->InstPtr.LowWord = LOWORD(InstPtr);
-
         if (GET_SEGMENT_RPL(CodeSel) > Cpl)
         {
             /* Pop ESP */
@@ -4815,6 +4804,24 @@ FAST486_OPCODE_HANDLER(Fast486OpcodeIret)
                 return FALSE;
             }
 
+            /* The new segments are checked against the outer privilege level */
+            State->Cpl = GET_SEGMENT_RPL(CodeSel);
+        }
+
+        /* Load the new CS */
+        if (!Fast486LoadSegment(State, FAST486_REG_CS, CodeSel))
+        {
+            /* Exception occurred */
+            State->Cpl = Cpl;
+            return FALSE;
+        }
+
+        /* Set EIP */
+        if (Size) State->InstPtr.Long = InstPtr;
+        else State->InstPtr.LowWord = LOWORD(InstPtr);
+
+        if (GET_SEGMENT_RPL(CodeSel) > Cpl)
+        {
             /* Load new SS */
             if (!Fast486LoadSegment(State, FAST486_REG_SS, StackSel))
             {
@@ -2212,8 +2212,37 @@ FAST486_OPCODE_HANDLER(Fast486OpcodeGroup0F01)
         /* INVLPG */
         case 7:
         {
-            UNIMPLEMENTED;
-            return FALSE;
+            ULONG LinearAddress;
+
+            if (!ModRegRm.Memory)
+            {
+                /* The operand must be a memory location */
+                Fast486Exception(State, FAST486_EXCEPTION_UD);
+                return FALSE;
+            }
+
+            /* This is a privileged instruction */
+            if (Fast486GetCurrentPrivLevel(State) != 0)
+            {
+                Fast486Exception(State, FAST486_EXCEPTION_GP);
+                return FALSE;
+            }
+
+            LinearAddress = State->SegmentRegs[Segment].Base + ModRegRm.MemoryAddress;
+
+            /* Invalidate the TLB entry of the page */
+            if (State->Tlb != NULL)
+            {
+                PFAST486_TLB_ENTRY Entry = &State->Tlb[(LinearAddress >> 12) % FAST486_TLB_SIZE];
+
+                Entry->ReadTag = INVALID_TLB_FIELD;
+                Entry->WriteTag = INVALID_TLB_FIELD;
+            }
+
+            /* The code page may have been that page */
+            State->CodePage = NULL;
+
+            return TRUE;
         }
 
         /* Invalid */
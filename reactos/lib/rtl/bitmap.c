@@ -202,6 +202,253 @@ RtlpGetLengthOfRunSet(
     return Length;
 }
 
+static
+BITMAP_INDEX
+RtlpFindRun(
+    _In_ PRTL_BITMAP BitMapHeader,
+    _In_ BITMAP_BUFFER XorMask,
+    _In_ BITMAP_INDEX NumberToFind,
+    _In_ BITMAP_INDEX FromIndex,
+    _In_ BITMAP_INDEX ToIndex)
+{
+    BITMAP_BUFFER Value, Masked;
+    BITMAP_INDEX BitPos, EndPos, RunStart = 0, RunLength = 0;
+    PBITMAP_BUFFER Buffer, LastBuffer;
+
+    /*
+     * Finds the first run of NumberToFind bits between FromIndex and ToIndex
+     * that are clear after being xored with XorMask. Bits outside the range
+     * are treated as set, so the run can't extend past it.
+     */
+    ASSERT(NumberToFind != 0);
+    if (FromIndex >= ToIndex || ToIndex - FromIndex < NumberToFind)
+        return MAXINDEX;
+
+    /* Calculate positions */
+    Buffer = BitMapHeader->Buffer + FromIndex / _BITCOUNT;
+    LastBuffer = BitMapHeader->Buffer + (ToIndex - 1) / _BITCOUNT;
+
+    /* Get the first value, the bits before the start don't count */
+    Value = (*Buffer ^ XorMask) | ~(MAXINDEX << (FromIndex & (_BITCOUNT - 1)));
+
+    while (TRUE)
+    {
+        /* The bits past the end don't count either */
+        if (Buffer == LastBuffer && (ToIndex & (_BITCOUNT - 1)))
+            Value |= MAXINDEX << (ToIndex & (_BITCOUNT - 1));
+
+        if (Value == 0)
+        {
+            /* The whole ULONG is clear, the run continues */
+            if (RunLength == 0)
+                RunStart = (BITMAP_INDEX)(Buffer - BitMapHeader->Buffer) * _BITCOUNT;
+            RunLength += _BITCOUNT;
+
+            if (RunLength >= NumberToFind)
+                return RunStart;
+        }
+        else if (Value == MAXINDEX)
+        {
+            /* The run ends here, skip all set ULONGs */
+            RunLength = 0;
+            while (Buffer < LastBuffer && (Buffer[1] ^ XorMask) == MAXINDEX)
+                Buffer++;
+        }
+        else if (NumberToFind >= _BITCOUNT)
+        {
+            /* Only the clear bits at both ends can be part of the run */
+            BitScanForward(&BitPos, Value);
+            if (RunLength + BitPos >= NumberToFind)
+                return RunStart;
+
+            /* Start a new run after the last set bit */
+            BitScanReverse(&BitPos, Value);
+            RunStart = (BITMAP_INDEX)(Buffer - BitMapHeader->Buffer) * _BITCOUNT + BitPos + 1;
+            RunLength = _BITCOUNT - 1 - BitPos;
+        }
+        else
+        {
+            /* Walk the clear runs inside this ULONG */
+            BitPos = 0;
+            while (TRUE)
+            {
+                /* Find the next set bit, which ends the current run */
+                Masked = Value >> BitPos << BitPos;
+                if (RunLength == 0)
+                    RunStart = (BITMAP_INDEX)(Buffer - BitMapHeader->Buffer) * _BITCOUNT + BitPos;
+
+                if (Masked == 0)
+                {
+                    /* The run continues in the next ULONG */
+                    RunLength += _BITCOUNT - BitPos;
+                    if (RunLength >= NumberToFind)
+                        return RunStart;
+                    break;
+                }
+
+                BitScanForward(&EndPos, Masked);
+                RunLength += EndPos - BitPos;
+                if (RunLength >= NumberToFind)
+                    return RunStart;
+                RunLength = 0;
+
+                /* Find the next clear bit, which starts a new run */
+                Masked = ~Value >> EndPos << EndPos;
+                if (Masked == 0)
+                    break;
+
+                BitScanForward(&BitPos, Masked);
+            }
+        }
+
+        /* Did we reach the end? */
+        if (Buffer == LastBuffer)
+            return MAXINDEX;
+
+        Value = *++Buffer ^ XorMask;
+    }
+}
+
+static __inline
+BOOLEAN
+RtlpAddRun(
+    _Inout_ PRTL_BITMAP_RUN RunArray,
+    _In_ ULONG SizeOfRunArray,
+    _In_ BOOLEAN LocateLongestRuns,
+    _Inout_ PULONG NumberOfRuns,
+    _Inout_ PULONG SmallestRun,
+    _In_ BITMAP_INDEX StartingIndex,
+    _In_ BITMAP_INDEX NumberOfBits)
+{
+    ULONG Run;
+
+    /* Is there still a free entry? */
+    if (*NumberOfRuns < SizeOfRunArray)
+    {
+        /* Add another run */
+        Run = (*NumberOfRuns)++;
+        RunArray[Run].StartingIndex = StartingIndex;
+        RunArray[Run].NumberOfBits = NumberOfBits;
+
+        /* Update smallest run */
+        if (NumberOfBits < RunArray[*SmallestRun].NumberOfBits)
+            *SmallestRun = Run;
+
+        /* Continue if there is space left or we look for the longest runs */
+        return (*NumberOfRuns < SizeOfRunArray) || LocateLongestRuns;
+    }
+
+    /* Replace the smallest run if this one is longer */
+    if (NumberOfBits > RunArray[*SmallestRun].NumberOfBits)
+    {
+        RunArray[*SmallestRun].StartingIndex = StartingIndex;
+        RunArray[*SmallestRun].NumberOfBits = NumberOfBits;
+
+        /* Find the new smallest run */
+        for (Run = 0; Run < SizeOfRunArray; Run++)
+        {
+            if (RunArray[Run].NumberOfBits < RunArray[*SmallestRun].NumberOfBits)
+                *SmallestRun = Run;
+        }
+    }
+
+    return TRUE;
+}
+
+static
+ULONG
+RtlpFindRuns(
+    _In_ PRTL_BITMAP BitMapHeader,
+    _In_ BITMAP_BUFFER XorMask,
+    _Out_ PRTL_BITMAP_RUN RunArray,
+    _In_ ULONG SizeOfRunArray,
+    _In_ BOOLEAN LocateLongestRuns)
+{
+    BITMAP_BUFFER Value, Masked;
+    BITMAP_INDEX BitPos, EndPos, RunStart = 0, RunLength = 0;
+    PBITMAP_BUFFER Buffer, LastBuffer;
+    ULONG NumberOfRuns = 0, SmallestRun = 0;
+
+    /*
+     * Collects the runs of bits that are clear after being xored with XorMask,
+     * either the first ones or the longest ones.
+     */
+    if (BitMapHeader->SizeOfBitMap == 0 || SizeOfRunArray == 0)
+        return 0;
+
+    /* Calculate positions */
+    Buffer = BitMapHeader->Buffer;
+    LastBuffer = Buffer + (BitMapHeader->SizeOfBitMap - 1) / _BITCOUNT;
+
+    for (;; Buffer++)
+    {
+        Value = *Buffer ^ XorMask;
+
+        /* The bits past the end don't count */
+        if (Buffer == LastBuffer && (BitMapHeader->SizeOfBitMap & (_BITCOUNT - 1)))
+            Value |= MAXINDEX << (BitMapHeader->SizeOfBitMap & (_BITCOUNT - 1));
+
+        if (Value == 0)
+        {
+            /* The whole ULONG is clear, the run continues */
+            if (RunLength == 0)
+                RunStart = (BITMAP_INDEX)(Buffer - BitMapHeader->Buffer) * _BITCOUNT;
+            RunLength += _BITCOUNT;
+        }
+        else if (Value != MAXINDEX || RunLength != 0)
+        {
+            /* Walk the clear runs inside this ULONG */
+            BitPos = 0;
+            while (TRUE)
+            {
+                /* Find the next set bit, which ends the current run */
+                Masked = Value >> BitPos << BitPos;
+                if (RunLength == 0)
+                    RunStart = (BITMAP_INDEX)(Buffer - BitMapHeader->Buffer) * _BITCOUNT + BitPos;
+
+                if (Masked == 0)
+                {
+                    /* The run continues in the next ULONG */
+                    RunLength += _BITCOUNT - BitPos;
+                    break;
+                }
+
+                BitScanForward(&EndPos, Masked);
+                RunLength += EndPos - BitPos;
+                if (RunLength != 0)
+                {
+                    if (!RtlpAddRun(RunArray, SizeOfRunArray, LocateLongestRuns,
+                                    &NumberOfRuns, &SmallestRun, RunStart, RunLength))
+                    {
+                        return NumberOfRuns;
+                    }
+                    RunLength = 0;
+                }
+
+                /* Find the next clear bit, which starts a new run */
+                Masked = ~Value >> EndPos << EndPos;
+                if (Masked == 0)
+                    break;
+
+                BitScanForward(&BitPos, Masked);
+            }
+        }
+
+        /* Did we reach the end? */
+        if (Buffer == LastBuffer)
+            break;
+    }
+
+    /* Add the run that reaches the end of the bitmap */
+    if (RunLength != 0)
+    {
+        RtlpAddRun(RunArray, SizeOfRunArray, LocateLongestRuns,
+                   &NumberOfRuns, &SmallestRun, RunStart, RunLength);
+    }
+
+    return NumberOfRuns;
+}
+
 
 /* PUBLIC FUNCTIONS **********************************************************/
 
@@ -505,7 +752,7 @@ RtlFindClearBits(
     _In_ BITMAP_INDEX NumberToFind,
     _In_ BITMAP_INDEX HintIndex)
 {
-    BITMAP_INDEX CurrentBit, Margin, CurrentLength;
+    BITMAP_INDEX Position;
 
     /* Check for valid parameters */
     if (!BitMapHeader || NumberToFind > BitMapHeader->SizeOfBitMap)
@@ -523,47 +770,26 @@ RtlFindClearBits(
         return HintIndex & ~7;
     }
 
-    /* First margin is end of bitmap */
-    Margin = BitMapHeader->SizeOfBitMap;
-
-retry:
-    /* Start with hint index, length is 0 */
-    CurrentBit = HintIndex;
-
-    /* Loop until something is found or the end is reached */
-    while (CurrentBit + NumberToFind < Margin)
-    {
-        /* Search for the next clear run, by skipping a set run */
-        CurrentBit += RtlpGetLengthOfRunSet(BitMapHeader,
-                                            CurrentBit,
-                                            MAXINDEX);
-
-        /* Get length of the clear bit run */
-        CurrentLength = RtlpGetLengthOfRunClear(BitMapHeader,
-                                                CurrentBit,
-                                                NumberToFind);
-
-        /* Is this long enough? */
-        if (CurrentLength >= NumberToFind)
-        {
-            /* It is */
-            return CurrentBit;
-        }
-
-        CurrentBit += CurrentLength;
-    }
+    /* Search from the hint to the end of the bitmap */
+    Position = RtlpFindRun(BitMapHeader,
+                           0,
+                           NumberToFind,
+                           HintIndex,
+                           BitMapHeader->SizeOfBitMap);
 
     /* Did we start at a hint? */
-    if (HintIndex)
+    if (Position == MAXINDEX && HintIndex)
     {
-        /* Retry at the start */
-        Margin = min(HintIndex + NumberToFind, BitMapHeader->SizeOfBitMap);
-        HintIndex = 0;
-        goto retry;
+        /* Retry at the start, up to runs that begin before the hint */
+        Position = RtlpFindRun(BitMapHeader,
+                               0,
+                               NumberToFind,
+                               0,
+                               min(HintIndex + NumberToFind - 1,
+                                   BitMapHeader->SizeOfBitMap));
     }
 
-    /* Nothing found */
-    return MAXINDEX;
+    return Position;
 }
 
 BITMAP_INDEX
@@ -573,7 +799,7 @@ RtlFindSetBits(
     _In_ BITMAP_INDEX NumberToFind,
     _In_ BITMAP_INDEX HintIndex)
 {
-    BITMAP_INDEX CurrentBit, Margin, CurrentLength;
+    BITMAP_INDEX Position;
 
     /* Check for valid parameters */
     if (!BitMapHeader || NumberToFind > BitMapHeader->SizeOfBitMap)
@@ -591,47 +817,26 @@ RtlFindSetBits(
         return HintIndex & ~7;
     }
 
-    /* First margin is end of bitmap */
-    Margin = BitMapHeader->SizeOfBitMap;
-
-retry:
-    /* Start with hint index, length is 0 */
-    CurrentBit = HintIndex;
-
-    /* Loop until something is found or the end is reached */
-    while (CurrentBit + NumberToFind <= Margin)
-    {
-        /* Search for the next set run, by skipping a clear run */
-        CurrentBit += RtlpGetLengthOfRunClear(BitMapHeader,
-                                              CurrentBit,
-                                              MAXINDEX);
-
-        /* Get length of the set bit run */
-        CurrentLength = RtlpGetLengthOfRunSet(BitMapHeader,
-                                              CurrentBit,
-                                              NumberToFind);
-
-        /* Is this long enough? */
-        if (CurrentLength >= NumberToFind)
-        {
-            /* It is */
-            return CurrentBit;
-        }
-
-        CurrentBit += CurrentLength;
-    }
+    /* Search from the hint to the end of the bitmap */
+    Position = RtlpFindRun(BitMapHeader,
+                           MAXINDEX,
+                           NumberToFind,
+                           HintIndex,
+                           BitMapHeader->SizeOfBitMap);
 
     /* Did we start at a hint? */
-    if (HintIndex)
+    if (Position == MAXINDEX && HintIndex)
     {
-        /* Retry at the start */
-        Margin = min(HintIndex + NumberToFind, BitMapHeader->SizeOfBitMap);
-        HintIndex = 0;
-        goto retry;
+        /* Retry at the start, up to runs that begin before the hint */
+        Position = RtlpFindRun(BitMapHeader,
+                               MAXINDEX,
+                               NumberToFind,
+                               0,
+                               min(HintIndex + NumberToFind - 1,
+                                   BitMapHeader->SizeOfBitMap));
     }
 
-    /* Nothing found */
-    return MAXINDEX;
+    return Position;
 }
 
 BITMAP_INDEX
@@ -811,75 +1016,12 @@ RtlFindClearRuns(
     _In_ ULONG SizeOfRunArray,
     _In_ BOOLEAN LocateLongestRuns)
 {
-    BITMAP_INDEX StartingIndex, NumberOfBits, FromIndex = 0, SmallestRun = 0;
-    ULONG Run;
-
-    /* Loop the runs */
-    for (Run = 0; Run < SizeOfRunArray; Run++)
-    {
-        /* Look for a run */
-        NumberOfBits = RtlFindNextForwardRunClear(BitMapHeader,
-                                                  FromIndex,
-                                                  &StartingIndex);
-
-        /* Nothing more found? Quit looping. */
-        if (NumberOfBits == 0) break;
-
-        /* Add another run */
-        RunArray[Run].StartingIndex = StartingIndex;
-        RunArray[Run].NumberOfBits = NumberOfBits;
-
-        /* Update smallest run */
-        if (NumberOfBits < RunArray[SmallestRun].NumberOfBits)
-        {
-            SmallestRun = Run;
-        }
-
-        /* Advance bits */
-        FromIndex = StartingIndex + NumberOfBits;
-    }
-
-    /* Check if we are finished */
-    if (Run < SizeOfRunArray || !LocateLongestRuns)
-    {
-        /* Return the number of found runs */
-        return Run;
-    }
-
-    while (1)
-    {
-        /* Look for a run */
-        NumberOfBits = RtlFindNextForwardRunClear(BitMapHeader,
-                                                  FromIndex,
-                                                  &StartingIndex);
-
-        /* Nothing more found? Quit looping. */
-        if (NumberOfBits == 0) break;
-
-        /* Check if we have something to update */
-        if (NumberOfBits > RunArray[SmallestRun].NumberOfBits)
-        {
-            /* Update smallest run */
-            RunArray[SmallestRun].StartingIndex = StartingIndex;
-            RunArray[SmallestRun].NumberOfBits = NumberOfBits;
-
-            /* Loop all runs */
-            for (Run = 0; Run < SizeOfRunArray; Run++)
-            {
-                /*Is this the new smallest run? */
-                if (NumberOfBits < RunArray[SmallestRun].NumberOfBits)
-                {
-                    /* Set it as new smallest run */
-                    SmallestRun = Run;
-                }
-            }
-        }
-
-        /* Advance bits */
-        FromIndex += NumberOfBits;
-    }
-
-    return Run;
+    /* Collect the clear runs */
+    return RtlpFindRuns(BitMapHeader,
+                        0,
+                        RunArray,
+                        SizeOfRunArray,
+                        LocateLongestRuns);
 }
 
 BITMAP_INDEX
@@ -888,31 +1030,17 @@ RtlFindLongestRunClear(
     IN PRTL_BITMAP BitMapHeader,
     IN PBITMAP_INDEX StartingIndex)
 {
-    BITMAP_INDEX NumberOfBits, Index, MaxNumberOfBits = 0, FromIndex = 0;
+    RTL_BITMAP_RUN Run;
 
-    while (1)
+    /* Look for the longest run */
+    if (RtlpFindRuns(BitMapHeader, 0, &Run, 1, TRUE) == 0)
     {
-        /* Look for a run */
-        NumberOfBits = RtlFindNextForwardRunClear(BitMapHeader,
-                                                  FromIndex,
-                                                  &Index);
-
-        /* Nothing more found? Quit looping. */
-        if (NumberOfBits == 0) break;
-
-        /* Was that the longest run? */
-        if (NumberOfBits > MaxNumberOfBits)
-        {
-            /* Update values */
-            MaxNumberOfBits = NumberOfBits;
-            *StartingIndex = Index;
-        }
-
-        /* Advance bits */
-        FromIndex += NumberOfBits;
+        /* Nothing found */
+        return 0;
     }
 
-    return MaxNumberOfBits;
+    *StartingIndex = Run.StartingIndex;
+    return Run.NumberOfBits;
 }
 
 BITMAP_INDEX
@@ -921,30 +1049,16 @@ RtlFindLongestRunSet(
     IN PRTL_BITMAP BitMapHeader,
     IN PBITMAP_INDEX StartingIndex)
 {
-    BITMAP_INDEX NumberOfBits, Index, MaxNumberOfBits = 0, FromIndex = 0;
+    RTL_BITMAP_RUN Run;
 
-    while (1)
+    /* Look for the longest run */
+    if (RtlpFindRuns(BitMapHeader, MAXINDEX, &Run, 1, TRUE) == 0)
     {
-        /* Look for a run */
-        NumberOfBits = RtlFindNextForwardRunSet(BitMapHeader,
-                                                FromIndex,
-                                                &Index);
-
-        /* Nothing more found? Quit looping. */
-        if (NumberOfBits == 0) break;
-
-        /* Was that the longest run? */
-        if (NumberOfBits > MaxNumberOfBits)
-        {
-            /* Update values */
-            MaxNumberOfBits = NumberOfBits;
-            *StartingIndex = Index;
-        }
-
-        /* Advance bits */
-        FromIndex += NumberOfBits;
+        /* Nothing found */
+        return 0;
     }
 
-    return MaxNumberOfBits;
+    *StartingIndex = Run.StartingIndex;
+    return Run.NumberOfBits;
 }
 
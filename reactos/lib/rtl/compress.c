@@ -17,12 +17,292 @@
 #define COMPRESSION_FORMAT_MASK  0x00FF
 #define COMPRESSION_ENGINE_MASK  0xFF00
 
-
+/* An LZNT1 buffer is a list of chunks, each of which holds up to 4KB of
+   uncompressed data and starts with a 16 bit header. The header stores the
+   size of the chunk minus 3, a signature and whether the chunk is compressed.
+   A header of 0 ends the list. */
+#define LZNT1_CHUNK_SIZE          0x1000
+#define LZNT1_CHUNK_SHIFT         12
+#define LZNT1_HEADER_SIZE         sizeof(USHORT)
+#define LZNT1_HEADER_SIZE_MASK    0x0FFF
+#define LZNT1_HEADER_SIGNATURE    0x3000
+#define LZNT1_HEADER_SIG_MASK     0x7000
+#define LZNT1_HEADER_COMPRESSED   0x8000
+
+/* Inside a compressed chunk, every group of eight tokens is preceded by a
+   flag byte telling literals (0) from matches (1). A match is a 16 bit
+   token holding the displacement and the length; the closer to the start
+   of the chunk, the fewer bits the displacement needs and the more are
+   left for the length. */
+#define LZNT1_MIN_MATCH           3
+#define LZNT1_MIN_OFFSET_SPAN     0x10
+#define LZNT1_MAX_LENGTH_MASK     0x0FFF
+
+#define LZNT1_HASH_BITS           12
+#define LZNT1_HASH_SIZE           (1 << LZNT1_HASH_BITS)
+
+/* How many earlier occurrences the match finder looks at */
+#define LZNT1_STANDARD_DEPTH      8
+#define LZNT1_MAXIMUM_DEPTH       LZNT1_CHUNK_SIZE
+
+#define LZNT1_WORKSPACE_SIZE      0x8010
+
+#define RtlpReadHeaderLZNT1(p)    ((USHORT)((p)[0] | ((p)[1] << 8)))
+
+typedef struct _RTLP_LZNT1_WORKSPACE
+{
+   /* Chunk offset + 1 of the last position with a given hash, 0 if none */
+   USHORT HashHead[LZNT1_HASH_SIZE];
+   /* Same for the position before this one with the same hash */
+   USHORT HashChain[LZNT1_CHUNK_SIZE];
+} RTLP_LZNT1_WORKSPACE, *PRTLP_LZNT1_WORKSPACE;
+
+C_ASSERT(sizeof(RTLP_LZNT1_WORKSPACE) <= LZNT1_WORKSPACE_SIZE);
+
+/* A chunk decompressing to 4KB of zeros: a zero literal and a 4095 byte
+   match at displacement 1. RtlReserveChunk and RtlDescribeChunk use it to
+   stand for a chunk size of 0. */
+static const UCHAR RtlpZeroChunkLZNT1[] =
+{
+   0x03, 0xB0, 0x02, 0x00, 0xFC, 0x0F
+};
 
 
 /* FUNCTIONS ****************************************************************/
 
 
+FORCEINLINE
+ULONG
+RtlpHashLZNT1(PUCHAR Data)
+{
+   ULONG Value = ((ULONG)Data[0] << 16) | ((ULONG)Data[1] << 8) | Data[2];
+
+   return((Value * 0x9E3779B1) >> (32 - LZNT1_HASH_BITS));
+}
+
+
+FORCEINLINE
+VOID
+RtlpInsertHashLZNT1(PRTLP_LZNT1_WORKSPACE WorkSpace,
+                    PUCHAR Chunk,
+                    ULONG Position)
+{
+   ULONG Hash = RtlpHashLZNT1(Chunk + Position);
+
+   WorkSpace->HashChain[Position] = WorkSpace->HashHead[Hash];
+   WorkSpace->HashHead[Hash] = (USHORT)(Position + 1);
+}
+
+
+/*
+ * Compresses one chunk, without its header. Returns the size of the
+ * compressed data, or 0 if it doesn't fit into OutputSize bytes.
+ */
+static ULONG
+RtlpCompressChunkLZNT1(PUCHAR Chunk,
+                       ULONG ChunkSize,
+                       PUCHAR Output,
+                       ULONG OutputSize,
+                       ULONG Depth,
+                       PRTLP_LZNT1_WORKSPACE WorkSpace)
+{
+   PUCHAR Out = Output;
+   PUCHAR OutEnd = Output + OutputSize;
+   PUCHAR Flags = NULL;
+   ULONG FlagBit = 8;
+   ULONG Position = 0;
+   ULONG OffsetShift = LZNT1_CHUNK_SHIFT;
+   ULONG MaxOffset = LZNT1_MIN_OFFSET_SPAN;
+   ULONG MaxLength = LZNT1_MAX_LENGTH_MASK + LZNT1_MIN_MATCH;
+   ULONG Limit, Length, BestLength, BestOffset, Candidate, Steps, Token;
+
+   RtlZeroMemory(WorkSpace->HashHead, sizeof(WorkSpace->HashHead));
+
+   while (Position < ChunkSize)
+   {
+      /* Move the displacement/length split once the displacement needs it */
+      while (Position > MaxOffset)
+      {
+         MaxOffset <<= 1;
+         OffsetShift--;
+         MaxLength = (LZNT1_MAX_LENGTH_MASK >> (LZNT1_CHUNK_SHIFT - OffsetShift)) + LZNT1_MIN_MATCH;
+      }
+
+      BestLength = 0;
+      BestOffset = 0;
+
+      if (ChunkSize - Position >= LZNT1_MIN_MATCH)
+      {
+         Limit = min(MaxLength, ChunkSize - Position);
+
+         Candidate = WorkSpace->HashHead[RtlpHashLZNT1(Chunk + Position)];
+         RtlpInsertHashLZNT1(WorkSpace, Chunk, Position);
+
+         /* Walk the chain of earlier positions with the same hash, newest first */
+         for (Steps = Depth; Candidate != 0 && Steps != 0; Steps--)
+         {
+            Candidate--;
+            if (Position - Candidate > MaxOffset)
+               break;
+
+            /* Only a candidate matching the byte after the best match can beat it */
+            if (Chunk[Candidate + BestLength] == Chunk[Position + BestLength])
+            {
+               for (Length = 0;
+                    Length < Limit && Chunk[Candidate + Length] == Chunk[Position + Length];
+                    Length++);
+
+               if (Length > BestLength)
+               {
+                  BestLength = Length;
+                  BestOffset = Position - Candidate;
+                  if (Length == Limit)
+                     break;
+               }
+            }
+
+            Candidate = WorkSpace->HashChain[Candidate];
+         }
+      }
+
+      if (FlagBit == 8)
+      {
+         if (Out == OutEnd)
+            return(0);
+
+         Flags = Out++;
+         *Flags = 0;
+         FlagBit = 0;
+      }
+
+      if (BestLength >= LZNT1_MIN_MATCH)
+      {
+         if (OutEnd - Out < 2)
+            return(0);
+
+         Token = ((BestOffset - 1) << OffsetShift) | (BestLength - LZNT1_MIN_MATCH);
+         *Out++ = (UCHAR)Token;
+         *Out++ = (UCHAR)(Token >> 8);
+         *Flags |= (UCHAR)(1 << FlagBit);
+
+         /* Keep the positions inside the match findable for later ones */
+         for (Length = 1; Length < BestLength; Length++)
+         {
+            if (ChunkSize - (Position + Length) < LZNT1_MIN_MATCH)
+               break;
+            RtlpInsertHashLZNT1(WorkSpace, Chunk, Position + Length);
+         }
+
+         Position += BestLength;
+      }
+      else
+      {
+         if (Out == OutEnd)
+            return(0);
+
+         *Out++ = Chunk[Position++];
+      }
+
+      FlagBit++;
+   }
+
+   return((ULONG)(Out - Output));
+}
+
+
+/*
+ * Decompresses the data of one compressed chunk. Stops early without an
+ * error when the output is full.
+ */
+static NTSTATUS
+RtlpDecompressChunkLZNT1(PUCHAR Output,
+                         ULONG OutputSize,
+                         PUCHAR Input,
+                         ULONG InputSize,
+                         PULONG FinalSize)
+{
+   PUCHAR Out = Output;
+   PUCHAR OutEnd = Output + OutputSize;
+   PUCHAR In = Input;
+   PUCHAR InEnd = Input + InputSize;
+   PUCHAR Match;
+   ULONG OffsetShift = LZNT1_CHUNK_SHIFT;
+   ULONG LengthMask = LZNT1_MAX_LENGTH_MASK;
+   ULONG MaxOffset = LZNT1_MIN_OFFSET_SPAN;
+   ULONG Flags, Bit, Token, Offset, Length, Position, Piece;
+
+   while (In < InEnd && Out < OutEnd)
+   {
+      Flags = *In++;
+
+      /* A group of eight literals is the common case for data which doesn't
+         compress well, copy it in one go */
+      if (Flags == 0 && InEnd - In >= 8 && OutEnd - Out >= 8)
+      {
+         RtlCopyMemory(Out, In, 8);
+         Out += 8;
+         In += 8;
+         continue;
+      }
+
+      for (Bit = 0; Bit < 8 && In < InEnd && Out < OutEnd; Bit++, Flags >>= 1)
+      {
+         if (!(Flags & 1))
+         {
+            *Out++ = *In++;
+            continue;
+         }
+
+         if (InEnd - In < 2)
+            return(STATUS_BAD_COMPRESSION_BUFFER);
+
+         Token = In[0] | (In[1] << 8);
+         In += 2;
+
+         Position = (ULONG)(Out - Output);
+         while (Position > MaxOffset)
+         {
+            MaxOffset <<= 1;
+            OffsetShift--;
+            LengthMask >>= 1;
+         }
+
+         Offset = (Token >> OffsetShift) + 1;
+         Length = (Token & LengthMask) + LZNT1_MIN_MATCH;
+
+         if (Offset > Position)
+            return(STATUS_BAD_COMPRESSION_BUFFER);
+
+         if (Length > (ULONG)(OutEnd - Out))
+            Length = (ULONG)(OutEnd - Out);
+
+         /* Most matches are short, copy those inline. Longer ones are
+            copied in pieces which don't overlap their source; for a match
+            repeating the last Offset bytes, the piece size doubles. */
+         Match = Out - Offset;
+         if (Length < 32)
+         {
+            while (Length--)
+               *Out++ = *Match++;
+         }
+         else
+         {
+            while (Length != 0)
+            {
+               Piece = min(Length, (ULONG)(Out - Match));
+               RtlCopyMemory(Out, Match, Piece);
+               Out += Piece;
+               Length -= Piece;
+            }
+         }
+      }
+   }
+
+   *FinalSize = (ULONG)(Out - Output);
+   return(STATUS_SUCCESS);
+}
+
+
 static NTSTATUS
 RtlpCompressBufferLZNT1(USHORT Engine,
                         PUCHAR UncompressedBuffer,
@@ -33,7 +313,217 @@ RtlpCompressBufferLZNT1(USHORT Engine,
                         PULONG FinalCompressedSize,
                         PVOID WorkSpace)
 {
-   return(STATUS_NOT_IMPLEMENTED);
+   PUCHAR In = UncompressedBuffer;
+   PUCHAR InEnd = UncompressedBuffer + UncompressedBufferSize;
+   PUCHAR Out = CompressedBuffer;
+   PUCHAR OutEnd = CompressedBuffer + CompressedBufferSize;
+   ULONG Depth, ChunkSize, Size, Available;
+   USHORT Header;
+
+   UNREFERENCED_PARAMETER(UncompressedChunkSize);
+
+   if (Engine == COMPRESSION_ENGINE_STANDARD)
+      Depth = LZNT1_STANDARD_DEPTH;
+   else if (Engine == COMPRESSION_ENGINE_MAXIMUM)
+      Depth = LZNT1_MAXIMUM_DEPTH;
+   else
+      return(STATUS_NOT_SUPPORTED);
+
+   for (; In < InEnd; In += ChunkSize)
+   {
+      ChunkSize = (ULONG)min(InEnd - In, LZNT1_CHUNK_SIZE);
+
+      if (OutEnd - Out < (LONG_PTR)LZNT1_HEADER_SIZE)
+         return(STATUS_BUFFER_TOO_SMALL);
+      Available = (ULONG)(OutEnd - Out) - LZNT1_HEADER_SIZE;
+
+      /* A compressed chunk has to be smaller than a stored one, so that
+         the chunk size tells the two apart */
+      Size = 0;
+      if (ChunkSize > LZNT1_MIN_MATCH)
+      {
+         Size = RtlpCompressChunkLZNT1(In,
+                                       ChunkSize,
+                                       Out + LZNT1_HEADER_SIZE,
+                                       min(Available, ChunkSize - LZNT1_MIN_MATCH),
+                                       Depth,
+                                       WorkSpace);
+      }
+
+      if (Size != 0)
+      {
+         Header = LZNT1_HEADER_COMPRESSED | LZNT1_HEADER_SIGNATURE |
+                  (USHORT)(Size + LZNT1_HEADER_SIZE - 3);
+      }
+      else
+      {
+         if (Available < ChunkSize)
+            return(STATUS_BUFFER_TOO_SMALL);
+
+         RtlCopyMemory(Out + LZNT1_HEADER_SIZE, In, ChunkSize);
+         Size = ChunkSize;
+         Header = LZNT1_HEADER_SIGNATURE | (USHORT)(Size + LZNT1_HEADER_SIZE - 3);
+      }
+
+      Out[0] = (UCHAR)Header;
+      Out[1] = (UCHAR)(Header >> 8);
+      Out += LZNT1_HEADER_SIZE + Size;
+   }
+
+   /* Terminate the chunk list if there is room, it doesn't count in the size */
+   if (OutEnd - Out >= (LONG_PTR)LZNT1_HEADER_SIZE)
+   {
+      Out[0] = 0;
+      Out[1] = 0;
+   }
+
+   *FinalCompressedSize = (ULONG)(Out - CompressedBuffer);
+   return(STATUS_SUCCESS);
+}
+
+
+static NTSTATUS
+RtlpDecompressBufferLZNT1(PUCHAR UncompressedBuffer,
+                          ULONG UncompressedBufferSize,
+                          PUCHAR CompressedBuffer,
+                          ULONG CompressedBufferSize,
+                          PULONG FinalUncompressedSize)
+{
+   PUCHAR In = CompressedBuffer;
+   PUCHAR InEnd = CompressedBuffer + CompressedBufferSize;
+   PUCHAR Out = UncompressedBuffer;
+   PUCHAR OutEnd = UncompressedBuffer + UncompressedBufferSize;
+   ULONG ChunkSize, Room, Written;
+   NTSTATUS Status;
+   USHORT Header;
+
+   while (InEnd - In >= (LONG_PTR)LZNT1_HEADER_SIZE && Out < OutEnd)
+   {
+      Header = RtlpReadHeaderLZNT1(In);
+      if (Header == 0)
+         break;
+
+      if ((Header & LZNT1_HEADER_SIG_MASK) != LZNT1_HEADER_SIGNATURE)
+         return(STATUS_BAD_COMPRESSION_BUFFER);
+
+      In += LZNT1_HEADER_SIZE;
+      ChunkSize = (Header & LZNT1_HEADER_SIZE_MASK) + 3 - LZNT1_HEADER_SIZE;
+      if (ChunkSize > (ULONG)(InEnd - In))
+         return(STATUS_BAD_COMPRESSION_BUFFER);
+
+      Room = (ULONG)min(OutEnd - Out, LZNT1_CHUNK_SIZE);
+      if (Header & LZNT1_HEADER_COMPRESSED)
+      {
+         Status = RtlpDecompressChunkLZNT1(Out, Room, In, ChunkSize, &Written);
+         if (!NT_SUCCESS(Status))
+            return(Status);
+      }
+      else
+      {
+         Written = min(ChunkSize, Room);
+         RtlCopyMemory(Out, In, Written);
+      }
+
+      In += ChunkSize;
+      Out += Written;
+
+      /* A short chunk followed by another one stands for a full chunk
+         ending in zeros */
+      if (Written < LZNT1_CHUNK_SIZE &&
+          Out < OutEnd &&
+          InEnd - In >= (LONG_PTR)LZNT1_HEADER_SIZE &&
+          RtlpReadHeaderLZNT1(In) != 0)
+      {
+         Room = (ULONG)min(OutEnd - Out, LZNT1_CHUNK_SIZE - Written);
+         RtlZeroMemory(Out, Room);
+         Out += Room;
+      }
+   }
+
+   *FinalUncompressedSize = (ULONG)(Out - UncompressedBuffer);
+   return(STATUS_SUCCESS);
+}
+
+
+static NTSTATUS
+RtlpDecompressFragmentLZNT1(PUCHAR UncompressedFragment,
+                            ULONG UncompressedFragmentSize,
+                            PUCHAR CompressedBuffer,
+                            ULONG CompressedBufferSize,
+                            ULONG FragmentOffset,
+                            PULONG FinalUncompressedSize,
+                            PUCHAR WorkSpace)
+{
+   PUCHAR In = CompressedBuffer;
+   PUCHAR InEnd = CompressedBuffer + CompressedBufferSize;
+   ULONG ChunkSize, Written, Copied = 0;
+   NTSTATUS Status;
+   USHORT Header;
+
+   *FinalUncompressedSize = 0;
+
+   /* Chunks before the fragment are skipped without decompressing them */
+   while (1)
+   {
+      if (InEnd - In < (LONG_PTR)LZNT1_HEADER_SIZE)
+         return(STATUS_SUCCESS);
+
+      Header = RtlpReadHeaderLZNT1(In);
+      if (Header == 0)
+         return(STATUS_SUCCESS);
+
+      if ((Header & LZNT1_HEADER_SIG_MASK) != LZNT1_HEADER_SIGNATURE)
+         return(STATUS_BAD_COMPRESSION_BUFFER);
+
+      ChunkSize = (Header & LZNT1_HEADER_SIZE_MASK) + 3;
+      if (ChunkSize > (ULONG)(InEnd - In))
+         return(STATUS_BAD_COMPRESSION_BUFFER);
+
+      if (FragmentOffset < LZNT1_CHUNK_SIZE)
+         break;
+
+      In += ChunkSize;
+      FragmentOffset -= LZNT1_CHUNK_SIZE;
+   }
+
+   if (FragmentOffset != 0)
+   {
+      /* The fragment starts inside this chunk. Decompress all of it into
+         the work space and take the part we were asked for. */
+      Status = RtlpDecompressBufferLZNT1(WorkSpace,
+                                         LZNT1_CHUNK_SIZE,
+                                         In,
+                                         (ULONG)(InEnd - In),
+                                         &Written);
+      if (!NT_SUCCESS(Status))
+         return(Status);
+
+      if (Written <= FragmentOffset)
+         return(STATUS_SUCCESS);
+
+      Copied = min(Written - FragmentOffset, UncompressedFragmentSize);
+      RtlCopyMemory(UncompressedFragment, WorkSpace + FragmentOffset, Copied);
+
+      /* A short chunk is the last one */
+      if (Written < LZNT1_CHUNK_SIZE)
+      {
+         *FinalUncompressedSize = Copied;
+         return(STATUS_SUCCESS);
+      }
+
+      In += ChunkSize;
+   }
+
+   Status = RtlpDecompressBufferLZNT1(UncompressedFragment + Copied,
+                                      UncompressedFragmentSize - Copied,
+                                      In,
+                                      (ULONG)(InEnd - In),
+                                      &Written);
+   if (!NT_SUCCESS(Status))
+      return(Status);
+
+   *FinalUncompressedSize = Copied + Written;
+   return(STATUS_SUCCESS);
 }
 
 
@@ -44,13 +534,14 @@ RtlpWorkSpaceSizeLZNT1(USHORT Engine,
 {
    if (Engine == COMPRESSION_ENGINE_STANDARD)
    {
-      *BufferAndWorkSpaceSize = 0x8010;
+      *BufferAndWorkSpaceSize = LZNT1_WORKSPACE_SIZE;
       *FragmentWorkSpaceSize = 0x1000;
       return(STATUS_SUCCESS);
    }
    else if (Engine == COMPRESSION_ENGINE_MAXIMUM)
    {
-      *BufferAndWorkSpaceSize = 0x10;
+      /* The deeper search works on the same hash chains */
+      *BufferAndWorkSpaceSize = LZNT1_WORKSPACE_SIZE;
       *FragmentWorkSpaceSize = 0x1000;
       return(STATUS_SUCCESS);
    }
@@ -94,7 +585,7 @@ RtlCompressBuffer(IN USHORT CompressionFormatAndEngine,
 
 
 /*
- * @unimplemented
+ * @implemented
  */
 NTSTATUS NTAPI
 RtlCompressChunks(IN PUCHAR UncompressedBuffer,
@@ -105,12 +596,73 @@ RtlCompressChunks(IN PUCHAR UncompressedBuffer,
                   IN ULONG CompressedDataInfoLength,
                   IN PVOID WorkSpace)
 {
-   return(STATUS_NOT_IMPLEMENTED);
+   USHORT Format = CompressedDataInfo->CompressionFormatAndEngine & COMPRESSION_FORMAT_MASK;
+   PUCHAR In = UncompressedBuffer;
+   PUCHAR Out = CompressedBuffer;
+   PUCHAR OutEnd = CompressedBuffer + CompressedBufferSize;
+   ULONG NumberOfChunks, Chunk, ChunkSize, Size, i;
+   NTSTATUS Status;
+
+   if ((Format == COMPRESSION_FORMAT_NONE) ||
+         (Format == COMPRESSION_FORMAT_DEFAULT))
+      return(STATUS_INVALID_PARAMETER);
+
+   if (Format != COMPRESSION_FORMAT_LZNT1)
+      return(STATUS_UNSUPPORTED_COMPRESSION);
+
+   if (CompressedDataInfo->ChunkShift != LZNT1_CHUNK_SHIFT)
+      return(STATUS_INVALID_PARAMETER);
+
+   NumberOfChunks = (UncompressedBufferSize + LZNT1_CHUNK_SIZE - 1) >> LZNT1_CHUNK_SHIFT;
+   if (CompressedDataInfoLength < (ULONG)FIELD_OFFSET(COMPRESSED_DATA_INFO, CompressedChunkSizes) +
+                                  NumberOfChunks * sizeof(ULONG))
+      return(STATUS_BUFFER_TOO_SMALL);
+
+   /* Every chunk is compressed on its own. A size of 0 stands for a chunk
+      of zeros, a size of a whole chunk for one which is stored as is. */
+   for (Chunk = 0; Chunk < NumberOfChunks; Chunk++, In += ChunkSize)
+   {
+      ChunkSize = min(UncompressedBufferSize - (ULONG)(In - UncompressedBuffer), LZNT1_CHUNK_SIZE);
+
+      for (i = 0; i < ChunkSize && In[i] == 0; i++);
+      if (i == ChunkSize)
+      {
+         CompressedDataInfo->CompressedChunkSizes[Chunk] = 0;
+         continue;
+      }
+
+      Status = RtlpCompressBufferLZNT1(CompressedDataInfo->CompressionFormatAndEngine & COMPRESSION_ENGINE_MASK,
+                                       In,
+                                       ChunkSize,
+                                       Out,
+                                       (ULONG)min(OutEnd - Out, LZNT1_CHUNK_SIZE - 1),
+                                       LZNT1_CHUNK_SIZE,
+                                       &Size,
+                                       WorkSpace);
+      if (Status == STATUS_NOT_SUPPORTED)
+         return(Status);
+
+      if (!NT_SUCCESS(Status))
+      {
+         if (OutEnd - Out < LZNT1_CHUNK_SIZE)
+            return(STATUS_BUFFER_TOO_SMALL);
+
+         RtlCopyMemory(Out, In, ChunkSize);
+         RtlZeroMemory(Out + ChunkSize, LZNT1_CHUNK_SIZE - ChunkSize);
+         Size = LZNT1_CHUNK_SIZE;
+      }
+
+      CompressedDataInfo->CompressedChunkSizes[Chunk] = Size;
+      Out += Size;
+   }
+
+   CompressedDataInfo->NumberOfChunks = (USHORT)NumberOfChunks;
+   return(STATUS_SUCCESS);
 }
 
 
 /*
- * @unimplemented
+ * @implemented
  */
 NTSTATUS NTAPI
 RtlDecompressBuffer(IN USHORT CompressionFormat,
@@ -120,12 +672,25 @@ RtlDecompressBuffer(IN USHORT CompressionFormat,
                     IN ULONG CompressedBufferSize,
                     OUT PULONG FinalUncompressedSize)
 {
-   return(STATUS_NOT_IMPLEMENTED);
+   USHORT Format = CompressionFormat & COMPRESSION_FORMAT_MASK;
+
+   if ((Format == COMPRESSION_FORMAT_NONE) ||
+         (Format == COMPRESSION_FORMAT_DEFAULT))
+      return(STATUS_INVALID_PARAMETER);
+
+   if (Format == COMPRESSION_FORMAT_LZNT1)
+      return(RtlpDecompressBufferLZNT1(UncompressedBuffer,
+                                       UncompressedBufferSize,
+                                       CompressedBuffer,
+                                       CompressedBufferSize,
+                                       FinalUncompressedSize));
+
+   return(STATUS_UNSUPPORTED_COMPRESSION);
 }
 
 
 /*
- * @unimplemented
+ * @implemented
  */
 NTSTATUS NTAPI
 RtlDecompressChunks(OUT PUCHAR UncompressedBuffer,
@@ -136,12 +701,71 @@ RtlDecompressChunks(OUT PUCHAR UncompressedBuffer,
                     IN ULONG CompressedTailSize,
                     IN PCOMPRESSED_DATA_INFO CompressedDataInfo)
 {
-   return(STATUS_NOT_IMPLEMENTED);
+   USHORT Format = CompressedDataInfo->CompressionFormatAndEngine & COMPRESSION_FORMAT_MASK;
+   PUCHAR In = CompressedBuffer;
+   PUCHAR InEnd = CompressedBuffer + CompressedBufferSize;
+   PUCHAR Out = UncompressedBuffer;
+   PUCHAR OutEnd = UncompressedBuffer + UncompressedBufferSize;
+   BOOLEAN InTail = FALSE;
+   ULONG Chunk, Size, Room, Written;
+   NTSTATUS Status;
+
+   if ((Format == COMPRESSION_FORMAT_NONE) ||
+         (Format == COMPRESSION_FORMAT_DEFAULT))
+      return(STATUS_INVALID_PARAMETER);
+
+   if (Format != COMPRESSION_FORMAT_LZNT1)
+      return(STATUS_UNSUPPORTED_COMPRESSION);
+
+   if (CompressedDataInfo->ChunkShift != LZNT1_CHUNK_SHIFT)
+      return(STATUS_INVALID_PARAMETER);
+
+   for (Chunk = 0; Chunk < CompressedDataInfo->NumberOfChunks && Out < OutEnd; Chunk++)
+   {
+      Size = CompressedDataInfo->CompressedChunkSizes[Chunk];
+      Room = (ULONG)min(OutEnd - Out, LZNT1_CHUNK_SIZE);
+
+      /* The chunks which don't fit into the buffer come from the tail */
+      if (Size > (ULONG)(InEnd - In))
+      {
+         if (InTail)
+            return(STATUS_BAD_COMPRESSION_BUFFER);
+
+         In = CompressedTail;
+         InEnd = CompressedTail + CompressedTailSize;
+         InTail = TRUE;
+
+         if (Size > CompressedTailSize)
+            return(STATUS_BAD_COMPRESSION_BUFFER);
+      }
+
+      if (Size == 0)
+      {
+         RtlZeroMemory(Out, Room);
+      }
+      else if (Size == LZNT1_CHUNK_SIZE)
+      {
+         RtlCopyMemory(Out, In, Room);
+      }
+      else
+      {
+         Status = RtlpDecompressBufferLZNT1(Out, Room, In, Size, &Written);
+         if (!NT_SUCCESS(Status))
+            return(Status);
+
+         RtlZeroMemory(Out + Written, Room - Written);
+      }
+
+      In += Size;
+      Out += Room;
+   }
+
+   return(STATUS_SUCCESS);
 }
 
 
 /*
- * @unimplemented
+ * @implemented
  */
 NTSTATUS NTAPI
 RtlDecompressFragment(IN USHORT CompressionFormat,
@@ -153,12 +777,27 @@ RtlDecompressFragment(IN USHORT CompressionFormat,
                       OUT PULONG FinalUncompressedSize,
                       IN PVOID WorkSpace)
 {
-   return(STATUS_NOT_IMPLEMENTED);
+   USHORT Format = CompressionFormat & COMPRESSION_FORMAT_MASK;
+
+   if ((Format == COMPRESSION_FORMAT_NONE) ||
+         (Format == COMPRESSION_FORMAT_DEFAULT))
+      return(STATUS_INVALID_PARAMETER);
+
+   if (Format == COMPRESSION_FORMAT_LZNT1)
+      return(RtlpDecompressFragmentLZNT1(UncompressedFragment,
+                                         UncompressedFragmentSize,
+                                         CompressedBuffer,
+                                         CompressedBufferSize,
+                                         FragmentOffset,
+                                         FinalUncompressedSize,
+                                         WorkSpace));
+
+   return(STATUS_UNSUPPORTED_COMPRESSION);
 }
 
 
 /*
- * @unimplemented
+ * @implemented
  */
 NTSTATUS NTAPI
 RtlDescribeChunk(IN USHORT CompressionFormat,
@@ -167,12 +806,60 @@ RtlDescribeChunk(IN USHORT CompressionFormat,
                  OUT PUCHAR *ChunkBuffer,
                  OUT PULONG ChunkSize)
 {
-   return(STATUS_NOT_IMPLEMENTED);
+   USHORT Format = CompressionFormat & COMPRESSION_FORMAT_MASK;
+   PUCHAR Chunk = *CompressedBuffer;
+   ULONG Size;
+   USHORT Header;
+
+   if ((Format == COMPRESSION_FORMAT_NONE) ||
+         (Format == COMPRESSION_FORMAT_DEFAULT))
+      return(STATUS_INVALID_PARAMETER);
+
+   if (Format != COMPRESSION_FORMAT_LZNT1)
+      return(STATUS_UNSUPPORTED_COMPRESSION);
+
+   *ChunkBuffer = Chunk;
+   *ChunkSize = 0;
+
+   if (EndOfCompressedBufferPlus1 - Chunk < (LONG_PTR)LZNT1_HEADER_SIZE)
+      return(STATUS_NO_MORE_ENTRIES);
+
+   Header = RtlpReadHeaderLZNT1(Chunk);
+   if (Header == 0)
+      return(STATUS_NO_MORE_ENTRIES);
+
+   if ((Header & LZNT1_HEADER_SIG_MASK) != LZNT1_HEADER_SIGNATURE)
+      return(STATUS_BAD_COMPRESSION_BUFFER);
+
+   Size = (Header & LZNT1_HEADER_SIZE_MASK) + 3;
+   if (Size > (ULONG)(EndOfCompressedBufferPlus1 - Chunk))
+      return(STATUS_BAD_COMPRESSION_BUFFER);
+
+   *CompressedBuffer = Chunk + Size;
+
+   /* Same conventions as RtlReserveChunk: a size of 0 is a chunk of zeros
+      and a size of a whole chunk points at the stored data */
+   if (Size == sizeof(RtlpZeroChunkLZNT1) &&
+       RtlCompareMemory(Chunk, RtlpZeroChunkLZNT1, Size) == Size)
+   {
+      return(STATUS_SUCCESS);
+   }
+
+   if (!(Header & LZNT1_HEADER_COMPRESSED) &&
+       Size == LZNT1_HEADER_SIZE + LZNT1_CHUNK_SIZE)
+   {
+      *ChunkBuffer = Chunk + LZNT1_HEADER_SIZE;
+      *ChunkSize = LZNT1_CHUNK_SIZE;
+      return(STATUS_SUCCESS);
+   }
+
+   *ChunkSize = Size;
+   return(STATUS_SUCCESS);
 }
 
 
 /*
- * @unimplemented
+ * @implemented
  */
 NTSTATUS NTAPI
 RtlGetCompressionWorkSpaceSize(IN USHORT CompressionFormatAndEngine,
@@ -197,7 +884,7 @@ RtlGetCompressionWorkSpaceSize(IN USHORT CompressionFormatAndEngine,
 
 
 /*
- * @unimplemented
+ * @implemented
  */
 NTSTATUS NTAPI
 RtlReserveChunk(IN USHORT CompressionFormat,
@@ -206,7 +893,45 @@ RtlReserveChunk(IN USHORT CompressionFormat,
                 OUT PUCHAR *ChunkBuffer,
                 IN ULONG ChunkSize)
 {
-   return(STATUS_NOT_IMPLEMENTED);
+   USHORT Format = CompressionFormat & COMPRESSION_FORMAT_MASK;
+   PUCHAR Chunk = *CompressedBuffer;
+   ULONG Size;
+
+   if ((Format == COMPRESSION_FORMAT_NONE) ||
+         (Format == COMPRESSION_FORMAT_DEFAULT))
+      return(STATUS_INVALID_PARAMETER);
+
+   if (Format != COMPRESSION_FORMAT_LZNT1)
+      return(STATUS_UNSUPPORTED_COMPRESSION);
+
+   if (ChunkSize == 0)
+      Size = sizeof(RtlpZeroChunkLZNT1);
+   else if (ChunkSize == LZNT1_CHUNK_SIZE)
+      Size = LZNT1_HEADER_SIZE + LZNT1_CHUNK_SIZE;
+   else if (ChunkSize <= LZNT1_HEADER_SIZE + LZNT1_CHUNK_SIZE)
+      Size = ChunkSize;
+   else
+      return(STATUS_INVALID_PARAMETER);
+
+   if (Size > (ULONG)(EndOfCompressedBufferPlus1 - Chunk))
+      return(STATUS_BUFFER_TOO_SMALL);
+
+   *ChunkBuffer = Chunk;
+
+   if (ChunkSize == 0)
+   {
+      RtlCopyMemory(Chunk, RtlpZeroChunkLZNT1, Size);
+   }
+   else if (ChunkSize == LZNT1_CHUNK_SIZE)
+   {
+      /* The caller copies the data behind a stored chunk header */
+      Chunk[0] = (UCHAR)(LZNT1_HEADER_SIGNATURE | (Size - 3));
+      Chunk[1] = (UCHAR)((LZNT1_HEADER_SIGNATURE | (Size - 3)) >> 8);
+      *ChunkBuffer = Chunk + LZNT1_HEADER_SIZE;
+   }
+
+   *CompressedBuffer = Chunk + Size;
+   return(STATUS_SUCCESS);
 }
 
 /* EOF */
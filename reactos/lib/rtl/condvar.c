@@ -3,6 +3,12 @@
  * PROJECT:           ReactOS system libraries
  * PURPOSE:           Condition Variable Routines
  * PROGRAMMER:        Thomas Weidenmueller <w3seek@reactos.com>
+ *
+ * NOTES:             Waiters are kept in a list of wait blocks on their
+ *                    stacks, the head of which is stored in the condition
+ *                    variable itself. Blocking and waking is done with the
+ *                    global keyed event, using the wait block address as
+ *                    the key, so no per condition variable handle is needed.
  */
 
 /* INCLUDES *****************************************************************/
@@ -14,6 +20,144 @@
 
 /* FUNCTIONS *****************************************************************/
 
+#ifdef _WIN64
+#define InterlockedAndPointer(ptr,val) InterlockedAnd64((PLONGLONG)ptr,(LONGLONG)val)
+#define InterlockedOrPointer(ptr,val) InterlockedOr64((PLONGLONG)ptr,(LONGLONG)val)
+#else
+#define InterlockedAndPointer(ptr,val) InterlockedAnd((PLONG)ptr,(LONG)val)
+#define InterlockedOrPointer(ptr,val) InterlockedOr((PLONG)ptr,(LONG)val)
+#endif
+
+/* The lowest bit of the pointer protects unlinking wait blocks. Adding a wait
+   block only touches the head and is done without it. */
+#define RTL_CONDVAR_LOCK_BIT    0
+#define RTL_CONDVAR_LOCK    (1 << RTL_CONDVAR_LOCK_BIT)
+#define RTL_CONDVAR_MASK    RTL_CONDVAR_LOCK
+
+typedef struct _RTLP_CONDVAR_WAITBLOCK
+{
+    /* Next points to the wait block which was added before this one */
+    volatile struct _RTLP_CONDVAR_WAITBLOCK *Next;
+} volatile RTLP_CONDVAR_WAITBLOCK, *PRTLP_CONDVAR_WAITBLOCK;
+
+
+static VOID
+NTAPI
+RtlpAcquireWaitListLock(IN OUT PRTL_CONDITION_VARIABLE ConditionVariable)
+{
+    while (InterlockedOrPointer(&ConditionVariable->Ptr,
+                                RTL_CONDVAR_LOCK) & RTL_CONDVAR_LOCK)
+    {
+        YieldProcessor();
+    }
+}
+
+
+static VOID
+NTAPI
+RtlpReleaseWaitListLock(IN OUT PRTL_CONDITION_VARIABLE ConditionVariable)
+{
+    InterlockedAndPointer(&ConditionVariable->Ptr,
+                          ~RTL_CONDVAR_LOCK);
+}
+
+
+static VOID
+NTAPI
+RtlpInsertWaitBlock(IN OUT PRTL_CONDITION_VARIABLE ConditionVariable,
+                    IN PRTLP_CONDVAR_WAITBLOCK WaitBlock)
+{
+    LONG_PTR CurrentValue, NewValue;
+
+    do
+    {
+        CurrentValue = (LONG_PTR)ConditionVariable->Ptr;
+
+        /* Push the wait block, keeping the lock bit as it is */
+        WaitBlock->Next = (PRTLP_CONDVAR_WAITBLOCK)(CurrentValue & ~RTL_CONDVAR_MASK);
+        NewValue = (LONG_PTR)WaitBlock | (CurrentValue & RTL_CONDVAR_MASK);
+    }
+    while (InterlockedCompareExchangePointer(&ConditionVariable->Ptr,
+                                             (PVOID)NewValue,
+                                             (PVOID)CurrentValue) != (PVOID)CurrentValue);
+}
+
+
+static BOOLEAN
+NTAPI
+RtlpRemoveWaitBlock(IN OUT PRTL_CONDITION_VARIABLE ConditionVariable,
+                    IN PRTLP_CONDVAR_WAITBLOCK WaitBlock)
+{
+    LONG_PTR CurrentValue;
+    PRTLP_CONDVAR_WAITBLOCK Current;
+
+    /* NOTE: The caller holds the wait list lock */
+
+    while (1)
+    {
+        CurrentValue = (LONG_PTR)ConditionVariable->Ptr;
+        ASSERT(CurrentValue & RTL_CONDVAR_LOCK);
+
+        Current = (PRTLP_CONDVAR_WAITBLOCK)(CurrentValue & ~RTL_CONDVAR_MASK);
+        if (Current != WaitBlock)
+            break;
+
+        /* It's the head, which concurrent waiters may be changing as well */
+        if (InterlockedCompareExchangePointer(&ConditionVariable->Ptr,
+                                              (PVOID)((LONG_PTR)WaitBlock->Next | RTL_CONDVAR_LOCK),
+                                              (PVOID)CurrentValue) == (PVOID)CurrentValue)
+        {
+            return TRUE;
+        }
+    }
+
+    /* Further down the chain only the lock owner changes the links */
+    while (Current != NULL)
+    {
+        if (Current->Next == WaitBlock)
+        {
+            Current->Next = WaitBlock->Next;
+            return TRUE;
+        }
+
+        Current = Current->Next;
+    }
+
+    /* Someone woke it up already */
+    return FALSE;
+}
+
+
+static NTSTATUS
+NTAPI
+RtlpWaitForWake(IN OUT PRTL_CONDITION_VARIABLE ConditionVariable,
+                IN PRTLP_CONDVAR_WAITBLOCK WaitBlock,
+                IN PLARGE_INTEGER TimeOut  OPTIONAL)
+{
+    NTSTATUS Status;
+    BOOLEAN Removed;
+
+    Status = NtWaitForKeyedEvent(NULL, (PVOID)WaitBlock, FALSE, TimeOut);
+    if (Status != STATUS_SUCCESS)
+    {
+        /* Take the wait block off the list, unless a waker got to it first */
+        RtlpAcquireWaitListLock(ConditionVariable);
+        Removed = RtlpRemoveWaitBlock(ConditionVariable, WaitBlock);
+        RtlpReleaseWaitListLock(ConditionVariable);
+
+        if (!Removed)
+        {
+            /* The waker is going to release this key, it must not be left
+               waiting for us. We've been woken up after all. */
+            NtWaitForKeyedEvent(NULL, (PVOID)WaitBlock, FALSE, NULL);
+            Status = STATUS_SUCCESS;
+        }
+    }
+
+    return Status;
+}
+
+
 VOID
 NTAPI
 RtlInitializeConditionVariable(OUT PRTL_CONDITION_VARIABLE ConditionVariable)
@@ -26,7 +170,28 @@ VOID
 NTAPI
 RtlWakeConditionVariable(IN OUT PRTL_CONDITION_VARIABLE ConditionVariable)
 {
-    UNIMPLEMENTED;
+    PRTLP_CONDVAR_WAITBLOCK WaitBlock;
+
+    /* Nothing to do if there are no waiters */
+    if (((LONG_PTR)ConditionVariable->Ptr & ~RTL_CONDVAR_MASK) == 0)
+        return;
+
+    RtlpAcquireWaitListLock(ConditionVariable);
+
+    /* Wake the oldest waiter, which is the last one in the chain */
+    WaitBlock = (PRTLP_CONDVAR_WAITBLOCK)((LONG_PTR)ConditionVariable->Ptr & ~RTL_CONDVAR_MASK);
+    if (WaitBlock != NULL)
+    {
+        while (WaitBlock->Next != NULL)
+            WaitBlock = WaitBlock->Next;
+
+        RtlpRemoveWaitBlock(ConditionVariable, WaitBlock);
+    }
+
+    RtlpReleaseWaitListLock(ConditionVariable);
+
+    if (WaitBlock != NULL)
+        NtReleaseKeyedEvent(NULL, (PVOID)WaitBlock, FALSE, NULL);
 }
 
 
@@ -34,7 +199,44 @@ VOID
 NTAPI
 RtlWakeAllConditionVariable(IN OUT PRTL_CONDITION_VARIABLE ConditionVariable)
 {
-    UNIMPLEMENTED;
+    LONG_PTR CurrentValue;
+    PRTLP_CONDVAR_WAITBLOCK WaitBlock, Next, Oldest = NULL;
+
+    /* Nothing to do if there are no waiters */
+    if (((LONG_PTR)ConditionVariable->Ptr & ~RTL_CONDVAR_MASK) == 0)
+        return;
+
+    RtlpAcquireWaitListLock(ConditionVariable);
+
+    /* Detach the whole chain */
+    do
+    {
+        CurrentValue = (LONG_PTR)ConditionVariable->Ptr;
+    }
+    while (InterlockedCompareExchangePointer(&ConditionVariable->Ptr,
+                                             (PVOID)RTL_CONDVAR_LOCK,
+                                             (PVOID)CurrentValue) != (PVOID)CurrentValue);
+
+    RtlpReleaseWaitListLock(ConditionVariable);
+
+    /* Nobody else can reach the detached wait blocks now. Reverse the
+       chain so the waiters are woken in the order they started waiting. */
+    WaitBlock = (PRTLP_CONDVAR_WAITBLOCK)(CurrentValue & ~RTL_CONDVAR_MASK);
+    while (WaitBlock != NULL)
+    {
+        Next = WaitBlock->Next;
+        WaitBlock->Next = Oldest;
+        Oldest = WaitBlock;
+        WaitBlock = Next;
+    }
+
+    while (Oldest != NULL)
+    {
+        /* The wait block is gone as soon as its waiter runs again */
+        Next = Oldest->Next;
+        NtReleaseKeyedEvent(NULL, (PVOID)Oldest, FALSE, NULL);
+        Oldest = Next;
+    }
 }
 
 
@@ -44,8 +246,17 @@ RtlSleepConditionVariableCS(IN OUT PRTL_CONDITION_VARIABLE ConditionVariable,
                             IN OUT PRTL_CRITICAL_SECTION CriticalSection,
                             IN PLARGE_INTEGER TimeOut  OPTIONAL)
 {
-    UNIMPLEMENTED;
-    return STATUS_NOT_IMPLEMENTED;
+    RTLP_CONDVAR_WAITBLOCK WaitBlock;
+    NTSTATUS Status;
+
+    /* Queue up while still holding the lock, so a wake can't be missed */
+    RtlpInsertWaitBlock(ConditionVariable, &WaitBlock);
+    RtlLeaveCriticalSection(CriticalSection);
+
+    Status = RtlpWaitForWake(ConditionVariable, &WaitBlock, TimeOut);
+
+    RtlEnterCriticalSection(CriticalSection);
+    return Status;
 }
 
 
@@ -56,6 +267,25 @@ RtlSleepConditionVariableSRW(IN OUT PRTL_CONDITION_VARIABLE ConditionVariable,
                              IN PLARGE_INTEGER TimeOut  OPTIONAL,
                              IN ULONG Flags)
 {
-    UNIMPLEMENTED;
-    return STATUS_NOT_IMPLEMENTED;
+    RTLP_CONDVAR_WAITBLOCK WaitBlock;
+    NTSTATUS Status;
+
+    if (Flags & ~RTL_CONDITION_VARIABLE_LOCKMODE_SHARED)
+        return STATUS_INVALID_PARAMETER_4;
+
+    /* Queue up while still holding the lock, so a wake can't be missed */
+    RtlpInsertWaitBlock(ConditionVariable, &WaitBlock);
+    if (Flags & RTL_CONDITION_VARIABLE_LOCKMODE_SHARED)
+        RtlReleaseSRWLockShared(SRWLock);
+    else
+        RtlReleaseSRWLockExclusive(SRWLock);
+
+    Status = RtlpWaitForWake(ConditionVariable, &WaitBlock, TimeOut);
+
+    if (Flags & RTL_CONDITION_VARIABLE_LOCKMODE_SHARED)
+        RtlAcquireSRWLockShared(SRWLock);
+    else
+        RtlAcquireSRWLockExclusive(SRWLock);
+
+    return Status;
 }
@@ -1501,7 +1501,8 @@ RtlCreateHeap(ULONG Flags,
     {
         RtlpAddHeapToProcessList(Heap);
 
-        // FIXME: What about lookasides?
+        /* The low fragmentation front end is enabled on request,
+           see RtlSetHeapInformation */
     }
 
     return Heap;
@@ -1546,6 +1547,10 @@ RtlDestroyHeap(HANDLE HeapPtr) /* [in] Handle of heap */
     if (RtlpGetMode() == UserMode &&
         HeapPtr == NtCurrentPeb()->ProcessHeap) return HeapPtr;
 
+    /* Front end subsegments are back end blocks, they go away with the segments */
+    Heap->FrontEndHeapType = 0;
+    Heap->FrontEndHeap = NULL;
+
     /* Free up all big allocations */
     Current = Heap->VirtualAllocdBlocks.Flink;
     while (Current != &Heap->VirtualAllocdBlocks)
@@ -1912,6 +1917,7 @@ RtlAllocateHeap(IN PVOID HeapPtr,
     PHEAP_VIRTUAL_ALLOC_ENTRY VirtualBlock = NULL;
     PHEAP_ENTRY_EXTRA Extra;
     NTSTATUS Status;
+    PVOID FrontEndBlock;
 
     /* Force flags */
     Flags |= Heap->ForceFlags;
@@ -1961,6 +1967,17 @@ RtlAllocateHeap(IN PVOID HeapPtr,
 
     Index = AllocationSize >>  HEAP_ENTRY_SHIFT;
 
+    /* Small blocks without extra stuff come from the front end, if it's enabled */
+    if (Heap->FrontEndHeapType == HEAP_FRONT_LOWFRAGHEAP &&
+        Index < HEAP_LFH_BUCKETS &&
+        !(EntryFlags & HEAP_ENTRY_EXTRA_PRESENT))
+    {
+        FrontEndBlock = RtlpLfhAllocate(Heap, Flags, Size, AllocationSize, EntryFlags);
+        if (FrontEndBlock) return FrontEndBlock;
+
+        /* Out of memory for a new subsegment, the back end will sort it out */
+    }
+
     /* Acquire the lock if necessary */
     if (!(Flags & HEAP_NO_SERIALIZE))
     {
@@ -2130,6 +2147,53 @@ RtlAllocateHeap(IN PVOID HeapPtr,
 }
 
 
+VOID NTAPI
+RtlpReleaseBusyBlock(PHEAP Heap,
+                     PHEAP_ENTRY HeapEntry,
+                     SIZE_T BlockSize)
+{
+    /* Coalesce in kernel mode, and in usermode if it's not disabled */
+    if (RtlpGetMode() == KernelMode ||
+        (RtlpGetMode() == UserMode && !(Heap->Flags & HEAP_DISABLE_COALESCE_ON_FREE)))
+    {
+        HeapEntry = (PHEAP_ENTRY)RtlpCoalesceFreeBlocks(Heap,
+                                                       (PHEAP_FREE_ENTRY)HeapEntry,
+                                                       &BlockSize,
+                                                       FALSE);
+    }
+
+    /* If there is no need to decommit the block - put it into a free list */
+    if (BlockSize < Heap->DeCommitFreeBlockThreshold ||
+        (Heap->TotalFreeSize + BlockSize < Heap->DeCommitTotalFreeThreshold))
+    {
+        /* Check if it needs to go to a 0 list */
+        if (BlockSize > HEAP_MAX_BLOCK_SIZE)
+        {
+            /* General-purpose 0 list */
+            RtlpInsertFreeBlock(Heap, (PHEAP_FREE_ENTRY)HeapEntry, BlockSize);
+        }
+        else
+        {
+            /* Usual free list */
+            RtlpInsertFreeBlockHelper(Heap, (PHEAP_FREE_ENTRY)HeapEntry, BlockSize, FALSE);
+
+            /* Assert sizes are consistent */
+            if (!(HeapEntry->Flags & HEAP_ENTRY_LAST_ENTRY))
+            {
+                ASSERT((HeapEntry + BlockSize)->PreviousSize == BlockSize);
+            }
+
+            /* Increase the free size */
+            Heap->TotalFreeSize += BlockSize;
+        }
+    }
+    else
+    {
+        /* Decommit this block */
+        RtlpDeCommitFreeBlock(Heap, (PHEAP_FREE_ENTRY)HeapEntry, BlockSize);
+    }
+}
+
 /***********************************************************************
  *           HeapFree   (KERNEL32.338)
  * RETURNS
@@ -2146,7 +2210,6 @@ BOOLEAN NTAPI RtlFreeHeap(
 {
     PHEAP Heap;
     PHEAP_ENTRY HeapEntry;
-    USHORT TagIndex = 0;
     SIZE_T BlockSize;
     PHEAP_VIRTUAL_ALLOC_ENTRY VirtualEntry;
     BOOLEAN Locked = FALSE;
@@ -2163,6 +2226,10 @@ BOOLEAN NTAPI RtlFreeHeap(
     if (RtlpHeapIsSpecial(Flags))
         return RtlDebugFreeHeap(Heap, Flags, Ptr);
 
+    /* Front end blocks don't need the heap lock */
+    if ((((PHEAP_ENTRY)Ptr) - 1)->SegmentOffset == HEAP_LFH_SEGMENT_OFFSET)
+        return RtlpLfhFree(Heap, (PHEAP_ENTRY)Ptr - 1);
+
     /* Lock if necessary */
     if (!(Flags & HEAP_NO_SERIALIZE))
     {
@@ -2217,54 +2284,7 @@ BOOLEAN NTAPI RtlFreeHeap(
 
         // TODO: Tagging
 
-        /* Coalesce in kernel mode, and in usermode if it's not disabled */
-        if (RtlpGetMode() == KernelMode ||
-            (RtlpGetMode() == UserMode && !(Heap->Flags & HEAP_DISABLE_COALESCE_ON_FREE)))
-        {
-            HeapEntry = (PHEAP_ENTRY)RtlpCoalesceFreeBlocks(Heap,
-                                                           (PHEAP_FREE_ENTRY)HeapEntry,
-                                                           &BlockSize,
-                                                           FALSE);
-        }
-
-        /* If there is no need to decommit the block - put it into a free list */
-        if (BlockSize < Heap->DeCommitFreeBlockThreshold ||
-            (Heap->TotalFreeSize + BlockSize < Heap->DeCommitTotalFreeThreshold))
-        {
-            /* Check if it needs to go to a 0 list */
-            if (BlockSize > HEAP_MAX_BLOCK_SIZE)
-            {
-                /* General-purpose 0 list */
-                RtlpInsertFreeBlock(Heap, (PHEAP_FREE_ENTRY)HeapEntry, BlockSize);
-            }
-            else
-            {
-                /* Usual free list */
-                RtlpInsertFreeBlockHelper(Heap, (PHEAP_FREE_ENTRY)HeapEntry, BlockSize, FALSE);
-
-                /* Assert sizes are consistent */
-                if (!(HeapEntry->Flags & HEAP_ENTRY_LAST_ENTRY))
-                {
-                    ASSERT((HeapEntry + BlockSize)->PreviousSize == BlockSize);
-                }
-
-                /* Increase the free size */
-                Heap->TotalFreeSize += BlockSize;
-            }
-
-
-            if (RtlpGetMode() == UserMode &&
-                TagIndex != 0)
-            {
-                // FIXME: Tagging
-                UNIMPLEMENTED;
-            }
-        }
-        else
-        {
-            /* Decommit this block */
-            RtlpDeCommitFreeBlock(Heap, (PHEAP_FREE_ENTRY)HeapEntry, BlockSize);
-        }
+        RtlpReleaseBusyBlock(Heap, HeapEntry, BlockSize);
     }
 
     /* Release the heap lock */
@@ -2573,6 +2593,10 @@ RtlReAllocateHeap(HANDLE HeapPtr,
         return NULL;
     }
 
+    /* Front end blocks are resized by the front end */
+    if ((((PHEAP_ENTRY)Ptr) - 1)->SegmentOffset == HEAP_LFH_SEGMENT_OFFSET)
+        return RtlpLfhReAllocate(Heap, Flags, Ptr, Size);
+
     /* Calculate allocation size and index */
     if (Size)
         AllocationSize = Size;
@@ -3129,17 +3153,26 @@ RtlpValidateHeapEntry(
     if (!(HeapEntry->Flags & HEAP_ENTRY_BUSY)) goto invalid_entry;
 
     BigAllocation = HeapEntry->Flags & HEAP_ENTRY_VIRTUAL_ALLOC;
-    Segment = Heap->Segments[HeapEntry->SegmentOffset];
 
     if (BigAllocation &&
         (((ULONG_PTR)HeapEntry & (PAGE_SIZE - 1)) != FIELD_OFFSET(HEAP_VIRTUAL_ALLOC_ENTRY, BusyBlock)))
          goto invalid_entry;
 
-    if (!BigAllocation && (HeapEntry->SegmentOffset >= HEAP_SEGMENTS ||
-        !Segment ||
-        HeapEntry < Segment->FirstEntry ||
-        HeapEntry >= Segment->LastValidEntry))
-        goto invalid_entry;
+    /* Front end blocks live inside a back end block, the segment search below covers them */
+    if (HeapEntry->SegmentOffset == HEAP_LFH_SEGMENT_OFFSET)
+    {
+        if (BigAllocation || !Heap->FrontEndHeap) goto invalid_entry;
+    }
+    else if (!BigAllocation)
+    {
+        if (HeapEntry->SegmentOffset >= HEAP_SEGMENTS) goto invalid_entry;
+
+        Segment = Heap->Segments[HeapEntry->SegmentOffset];
+        if (!Segment ||
+            HeapEntry < Segment->FirstEntry ||
+            HeapEntry >= Segment->LastValidEntry)
+            goto invalid_entry;
+    }
 
     if ((HeapEntry->Flags & HEAP_ENTRY_FILL_PATTERN) &&
         !RtlpCheckInUsePattern(HeapEntry))
@@ -3892,13 +3925,14 @@ RtlSetHeapInformation(IN HANDLE HeapHandle OPTIONAL,
         }
 
         /* Check for a special magic value for enabling LFH */
-        if (*(PULONG)HeapInformation != 2)
+        if (*(PULONG)HeapInformation != HEAP_FRONT_LOWFRAGHEAP)
         {
             return STATUS_UNSUCCESSFUL;
         }
 
-        DPRINT1("RtlSetHeapInformation() needs to enable LFH\n");
-        return STATUS_SUCCESS;
+        if (!HeapHandle) return STATUS_INVALID_PARAMETER;
+
+        return RtlpLfhEnable((PHEAP)HeapHandle);
     }
 
     return STATUS_SUCCESS;
@@ -3937,7 +3971,55 @@ RtlQueryHeapInformation(HANDLE HeapHandle,
     return STATUS_UNSUCCESSFUL;
 }
 
-NTSTATUS
+PHEAP_FREE_ENTRY NTAPI
+RtlpFindFreeBlock(PHEAP Heap,
+                  SIZE_T Index)
+{
+    PULONG FreeListsInUse;
+    ULONG FreeListsInUseUlong;
+    SIZE_T InUseIndex, i;
+    PLIST_ENTRY FreeListHead, Next;
+    PHEAP_FREE_ENTRY FreeBlock;
+
+    /* Try the dedicated lists first, the bitmap tells which ones aren't empty */
+    if (Index < HEAP_FREELISTS)
+    {
+        InUseIndex = Index >> 5;
+        FreeListsInUse = &Heap->u.FreeListsInUseUlong[InUseIndex];
+
+        /* Disable all sizes which are less than the requested one */
+        FreeListsInUseUlong = *FreeListsInUse++ & ~((1 << ((ULONG)Index & 0x1f)) - 1);
+
+        for (i = InUseIndex; i < 4; i++)
+        {
+            if (FreeListsInUseUlong)
+            {
+                FreeListHead = &Heap->FreeLists[i * 32] + RtlpFindLeastSetBit(FreeListsInUseUlong);
+                return CONTAINING_RECORD(FreeListHead->Blink, HEAP_FREE_ENTRY, FreeList);
+            }
+
+            if (i < 3) FreeListsInUseUlong = *FreeListsInUse++;
+        }
+    }
+
+    /* The non-dedicated list is sorted, take the first entry which is big enough */
+    FreeListHead = &Heap->FreeLists[0];
+    Next = FreeListHead->Flink;
+    while (FreeListHead != Next)
+    {
+        FreeBlock = CONTAINING_RECORD(Next, HEAP_FREE_ENTRY, FreeList);
+        if (FreeBlock->Size >= Index) return FreeBlock;
+
+        Next = Next->Flink;
+    }
+
+    return NULL;
+}
+
+/*
+ * @implemented
+ */
+ULONG
 NTAPI
 RtlMultipleAllocateHeap(IN PVOID HeapHandle,
                         IN ULONG Flags,
@@ -3945,19 +4027,349 @@ RtlMultipleAllocateHeap(IN PVOID HeapHandle,
                         IN ULONG Count,
                         OUT PVOID *Array)
 {
-    UNIMPLEMENTED;
-    return 0;
+    PHEAP Heap = (PHEAP)HeapHandle;
+    SIZE_T AllocationSize, Index, Wanted, BlockSize;
+    PHEAP_FREE_ENTRY FreeBlock;
+    PHEAP_ENTRY InUseEntry;
+    PHEAP_ENTRY_EXTRA Extra;
+    UCHAR FreeFlags, EntryFlags = HEAP_ENTRY_BUSY;
+    EXCEPTION_RECORD ExceptionRecord;
+    BOOLEAN HeapLocked = FALSE;
+    ULONG Allocated = 0, i;
+
+    /* Force flags */
+    Flags |= Heap->ForceFlags;
+
+    /* Special heaps, and blocks which are too big for a segment, go one by one */
+    if (RtlpHeapIsSpecial(Flags) || Size >= 0x80000000)
+    {
+        while (Allocated < Count)
+        {
+            Array[Allocated] = RtlAllocateHeap(Heap, Flags, Size);
+            if (!Array[Allocated]) break;
+            Allocated++;
+        }
+
+        return Allocated;
+    }
+
+    /* Calculate allocation size and index, the same way RtlAllocateHeap does */
+    if (Size)
+        AllocationSize = Size;
+    else
+        AllocationSize = 1;
+    AllocationSize = (AllocationSize + Heap->AlignRound) & Heap->AlignMask;
+
+    if ((Flags & HEAP_EXTRA_FLAGS_MASK) ||
+        Heap->PseudoTagEntries)
+    {
+        EntryFlags |= HEAP_ENTRY_EXTRA_PRESENT;
+        AllocationSize += sizeof(HEAP_ENTRY_EXTRA);
+    }
+
+    EntryFlags |= (Flags & HEAP_SETTABLE_USER_FLAGS) >> 4;
+
+    Index = AllocationSize >> HEAP_ENTRY_SHIFT;
+
+    /* The front end doesn't take the heap lock at all */
+    if (Heap->FrontEndHeapType == HEAP_FRONT_LOWFRAGHEAP &&
+        Index < HEAP_LFH_BUCKETS &&
+        !(EntryFlags & HEAP_ENTRY_EXTRA_PRESENT))
+    {
+        while (Allocated < Count)
+        {
+            Array[Allocated] = RtlpLfhAllocate(Heap, Flags, Size, AllocationSize, EntryFlags);
+            if (!Array[Allocated]) break;
+            Allocated++;
+        }
+
+        /* Out of memory for a new subsegment, the back end will sort it out */
+        if (Allocated == Count) return Allocated;
+    }
+
+    /* Blocks which need their own virtual allocation gain nothing from batching */
+    if (Index > Heap->VirtualMemoryThreshold)
+    {
+        while (Allocated < Count)
+        {
+            Array[Allocated] = RtlAllocateHeap(Heap, Flags, Size);
+            if (!Array[Allocated]) break;
+            Allocated++;
+        }
+
+        return Allocated;
+    }
+
+    /* Acquire the lock once for the whole batch */
+    if (!(Flags & HEAP_NO_SERIALIZE))
+    {
+        RtlEnterHeapLock(Heap->LockVariable, TRUE);
+        HeapLocked = TRUE;
+    }
+
+    i = Allocated;
+    while (Allocated < Count)
+    {
+        /* Look for a free block which fits everything that's left */
+        if (Count - Allocated < HEAP_MAX_BLOCK_SIZE / Index)
+            Wanted = (Count - Allocated) * Index;
+        else
+            Wanted = HEAP_MAX_BLOCK_SIZE;
+        FreeBlock = RtlpFindFreeBlock(Heap, Wanted);
+
+        /* Otherwise take the biggest one there is, or any which fits a single block */
+        if (!FreeBlock && Wanted > Index)
+        {
+            FreeBlock = CONTAINING_RECORD(Heap->FreeLists[0].Blink, HEAP_FREE_ENTRY, FreeList);
+            if (IsListEmpty(&Heap->FreeLists[0]) || FreeBlock->Size < Index)
+                FreeBlock = RtlpFindFreeBlock(Heap, Index);
+        }
+
+        /* Nothing suitable in the free lists, extend the heap */
+        if (!FreeBlock)
+            FreeBlock = RtlpExtendHeap(Heap, Wanted << HEAP_ENTRY_SHIFT);
+        if (!FreeBlock && Wanted > Index)
+            FreeBlock = RtlpExtendHeap(Heap, AllocationSize);
+        if (!FreeBlock) break;
+
+        RtlpRemoveFreeBlock(Heap, FreeBlock, FALSE, FALSE);
+
+        /* Carve blocks off the front while at least two more fit. These don't need
+           the remainder handling of RtlpSplitEntry, the next carve overwrites it anyway */
+        FreeFlags = FreeBlock->Flags;
+        BlockSize = FreeBlock->Size;
+        while (Allocated + 1 < Count && BlockSize >= 2 * Index)
+        {
+            InUseEntry = (PHEAP_ENTRY)FreeBlock;
+            FreeBlock = (PHEAP_FREE_ENTRY)(InUseEntry + Index);
+            BlockSize -= Index;
+
+            /* What's left is a free entry again */
+            FreeBlock->Flags = FreeFlags;
+            FreeBlock->SegmentOffset = InUseEntry->SegmentOffset;
+            FreeBlock->Size = (USHORT)BlockSize;
+            FreeBlock->PreviousSize = (USHORT)Index;
+
+            /* And the front is an in-use one */
+            InUseEntry->Flags = EntryFlags;
+            InUseEntry->SmallTagIndex = 0;
+            InUseEntry->Size = (USHORT)Index;
+            InUseEntry->UnusedBytes = (UCHAR)(AllocationSize - Size);
+
+            Heap->TotalFreeSize -= Index;
+            Array[Allocated++] = InUseEntry + 1;
+        }
+
+        /* The entry following the remainder still has the size of the whole block */
+        if (!(FreeFlags & HEAP_ENTRY_LAST_ENTRY))
+            ((PHEAP_ENTRY)FreeBlock + BlockSize)->PreviousSize = (USHORT)BlockSize;
+
+        /* The last block is split off normally, giving the rest back to the free lists */
+        InUseEntry = RtlpSplitEntry(Heap, Flags, FreeBlock, AllocationSize, Index, Size);
+        Array[Allocated++] = InUseEntry + 1;
+    }
+
+    /* Release the lock */
+    if (HeapLocked) RtlLeaveHeapLock(Heap->LockVariable);
+
+    /* Now prepare the blocks the same way RtlAllocateHeap does */
+    for (; i < Allocated; i++)
+    {
+        InUseEntry = (PHEAP_ENTRY)Array[i] - 1;
+
+        /* Zero memory if that was requested */
+        if (Flags & HEAP_ZERO_MEMORY)
+            RtlZeroMemory(InUseEntry + 1, Size);
+        else if (Heap->Flags & HEAP_FREE_CHECKING_ENABLED)
+        {
+            /* Fill this block with a special pattern */
+            RtlFillMemoryUlong(InUseEntry + 1, Size & ~0x3, ARENA_INUSE_FILLER);
+        }
+
+        /* Fill tail of the block with a special pattern too if requested */
+        if (Heap->Flags & HEAP_TAIL_CHECKING_ENABLED)
+        {
+            RtlFillMemory((PCHAR)(InUseEntry + 1) + Size, sizeof(HEAP_ENTRY), HEAP_TAIL_FILL);
+            InUseEntry->Flags |= HEAP_ENTRY_FILL_PATTERN;
+        }
+
+        /* Prepare extra if it's present */
+        if (InUseEntry->Flags & HEAP_ENTRY_EXTRA_PRESENT)
+        {
+            Extra = RtlpGetExtraStuffPointer(InUseEntry);
+            RtlZeroMemory(Extra, sizeof(HEAP_ENTRY_EXTRA));
+
+            // TODO: Tagging
+        }
+    }
+
+    if (Allocated < Count)
+    {
+        /* Out of memory, the caller gets what has been allocated so far */
+        RtlSetLastWin32ErrorAndNtStatusFromNtStatus(STATUS_NO_MEMORY);
+        DPRINT1("HEAP: Allocated only %lu blocks of %lu!\n", Allocated, Count);
+
+        /* Generate an exception */
+        if (Flags & HEAP_GENERATE_EXCEPTIONS)
+        {
+            ExceptionRecord.ExceptionCode = STATUS_NO_MEMORY;
+            ExceptionRecord.ExceptionRecord = NULL;
+            ExceptionRecord.NumberParameters = 1;
+            ExceptionRecord.ExceptionFlags = 0;
+            ExceptionRecord.ExceptionInformation[0] = AllocationSize;
+
+            RtlRaiseException(&ExceptionRecord);
+        }
+    }
+
+    return Allocated;
 }
 
-NTSTATUS
+/*
+ * @implemented
+ */
+ULONG
 NTAPI
 RtlMultipleFreeHeap(IN PVOID HeapHandle,
                     IN ULONG Flags,
                     IN ULONG Count,
-                    OUT PVOID *Array)
+                    IN PVOID *Array)
 {
-    UNIMPLEMENTED;
-    return 0;
+    PHEAP Heap = (PHEAP)HeapHandle;
+    PHEAP_ENTRY HeapEntry, RunEntry = NULL;
+    PHEAP_VIRTUAL_ALLOC_ENTRY VirtualEntry;
+    SIZE_T BlockSize, RunSize = 0;
+    UCHAR RunLast = 0;
+    BOOLEAN Locked = FALSE;
+    NTSTATUS Status;
+    ULONG Freed = 0, i;
+
+    /* Force flags */
+    Flags |= Heap->ForceFlags;
+
+    /* Special heaps go one by one */
+    if (RtlpHeapIsSpecial(Flags))
+    {
+        for (i = 0; i < Count; i++)
+        {
+            if (RtlFreeHeap(Heap, Flags, Array[i])) Freed++;
+        }
+
+        return Freed;
+    }
+
+    /* Lock once for the whole batch */
+    if (!(Flags & HEAP_NO_SERIALIZE))
+    {
+        RtlEnterHeapLock(Heap->LockVariable, TRUE);
+        Locked = TRUE;
+    }
+
+    for (i = 0; i < Count; i++)
+    {
+        /* Freeing NULL pointer is a legal operation */
+        if (!Array[i])
+        {
+            Freed++;
+            continue;
+        }
+
+        HeapEntry = (PHEAP_ENTRY)Array[i] - 1;
+
+        /* Front end blocks go back to their subsegment */
+        if (HeapEntry->SegmentOffset == HEAP_LFH_SEGMENT_OFFSET)
+        {
+            if (RtlpLfhFree(Heap, HeapEntry)) Freed++;
+            continue;
+        }
+
+        /* Check this entry, skip it if it's invalid */
+        if (!(HeapEntry->Flags & HEAP_ENTRY_BUSY) ||
+            (((ULONG_PTR)Array[i] & 0x7) != 0) ||
+            (HeapEntry->SegmentOffset >= HEAP_SEGMENTS))
+        {
+            DPRINT1("HEAP: Trying to free an invalid address %p!\n", Array[i]);
+            RtlSetLastWin32ErrorAndNtStatusFromNtStatus(STATUS_INVALID_PARAMETER);
+            continue;
+        }
+
+        Freed++;
+
+        if (HeapEntry->Flags & HEAP_ENTRY_VIRTUAL_ALLOC)
+        {
+            /* Big allocation */
+            VirtualEntry = CONTAINING_RECORD(HeapEntry, HEAP_VIRTUAL_ALLOC_ENTRY, BusyBlock);
+            RemoveEntryList(&VirtualEntry->Entry);
+
+            BlockSize = 0;
+            Status = ZwFreeVirtualMemory(NtCurrentProcess(),
+                                         (PVOID *)&VirtualEntry,
+                                         &BlockSize,
+                                         MEM_RELEASE);
+
+            if (!NT_SUCCESS(Status))
+            {
+                DPRINT1("HEAP: Failed releasing memory with Status 0x%08X. Heap %p, ptr %p, base address %p\n",
+                    Status, Heap, Array[i], VirtualEntry);
+                RtlSetLastWin32ErrorAndNtStatusFromNtStatus(Status);
+            }
+
+            continue;
+        }
+
+        BlockSize = HeapEntry->Size;
+
+        // TODO: Tagging
+
+        /* Blocks which are physical neighbours of the pending run join it, so a batch
+           which came from RtlMultipleAllocateHeap goes back as a single free block */
+        if (RunEntry &&
+            RunSize + BlockSize <= HEAP_MAX_BLOCK_SIZE)
+        {
+            if (!RunLast && RunEntry + RunSize == HeapEntry)
+            {
+                RunLast = HeapEntry->Flags & HEAP_ENTRY_LAST_ENTRY;
+                RunSize += BlockSize;
+                continue;
+            }
+
+            if (HeapEntry + BlockSize == RunEntry)
+            {
+                RunEntry = HeapEntry;
+                RunSize += BlockSize;
+                continue;
+            }
+        }
+
+        /* Not a neighbour, release the pending run and start a new one */
+        if (RunEntry)
+        {
+            RunEntry->Flags = HEAP_ENTRY_BUSY | RunLast;
+            RunEntry->Size = (USHORT)RunSize;
+            if (!RunLast) (RunEntry + RunSize)->PreviousSize = (USHORT)RunSize;
+
+            RtlpReleaseBusyBlock(Heap, RunEntry, RunSize);
+        }
+
+        RunEntry = HeapEntry;
+        RunSize = BlockSize;
+        RunLast = HeapEntry->Flags & HEAP_ENTRY_LAST_ENTRY;
+    }
+
+    /* Release the last run */
+    if (RunEntry)
+    {
+        RunEntry->Flags = HEAP_ENTRY_BUSY | RunLast;
+        RunEntry->Size = (USHORT)RunSize;
+        if (!RunLast) (RunEntry + RunSize)->PreviousSize = (USHORT)RunSize;
+
+        RtlpReleaseBusyBlock(Heap, RunEntry, RunSize);
+    }
+
+    /* Release the heap lock */
+    if (Locked) RtlLeaveHeapLock(Heap->LockVariable);
+
+    return Freed;
 }
 
 /* EOF */
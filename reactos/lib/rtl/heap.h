@@ -55,6 +55,13 @@
 /* Segment flags */
 #define HEAP_USER_ALLOCATED    0x1
 
+/* Low fragmentation front end */
+#define HEAP_FRONT_LOWFRAGHEAP     2
+#define HEAP_LFH_BUCKETS           HEAP_FREELISTS /* Block sizes served, in heap entries */
+#define HEAP_LFH_AFFINITY_SLOTS    8
+#define HEAP_LFH_SUBSEGMENT_SIZE   0x4000
+#define HEAP_LFH_SEGMENT_OFFSET    0xFF /* SegmentOffset of front end blocks */
+
 /* A handy inline to distinguis normal heap, special "debug heap" and special "page heap" */
 FORCEINLINE BOOLEAN
 RtlpHeapIsSpecial(ULONG Flags)
@@ -327,6 +334,18 @@ typedef struct _HEAP_VIRTUAL_ALLOC_ENTRY
     HEAP_ENTRY BusyBlock;
 } HEAP_VIRTUAL_ALLOC_ENTRY, *PHEAP_VIRTUAL_ALLOC_ENTRY;
 
+typedef struct _HEAP_LFH_BUCKET
+{
+    SLIST_HEADER FreeList[HEAP_LFH_AFFINITY_SLOTS];
+} HEAP_LFH_BUCKET, *PHEAP_LFH_BUCKET;
+
+typedef struct _HEAP_LFH
+{
+    HEAP_LFH_BUCKET Buckets[HEAP_LFH_BUCKETS];
+    ULONG AffinitySlots;
+    LONG SubSegments;
+} HEAP_LFH, *PHEAP_LFH;
+
 /* Global variables */
 extern RTL_CRITICAL_SECTION RtlpProcessHeapsListLock;
 extern BOOLEAN RtlpPageHeapEnabled;
@@ -352,6 +371,27 @@ RtlpValidateHeapEntry(PHEAP Heap, PHEAP_ENTRY HeapEntry);
 BOOLEAN NTAPI
 RtlpValidateHeapHeaders(PHEAP Heap, BOOLEAN Recalculate);
 
+/* heaplfh.c */
+NTSTATUS NTAPI
+RtlpLfhEnable(PHEAP Heap);
+
+PVOID NTAPI
+RtlpLfhAllocate(PHEAP Heap,
+                ULONG Flags,
+                SIZE_T Size,
+                SIZE_T AllocationSize,
+                UCHAR EntryFlags);
+
+BOOLEAN NTAPI
+RtlpLfhFree(PHEAP Heap,
+            PHEAP_ENTRY HeapEntry);
+
+PVOID NTAPI
+RtlpLfhReAllocate(PHEAP Heap,
+                  ULONG Flags,
+                  PVOID Ptr,
+                  SIZE_T Size);
+
 /* heapdbg.c */
 HANDLE NTAPI
 RtlDebugCreateHeap(ULONG Flags,
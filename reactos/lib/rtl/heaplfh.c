@@ -0,0 +1,306 @@
+/* COPYRIGHT:       See COPYING in the top level directory
+ * PROJECT:         ReactOS system libraries
+ * FILE:            lib/rtl/heaplfh.c
+ * PURPOSE:         RTL Low Fragmentation Heap front end
+ * PROGRAMMERS:     ReactOS Team
+ */
+
+/* Useful references:
+   http://illmatics.com/Understanding_the_LFH.pdf
+   http://msdn.microsoft.com/en-us/library/aa366750(VS.85).aspx
+*/
+
+/* The front end serves small blocks, up to HEAP_LFH_BUCKETS heap entries
+   including the header, out of subsegments: back end blocks of about
+   HEAP_LFH_SUBSEGMENT_SIZE bytes that are cut into equal blocks. Every
+   bucket (block size) has one lock free list of free blocks per affinity
+   slot, threads pick their slot from their thread id so concurrent
+   threads mostly work on different lists and never take the heap lock.
+
+   A front end block looks like a busy back end block whose SegmentOffset
+   is HEAP_LFH_SEGMENT_OFFSET, so RtlSizeHeap and friends need no special
+   casing. Subsegments are kept for the lifetime of the heap and go away
+   with its segments in RtlDestroyHeap. */
+
+/* INCLUDES *****************************************************************/
+
+#include <rtl.h>
+#include <heap.h>
+
+#define NDEBUG
+#include <debug.h>
+
+/* FUNCTIONS *****************************************************************/
+
+FORCEINLINE
+ULONG
+RtlpLfhGetAffinitySlot(PHEAP_LFH Lfh)
+{
+    /* Thread ids are multiples of 4 */
+    return ((ULONG)(ULONG_PTR)NtCurrentTeb()->ClientId.UniqueThread >> 2) % Lfh->AffinitySlots;
+}
+
+FORCEINLINE
+PHEAP_ENTRY
+RtlpLfhPopBlock(PSLIST_HEADER FreeList)
+{
+    PSLIST_ENTRY ListEntry;
+
+    /* Free blocks keep the list link in their user data */
+    ListEntry = RtlInterlockedPopEntrySList(FreeList);
+    if (!ListEntry) return NULL;
+
+    return (PHEAP_ENTRY)ListEntry - 1;
+}
+
+FORCEINLINE
+VOID
+RtlpLfhPushBlock(PSLIST_HEADER FreeList,
+                 PHEAP_ENTRY HeapEntry)
+{
+    RtlInterlockedPushEntrySList(FreeList, (PSLIST_ENTRY)(HeapEntry + 1));
+}
+
+static
+PHEAP_ENTRY
+RtlpLfhCreateSubSegment(PHEAP Heap,
+                        PHEAP_LFH Lfh,
+                        SIZE_T Index,
+                        ULONG Slot)
+{
+    SIZE_T BlockSize, BlockCount, i;
+    PUCHAR SubSegment;
+    PHEAP_ENTRY HeapEntry;
+
+    BlockSize = Index << HEAP_ENTRY_SHIFT;
+    BlockCount = HEAP_LFH_SUBSEGMENT_SIZE / BlockSize;
+
+    /* Carve from the back end. The request is far above the front end range,
+       so this never comes back here */
+    ASSERT(((BlockCount * BlockSize) >> HEAP_ENTRY_SHIFT) >= HEAP_LFH_BUCKETS);
+    SubSegment = RtlAllocateHeap(Heap, 0, BlockCount * BlockSize);
+    if (!SubSegment) return NULL;
+
+    InterlockedIncrement(&Lfh->SubSegments);
+
+    /* Give every block a front end header. Push them in reverse order, so
+       the lowest addresses get used first */
+    for (i = BlockCount; i > 0; i--)
+    {
+        HeapEntry = (PHEAP_ENTRY)(SubSegment + (i - 1) * BlockSize);
+        RtlZeroMemory(HeapEntry, sizeof(HEAP_ENTRY));
+        HeapEntry->Size = (USHORT)Index;
+        HeapEntry->SegmentOffset = HEAP_LFH_SEGMENT_OFFSET;
+
+        /* The first block goes straight to the caller */
+        if (i > 1) RtlpLfhPushBlock(&Lfh->Buckets[Index].FreeList[Slot], HeapEntry);
+    }
+
+    return (PHEAP_ENTRY)SubSegment;
+}
+
+PVOID NTAPI
+RtlpLfhAllocate(PHEAP Heap,
+                ULONG Flags,
+                SIZE_T Size,
+                SIZE_T AllocationSize,
+                UCHAR EntryFlags)
+{
+    PHEAP_LFH Lfh = Heap->FrontEndHeap;
+    PHEAP_LFH_BUCKET Bucket;
+    PHEAP_ENTRY HeapEntry;
+    SIZE_T Index;
+    ULONG Slot, i;
+
+    Index = AllocationSize >> HEAP_ENTRY_SHIFT;
+    ASSERT(Index >= 2 && Index < HEAP_LFH_BUCKETS);
+
+    Bucket = &Lfh->Buckets[Index];
+    Slot = RtlpLfhGetAffinitySlot(Lfh);
+
+    /* Try our own slot first */
+    HeapEntry = RtlpLfhPopBlock(&Bucket->FreeList[Slot]);
+
+    /* Then take a block freed on another slot before growing */
+    for (i = 1; !HeapEntry && i < Lfh->AffinitySlots; i++)
+    {
+        HeapEntry = RtlpLfhPopBlock(&Bucket->FreeList[(Slot + i) % Lfh->AffinitySlots]);
+    }
+
+    if (!HeapEntry)
+    {
+        HeapEntry = RtlpLfhCreateSubSegment(Heap, Lfh, Index, Slot);
+
+        /* Let the back end handle the failure */
+        if (!HeapEntry) return NULL;
+    }
+
+    ASSERT(HeapEntry->Size == Index);
+    ASSERT(HeapEntry->SegmentOffset == HEAP_LFH_SEGMENT_OFFSET);
+
+    /* Initialize this block */
+    HeapEntry->Flags = EntryFlags;
+    HeapEntry->UnusedBytes = (UCHAR)(AllocationSize - Size);
+    HeapEntry->SmallTagIndex = 0;
+
+    /* Zero memory if that was requested */
+    if (Flags & HEAP_ZERO_MEMORY)
+        RtlZeroMemory(HeapEntry + 1, Size);
+
+    return HeapEntry + 1;
+}
+
+BOOLEAN NTAPI
+RtlpLfhFree(PHEAP Heap,
+            PHEAP_ENTRY HeapEntry)
+{
+    PHEAP_LFH Lfh = Heap->FrontEndHeap;
+
+    /* Check this entry, fail if it's invalid */
+    if (!Lfh ||
+        !(HeapEntry->Flags & HEAP_ENTRY_BUSY) ||
+        ((ULONG_PTR)HeapEntry & (HEAP_ENTRY_SIZE - 1)) ||
+        HeapEntry->Size < 2 ||
+        HeapEntry->Size >= HEAP_LFH_BUCKETS)
+    {
+        DPRINT1("HEAP: Trying to free an invalid front end address %p!\n", HeapEntry + 1);
+        RtlSetLastWin32ErrorAndNtStatusFromNtStatus(STATUS_INVALID_PARAMETER);
+        return FALSE;
+    }
+
+    HeapEntry->Flags = 0;
+    RtlpLfhPushBlock(&Lfh->Buckets[HeapEntry->Size].FreeList[RtlpLfhGetAffinitySlot(Lfh)], HeapEntry);
+
+    return TRUE;
+}
+
+PVOID NTAPI
+RtlpLfhReAllocate(PHEAP Heap,
+                  ULONG Flags,
+                  PVOID Ptr,
+                  SIZE_T Size)
+{
+    PHEAP_ENTRY InUseEntry = (PHEAP_ENTRY)Ptr - 1;
+    SIZE_T AllocationSize, OldSize;
+    PVOID NewBaseAddress;
+
+    /* If that entry is not really in-use, we have a problem */
+    if (!(InUseEntry->Flags & HEAP_ENTRY_BUSY))
+    {
+        RtlSetLastWin32ErrorAndNtStatusFromNtStatus(STATUS_INVALID_PARAMETER);
+        return Ptr;
+    }
+
+    OldSize = (InUseEntry->Size << HEAP_ENTRY_SHIFT) - InUseEntry->UnusedBytes;
+
+    /* Calculate allocation size */
+    AllocationSize = (Size ? Size : 1);
+    AllocationSize = (AllocationSize + Heap->AlignRound) & Heap->AlignMask;
+
+    /* Same bucket and nothing extra requested - resize in place */
+    if ((AllocationSize >> HEAP_ENTRY_SHIFT) == InUseEntry->Size &&
+        !(Flags & HEAP_EXTRA_FLAGS_MASK) &&
+        !Heap->PseudoTagEntries)
+    {
+        if (Size > OldSize && (Flags & HEAP_ZERO_MEMORY))
+            RtlZeroMemory((PCHAR)Ptr + OldSize, Size - OldSize);
+
+        InUseEntry->UnusedBytes = (UCHAR)(AllocationSize - Size);
+        return Ptr;
+    }
+
+    if (Flags & HEAP_REALLOC_IN_PLACE_ONLY)
+    {
+        DPRINT1("Realloc in place failed, but it was the only option\n");
+        NewBaseAddress = NULL;
+    }
+    else
+    {
+        /* Move it, either to another bucket or to the back end */
+        NewBaseAddress = RtlAllocateHeap(Heap, Flags & ~HEAP_ZERO_MEMORY, Size);
+        if (NewBaseAddress)
+        {
+            /* Copy actual user bits */
+            RtlMoveMemory(NewBaseAddress, Ptr, min(Size, OldSize));
+
+            /* Zero remaining part if required */
+            if (Size > OldSize && (Flags & HEAP_ZERO_MEMORY))
+                RtlZeroMemory((PCHAR)NewBaseAddress + OldSize, Size - OldSize);
+
+            RtlpLfhFree(Heap, InUseEntry);
+        }
+    }
+
+    if (!NewBaseAddress && (Flags & HEAP_GENERATE_EXCEPTIONS))
+    {
+        EXCEPTION_RECORD ExceptionRecord;
+
+        /* Generate an exception if required */
+        ExceptionRecord.ExceptionCode = STATUS_NO_MEMORY;
+        ExceptionRecord.ExceptionRecord = NULL;
+        ExceptionRecord.NumberParameters = 1;
+        ExceptionRecord.ExceptionFlags = 0;
+        ExceptionRecord.ExceptionInformation[0] = AllocationSize;
+
+        RtlRaiseException(&ExceptionRecord);
+    }
+
+    return NewBaseAddress;
+}
+
+NTSTATUS NTAPI
+RtlpLfhEnable(PHEAP Heap)
+{
+    PHEAP_LFH Lfh;
+    ULONG Bucket, Slot;
+
+    /* Already enabled */
+    if (Heap->FrontEndHeapType == HEAP_FRONT_LOWFRAGHEAP) return STATUS_SUCCESS;
+
+    /* Like Windows, the front end is not available for unserialized and debug
+       heaps. It also relies on the TEB, so it is user mode only */
+    if (RtlpGetMode() != UserMode ||
+        (Heap->Flags & HEAP_NO_SERIALIZE) ||
+        (Heap->ForceFlags & HEAP_FLAG_PAGE_ALLOCS) ||
+        RtlpHeapIsSpecial(Heap->Flags) ||
+        (Heap->Flags & (HEAP_TAIL_CHECKING_ENABLED |
+                        HEAP_FREE_CHECKING_ENABLED |
+                        HEAP_CREATE_ALIGN_16)))
+    {
+        return STATUS_UNSUCCESSFUL;
+    }
+
+    /* The front end data lives in the heap itself */
+    Lfh = RtlAllocateHeap(Heap, 0, sizeof(HEAP_LFH));
+    if (!Lfh) return STATUS_NO_MEMORY;
+
+    for (Bucket = 0; Bucket < HEAP_LFH_BUCKETS; Bucket++)
+    {
+        for (Slot = 0; Slot < HEAP_LFH_AFFINITY_SLOTS; Slot++)
+            RtlInitializeSListHead(&Lfh->Buckets[Bucket].FreeList[Slot]);
+    }
+
+    Lfh->AffinitySlots = min(max(NtCurrentPeb()->NumberOfProcessors, 1), HEAP_LFH_AFFINITY_SLOTS);
+    Lfh->SubSegments = 0;
+
+    RtlEnterHeapLock(Heap->LockVariable, TRUE);
+
+    /* Someone else could have been faster */
+    if (Heap->FrontEndHeap)
+    {
+        RtlLeaveHeapLock(Heap->LockVariable);
+        RtlFreeHeap(Heap, 0, Lfh);
+        return STATUS_SUCCESS;
+    }
+
+    /* Publish the front end data before the type, allocations check the type */
+    InterlockedExchangePointer(&Heap->FrontEndHeap, Lfh);
+    Heap->FrontEndHeapType = HEAP_FRONT_LOWFRAGHEAP;
+
+    RtlLeaveHeapLock(Heap->LockVariable);
+
+    DPRINT("Enabled LFH for heap %p with %lu affinity slots\n", Heap, Lfh->AffinitySlots);
+    return STATUS_SUCCESS;
+}
+
+/* EOF */
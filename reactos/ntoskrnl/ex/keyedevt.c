@@ -188,6 +188,9 @@ ExpReleaseOrWaitForKeyedEvent(
 
             return STATUS_SUCCESS;
         }
+
+        /* Go to the next entry */
+        ListEntry = ListEntry->Flink;
     }
 
     /* Get the current thread */
@@ -226,6 +229,12 @@ ExpReleaseOrWaitForKeyedEvent(
             /* Remove the thread from the list */
             RemoveEntryList(&CurrentThread->KeyedWaitChain);
         }
+        else
+        {
+            /* The other side took us off the list before we could give up,
+               it was told that we got the event, so we did */
+            Status = STATUS_SUCCESS;
+        }
 
         /* Unlock the list */
         ExReleasePushLockExclusive(&KeyedEvent->HashTable[HashIndex].Lock);
@@ -446,6 +455,7 @@ NtWaitForKeyedEvent(
     {
         /* Use the default keyed event for low memory critical sections */
         KeyedEvent = ExpCritSecOutOfMemoryEvent;
+        ObReferenceObject(KeyedEvent);
     }
 
     /* Do the wait */
@@ -506,6 +516,7 @@ NtReleaseKeyedEvent(
     {
         /* Use the default keyed event for low memory critical sections */
         KeyedEvent = ExpCritSecOutOfMemoryEvent;
+        ObReferenceObject(KeyedEvent);
     }
 
     /* Do the wait */
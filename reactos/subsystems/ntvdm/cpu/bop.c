@@ -45,6 +45,12 @@ VOID WINAPI EmulatorBiosOperation(PFAST486_STATE State, UCHAR BopCode)
         BopProc[BopCode](Stack);
     else
         DPRINT1("Invalid BOP code: 0x%02X\n", BopCode);
+
+    /*
+     * BOP handlers write straight into the guest memory (loading
+     * programs, reading files...), flush the CPU code cache.
+     */
+    Fast486InvalidateCache(State, 0, 0xFFFFFFFF);
 }
 
 /* EOF */
@@ -33,6 +33,8 @@
 /* PRIVATE VARIABLES **********************************************************/
 
 FAST486_STATE EmulatorContext;
+static FAST486_TLB_ENTRY Tlb[FAST486_TLB_SIZE];
+static FAST486_CODE_PAGE CodeCache[FAST486_CODE_CACHE_PAGES];
 BOOLEAN CpuRunning = FALSE;
 
 /* No more than 'MaxCpuCallLevel' recursive CPU calls are allowed */
@@ -126,6 +128,9 @@ VOID CpuSimulate(VOID)
     CpuCallLevel++;
     DPRINT("CpuSimulate --> Level %d\n", CpuCallLevel);
 
+    /* The caller may have put new code in memory (callback trampolines...) */
+    Fast486InvalidateCache(&EmulatorContext, 0, 0xFFFFFFFF);
+
     CpuRunning = TRUE;
     while (VdmRunning && CpuRunning) ClockUpdate();
 
@@ -171,12 +176,14 @@ BOOLEAN CpuInitialize(VOID)
     Fast486Initialize(&EmulatorContext,
                       EmulatorReadMemory,
                       EmulatorWriteMemory,
+                      EmulatorMapMemory,
                       EmulatorReadIo,
                       EmulatorWriteIo,
                       NULL,
                       EmulatorBiosOperation,
                       EmulatorIntAcknowledge,
-                      NULL /* TODO: Use a TLB */);
+                      Tlb,
+                      CodeCache);
 
     /* Initialize the software callback system and register the emulator BOPs */
     // RegisterBop(BOP_DEBUGGER  , EmulatorDebugBreakBop);
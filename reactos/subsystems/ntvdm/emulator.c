@@ -130,6 +130,32 @@ VOID WINAPI EmulatorWriteMemory(PFAST486_STATE State, ULONG Address, PVOID Buffe
     }
 }
 
+PVOID WINAPI EmulatorMapMemory(PFAST486_STATE State, ULONG Address, BOOLEAN Write)
+{
+    UNREFERENCED_PARAMETER(State);
+
+    /* Leave the BIOS image hack above to the memory callbacks */
+    if (Address >= 0xFFFFF000) return NULL;
+
+    /* If the A20 line is disabled, mask bit 20 */
+    if (!A20Line) Address &= ~(1 << 20);
+
+    /* Make sure the page is valid */
+    if ((Address + PAGE_SIZE) > MAX_ADDRESS) return NULL;
+
+    /*
+     * The VGA memory is emulated. Keep the whole window out,
+     * so that changing the VGA memory map doesn't need a TLB flush.
+     */
+    if (((Address + PAGE_SIZE) > 0xA0000) && (Address < 0xC0000)) return NULL;
+
+    /* Writes to the ROM area must be ignored */
+    if (Write && ((Address + PAGE_SIZE) > ROM_AREA_START) && (Address <= ROM_AREA_END)) return NULL;
+
+    /* Everything else is plain RAM */
+    return REAL_TO_PHYS(Address);
+}
+
 UCHAR WINAPI EmulatorIntAcknowledge(PFAST486_STATE State)
 {
     UNREFERENCED_PARAMETER(State);
@@ -193,6 +219,10 @@ VOID EmulatorInterruptSignal(VOID)
 VOID EmulatorSetA20(BOOLEAN Enabled)
 {
     A20Line = Enabled;
+
+    /* The memory above 1 MB may be aliased differently now */
+    Fast486InvalidateCache(&EmulatorContext, 0, 0xFFFFFFFF);
+    Fast486FlushTlb(&EmulatorContext);
 }
 
 static VOID WINAPI EmulatorDebugBreakBop(LPWORD Stack)
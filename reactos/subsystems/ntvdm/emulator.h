@@ -87,6 +87,13 @@ VOID WINAPI EmulatorWriteMemory
     ULONG Size
 );
 
+PVOID WINAPI EmulatorMapMemory
+(
+    PFAST486_STATE State,
+    ULONG Address,
+    BOOLEAN Write
+);
+
 UCHAR WINAPI EmulatorIntAcknowledge
 (
     PFAST486_STATE State
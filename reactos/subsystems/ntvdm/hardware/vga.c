@@ -247,6 +247,13 @@ static BOOLEAN DoubleVision = FALSE;
  */
 static BYTE VgaMemory[VGA_NUM_BANKS * VGA_BANK_SIZE];
 
+/*
+ * Blocks of plane offsets written since the graphics framebuffer was last
+ * updated. Only the scanlines displaying them are converted again.
+ */
+static BOOLEAN VgaDirtyBlocks[VGA_DIRTY_BLOCKS];
+static BOOLEAN VgaMemoryDirty = TRUE;
+
 static BYTE VgaLatchRegisters[VGA_NUM_BANKS] = {0, 0, 0, 0};
 
 static BYTE VgaMiscRegister;
@@ -290,6 +297,28 @@ enum SCREEN_MODE
 
 static SMALL_RECT UpdateRectangle = { 0, 0, 0, 0 };
 
+/* Everything the conversion of the graphics memory depends on */
+typedef struct _VGA_DISPLAY_STATE
+{
+    PVOID Framebuffer;
+    COORD Resolution;
+    DWORD StartAddress;
+    DWORD ScanlineSize;
+    DWORD AddressSize;
+    BYTE GcMode;
+    BYTE GcMisc;
+    BYTE AcControl;
+    BOOLEAN AcPalDisable;
+    BOOLEAN DoubleVision;
+    BYTE AcPalette[VGA_AC_PAL_F_REG + 1];
+} VGA_DISPLAY_STATE, *PVGA_DISPLAY_STATE;
+
+static VGA_DISPLAY_STATE LastDisplayState;
+
+/* Spreads the 8 bits of a plane byte over the lowest bits of 8 pixel bytes */
+static ULONGLONG VgaPlanarTable[256];
+static BYTE ScanlineBuffer[VGA_MAXIMUM_WIDTH];
+
 /* RegisterConsoleVDM EMULATION ***********************************************/
 
 #include <ntddvdeo.h>
@@ -1140,13 +1169,198 @@ static VOID VgaChangeMode(VOID)
     UpdateRectangle.Right = Resolution.X;
     UpdateRectangle.Bottom = Resolution.Y;
 
+    /* The new framebuffer has to be converted from scratch */
+    ZeroMemory(&LastDisplayState, sizeof(LastDisplayState));
+
     /* Reset the mode change flag */
     ModeChanged = FALSE;
 }
 
+static inline BOOLEAN VgaIsRangeDirty(DWORD Offset, DWORD Size)
+{
+    DWORD Block = Offset / VGA_DIRTY_BLOCK_SIZE;
+    DWORD LastBlock = (Offset + Size - 1) / VGA_DIRTY_BLOCK_SIZE;
+
+    if (Size == 0) return FALSE;
+
+    /* The range may wrap around the end of the planes */
+    for (; Block <= LastBlock; Block++)
+    {
+        if (VgaDirtyBlocks[Block % VGA_DIRTY_BLOCKS]) return TRUE;
+    }
+
+    return FALSE;
+}
+
+static BOOLEAN VgaSaveDisplayState(COORD Resolution,
+                                   DWORD StartAddress,
+                                   DWORD ScanlineSize,
+                                   DWORD AddressSize)
+{
+    VGA_DISPLAY_STATE State;
+
+    /* Zero the padding too, the states are compared as a whole */
+    ZeroMemory(&State, sizeof(State));
+
+    State.Framebuffer = ConsoleFramebuffer;
+    State.Resolution = Resolution;
+    State.StartAddress = StartAddress;
+    State.ScanlineSize = ScanlineSize;
+    State.AddressSize = AddressSize;
+    State.GcMode = VgaGcRegisters[VGA_GC_MODE_REG]
+                   & (VGA_GC_MODE_OE | VGA_GC_MODE_SHIFTREG | VGA_GC_MODE_SHIFT256);
+    State.GcMisc = VgaGcRegisters[VGA_GC_MISC_REG];
+    State.AcControl = VgaAcRegisters[VGA_AC_CONTROL_REG];
+    State.AcPalDisable = VgaAcPalDisable;
+    State.DoubleVision = DoubleVision;
+    RtlCopyMemory(State.AcPalette, VgaAcRegisters, sizeof(State.AcPalette));
+
+    /* Check if the memory is displayed the same way as the last time */
+    if (RtlCompareMemory(&State, &LastDisplayState, sizeof(State)) == sizeof(State))
+    {
+        return FALSE;
+    }
+
+    LastDisplayState = State;
+    return TRUE;
+}
+
+static VOID VgaConvertScanline(PBYTE Pixels, DWORD Address, SHORT Width, DWORD AddressSize)
+{
+    SHORT j, k;
+
+    /* Check the shifting mode */
+    if (VgaGcRegisters[VGA_GC_MODE_REG] & VGA_GC_MODE_SHIFT256)
+    {
+        /* 4 bits shifted from each plane */
+
+        /* Check if this is 16 or 256 color mode */
+        if (VgaAcRegisters[VGA_AC_CONTROL_REG] & VGA_AC_CONTROL_8BIT)
+        {
+            /* One byte per pixel */
+            for (j = 0; j < Width; j++)
+            {
+                Pixels[j] = VgaMemory[(j % VGA_NUM_BANKS) * VGA_BANK_SIZE
+                                      + LOWORD((Address + (j / VGA_NUM_BANKS)) * AddressSize)];
+            }
+        }
+        else
+        {
+            /* 4-bits per pixel */
+            for (j = 0; j < Width; j++)
+            {
+                BYTE PixelData = VgaMemory[(j % VGA_NUM_BANKS) * VGA_BANK_SIZE
+                                           + LOWORD((Address + (j / (VGA_NUM_BANKS * 2)))
+                                                    * AddressSize)];
+
+                /* Check if we should use the highest 4 bits or lowest 4 */
+                Pixels[j] = (((j / VGA_NUM_BANKS) % 2) == 0) ? (PixelData >> 4)
+                                                             : (PixelData & 0x0F);
+            }
+        }
+    }
+    else if (VgaGcRegisters[VGA_GC_MODE_REG] & VGA_GC_MODE_SHIFTREG)
+    {
+        /* Check if this is 16 or 256 color mode */
+        if (VgaAcRegisters[VGA_AC_CONTROL_REG] & VGA_AC_CONTROL_8BIT)
+        {
+            // TODO: NOT IMPLEMENTED
+            DPRINT1("8-bit interleaved mode is not implemented!\n");
+            ZeroMemory(Pixels, Width);
+        }
+        else
+        {
+            /*
+             * 2 bits shifted from plane 0 and 2 for the first 4 pixels,
+             * then 2 bits shifted from plane 1 and 3 for the next 4
+             */
+            for (j = 0; j < Width; j++)
+            {
+                DWORD BankNumber = (j / 4) % 2;
+                DWORD Offset = LOWORD((Address + (j / 8)) * AddressSize);
+                BYTE LowPlaneData = VgaMemory[BankNumber * VGA_BANK_SIZE + Offset];
+                BYTE HighPlaneData = VgaMemory[(BankNumber + 2) * VGA_BANK_SIZE + Offset];
+
+                /* Extract the two bits from each plane */
+                LowPlaneData = (LowPlaneData >> (6 - ((j % 4) * 2))) & 3;
+                HighPlaneData = (HighPlaneData >> (6 - ((j % 4) * 2))) & 3;
+
+                /* Combine them into the pixel */
+                Pixels[j] = LowPlaneData | (HighPlaneData << 2);
+            }
+        }
+    }
+    else
+    {
+        /* 1 bit shifted from each plane */
+
+        /* Check if this is 16 or 256 color mode */
+        if (VgaAcRegisters[VGA_AC_CONTROL_REG] & VGA_AC_CONTROL_8BIT)
+        {
+            /* 8 bits per pixel, 2 on each plane */
+            for (j = 0; j < Width; j++)
+            {
+                BYTE PixelData = 0;
+
+                for (k = 0; k < VGA_NUM_BANKS; k++)
+                {
+                    /* The data is on plane k, 4 pixels per byte */
+                    BYTE PlaneData = VgaMemory[k * VGA_BANK_SIZE
+                                               + LOWORD((Address + (j / VGA_NUM_BANKS))
+                                                        * AddressSize)];
+
+                    /* The mask of the first bit in the pair */
+                    BYTE BitMask = 1 << (((3 - (j % VGA_NUM_BANKS)) * 2) + 1);
+
+                    /* Bits 0, 1, 2 and 3 come from the first bit of the pair */
+                    if (PlaneData & BitMask) PixelData |= 1 << k;
+
+                    /* Bits 4, 5, 6 and 7 come from the second bit of the pair */
+                    if (PlaneData & (BitMask >> 1)) PixelData |= 1 << (k + 4);
+                }
+
+                Pixels[j] = PixelData;
+            }
+        }
+        else
+        {
+            /* 4 bits per pixel, 1 on each plane, 8 pixels in each plane byte */
+            for (j = 0; j < Width; j += 8)
+            {
+                DWORD Offset = LOWORD((Address + (j / 8)) * AddressSize);
+                ULONGLONG PixelData;
+
+                /* Spread the bits of each plane over the 8 pixels */
+                PixelData = VgaPlanarTable[VgaMemory[Offset]]
+                            | (VgaPlanarTable[VgaMemory[VGA_BANK_SIZE + Offset]] << 1)
+                            | (VgaPlanarTable[VgaMemory[2 * VGA_BANK_SIZE + Offset]] << 2)
+                            | (VgaPlanarTable[VgaMemory[3 * VGA_BANK_SIZE + Offset]] << 3);
+
+                for (k = 0; (k < 8) && ((j + k) < Width); k++)
+                {
+                    Pixels[j + k] = (BYTE)(PixelData >> (k * 8));
+                }
+            }
+        }
+    }
+
+    if (!(VgaAcRegisters[VGA_AC_CONTROL_REG] & VGA_AC_CONTROL_8BIT))
+    {
+        /*
+         * In 16 color mode, the value is an index to the AC registers
+         * if external palette access is disabled, otherwise (in case
+         * of palette loading) it is a blank pixel.
+         */
+        for (j = 0; j < Width; j++)
+        {
+            Pixels[j] = (VgaAcPalDisable ? VgaAcRegisters[Pixels[j] & 0x0F] : 0);
+        }
+    }
+}
+
 static VOID VgaUpdateFramebuffer(VOID)
 {
-    SHORT i, j, k;
+    SHORT i, j;
     COORD Resolution = VgaGetDisplayResolution();
     DWORD AddressSize = VgaGetAddressSize();
     DWORD Address = MAKEWORD(VgaCrtcRegisters[VGA_CRTC_START_ADDR_LOW_REG],
@@ -1165,6 +1379,20 @@ static VOID VgaUpdateFramebuffer(VOID)
         /* Graphics mode */
         PBYTE GraphicsBuffer = (PBYTE)ConsoleFramebuffer;
         DWORD InterlaceHighBit = VGA_INTERLACE_HIGH_BIT;
+        DWORD PixelsPerAddress;
+        BOOLEAN FullUpdate;
+
+        /* Everything must be converted again if the memory is displayed differently */
+        FullUpdate = VgaSaveDisplayState(Resolution, Address, ScanlineSize, AddressSize);
+
+        /* Otherwise only the scanlines which were written to */
+        if (!FullUpdate && !VgaMemoryDirty) return;
+
+        /* Each address holds 4 pixels in 256 color modes and 8 pixels otherwise */
+        PixelsPerAddress = (VgaAcRegisters[VGA_AC_CONTROL_REG] & VGA_AC_CONTROL_8BIT) ? 4 : 8;
+
+        /* The scanline buffer holds one line */
+        Resolution.X = min(Resolution.X, VGA_MAXIMUM_WIDTH);
 
         /*
          * Synchronize access to the graphics framebuffer
@@ -1187,152 +1415,52 @@ static VOID VgaUpdateFramebuffer(VOID)
                 Address |= InterlaceHighBit;
             }
 
-            /* Loop through the pixels */
-            for (j = 0; j < Resolution.X; j++)
+            if (FullUpdate
+                || VgaIsRangeDirty(LOWORD(Address * AddressSize),
+                                   ((Resolution.X + PixelsPerAddress - 1) / PixelsPerAddress)
+                                   * AddressSize))
             {
-                BYTE PixelData = 0;
+                SHORT Left = Resolution.X, Right = -1;
 
-                /* Check the shifting mode */
-                if (VgaGcRegisters[VGA_GC_MODE_REG] & VGA_GC_MODE_SHIFT256)
-                {
-                    /* 4 bits shifted from each plane */
+                /* Convert the scanline */
+                VgaConvertScanline(ScanlineBuffer, Address, Resolution.X, AddressSize);
 
-                    /* Check if this is 16 or 256 color mode */
-                    if (VgaAcRegisters[VGA_AC_CONTROL_REG] & VGA_AC_CONTROL_8BIT)
-                    {
-                        /* One byte per pixel */
-                        PixelData = VgaMemory[(j % VGA_NUM_BANKS) * VGA_BANK_SIZE
-                                              + (Address + (j / VGA_NUM_BANKS))
-                                                * AddressSize];
-                    }
-                    else
-                    {
-                        /* 4-bits per pixel */
-
-                        PixelData = VgaMemory[(j % VGA_NUM_BANKS) * VGA_BANK_SIZE
-                                              + (Address + (j / (VGA_NUM_BANKS * 2)))
-                                                * AddressSize];
-
-                        /* Check if we should use the highest 4 bits or lowest 4 */
-                        if (((j / VGA_NUM_BANKS) % 2) == 0)
-                        {
-                            /* Highest 4 */
-                            PixelData >>= 4;
-                        }
-                        else
-                        {
-                            /* Lowest 4 */
-                            PixelData &= 0x0F;
-                        }
-                    }
-                }
-                else if (VgaGcRegisters[VGA_GC_MODE_REG] & VGA_GC_MODE_SHIFTREG)
+                /* Loop through the pixels */
+                for (j = 0; j < Resolution.X; j++)
                 {
-                    /* Check if this is 16 or 256 color mode */
-                    if (VgaAcRegisters[VGA_AC_CONTROL_REG] & VGA_AC_CONTROL_8BIT)
-                    {
-                        // TODO: NOT IMPLEMENTED
-                        DPRINT1("8-bit interleaved mode is not implemented!\n");
-                    }
-                    else
-                    {
-                        /*
-                         * 2 bits shifted from plane 0 and 2 for the first 4 pixels,
-                         * then 2 bits shifted from plane 1 and 3 for the next 4
-                         */
-                        DWORD BankNumber = (j / 4) % 2;
-                        DWORD Offset = Address + (j / 8);
-                        BYTE LowPlaneData = VgaMemory[BankNumber * VGA_BANK_SIZE + Offset * AddressSize];
-                        BYTE HighPlaneData = VgaMemory[(BankNumber + 2) * VGA_BANK_SIZE + Offset * AddressSize];
-
-                        /* Extract the two bits from each plane */
-                        LowPlaneData = (LowPlaneData >> (6 - ((j % 4) * 2))) & 3;
-                        HighPlaneData = (HighPlaneData >> (6 - ((j % 4) * 2))) & 3;
-
-                        /* Combine them into the pixel */
-                        PixelData = LowPlaneData | (HighPlaneData << 2);
-                    }
-                }
-                else
-                {
-                    /* 1 bit shifted from each plane */
-
-                    /* Check if this is 16 or 256 color mode */
-                    if (VgaAcRegisters[VGA_AC_CONTROL_REG] & VGA_AC_CONTROL_8BIT)
-                    {
-                        /* 8 bits per pixel, 2 on each plane */
-
-                        for (k = 0; k < VGA_NUM_BANKS; k++)
-                        {
-                            /* The data is on plane k, 4 pixels per byte */
-                            BYTE PlaneData = VgaMemory[k * VGA_BANK_SIZE
-                                                       + (Address + (j / VGA_NUM_BANKS))
-                                                         * AddressSize];
-
-                            /* The mask of the first bit in the pair */
-                            BYTE BitMask = 1 << (((3 - (j % VGA_NUM_BANKS)) * 2) + 1);
+                    BYTE PixelData = ScanlineBuffer[j];
 
-                            /* Bits 0, 1, 2 and 3 come from the first bit of the pair */
-                            if (PlaneData & BitMask) PixelData |= 1 << k;
-
-                            /* Bits 4, 5, 6 and 7 come from the second bit of the pair */
-                            if (PlaneData & (BitMask >> 1)) PixelData |= 1 << (k + 4);
-                        }
-                    }
-                    else
+                    /* Take into account DoubleVision mode when checking for pixel updates */
+                    if (DoubleVision)
                     {
-                        /* 4 bits per pixel, 1 on each plane */
-
-                        for (k = 0; k < VGA_NUM_BANKS; k++)
-                        {
-                            BYTE PlaneData = VgaMemory[k * VGA_BANK_SIZE
-                                                       + (Address + (j / (VGA_NUM_BANKS * 2)))
-                                                         * AddressSize];
-
-                            /* If the bit on that plane is set, set it */
-                            if (PlaneData & (1 << (7 - (j % 8)))) PixelData |= 1 << k;
-                        }
-                    }
-                }
-
-                if (!(VgaAcRegisters[VGA_AC_CONTROL_REG] & VGA_AC_CONTROL_8BIT))
-                {
-                    /*
-                     * In 16 color mode, the value is an index to the AC registers
-                     * if external palette access is disabled, otherwise (in case
-                     * of palette loading) it is a blank pixel.
-                     */
-                    PixelData = (VgaAcPalDisable ? VgaAcRegisters[PixelData & 0x0F]
-                                                 : 0);
-                }
+                        /* Now check if the resulting pixel data has changed */
+                        if (GraphicsBuffer[(i * Resolution.X * 4) + (j * 2)] == PixelData) continue;
 
-                /* Take into account DoubleVision mode when checking for pixel updates */
-                if (DoubleVision)
-                {
-                    /* Now check if the resulting pixel data has changed */
-                    if (GraphicsBuffer[(i * Resolution.X * 4) + (j * 2)] != PixelData)
-                    {
                         /* Yes, write the new value */
                         GraphicsBuffer[(i * Resolution.X * 4) + (j * 2)] = PixelData;
                         GraphicsBuffer[(i * Resolution.X * 4) + (j * 2 + 1)] = PixelData;
                         GraphicsBuffer[((i * 2 + 1) * Resolution.X * 2) + (j * 2)] = PixelData;
                         GraphicsBuffer[((i * 2 + 1) * Resolution.X * 2) + (j * 2 + 1)] = PixelData;
-
-                        /* Mark the specified pixel as changed */
-                        VgaMarkForUpdate(i, j);
                     }
-                }
-                else
-                {
-                    /* Now check if the resulting pixel data has changed */
-                    if (GraphicsBuffer[i * Resolution.X + j] != PixelData)
+                    else
                     {
+                        /* Now check if the resulting pixel data has changed */
+                        if (GraphicsBuffer[i * Resolution.X + j] == PixelData) continue;
+
                         /* Yes, write the new value */
                         GraphicsBuffer[i * Resolution.X + j] = PixelData;
-
-                        /* Mark the specified pixel as changed */
-                        VgaMarkForUpdate(i, j);
                     }
+
+                    /* Remember the changed part of the scanline */
+                    Left = min(Left, j);
+                    Right = j;
+                }
+
+                if (Right >= Left)
+                {
+                    /* Mark the changed pixels for update */
+                    VgaMarkForUpdate(i, Left);
+                    VgaMarkForUpdate(i, Right);
                 }
             }
 
@@ -1349,6 +1477,10 @@ static VOID VgaUpdateFramebuffer(VOID)
             }
         }
 
+        /* The framebuffer is up to date now */
+        ZeroMemory(VgaDirtyBlocks, sizeof(VgaDirtyBlocks));
+        VgaMemoryDirty = FALSE;
+
         /*
          * Release the console framebuffer mutex
          * so that we allow for repainting.
@@ -1896,12 +2028,23 @@ VOID VgaWriteMemory(DWORD Address, LPBYTE Buffer, DWORD Size)
             /* Copy the value to the VGA memory */
             VgaMemory[VideoAddress + j * VGA_BANK_SIZE] = VgaTranslateByteForWriting(Buffer[i], j);
         }
+
+        /* Mark the offset as dirty */
+        VgaDirtyBlocks[LOWORD(VideoAddress) / VGA_DIRTY_BLOCK_SIZE] = TRUE;
+        VgaMemoryDirty = TRUE;
     }
 }
 
+static VOID VgaMarkAllDirty(VOID)
+{
+    FillMemory(VgaDirtyBlocks, sizeof(VgaDirtyBlocks), TRUE);
+    VgaMemoryDirty = TRUE;
+}
+
 VOID VgaClearMemory(VOID)
 {
     ZeroMemory(VgaMemory, sizeof(VgaMemory));
+    VgaMarkAllDirty();
 }
 
 VOID VgaResetPalette(VOID)
@@ -1935,6 +2078,9 @@ VOID VgaWriteFont(UINT FontNumber, CONST UCHAR *FontData, UINT Height)
             FontMemory[i * VGA_MAX_FONT_HEIGHT + j] = 0;
         }
     }
+
+    /* The font plane is displayed in graphics modes */
+    VgaMarkAllDirty();
 }
 
 VOID ScreenEventHandler(PWINDOW_BUFFER_SIZE_RECORD ScreenEvent)
@@ -2006,6 +2152,18 @@ VOID VgaDetachFromConsole(BOOL ChangingMode)
 
 BOOLEAN VgaInitialize(HANDLE TextHandle)
 {
+    UINT i, j;
+
+    /* Build the planar to chunky conversion table, the leftmost pixel is the MSB */
+    for (i = 0; i < 256; i++)
+    {
+        VgaPlanarTable[i] = 0;
+        for (j = 0; j < 8; j++)
+        {
+            if (i & (0x80 >> j)) VgaPlanarTable[i] |= (ULONGLONG)1 << (j * 8);
+        }
+    }
+
     /* Save the default text-mode console output handle */
     if (!IsConsoleHandle(TextHandle)) return FALSE;
     TextConsoleBuffer = TextHandle;
@@ -22,6 +22,9 @@
 #define VGA_BITMAP_INFO_SIZE (sizeof(BITMAPINFOHEADER) + 2 * (VGA_PALETTE_SIZE / 3))
 #define VGA_MINIMUM_WIDTH 400
 #define VGA_MINIMUM_HEIGHT 300
+#define VGA_MAXIMUM_WIDTH (256 * 9)
+#define VGA_DIRTY_BLOCK_SIZE 64
+#define VGA_DIRTY_BLOCKS (VGA_BANK_SIZE / VGA_DIRTY_BLOCK_SIZE)
 #define VGA_DAC_TO_COLOR(x) (((x) << 2) | ((x) >> 4))
 #define VGA_COLOR_TO_DAC(x) ((x) >> 2)
 #define VGA_INTERLACE_HIGH_BIT (1 << 13)
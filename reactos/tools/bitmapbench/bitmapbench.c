@@ -0,0 +1,421 @@
+/*
+ * PROJECT:         ReactOS host tools
+ * LICENSE:         GPL - See COPYING in the top level directory
+ * PURPOSE:         Benchmark and correctness test for the RTL bitmap search routines
+ * PROGRAMMERS:     ReactOS Team
+ *
+ * The search routines are first checked against a simple bit by bit model on
+ * random bitmaps of every size up to 160 bits, with every hint and every run
+ * length. The bits past the end of the bitmap are random, too. Then the time
+ * per call is measured on large bitmaps with typical layouts.
+ * The process exit code is the number of failed checks, capped at 255.
+ *
+ * Usage: bitmapbench [-t ms] [-s seed]
+ */
+
+#include <rtl.h>
+#include <time.h>
+
+#define MAX_TEST_BITS   160
+#define MAX_TEST_RUNS   8
+#define BENCH_BITS      (1024 * 1024)
+
+typedef struct
+{
+    const char *pszName;
+    PULONG pulBuffer;
+} LAYOUT;
+
+static ULONG gulMinTimeMs = 500;
+static ULONG gulSeed = 12345;
+static ULONG gcFailures = 0;
+
+static
+ULONG
+Random(VOID)
+{
+    gulSeed = gulSeed * 1103515245 + 12345;
+    return (gulSeed >> 16) | (gulSeed << 16);
+}
+
+static
+double
+ElapsedMs(clock_t Start)
+{
+    return (double)(clock() - Start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+static
+BOOLEAN
+TestBit(PRTL_BITMAP pBitMap, ULONG ulIndex)
+{
+    return (pBitMap->Buffer[ulIndex / 32] >> (ulIndex % 32)) & 1;
+}
+
+/* Reference for RtlFindClearBits/RtlFindSetBits: search from the hint to the
+   end, then for runs starting before the hint */
+static
+ULONG
+RefFindBits(PRTL_BITMAP pBitMap, BOOLEAN bSet, ULONG cBits, ULONG ulHint)
+{
+    ULONG ulStart, ulEnd, ulIndex, i;
+
+    if (cBits > pBitMap->SizeOfBitMap)
+        return MAXULONG;
+    if (ulHint >= pBitMap->SizeOfBitMap)
+        ulHint = 0;
+    if (cBits == 0)
+        return ulHint & ~7;
+
+    for (i = 0; i < 2; i++)
+    {
+        ulStart = i ? 0 : ulHint;
+        ulEnd = i ? ulHint : pBitMap->SizeOfBitMap;
+
+        for (ulIndex = ulStart; ulIndex < ulEnd; ulIndex++)
+        {
+            ULONG j;
+
+            if (ulIndex + cBits > pBitMap->SizeOfBitMap)
+                break;
+
+            for (j = 0; j < cBits; j++)
+            {
+                if (TestBit(pBitMap, ulIndex + j) != bSet)
+                    break;
+            }
+
+            if (j == cBits)
+                return ulIndex;
+        }
+    }
+
+    return MAXULONG;
+}
+
+/* Reference for the run routines, returns all runs in order */
+static
+ULONG
+RefGetRuns(PRTL_BITMAP pBitMap, BOOLEAN bSet, PRTL_BITMAP_RUN pRuns)
+{
+    ULONG cRuns = 0, ulIndex;
+
+    for (ulIndex = 0; ulIndex < pBitMap->SizeOfBitMap; ulIndex++)
+    {
+        if (TestBit(pBitMap, ulIndex) != bSet)
+            continue;
+
+        if (ulIndex == 0 || TestBit(pBitMap, ulIndex - 1) != bSet)
+        {
+            pRuns[cRuns].StartingIndex = ulIndex;
+            pRuns[cRuns].NumberOfBits = 0;
+            cRuns++;
+        }
+
+        pRuns[cRuns - 1].NumberOfBits++;
+    }
+
+    return cRuns;
+}
+
+static
+int
+CompareRunLength(const void *p1, const void *p2)
+{
+    ULONG ul1 = ((const RTL_BITMAP_RUN *)p1)->NumberOfBits;
+    ULONG ul2 = ((const RTL_BITMAP_RUN *)p2)->NumberOfBits;
+
+    return (ul1 < ul2) - (ul1 > ul2);
+}
+
+static
+VOID
+Fail(PRTL_BITMAP pBitMap, const char *pszFormat, ULONG ulArg1, ULONG ulArg2,
+     ULONG ulResult, ULONG ulExpected)
+{
+    if (gcFailures++ < 20)
+    {
+        printf("size %lu: ", (unsigned long)pBitMap->SizeOfBitMap);
+        printf(pszFormat, (unsigned long)ulArg1, (unsigned long)ulArg2);
+        printf(" returned 0x%lx, expected 0x%lx\n",
+               (unsigned long)ulResult, (unsigned long)ulExpected);
+    }
+}
+
+static
+VOID
+CheckBitMap(PRTL_BITMAP pBitMap)
+{
+    static RTL_BITMAP_RUN aRefRuns[MAX_TEST_BITS], aRuns[MAX_TEST_RUNS];
+    ULONG aulCopy[MAX_TEST_BITS / 32 + 1];
+    RTL_BITMAP Copy;
+    ULONG cBits, ulHint, ulResult, ulExpected, ulIndex, cRefRuns, cRuns, i, j;
+    BOOLEAN bSet;
+
+    for (cBits = 0; cBits <= pBitMap->SizeOfBitMap + 1; cBits++)
+    {
+        for (ulHint = 0; ulHint <= pBitMap->SizeOfBitMap + 1; ulHint++)
+        {
+            ulExpected = RefFindBits(pBitMap, FALSE, cBits, ulHint);
+            ulResult = RtlFindClearBits(pBitMap, cBits, ulHint);
+            if (ulResult != ulExpected)
+                Fail(pBitMap, "RtlFindClearBits(%lu, %lu)", cBits, ulHint, ulResult, ulExpected);
+
+            ulResult = RtlFindSetBits(pBitMap, cBits, ulHint);
+            if (ulResult != RefFindBits(pBitMap, TRUE, cBits, ulHint))
+                Fail(pBitMap, "RtlFindSetBits(%lu, %lu)", cBits, ulHint, ulResult,
+                     RefFindBits(pBitMap, TRUE, cBits, ulHint));
+        }
+    }
+
+    /* The bits found must be set afterwards, and nothing else */
+    memcpy(aulCopy, pBitMap->Buffer, sizeof(aulCopy));
+    RtlInitializeBitMap(&Copy, aulCopy, pBitMap->SizeOfBitMap);
+    cBits = Random() % 40 + 1;
+    ulHint = Random() % (pBitMap->SizeOfBitMap + 1);
+    ulExpected = RefFindBits(&Copy, FALSE, cBits, ulHint);
+    ulResult = RtlFindClearBitsAndSet(&Copy, cBits, ulHint);
+    if (ulResult != ulExpected)
+        Fail(pBitMap, "RtlFindClearBitsAndSet(%lu, %lu)", cBits, ulHint, ulResult, ulExpected);
+    if (ulResult != MAXULONG)
+        RtlClearBits(&Copy, ulResult, cBits);
+    if (memcmp(aulCopy, pBitMap->Buffer, sizeof(aulCopy)))
+        Fail(pBitMap, "RtlFindClearBitsAndSet(%lu, %lu) bits", cBits, ulHint, 0, 0);
+
+    for (bSet = FALSE; bSet <= TRUE; bSet++)
+    {
+        const char *pszName = bSet ? "RtlFindLongestRunSet(%lu)" : "RtlFindLongestRunClear(%lu)";
+
+        /* The longest run is the first of the longest ones */
+        cRefRuns = RefGetRuns(pBitMap, bSet, aRefRuns);
+        for (i = 0, j = 0; i < cRefRuns; i++)
+        {
+            if (aRefRuns[i].NumberOfBits > aRefRuns[j].NumberOfBits)
+                j = i;
+        }
+
+        ulIndex = MAXULONG;
+        ulResult = bSet ? RtlFindLongestRunSet(pBitMap, &ulIndex) :
+                          RtlFindLongestRunClear(pBitMap, &ulIndex);
+        ulExpected = cRefRuns ? aRefRuns[j].NumberOfBits : 0;
+        if (ulResult != ulExpected)
+            Fail(pBitMap, pszName, 0, 0, ulResult, ulExpected);
+        else if (cRefRuns && ulIndex != aRefRuns[j].StartingIndex)
+            Fail(pBitMap, pszName, 0, 0, ulIndex, aRefRuns[j].StartingIndex);
+    }
+
+    cRefRuns = RefGetRuns(pBitMap, FALSE, aRefRuns);
+    for (i = 0; i <= MAX_TEST_RUNS; i++)
+    {
+        /* Without LocateLongestRuns, the first runs are returned in order */
+        cRuns = RtlFindClearRuns(pBitMap, aRuns, i, FALSE);
+        ulExpected = min(i, cRefRuns);
+        if (cRuns != ulExpected)
+            Fail(pBitMap, "RtlFindClearRuns(%lu, %lu)", i, FALSE, cRuns, ulExpected);
+        else if (memcmp(aRuns, aRefRuns, cRuns * sizeof(RTL_BITMAP_RUN)))
+            Fail(pBitMap, "RtlFindClearRuns(%lu, %lu) runs", i, FALSE, 0, 0);
+
+        /* With it, any order of real runs with the longest lengths */
+        cRuns = RtlFindClearRuns(pBitMap, aRuns, i, TRUE);
+        if (cRuns != ulExpected)
+        {
+            Fail(pBitMap, "RtlFindClearRuns(%lu, %lu)", i, TRUE, cRuns, ulExpected);
+            continue;
+        }
+
+        for (j = 0; j < cRuns; j++)
+        {
+            ulIndex = aRuns[j].StartingIndex;
+            if ((ulIndex != 0 && !TestBit(pBitMap, ulIndex - 1)) ||
+                aRuns[j].NumberOfBits == 0 ||
+                RefFindBits(pBitMap, FALSE, aRuns[j].NumberOfBits, ulIndex) != ulIndex ||
+                (ulIndex + aRuns[j].NumberOfBits < pBitMap->SizeOfBitMap &&
+                 !TestBit(pBitMap, ulIndex + aRuns[j].NumberOfBits)))
+            {
+                Fail(pBitMap, "RtlFindClearRuns(%lu, %lu) bad run", i, TRUE, ulIndex, 0);
+            }
+        }
+
+        qsort(aRuns, cRuns, sizeof(RTL_BITMAP_RUN), CompareRunLength);
+        qsort(aRefRuns, cRefRuns, sizeof(RTL_BITMAP_RUN), CompareRunLength);
+        for (j = 0; j < cRuns; j++)
+        {
+            if (aRuns[j].NumberOfBits != aRefRuns[j].NumberOfBits)
+                Fail(pBitMap, "RtlFindClearRuns(%lu, %lu) length", i, TRUE,
+                     aRuns[j].NumberOfBits, aRefRuns[j].NumberOfBits);
+        }
+
+        /* Restore the order for the next round */
+        cRefRuns = RefGetRuns(pBitMap, FALSE, aRefRuns);
+    }
+}
+
+/* Random bits, biased towards set or clear, or long runs of either */
+static
+VOID
+FillRandom(PULONG pulBuffer, ULONG cUlongs, ULONG ulKind)
+{
+    ULONG i;
+
+    for (i = 0; i < cUlongs; i++)
+    {
+        switch (ulKind)
+        {
+            case 0: pulBuffer[i] = Random(); break;
+            case 1: pulBuffer[i] = Random() & Random() & Random(); break;
+            case 2: pulBuffer[i] = Random() | Random() | Random(); break;
+            default:
+                pulBuffer[i] = (Random() % 4) ? ((Random() & 1) ? 0 : ~0) : Random();
+                break;
+        }
+    }
+}
+
+static
+VOID
+RunTests(VOID)
+{
+    ULONG aulBuffer[MAX_TEST_BITS / 32 + 1];
+    RTL_BITMAP BitMap;
+    ULONG cBits, ulKind, cChecks = 0;
+
+    for (cBits = 0; cBits <= MAX_TEST_BITS; cBits++)
+    {
+        for (ulKind = 0; ulKind < 4; ulKind++)
+        {
+            FillRandom(aulBuffer, MAX_TEST_BITS / 32 + 1, ulKind);
+            RtlInitializeBitMap(&BitMap, aulBuffer, cBits);
+            CheckBitMap(&BitMap);
+            cChecks++;
+        }
+    }
+
+    printf("%lu random bitmaps checked, %lu failures\n",
+           (unsigned long)cChecks, (unsigned long)gcFailures);
+}
+
+/* Layouts of the allocation maps the kernel keeps */
+static
+ULONG
+CreateLayouts(LAYOUT *pLayouts)
+{
+    const ULONG cUlongs = BENCH_BITS / 32;
+    RTL_BITMAP BitMap;
+    ULONG i, j;
+
+    for (i = 0; i < 3; i++)
+        pLayouts[i].pulBuffer = malloc(cUlongs * sizeof(ULONG));
+
+    /* About half used, in small pieces */
+    pLayouts[0].pszName = "<fragmented>";
+    FillRandom(pLayouts[0].pulBuffer, cUlongs, 0);
+
+    /* Full, with a few short holes and one long one near the end */
+    pLayouts[1].pszName = "<full>";
+    RtlInitializeBitMap(&BitMap, pLayouts[1].pulBuffer, BENCH_BITS);
+    RtlSetBits(&BitMap, 0, BENCH_BITS);
+    for (i = 0; i < BENCH_BITS - 64; i += 4096 + Random() % 1024)
+        RtlClearBits(&BitMap, i, Random() % 16 + 1);
+    RtlClearBits(&BitMap, BENCH_BITS - 8192, 4096);
+
+    /* Mostly free, allocations of a few bits here and there */
+    pLayouts[2].pszName = "<sparse>";
+    RtlInitializeBitMap(&BitMap, pLayouts[2].pulBuffer, BENCH_BITS);
+    RtlClearBits(&BitMap, 0, BENCH_BITS);
+    for (j = 0; j < BENCH_BITS / 64; j++)
+    {
+        i = Random() % (BENCH_BITS - 8);
+        RtlSetBits(&BitMap, i, Random() % 8 + 1);
+    }
+
+    return 3;
+}
+
+static
+VOID
+RunBenchmark(const LAYOUT *pLayout)
+{
+    static const ULONG acBits[] = { 1, 16, 64, 1024 };
+    RTL_BITMAP_RUN aRuns[16];
+    RTL_BITMAP BitMap;
+    double adUs[6];
+    ULONG cCalls, ulIndex, ulSum = 0, i;
+    clock_t Start;
+
+    RtlInitializeBitMap(&BitMap, pLayout->pulBuffer, BENCH_BITS);
+
+    for (i = 0; i < 4; i++)
+    {
+        Start = clock();
+        cCalls = 0;
+        do
+        {
+            ulSum += RtlFindClearBits(&BitMap, acBits[i], (cCalls * 7919) % BENCH_BITS);
+            cCalls++;
+        } while (ElapsedMs(Start) < gulMinTimeMs);
+        adUs[i] = ElapsedMs(Start) * 1000.0 / cCalls;
+    }
+
+    Start = clock();
+    cCalls = 0;
+    do
+    {
+        ulSum += RtlFindClearRuns(&BitMap, aRuns, 16, TRUE);
+        cCalls++;
+    } while (ElapsedMs(Start) < gulMinTimeMs);
+    adUs[4] = ElapsedMs(Start) * 1000.0 / cCalls;
+
+    Start = clock();
+    cCalls = 0;
+    do
+    {
+        ulSum += RtlFindLongestRunClear(&BitMap, &ulIndex);
+        cCalls++;
+    } while (ElapsedMs(Start) < gulMinTimeMs);
+    adUs[5] = ElapsedMs(Start) * 1000.0 / cCalls;
+
+    printf("%-14s %10.2f %10.2f %10.2f %10.2f %10.1f %10.1f  (%lx)\n",
+           pLayout->pszName, adUs[0], adUs[1], adUs[2], adUs[3], adUs[4], adUs[5],
+           (unsigned long)ulSum);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LAYOUT aLayouts[3];
+    ULONG cLayouts, i;
+    int iArg;
+
+    for (iArg = 1; iArg < argc; iArg++)
+    {
+        if (!strcmp(argv[iArg], "-t") && iArg + 1 < argc)
+        {
+            gulMinTimeMs = atoi(argv[++iArg]);
+        }
+        else if (!strcmp(argv[iArg], "-s") && iArg + 1 < argc)
+        {
+            gulSeed = strtoul(argv[++iArg], NULL, 0);
+        }
+        else
+        {
+            printf("Usage: bitmapbench [-t ms] [-s seed]\n");
+            return -1;
+        }
+    }
+
+    RunTests();
+
+    cLayouts = CreateLayouts(aLayouts);
+
+    printf("\nmicroseconds per call on %lu bits\n", (unsigned long)BENCH_BITS);
+    printf("%-14s %10s %10s %10s %10s %10s %10s\n", "LAYOUT",
+           "clear 1", "clear 16", "clear 64", "clear 1024", "runs 16", "longest");
+
+    for (i = 0; i < cLayouts; i++)
+    {
+        RunBenchmark(&aLayouts[i]);
+        free(aLayouts[i].pulBuffer);
+    }
+
+    return (int)min(gcFailures, 255);
+}
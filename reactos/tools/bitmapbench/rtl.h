@@ -0,0 +1,72 @@
+/*
+ * PROJECT:         ReactOS host tools
+ * LICENSE:         GPL - See COPYING in the top level directory
+ * PURPOSE:         Stand-in for rtl.h, enough to build lib/rtl/bitmap.c on the host
+ * PROGRAMMERS:     ReactOS Team
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+#include <typedefs.h>
+
+#define _In_
+#define _In_opt_
+#define _In_range_(l, h)
+#define _Inout_
+#define _Out_
+#define __drv_aliasesMem
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define BitScanForward(Index, Mask) _BitScanForward((unsigned long *)(Index), Mask)
+#define BitScanReverse(Index, Mask) _BitScanReverse((unsigned long *)(Index), Mask)
+#else
+static inline
+BOOLEAN
+BitScanForward(PULONG Index, ULONG Mask)
+{
+    if (!Mask)
+        return FALSE;
+    *Index = __builtin_ctz(Mask);
+    return TRUE;
+}
+
+static inline
+BOOLEAN
+BitScanReverse(PULONG Index, ULONG Mask)
+{
+    if (!Mask)
+        return FALSE;
+    *Index = 31 - __builtin_clz(Mask);
+    return TRUE;
+}
+#endif
+
+static inline
+VOID
+RtlFillMemoryUlong(PVOID Destination, SIZE_T Length, ULONG Fill)
+{
+    PULONG Dest = Destination;
+    SIZE_T i;
+
+    for (i = 0; i < Length / sizeof(ULONG); i++)
+        Dest[i] = Fill;
+}
+
+VOID NTAPI RtlInitializeBitMap(PRTL_BITMAP BitMapHeader, PULONG BitMapBuffer, ULONG SizeOfBitMap);
+VOID NTAPI RtlClearBits(PRTL_BITMAP BitMapHeader, ULONG StartingIndex, ULONG NumberToClear);
+VOID NTAPI RtlSetBits(PRTL_BITMAP BitMapHeader, ULONG StartingIndex, ULONG NumberToSet);
+ULONG NTAPI RtlFindClearBits(PRTL_BITMAP BitMapHeader, ULONG NumberToFind, ULONG HintIndex);
+ULONG NTAPI RtlFindSetBits(PRTL_BITMAP BitMapHeader, ULONG NumberToFind, ULONG HintIndex);
+ULONG NTAPI RtlFindClearBitsAndSet(PRTL_BITMAP BitMapHeader, ULONG NumberToFind, ULONG HintIndex);
+ULONG NTAPI RtlFindSetBitsAndClear(PRTL_BITMAP BitMapHeader, ULONG NumberToFind, ULONG HintIndex);
+ULONG NTAPI RtlFindClearRuns(PRTL_BITMAP BitMapHeader, PRTL_BITMAP_RUN RunArray,
+                             ULONG SizeOfRunArray, BOOLEAN LocateLongestRuns);
+ULONG NTAPI RtlFindLongestRunClear(PRTL_BITMAP BitMapHeader, PULONG StartingIndex);
+ULONG NTAPI RtlFindLongestRunSet(PRTL_BITMAP BitMapHeader, PULONG StartingIndex);
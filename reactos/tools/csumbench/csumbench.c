@@ -0,0 +1,287 @@
+/*
+ * PROJECT:         ReactOS host tools
+ * LICENSE:         GPL - See COPYING in the top level directory
+ * PURPOSE:         Benchmark and correctness test for the tcpip checksum routines
+ * PROGRAMMERS:     ReactOS Team
+ *
+ * ChecksumCompute and ChecksumCopy are first checked against the RFC 1071
+ * 16-bit loop on random buffers of every length up to 2048 bytes, at every
+ * alignment and with random seeds. UDPv4ChecksumCalculate is checked against
+ * the byte by byte version it replaced. Then the throughput of the RFC 1071
+ * loop, ChecksumCompute, ChecksumCopy and a copy followed by a checksum is
+ * measured for typical packet sizes.
+ * The process exit code is the number of failed checks, capped at 255.
+ *
+ * The clock is only read every few hundred calls, so that it doesn't
+ * dominate the small packet sizes.
+ *
+ * Usage: csumbench [-t ms] [-s seed]
+ */
+
+#include <precomp.h>
+#include <time.h>
+
+#define MAX_TEST_LENGTH     2048
+#define MAX_BENCH_LENGTH    9000
+#define BENCH_BATCH         256
+
+static ULONG gulMinTimeMs = 500;
+static ULONG gulSeed = 12345;
+static ULONG gcFailures = 0;
+
+static
+ULONG
+Random(VOID)
+{
+    gulSeed = gulSeed * 1103515245 + 12345;
+    return (gulSeed >> 16) | (gulSeed << 16);
+}
+
+static
+double
+ElapsedMs(clock_t Start)
+{
+    return (double)(clock() - Start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+static
+double
+MBytesPerSecond(ULONG cjData, ULONG cIterations, double dMs)
+{
+    return dMs > 0 ? (double)cjData * cIterations / (dMs * 1000.0) : 0;
+}
+
+/* The RFC 1071 loop ChecksumCompute used before */
+static
+ULONG
+RefChecksumCompute(PVOID Data, UINT Count, ULONG Seed)
+{
+    ULONG Sum = Seed;
+
+    while (Count > 1)
+    {
+        Sum += *(PUSHORT)Data;
+        Count -= 2;
+        Data = (PVOID)((ULONG_PTR)Data + 2);
+    }
+
+    /* Add left-over byte, if any */
+    if (Count > 0)
+        Sum += *(PUCHAR)Data;
+
+    return Sum;
+}
+
+/* The byte by byte UDPv4ChecksumCalculate used before */
+static
+ULONG
+RefUDPv4ChecksumCalculate(PIPv4_HEADER IPHeader, PUCHAR PacketBuffer, ULONG DataLength)
+{
+    ULONG Sum = 0;
+    USHORT TmpSum;
+    ULONG i;
+    BOOLEAN Pad;
+
+    Pad = (DataLength & 1);
+    if (Pad)
+        DataLength++;
+
+    for (i = 0; i < DataLength; i += 2)
+    {
+        TmpSum = ((PacketBuffer[i] << 8) & 0xFF00) +
+                 ((Pad && i == DataLength - 2) ? 0 : (PacketBuffer[i + 1] & 0x00FF));
+        Sum += TmpSum;
+    }
+
+    for (i = 0; i < sizeof(IPv4_RAW_ADDRESS); i += 2)
+    {
+        TmpSum = ((((PUCHAR)&IPHeader->SrcAddr)[i] << 8) & 0xFF00) +
+                 (((PUCHAR)&IPHeader->SrcAddr)[i + 1] & 0x00FF);
+        Sum += TmpSum;
+    }
+
+    for (i = 0; i < sizeof(IPv4_RAW_ADDRESS); i += 2)
+    {
+        TmpSum = ((((PUCHAR)&IPHeader->DstAddr)[i] << 8) & 0xFF00) +
+                 (((PUCHAR)&IPHeader->DstAddr)[i + 1] & 0x00FF);
+        Sum += TmpSum;
+    }
+
+    Sum += IPPROTO_UDP + (DataLength - (Pad ? 1 : 0));
+
+    return ~ChecksumFold(Sum);
+}
+
+static
+VOID
+Fail(const char *pszName, ULONG cjData, ULONG ulAlign, ULONG ulResult, ULONG ulExpected)
+{
+    if (gcFailures++ < 20)
+    {
+        printf("%s: length %lu align %lu returned 0x%lx, expected 0x%lx\n",
+               pszName, (unsigned long)cjData, (unsigned long)ulAlign,
+               (unsigned long)ulResult, (unsigned long)ulExpected);
+    }
+}
+
+static
+VOID
+RunTests(VOID)
+{
+    static UCHAR ajSource[MAX_TEST_LENGTH + 16], ajCopy[MAX_TEST_LENGTH + 16];
+    IPv4_HEADER Header;
+    ULONG cjData, ulAlign, ulSeed, ulExpected, ulResult, i;
+
+    for (i = 0; i < sizeof(ajSource); i++)
+        ajSource[i] = (UCHAR)Random();
+
+    for (cjData = 0; cjData <= MAX_TEST_LENGTH; cjData++)
+    {
+        for (ulAlign = 0; ulAlign < 8; ulAlign++)
+        {
+            /* Keep the seed small enough for the reference not to overflow */
+            ulSeed = Random() & 0xFFFF;
+
+            /* The sums may differ in how far they are folded, but not in
+               their value */
+            ulExpected = ChecksumFold(RefChecksumCompute(ajSource + ulAlign, cjData, ulSeed));
+
+            ulResult = ChecksumFold(ChecksumCompute(ajSource + ulAlign, cjData, ulSeed));
+            if (ulResult != ulExpected)
+                Fail("ChecksumCompute", cjData, ulAlign, ulResult, ulExpected);
+
+            memset(ajCopy, 0xCC, sizeof(ajCopy));
+            ulResult = ChecksumFold(ChecksumCopy(ajCopy + (7 - ulAlign),
+                                                 ajSource + ulAlign,
+                                                 cjData,
+                                                 ulSeed));
+            if (ulResult != ulExpected)
+                Fail("ChecksumCopy", cjData, ulAlign, ulResult, ulExpected);
+            if (memcmp(ajCopy + (7 - ulAlign), ajSource + ulAlign, cjData) ||
+                ajCopy[7 - ulAlign + cjData] != 0xCC ||
+                (ulAlign < 7 && ajCopy[6 - ulAlign] != 0xCC))
+            {
+                Fail("ChecksumCopy data", cjData, ulAlign, 0, 0);
+            }
+        }
+
+        /* A UDP datagram is at least a header long */
+        if (cjData >= 8)
+        {
+            Header.SrcAddr = Random();
+            Header.DstAddr = Random();
+            ulExpected = RefUDPv4ChecksumCalculate(&Header, ajSource, cjData);
+            ulResult = UDPv4ChecksumCalculate(&Header, ajSource, cjData);
+            if (ulResult != ulExpected)
+                Fail("UDPv4ChecksumCalculate", cjData, 0, ulResult, ulExpected);
+        }
+    }
+
+    printf("%lu failed checks\n", (unsigned long)gcFailures);
+}
+
+static
+VOID
+RunBenchmark(ULONG cjData, PUCHAR pjSource, PUCHAR pjDest)
+{
+    double adMBps[4];
+    ULONG cIterations, ulSum = 0, i;
+    clock_t Start;
+
+    Start = clock();
+    cIterations = 0;
+    do
+    {
+        for (i = 0; i < BENCH_BATCH; i++)
+            ulSum += RefChecksumCompute(pjSource, cjData, ulSum);
+        cIterations += BENCH_BATCH;
+    } while (ElapsedMs(Start) < gulMinTimeMs);
+    adMBps[0] = MBytesPerSecond(cjData, cIterations, ElapsedMs(Start));
+
+    Start = clock();
+    cIterations = 0;
+    do
+    {
+        for (i = 0; i < BENCH_BATCH; i++)
+            ulSum += ChecksumCompute(pjSource, cjData, ulSum);
+        cIterations += BENCH_BATCH;
+    } while (ElapsedMs(Start) < gulMinTimeMs);
+    adMBps[1] = MBytesPerSecond(cjData, cIterations, ElapsedMs(Start));
+
+    Start = clock();
+    cIterations = 0;
+    do
+    {
+        for (i = 0; i < BENCH_BATCH; i++)
+            ulSum += ChecksumCopy(pjDest, pjSource, cjData, ulSum);
+        cIterations += BENCH_BATCH;
+    } while (ElapsedMs(Start) < gulMinTimeMs);
+    adMBps[2] = MBytesPerSecond(cjData, cIterations, ElapsedMs(Start));
+
+    Start = clock();
+    cIterations = 0;
+    do
+    {
+        for (i = 0; i < BENCH_BATCH; i++)
+        {
+            memcpy(pjDest, pjSource, cjData);
+            ulSum += ChecksumCompute(pjDest, cjData, ulSum);
+        }
+        cIterations += BENCH_BATCH;
+    } while (ElapsedMs(Start) < gulMinTimeMs);
+    adMBps[3] = MBytesPerSecond(cjData, cIterations, ElapsedMs(Start));
+
+    printf("%8lu %10.0f %10.0f %10.0f %10.0f  (%lx)\n",
+           (unsigned long)cjData, adMBps[0], adMBps[1], adMBps[2], adMBps[3],
+           (unsigned long)ulSum);
+}
+
+int
+main(int argc, char *argv[])
+{
+    static const ULONG acjData[] = { 20, 64, 576, 1500, 9000 };
+    PUCHAR pjSource, pjDest;
+    ULONG i;
+    int iArg;
+
+    for (iArg = 1; iArg < argc; iArg++)
+    {
+        if (!strcmp(argv[iArg], "-t") && iArg + 1 < argc)
+        {
+            gulMinTimeMs = atoi(argv[++iArg]);
+        }
+        else if (!strcmp(argv[iArg], "-s") && iArg + 1 < argc)
+        {
+            gulSeed = strtoul(argv[++iArg], NULL, 0);
+        }
+        else
+        {
+            printf("Usage: csumbench [-t ms] [-s seed]\n");
+            return -1;
+        }
+    }
+
+    RunTests();
+
+    pjSource = malloc(MAX_BENCH_LENGTH);
+    pjDest = malloc(MAX_BENCH_LENGTH);
+    if (!pjSource || !pjDest)
+    {
+        printf("Out of memory\n");
+        return 255;
+    }
+
+    for (i = 0; i < MAX_BENCH_LENGTH; i++)
+        pjSource[i] = (UCHAR)Random();
+
+    printf("\nMB/s\n");
+    printf("%8s %10s %10s %10s %10s\n", "LENGTH", "RFC 1071", "compute", "copy", "memcpy+sum");
+
+    for (i = 0; i < sizeof(acjData) / sizeof(acjData[0]); i++)
+        RunBenchmark(acjData[i], pjSource, pjDest);
+
+    free(pjSource);
+    free(pjDest);
+
+    return (int)min(gcFailures, 255);
+}
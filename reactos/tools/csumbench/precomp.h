@@ -0,0 +1,56 @@
+/*
+ * PROJECT:         ReactOS host tools
+ * LICENSE:         GPL - See COPYING in the top level directory
+ * PURPOSE:         Stand-in for the tcpip precomp.h, enough to build network/checksum.c on the host
+ * PROGRAMMERS:     ReactOS Team
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <typedefs.h>
+
+#ifndef CONST
+#define CONST const
+#endif
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
+/* Host compilers don't define the MSVC names. The i386 build calls the
+   csum_partial assembly, so i386 hosts measure the portable loop instead */
+#if defined(__x86_64__) && !defined(_M_AMD64)
+#define _M_AMD64
+#endif
+#undef _M_IX86
+
+#define IPPROTO_UDP 17
+
+/* The host is little endian, like every architecture tcpip.h supports */
+#define WN2H(w) \
+    ((((w) & 0xFF00) >> 8) | \
+     (((w) & 0x00FF) << 8))
+
+#define WH2N(w) \
+    ((((w) & 0xFF00) >> 8) | \
+     (((w) & 0x00FF) << 8))
+
+typedef ULONG IPv4_RAW_ADDRESS;
+
+typedef struct IPv4_HEADER {
+    UCHAR VerIHL;
+    UCHAR Tos;
+    USHORT TotalLength;
+    USHORT Id;
+    USHORT FlagsFragOfs;
+    UCHAR Ttl;
+    UCHAR Protocol;
+    USHORT Checksum;
+    IPv4_RAW_ADDRESS SrcAddr;
+    IPv4_RAW_ADDRESS DstAddr;
+} IPv4_HEADER, *PIPv4_HEADER;
+
+#include <checksum.h>
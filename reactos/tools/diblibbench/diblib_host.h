@@ -0,0 +1,143 @@
+/*
+ * PROJECT:         ReactOS host tools
+ * LICENSE:         GPL - See COPYING in the top level directory
+ * PURPOSE:         Subset of the GDI/DDI definitions needed to build diblib on the host
+ * PROGRAMMERS:     ReactOS Team
+ */
+
+#pragma once
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <typedefs.h>
+
+#define APIENTRY
+
+/* Only i386 has a fastcall convention, other hosts would warn about it */
+#ifndef FASTCALL
+#if defined(_M_IX86)
+#define FASTCALL __fastcall
+#elif defined(__i386__)
+#define FASTCALL __attribute__((fastcall))
+#else
+#define FASTCALL
+#endif
+#endif
+#define UNREFERENCED_PARAMETER(P) ((void)(P))
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+typedef BYTE *PBYTE;
+typedef ULONG FLONG, ROP4;
+typedef PVOID DHSURF, HSURF, DHPDEV, HDEV;
+
+typedef struct _POINTL
+{
+    LONG x;
+    LONG y;
+} POINTL, *PPOINTL;
+
+typedef struct _RECTL
+{
+    LONG left;
+    LONG top;
+    LONG right;
+    LONG bottom;
+} RECTL, *PRECTL;
+
+typedef struct tagSIZE
+{
+    LONG cx;
+    LONG cy;
+} SIZEL, *PSIZEL;
+
+typedef struct _XLATEOBJ
+{
+    ULONG iUniq;
+    FLONG flXlate;
+    USHORT iSrcType;
+    USHORT iDstType;
+    ULONG cEntries;
+    ULONG *pulXlate;
+} XLATEOBJ;
+
+typedef struct _BRUSHOBJ
+{
+    ULONG iSolidColor;
+    PVOID pvRbrush;
+    FLONG flColorType;
+} BRUSHOBJ;
+
+typedef struct _CLIPOBJ
+{
+    ULONG iUniq;
+    RECTL rclBounds;
+    BYTE iDComplexity;
+    BYTE iFComplexity;
+    BYTE iMode;
+    BYTE fjOptions;
+} CLIPOBJ;
+
+typedef struct _BLENDFUNCTION
+{
+    BYTE BlendOp;
+    BYTE BlendFlags;
+    BYTE SourceConstantAlpha;
+    BYTE AlphaFormat;
+} BLENDFUNCTION, *PBLENDFUNCTION;
+
+typedef struct _BLENDOBJ
+{
+    BLENDFUNCTION BlendFunction;
+} BLENDOBJ, *PBLENDOBJ;
+
+typedef struct _SURFOBJ
+{
+    DHSURF dhsurf;
+    HSURF hsurf;
+    DHPDEV dhpdev;
+    HDEV hdev;
+    SIZEL sizlBitmap;
+    ULONG cjBits;
+    PVOID pvBits;
+    PVOID pvScan0;
+    LONG lDelta;
+    ULONG iUniq;
+    ULONG iBitmapFormat;
+    USHORT iType;
+    USHORT fjBitmap;
+} SURFOBJ;
+
+#define BMF_1BPP 1L
+#define BMF_4BPP 2L
+#define BMF_8BPP 3L
+#define BMF_16BPP 4L
+#define BMF_24BPP 5L
+#define BMF_32BPP 6L
+#define BMF_4RLE 7L
+#define BMF_8RLE 8L
+#define BMF_JPEG 9L
+#define BMF_PNG 10L
+
+#define XO_TRIVIAL 0x00000001
+#define XO_TABLE 0x00000002
+
+#define AC_SRC_OVER 0x00
+#define AC_SRC_ALPHA 0x01
+
+#define COLORONCOLOR 3
+#define HALFTONE 4
+
+#define BLACKNESS 0x00000042
+#define WHITENESS 0x00FF0062
+#define MAKEROP4(f,b) (DWORD)((((b)<<8)&0xFF000000)|(f))
+
+/* Implemented by the host program */
+ULONG APIENTRY XLATEOBJ_iXlate(XLATEOBJ *pxlo, ULONG iColor);
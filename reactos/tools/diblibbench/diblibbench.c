@@ -0,0 +1,687 @@
+/*
+ * PROJECT:         ReactOS host tools
+ * LICENSE:         GPL - See COPYING in the top level directory
+ * PURPOSE:         Benchmark and conformance test for the diblib BitBlt kernels
+ * PROGRAMMERS:     ReactOS Team
+ *
+ * Every ROP / source format / destination format combination is run through
+ * both the diblib kernels and the legacy win32ss/gdi/dib implementation on
+ * the same input. The results are compared byte by byte and both are timed.
+ * The process exit code is the number of combinations that differ, capped
+ * at 255.
+ *
+ * Usage: diblibbench [-c] [-r rop] [-d bpp] [-s bpp] [-t ms] [WIDTHxHEIGHT ...]
+ */
+
+#include <win32k.h>
+#include <diblib/DibLib_interface.h>
+#include <time.h>
+
+PALETTE gpalRGB = {PAL_RGB};
+PALETTE gpalBGR = {PAL_BGR};
+
+const BYTE gajXlate5to8[32] =
+{  0,  8, 16, 25, 33, 41, 49, 58, 66, 74, 82, 90, 99,107,115,123,
+ 132,140,148,156,165,173,181,189,197,206,214,222,231,239,247,255};
+
+const BYTE gajXlate6to8[64] =
+{ 0,  4,  8, 12, 16, 20, 24, 28, 32, 36, 40, 45, 49, 52, 57, 61,
+ 65, 69, 73, 77, 81, 85, 89, 93, 97,101,105,109,113,117,121,125,
+130,134,138,142,146,150,154,158,162,166,170,174,178,182,186,190,
+194,198,202,207,210,215,219,223,227,231,235,239,243,247,251,255};
+
+UCHAR gajBitsPerFormat[11] = {0, 1, 4, 8, 16, 24, 32, 4, 8, 0, 0};
+
+static const ULONG gaulFormatMask[7] =
+    {0, 0x1, 0xF, 0xFF, 0xFFFF, 0xFFFFFF, 0xFFFFFFFF};
+
+#define PATTERN_SIZE 8
+#define SOURCE_OFFSET_X 5
+#define SOURCE_OFFSET_Y 1
+#define DEST_OFFSET_X 3
+#define DEST_OFFSET_Y 2
+
+typedef enum
+{
+    BRUSH_NONE,
+    BRUSH_SOLID,
+    BRUSH_PATTERN
+} BRUSH_KIND;
+
+typedef struct
+{
+    const char *pszName;
+    UCHAR jRop3;
+} ROP_ENTRY;
+
+/* The named ROPs have dedicated diblib kernels, the rest use the generic ones */
+static const ROP_ENTRY gaRops[] =
+{
+    {"BLACKNESS", 0x00},
+    {"NOTSRCERASE", 0x11},
+    {"NOTSRCCOPY", 0x33},
+    {"SRCERASE", 0x44},
+    {"DSTINVERT", 0x55},
+    {"PATINVERT", 0x5A},
+    {"SRCINVERT", 0x66},
+    {"SRCAND", 0x88},
+    {"MERGEPAINT", 0xBB},
+    {"MERGECOPY", 0xC0},
+    {"SRCCOPY", 0xCC},
+    {"SRCPAINT", 0xEE},
+    {"PATCOPY", 0xF0},
+    {"PATPAINT", 0xFB},
+    {"WHITENESS", 0xFF},
+    {"PSx", 0x3C},
+    {"DPa", 0xA0},
+    {"DSna", 0x22},
+    {"PSDPxax", 0xB8},
+    {"DSPDxax", 0xE2},
+};
+
+typedef struct
+{
+    SIZEL sizl;
+    ULONG cIterations;
+    double dLegacy;
+    double dDibLib;
+} TIMING;
+
+static BOOL gbTiming = TRUE;
+static BOOL gb555 = FALSE;
+static ULONG gulMinTimeMs = 50;
+
+/* Color translation between two different formats. Any mapping works for
+   comparing the two implementations, as long as the result fits the target. */
+static
+ULONG
+FASTCALL
+XlateMix(XLATEOBJ *pxlo, ULONG ulColor)
+{
+    ULONG ulMix = (ulColor + pxlo->iUniq) * 0x9E3779B1;
+    return (ulMix ^ (ulMix >> 15)) & gaulFormatMask[pxlo->iDstType];
+}
+
+static
+ULONG
+FASTCALL
+XlateTrivial(XLATEOBJ *pxlo, ULONG ulColor)
+{
+    UNREFERENCED_PARAMETER(pxlo);
+    return ulColor;
+}
+
+/* The direct color conversions win32k uses between BGR and 555 / 565 */
+static
+ULONG
+FASTCALL
+XlateBGRto555(XLATEOBJ *pxlo, ULONG ulColor)
+{
+    UNREFERENCED_PARAMETER(pxlo);
+    return ((ulColor >> 3) & 0x1F) | ((ulColor >> 6) & 0x3E0) | ((ulColor >> 9) & 0x7C00);
+}
+
+static
+ULONG
+FASTCALL
+XlateBGRto565(XLATEOBJ *pxlo, ULONG ulColor)
+{
+    UNREFERENCED_PARAMETER(pxlo);
+    return ((ulColor >> 3) & 0x1F) | ((ulColor >> 5) & 0x7E0) | ((ulColor >> 8) & 0xF800);
+}
+
+static
+ULONG
+FASTCALL
+Xlate555toBGR(XLATEOBJ *pxlo, ULONG ulColor)
+{
+    UNREFERENCED_PARAMETER(pxlo);
+    return gajXlate5to8[ulColor & 0x1F] |
+           (gajXlate5to8[(ulColor >> 5) & 0x1F] << 8) |
+           (gajXlate5to8[(ulColor >> 10) & 0x1F] << 16);
+}
+
+static
+ULONG
+FASTCALL
+Xlate565toBGR(XLATEOBJ *pxlo, ULONG ulColor)
+{
+    UNREFERENCED_PARAMETER(pxlo);
+    return gajXlate5to8[ulColor & 0x1F] |
+           (gajXlate6to8[(ulColor >> 5) & 0x3F] << 8) |
+           (gajXlate5to8[(ulColor >> 11) & 0x1F] << 16);
+}
+
+ULONG
+APIENTRY
+XLATEOBJ_iXlate(XLATEOBJ *pxlo, ULONG iColor)
+{
+    EXLATEOBJ *pexlo;
+
+    if (!pxlo)
+        return iColor;
+
+    pexlo = CONTAINING_RECORD(pxlo, EXLATEOBJ, xlo);
+    return pexlo->pfnXlate(pxlo, iColor);
+}
+
+/* Only the BitBlt paths are exercised, the palette based ones stay trivial */
+VOID
+EXLATEOBJ_vInitialize(PEXLATEOBJ pexlo, PPALETTE ppalSrc, PPALETTE ppalDst,
+                      ULONG crSrcBackColor, ULONG crDstBackColor, ULONG crDstForeColor)
+{
+    UNREFERENCED_PARAMETER(crSrcBackColor);
+    UNREFERENCED_PARAMETER(crDstBackColor);
+    UNREFERENCED_PARAMETER(crDstForeColor);
+
+    memset(pexlo, 0, sizeof(*pexlo));
+    pexlo->xlo.flXlate = XO_TRIVIAL;
+    pexlo->pfnXlate = XlateTrivial;
+    pexlo->ppalSrc = ppalSrc;
+    pexlo->ppalDst = ppalDst;
+}
+
+VOID
+EXLATEOBJ_vCleanup(PEXLATEOBJ pexlo)
+{
+    UNREFERENCED_PARAMETER(pexlo);
+}
+
+static
+BOOL
+IsBGRFormat(ULONG iFormat)
+{
+    return (iFormat == BMF_24BPP) || (iFormat == BMF_32BPP);
+}
+
+/* Sets up the translation like EXLATEOBJ_vInitialize would for surfaces
+   with these formats and returns the matching DIB_XLATE_ type */
+static
+ULONG
+InitXlate(EXLATEOBJ *pexlo, ULONG iSrcFormat, ULONG iDstFormat)
+{
+    memset(pexlo, 0, sizeof(*pexlo));
+    pexlo->xlo.iUniq = iSrcFormat * 7 + iDstFormat;
+    pexlo->xlo.iSrcType = (USHORT)iSrcFormat;
+    pexlo->xlo.iDstType = (USHORT)iDstFormat;
+    pexlo->pfnXlate = XlateTrivial;
+
+    if (iSrcFormat == iDstFormat || iSrcFormat == 0)
+    {
+        pexlo->xlo.flXlate = XO_TRIVIAL;
+        return DIB_XLATE_TRIVIAL;
+    }
+
+    /* Both BGR, win32k uses the trivial function without XO_TRIVIAL */
+    if (IsBGRFormat(iSrcFormat) && IsBGRFormat(iDstFormat))
+        return DIB_XLATE_TRIVIAL;
+
+    if (IsBGRFormat(iSrcFormat) && iDstFormat == BMF_16BPP)
+    {
+        pexlo->pfnXlate = gb555 ? XlateBGRto555 : XlateBGRto565;
+        return gb555 ? DIB_XLATE_BGR_TO_555 : DIB_XLATE_BGR_TO_565;
+    }
+
+    if (iSrcFormat == BMF_16BPP && IsBGRFormat(iDstFormat))
+    {
+        pexlo->pfnXlate = gb555 ? Xlate555toBGR : Xlate565toBGR;
+        return gb555 ? DIB_XLATE_555_TO_BGR : DIB_XLATE_565_TO_BGR;
+    }
+
+    pexlo->pfnXlate = XlateMix;
+    return DIB_XLATE_OTHER;
+}
+
+/* Bits per pixel for display, 15 for 555 surfaces */
+static
+ULONG
+FormatBpp(ULONG iFormat)
+{
+    if (iFormat == BMF_16BPP && gb555)
+        return 15;
+
+    return gajBitsPerFormat[iFormat];
+}
+
+static ULONG gulRandom = 0x12345678;
+
+static
+ULONG
+NextRandom(VOID)
+{
+    gulRandom = gulRandom * 1103515245 + 12345;
+    return gulRandom;
+}
+
+static
+BOOL
+CreateSurface(SURFOBJ *pso, ULONG iFormat, LONG cx, LONG cy)
+{
+    ULONG i;
+
+    memset(pso, 0, sizeof(*pso));
+    pso->iBitmapFormat = iFormat;
+    pso->sizlBitmap.cx = cx;
+    pso->sizlBitmap.cy = cy;
+    pso->lDelta = ((cx * gajBitsPerFormat[iFormat] + 31) & ~31) / 8;
+    pso->cjBits = pso->lDelta * cy;
+    pso->pvBits = malloc(pso->cjBits);
+    pso->pvScan0 = pso->pvBits;
+    if (!pso->pvBits)
+        return FALSE;
+
+    for (i = 0; i < pso->cjBits; i++)
+        ((PBYTE)pso->pvBits)[i] = (BYTE)(NextRandom() >> 16);
+
+    return TRUE;
+}
+
+static
+VOID
+CopySurface(SURFOBJ *psoDst, SURFOBJ *psoSrc)
+{
+    *psoDst = *psoSrc;
+    psoDst->pvBits = psoDst->pvScan0 = malloc(psoSrc->cjBits);
+    memcpy(psoDst->pvBits, psoSrc->pvBits, psoSrc->cjBits);
+}
+
+static
+VOID
+FreeSurface(SURFOBJ *pso)
+{
+    free(pso->pvBits);
+    pso->pvBits = pso->pvScan0 = NULL;
+}
+
+static
+VOID
+SetSurfaceInfo(SURFINFO *psi, SURFOBJ *pso)
+{
+    psi->iFormat = pso->iBitmapFormat;
+    psi->pvScan0 = pso->pvScan0;
+    psi->lDelta = pso->lDelta;
+    psi->cjAdvanceY = pso->lDelta;
+    psi->jBpp = gajBitsPerFormat[pso->iBitmapFormat];
+}
+
+static
+VOID
+SetBasePointer(SURFINFO *psi, LONG x, LONG y)
+{
+    psi->ptOrig.x = x;
+    psi->ptOrig.y = y;
+    psi->pjBase = psi->pvScan0 + y * psi->lDelta + x * psi->jBpp / 8;
+}
+
+/* Same setup as EngBitBlt for a single, unclipped rectangle */
+static
+VOID
+DibLibBitBlt(
+    SURFOBJ *psoDst,
+    SURFOBJ *psoSrc,
+    SURFOBJ *psoPat,
+    XLATEOBJ *pxlo,
+    PFN_XLATE pfnXlate,
+    ULONG iXlateType,
+    RECTL *prcl,
+    POINTL *pptlSrc,
+    ULONG ulSolidColor,
+    ROP4 rop4)
+{
+    BLTDATA bltdata;
+
+    memset(&bltdata, 0, sizeof(bltdata));
+    bltdata.dy = 1;
+    bltdata.rop4 = rop4;
+    bltdata.apfnDoRop[0] = gapfnRop[ROP4_BKGND(rop4)];
+    bltdata.apfnDoRop[1] = gapfnRop[ROP4_FGND(rop4)];
+    bltdata.pxlo = pxlo;
+    bltdata.pfnXlate = pfnXlate;
+    bltdata.iXlateType = iXlateType;
+    bltdata.ulWidth = prcl->right - prcl->left;
+    bltdata.ulHeight = prcl->bottom - prcl->top;
+    bltdata.ulSolidColor = ulSolidColor;
+
+    SetSurfaceInfo(&bltdata.siDst, psoDst);
+    SetBasePointer(&bltdata.siDst, prcl->left, prcl->top);
+
+    if (ROP4_USES_SOURCE(rop4))
+    {
+        SetSurfaceInfo(&bltdata.siSrc, psoSrc);
+        SetBasePointer(&bltdata.siSrc, pptlSrc->x, pptlSrc->y);
+    }
+
+    if (psoPat)
+    {
+        /* The legacy code aligns the pattern to the surface origin */
+        SetSurfaceInfo(&bltdata.siPat, psoPat);
+        bltdata.siPat.pjBase = bltdata.siPat.pvScan0;
+        bltdata.siPat.ptOrig.x = prcl->left % psoPat->sizlBitmap.cx;
+        bltdata.siPat.ptOrig.y = prcl->top % psoPat->sizlBitmap.cy;
+        bltdata.ulPatWidth = psoPat->sizlBitmap.cx;
+        bltdata.ulPatHeight = psoPat->sizlBitmap.cy;
+    }
+
+    gapfnDibFunction[gajIndexPerRop[ROP4_FGND(rop4)]](&bltdata);
+}
+
+/* Same dispatch as EngBitBlt / CallDibBitBlt in eng/bitblt.c */
+static
+VOID
+LegacyBitBlt(
+    SURFOBJ *psoDst,
+    SURFOBJ *psoSrc,
+    SURFOBJ *psoPat,
+    XLATEOBJ *pxlo,
+    RECTL *prcl,
+    POINTL *pptlSrc,
+    BRUSHOBJ *pbo,
+    ROP4 rop4)
+{
+    BLTINFO BltInfo;
+
+    if ((rop4 & 0xFF) == R3_OPINDEX_PATCOPY && !psoPat)
+    {
+        DibFunctionsForBitmapFormat[psoDst->iBitmapFormat].DIB_ColorFill(psoDst, prcl, pbo->iSolidColor);
+        return;
+    }
+
+    memset(&BltInfo, 0, sizeof(BltInfo));
+    BltInfo.DestSurface = psoDst;
+    BltInfo.SourceSurface = psoSrc;
+    BltInfo.PatternSurface = psoPat;
+    BltInfo.XlateSourceToDest = pxlo;
+    BltInfo.DestRect = *prcl;
+    BltInfo.SourcePoint = *pptlSrc;
+    BltInfo.Brush = pbo;
+    BltInfo.Rop4 = rop4;
+
+    if ((rop4 & 0xFF) == R3_OPINDEX_SRCCOPY)
+        DibFunctionsForBitmapFormat[psoDst->iBitmapFormat].DIB_BitBltSrcCopy(&BltInfo);
+    else
+        DibFunctionsForBitmapFormat[psoDst->iBitmapFormat].DIB_BitBlt(&BltInfo);
+}
+
+static
+ULONG
+ReadPixel(SURFOBJ *pso, LONG x, LONG y)
+{
+    return DibFunctionsForBitmapFormat[pso->iBitmapFormat].DIB_GetPixel(pso, x, y);
+}
+
+static
+double
+ElapsedMs(clock_t Start)
+{
+    return (double)(clock() - Start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+static
+const char *
+BrushName(BRUSH_KIND BrushKind)
+{
+    return (BrushKind == BRUSH_PATTERN) ? "pat" : (BrushKind == BRUSH_SOLID) ? "solid" : "-";
+}
+
+/* Runs one combination, returns FALSE when the two results differ */
+static
+BOOL
+RunCase(
+    const ROP_ENTRY *pRop,
+    ULONG iSrcFormat,
+    ULONG iDstFormat,
+    BRUSH_KIND BrushKind,
+    TIMING *pTiming)
+{
+    SURFOBJ soSrc, soDstOriginal, soDstLegacy, soDstDibLib, soPat;
+    SURFOBJ *psoSrc = NULL, *psoPat = NULL;
+    EXLATEOBJ exlo;
+    BRUSHOBJ bo;
+    RECTL rcl;
+    POINTL ptlSrc = {SOURCE_OFFSET_X, SOURCE_OFFSET_Y};
+    ROP4 rop4 = ROP4_FROM_INDEX(pRop->jRop3);
+    LONG cx = pTiming->sizl.cx, cy = pTiming->sizl.cy, x, y;
+    ULONG i, cIterations, iXlateType, ulSolidColor = 0xFFFFFFFF;
+    clock_t Start;
+    BOOL bResult = TRUE;
+
+    rcl.left = DEST_OFFSET_X;
+    rcl.top = DEST_OFFSET_Y;
+    rcl.right = rcl.left + cx;
+    rcl.bottom = rcl.top + cy;
+
+    if (!CreateSurface(&soDstOriginal, iDstFormat, cx + DEST_OFFSET_X + 7, cy + DEST_OFFSET_Y + 1))
+        return FALSE;
+    CopySurface(&soDstLegacy, &soDstOriginal);
+    CopySurface(&soDstDibLib, &soDstOriginal);
+
+    if (iSrcFormat)
+    {
+        CreateSurface(&soSrc, iSrcFormat, cx + SOURCE_OFFSET_X + 3, cy + SOURCE_OFFSET_Y);
+        psoSrc = &soSrc;
+    }
+
+    memset(&bo, 0, sizeof(bo));
+    if (BrushKind == BRUSH_PATTERN)
+    {
+        CreateSurface(&soPat, iDstFormat, PATTERN_SIZE, PATTERN_SIZE);
+        psoPat = &soPat;
+        bo.iSolidColor = 0xFFFFFFFF;
+    }
+    else if (BrushKind == BRUSH_SOLID)
+    {
+        bo.iSolidColor = ulSolidColor = NextRandom() & gaulFormatMask[iDstFormat];
+    }
+
+    iXlateType = InitXlate(&exlo, iSrcFormat, iDstFormat);
+
+    /* Conformance */
+    LegacyBitBlt(&soDstLegacy, psoSrc, psoPat, &exlo.xlo, &rcl, &ptlSrc, &bo, rop4);
+    DibLibBitBlt(&soDstDibLib, psoSrc, psoPat, &exlo.xlo, exlo.pfnXlate, iXlateType, &rcl, &ptlSrc, ulSolidColor, rop4);
+
+    if (memcmp(soDstLegacy.pvBits, soDstDibLib.pvBits, soDstLegacy.cjBits) != 0)
+    {
+        bResult = FALSE;
+        printf("MISMATCH: %s S%u D%u %s %ldx%ld\n",
+               pRop->pszName,
+               FormatBpp(iSrcFormat),
+               FormatBpp(iDstFormat),
+               BrushName(BrushKind),
+               (long)cx, (long)cy);
+
+        for (y = 0; y < soDstLegacy.sizlBitmap.cy; y++)
+        {
+            for (x = 0; x < soDstLegacy.sizlBitmap.cx; x++)
+            {
+                if (ReadPixel(&soDstLegacy, x, y) != ReadPixel(&soDstDibLib, x, y))
+                    break;
+            }
+            if (x < soDstLegacy.sizlBitmap.cx)
+            {
+                printf("  first difference at (%ld,%ld): original 0x%lx, legacy 0x%lx, diblib 0x%lx\n",
+                       (long)x, (long)y,
+                       (unsigned long)ReadPixel(&soDstOriginal, x, y),
+                       (unsigned long)ReadPixel(&soDstLegacy, x, y),
+                       (unsigned long)ReadPixel(&soDstDibLib, x, y));
+                break;
+            }
+        }
+    }
+
+    /* Timing: repeat until both sides ran for at least the minimum time */
+    pTiming->dLegacy = pTiming->dDibLib = 0;
+    if (gbTiming)
+    {
+        for (cIterations = 1; ; cIterations *= 2)
+        {
+            Start = clock();
+            for (i = 0; i < cIterations; i++)
+                LegacyBitBlt(&soDstLegacy, psoSrc, psoPat, &exlo.xlo, &rcl, &ptlSrc, &bo, rop4);
+            pTiming->dLegacy = ElapsedMs(Start);
+            if (pTiming->dLegacy >= gulMinTimeMs)
+                break;
+        }
+
+        Start = clock();
+        for (i = 0; i < cIterations; i++)
+            DibLibBitBlt(&soDstDibLib, psoSrc, psoPat, &exlo.xlo, exlo.pfnXlate, iXlateType, &rcl, &ptlSrc, ulSolidColor, rop4);
+        pTiming->dDibLib = ElapsedMs(Start);
+        pTiming->cIterations = cIterations;
+    }
+
+    FreeSurface(&soDstOriginal);
+    FreeSurface(&soDstLegacy);
+    FreeSurface(&soDstDibLib);
+    if (psoSrc) FreeSurface(psoSrc);
+    if (psoPat) FreeSurface(psoPat);
+
+    return bResult;
+}
+
+static
+double
+MPixelsPerSecond(TIMING *pTiming, double dMs)
+{
+    double dPixels = (double)pTiming->sizl.cx * pTiming->sizl.cy * pTiming->cIterations;
+    return (dMs > 0) ? dPixels / (dMs * 1000.0) : 0;
+}
+
+static
+VOID
+Usage(VOID)
+{
+    printf("Usage: diblibbench [-c] [-r rop] [-d bpp] [-s bpp] [-t ms] [WIDTHxHEIGHT ...]\n"
+           "  -c       conformance only, no timing\n"
+           "  -r rop   only run the named ROP (e.g. SRCCOPY)\n"
+           "  -d bpp   only run this destination format\n"
+           "  -s bpp   only run this source format\n"
+           "  -t ms    minimum time per measurement (default 50)\n"
+           "Default sizes are 16x16, 256x256 and 1024x768.\n");
+}
+
+static
+ULONG
+FormatFromBpp(const char *psz)
+{
+    ULONG i, cBits = atoi(psz);
+
+    for (i = BMF_1BPP; i <= BMF_32BPP; i++)
+    {
+        if (gajBitsPerFormat[i] == cBits)
+            return i;
+    }
+
+    return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+    static const SIZEL asizlDefault[] = {{16, 16}, {256, 256}, {1024, 768}};
+    SIZEL asizl[16];
+    ULONG cSizes = 0, iSize, iRop, iSrcFormat, iDstFormat, iFirstSrc, iLastSrc;
+    ULONG iOnlySrc = 0, iOnlyDst = 0, cCases = 0, cFailures = 0, iLayout, cLayouts;
+    const char *pszRop = NULL;
+    BRUSH_KIND BrushKind, LastBrush;
+    TIMING Timing;
+    ROP4 rop4;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-c"))
+            gbTiming = FALSE;
+        else if (!strcmp(argv[i], "-r") && i + 1 < argc)
+            pszRop = argv[++i];
+        else if (!strcmp(argv[i], "-d") && i + 1 < argc)
+            iOnlyDst = FormatFromBpp(argv[++i]);
+        else if (!strcmp(argv[i], "-s") && i + 1 < argc)
+            iOnlySrc = FormatFromBpp(argv[++i]);
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc)
+            gulMinTimeMs = atoi(argv[++i]);
+        else if (cSizes < 16 && sscanf(argv[i], "%ldx%ld", (long*)&asizl[cSizes].cx, (long*)&asizl[cSizes].cy) == 2 &&
+                 asizl[cSizes].cx > 0 && asizl[cSizes].cy > 0)
+            cSizes++;
+        else
+        {
+            Usage();
+            return -1;
+        }
+    }
+
+    if (cSizes == 0)
+    {
+        memcpy(asizl, asizlDefault, sizeof(asizlDefault));
+        cSizes = sizeof(asizlDefault) / sizeof(asizlDefault[0]);
+    }
+
+    if (gbTiming)
+        printf("%-12s %-4s %-4s %-6s %-10s %12s %12s %7s\n",
+               "ROP", "SRC", "DST", "BRUSH", "SIZE", "legacy MP/s", "diblib MP/s", "ratio");
+
+    for (iRop = 0; iRop < sizeof(gaRops) / sizeof(gaRops[0]); iRop++)
+    {
+        if (pszRop && strcmp(pszRop, gaRops[iRop].pszName) != 0)
+            continue;
+
+        rop4 = ROP4_FROM_INDEX(gaRops[iRop].jRop3);
+
+        iFirstSrc = ROP4_USES_SOURCE(rop4) ? BMF_1BPP : 0;
+        iLastSrc = ROP4_USES_SOURCE(rop4) ? BMF_32BPP : 0;
+        LastBrush = ROP4_USES_PATTERN(rop4) ? BRUSH_PATTERN : BRUSH_NONE;
+
+        for (iDstFormat = BMF_1BPP; iDstFormat <= BMF_32BPP; iDstFormat++)
+        {
+            if (iOnlyDst && iDstFormat != iOnlyDst)
+                continue;
+
+            for (iSrcFormat = iFirstSrc; iSrcFormat <= iLastSrc; iSrcFormat++)
+            {
+                if (iOnlySrc && iSrcFormat && iSrcFormat != iOnlySrc)
+                    continue;
+
+                /* 16bpp conversions from and to BGR run with 565 and 555 */
+                cLayouts = ((iSrcFormat == BMF_16BPP && IsBGRFormat(iDstFormat)) ||
+                            (iDstFormat == BMF_16BPP && IsBGRFormat(iSrcFormat))) ? 2 : 1;
+                for (iLayout = 0; iLayout < cLayouts; iLayout++)
+                {
+                    gb555 = (iLayout != 0);
+                    BrushKind = ROP4_USES_PATTERN(rop4) ? BRUSH_SOLID : BRUSH_NONE;
+                    for (; BrushKind <= LastBrush; BrushKind++)
+                    {
+                        for (iSize = 0; iSize < cSizes; iSize++)
+                        {
+                            memset(&Timing, 0, sizeof(Timing));
+                            Timing.sizl = asizl[iSize];
+                            cCases++;
+
+                            if (!RunCase(&gaRops[iRop], iSrcFormat, iDstFormat, BrushKind, &Timing))
+                                cFailures++;
+
+                            if (gbTiming)
+                            {
+                                char szSize[24];
+                                sprintf(szSize, "%ldx%ld", (long)Timing.sizl.cx, (long)Timing.sizl.cy);
+                                printf("%-12s %-4u %-4u %-6s %-10s %12.1f %12.1f %7.2f\n",
+                                       gaRops[iRop].pszName,
+                                       FormatBpp(iSrcFormat),
+                                       FormatBpp(iDstFormat),
+                                       BrushName(BrushKind),
+                                       szSize,
+                                       MPixelsPerSecond(&Timing, Timing.dLegacy),
+                                       MPixelsPerSecond(&Timing, Timing.dDibLib),
+                                       Timing.dDibLib > 0 ? Timing.dLegacy / Timing.dDibLib : 0);
+                            }
+                        }
+                    }
+                }
+                gb555 = FALSE;
+            }
+        }
+    }
+
+    printf("%lu of %lu combinations differ from the legacy implementation\n",
+           (unsigned long)cFailures, (unsigned long)cCases);
+
+    return (int)min(cFailures, 255);
+}
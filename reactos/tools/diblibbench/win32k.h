@@ -0,0 +1,88 @@
+/*
+ * PROJECT:         ReactOS host tools
+ * LICENSE:         GPL - See COPYING in the top level directory
+ * PURPOSE:         Stand-in for win32k.h, enough to build win32ss/gdi/dib on the host
+ * PROGRAMMERS:     ReactOS Team
+ */
+
+#pragma once
+
+#include <diblib_host.h>
+
+/* Same shape as the diblib callback, so one function serves both libraries */
+typedef ULONG (FASTCALL *PFN_XLATE)(XLATEOBJ *pxlo, ULONG ulColor);
+
+typedef struct _PALETTE
+{
+    FLONG flFlags;
+} PALETTE, *PPALETTE;
+
+#define PAL_INDEXED 0x00000001
+#define PAL_BITFIELDS 0x00000002
+#define PAL_RGB 0x00000004
+#define PAL_BGR 0x00000008
+#define PAL_MONOCHROME 0x00002000
+#define PAL_RGB16_555 0x00200000
+#define PAL_RGB16_565 0x00400000
+
+typedef struct _EXLATEOBJ
+{
+    XLATEOBJ xlo;
+    PFN_XLATE pfnXlate;
+    PPALETTE ppalSrc;
+    PPALETTE ppalDst;
+    PPALETTE ppalDstDc;
+} EXLATEOBJ, *PEXLATEOBJ;
+
+extern PALETTE gpalRGB, gpalBGR;
+extern const BYTE gajXlate5to8[32];
+extern const BYTE gajXlate6to8[64];
+extern UCHAR gajBitsPerFormat[];
+#define BitsPerFormat(Format) gajBitsPerFormat[Format]
+
+VOID EXLATEOBJ_vInitialize(PEXLATEOBJ pexlo, PPALETTE ppalSrc, PPALETTE ppalDst,
+                           ULONG crSrcBackColor, ULONG crDstBackColor, ULONG crDstForeColor);
+VOID EXLATEOBJ_vCleanup(PEXLATEOBJ pexlo);
+
+#define GDITAG_TEMP 0
+#define EngAllocMem(fl, cj, tag) malloc(cj)
+#define EngFreeMem(pv) free(pv)
+
+#define ALIGN_UP_BY(size, align) \
+    (((ULONG_PTR)(size) + (align) - 1) & ~((ULONG_PTR)(align) - 1))
+
+#define DbgPrint printf
+
+enum _R3_ROPCODES
+{
+    R3_OPINDEX_NOOP         = 0xAA,
+    R3_OPINDEX_BLACKNESS    = 0x00,
+    R3_OPINDEX_NOTSRCERASE  = 0x11,
+    R3_OPINDEX_NOTSRCCOPY   = 0x33,
+    R3_OPINDEX_SRCERASE     = 0x44,
+    R3_OPINDEX_DSTINVERT    = 0x55,
+    R3_OPINDEX_PATINVERT    = 0x5A,
+    R3_OPINDEX_SRCINVERT    = 0x66,
+    R3_OPINDEX_SRCAND       = 0x88,
+    R3_OPINDEX_MERGEPAINT   = 0xBB,
+    R3_OPINDEX_MERGECOPY    = 0xC0,
+    R3_OPINDEX_SRCCOPY      = 0xCC,
+    R3_OPINDEX_SRCPAINT     = 0xEE,
+    R3_OPINDEX_PATCOPY      = 0xF0,
+    R3_OPINDEX_PATPAINT     = 0xFB,
+    R3_OPINDEX_WHITENESS    = 0xFF
+};
+
+#define ROP4_FROM_INDEX(index) ((index) | ((index) << 8))
+
+#define ROP4_USES_SOURCE(Rop4)  (((((Rop4) & 0xCC00) >> 2) != ((Rop4) & 0x3300)) || ((((Rop4) & 0xCC) >> 2) != ((Rop4) & 0x33)))
+#define ROP4_USES_MASK(Rop4)    (((Rop4) & 0xFF00) != (((Rop4) & 0xff) << 8))
+#define ROP4_USES_DEST(Rop4)    (((((Rop4) & 0xAA) >> 1) != ((Rop4) & 0x55)) || ((((Rop4) & 0xAA00) >> 1) != ((Rop4) & 0x5500)))
+#define ROP4_USES_PATTERN(Rop4) (((((Rop4) & 0xF0) >> 4) != ((Rop4) & 0x0F)) || ((((Rop4) & 0xF000) >> 4) != ((Rop4) & 0x0F00)))
+
+#define IS_VALID_ROP4(rop) (((rop) & 0xFFFF0000) == 0)
+
+#define ROP4_FGND(Rop4)    ((Rop4) & 0x00FF)
+#define ROP4_BKGND(Rop4)    (((Rop4) & 0xFF00) >> 8)
+
+#include <dib/dib.h>
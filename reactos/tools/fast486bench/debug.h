@@ -0,0 +1,12 @@
+/*
+ * PROJECT:         ReactOS host tools
+ * LICENSE:         GPL - See COPYING in the top level directory
+ * PURPOSE:         Stand-in for debug.h, the host typedefs provide the rest
+ * PROGRAMMERS:     ReactOS Team
+ */
+
+#pragma once
+
+/* Unimplemented opcodes must not end the run, they show up as failures */
+#undef UNIMPLEMENTED
+#define UNIMPLEMENTED DPRINT1("%s is unimplemented\n", __FUNCTION__)
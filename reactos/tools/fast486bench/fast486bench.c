@@ -0,0 +1,499 @@
+/*
+ * PROJECT:         ReactOS host tools
+ * LICENSE:         GPL - See COPYING in the top level directory
+ * PURPOSE:         Benchmark and conformance runner for the Fast486 emulator
+ * PROGRAMMERS:     ReactOS Team
+ *
+ * Flat binaries are loaded at 1000:0000 in real mode, with all the segment
+ * registers set to 1000 and SP to FFFE, and run until they execute BOP 00
+ * (C4 C4 00). Each program is single stepped once, which counts the
+ * instructions and records or checks the trace, then run with
+ * Fast486Continue for the time given with -t to measure the speed.
+ *
+ * Without files, the built-in programs from tests.h are run. They cover the
+ * opcode groups of opcodes.c, opgroups.c, extraops.c and fpu.c and their
+ * final state is compared with the one the same code produced on a real
+ * processor, see tests/prologue.inc. The paging program covers the TLB and
+ * page faults in protected mode and checks its own results, since a Linux
+ * process cannot enable paging.
+ *
+ * A trace holds one line per instruction with the registers and flags
+ * before it. -r records the traces of all the programs into a file, -g
+ * compares them with a file recorded earlier and reports the first
+ * difference of each program. -n turns off the code cache and the TLB.
+ * The process exit code is the number of programs which failed.
+ *
+ * Usage: fast486bench [-t ms] [-n] [-r trace] [-g trace] [file ...]
+ */
+
+#include <windef.h>
+#include <fast486.h>
+#include <setjmp.h>
+#include <time.h>
+
+#define MEMORY_SIZE     0x110000
+#define PAGE_SIZE       0x1000
+#define LOAD_SEGMENT    0x1000
+#define STUB_SEGMENT    0xF000
+#define DATA_OFFSET     0x8000
+#define DATA_SIZE       256
+#define MAX_PROGRAM     DATA_OFFSET
+#define MAX_STEPS       100000000
+#define MAX_TRACE_LINE  160
+
+#define BOP_HALT        0x00
+#define BOP_INTERRUPT   0x01
+
+/* Arithmetic flags and DF */
+#define FLAGS_MASK      0x0CD5
+
+/* Exception flags of the FPU status word, the only part the emulator models */
+#define FPU_STATUS_MASK 0x003F
+
+typedef struct
+{
+    ULONG Eax, Ebx, Ecx, Edx, Esi, Edi;
+    ULONG Flags;
+    USHORT FpuStatus;
+    USHORT FpuControl;
+    UCHAR Data[DATA_SIZE];
+} GOLDEN_STATE, *PGOLDEN_STATE;
+
+typedef struct
+{
+    const char *pszName;
+    const UCHAR *pjCode;
+    ULONG cjCode;
+    const GOLDEN_STATE *pGolden;
+} TEST_PROGRAM, *PTEST_PROGRAM;
+
+#include "tests.h"
+
+static UCHAR gajMemory[MEMORY_SIZE];
+static FAST486_STATE gState;
+static FAST486_TLB_ENTRY gaTlb[FAST486_TLB_SIZE];
+static FAST486_CODE_PAGE gaCodeCache[FAST486_CODE_CACHE_PAGES];
+static jmp_buf gHalt;
+static LONG glInterrupt;
+static ULONG gcSteps;
+static ULONG gulMinTimeMs = 500;
+static FILE *gfpRecord;
+static FILE *gfpGolden;
+
+static
+VOID
+NTAPI
+MemReadCallback(PFAST486_STATE State, ULONG Address, PVOID Buffer, ULONG Size)
+{
+    UNREFERENCED_PARAMETER(State);
+
+    if (Address < MEMORY_SIZE && Size <= MEMORY_SIZE - Address)
+        memcpy(Buffer, &gajMemory[Address], Size);
+    else
+        memset(Buffer, 0xFF, Size);
+}
+
+static
+VOID
+NTAPI
+MemWriteCallback(PFAST486_STATE State, ULONG Address, PVOID Buffer, ULONG Size)
+{
+    UNREFERENCED_PARAMETER(State);
+
+    if (Address < MEMORY_SIZE && Size <= MEMORY_SIZE - Address)
+        memcpy(&gajMemory[Address], Buffer, Size);
+}
+
+static
+PVOID
+NTAPI
+MemMapCallback(PFAST486_STATE State, ULONG Address, BOOLEAN Write)
+{
+    UNREFERENCED_PARAMETER(State);
+    UNREFERENCED_PARAMETER(Write);
+
+    /* All of the memory is plain RAM */
+    if (Address < MEMORY_SIZE && PAGE_SIZE <= MEMORY_SIZE - Address)
+        return &gajMemory[Address];
+
+    return NULL;
+}
+
+static
+VOID
+NTAPI
+BopCallback(PFAST486_STATE State, UCHAR BopCode)
+{
+    /* The interrupt stubs are 4 bytes apart and the BOP has just been fetched */
+    if (BopCode == BOP_INTERRUPT)
+        glInterrupt = (State->InstPtr.LowWord - 3) / 4;
+
+    longjmp(gHalt, 1);
+}
+
+static
+double
+ElapsedMs(clock_t Start)
+{
+    return (double)(clock() - Start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+/* Puts the program in memory and the CPU at its start */
+static
+VOID
+LoadProgram(const TEST_PROGRAM *pProgram, BOOL bCaches)
+{
+    ULONG i;
+
+    Fast486Initialize(&gState,
+                      MemReadCallback,
+                      MemWriteCallback,
+                      MemMapCallback,
+                      NULL,
+                      NULL,
+                      NULL,
+                      BopCallback,
+                      NULL,
+                      bCaches ? gaTlb : NULL,
+                      bCaches ? gaCodeCache : NULL);
+
+    /* Every interrupt vector points to a BOP which ends the run */
+    for (i = 0; i < 256; i++)
+    {
+        *(PULONG)&gajMemory[i * 4] = MAKELONG(i * 4, STUB_SEGMENT);
+        gajMemory[STUB_SEGMENT * 16 + i * 4 + 0] = 0xC4;
+        gajMemory[STUB_SEGMENT * 16 + i * 4 + 1] = 0xC4;
+        gajMemory[STUB_SEGMENT * 16 + i * 4 + 2] = BOP_INTERRUPT;
+        gajMemory[STUB_SEGMENT * 16 + i * 4 + 3] = 0x90;
+    }
+
+    memset(&gajMemory[LOAD_SEGMENT * 16], 0, 0x10000);
+    memcpy(&gajMemory[LOAD_SEGMENT * 16], pProgram->pjCode, pProgram->cjCode);
+
+    for (i = 0; i < FAST486_NUM_SEG_REGS; i++)
+        Fast486SetSegment(&gState, i, LOAD_SEGMENT);
+
+    Fast486SetStack(&gState, LOAD_SEGMENT, 0xFFFE);
+    Fast486ExecuteAt(&gState, LOAD_SEGMENT, 0);
+
+    glInterrupt = -1;
+}
+
+static
+VOID
+FormatTraceLine(char *pszLine)
+{
+    sprintf(pszLine,
+            "%lu %04X:%08lX EAX=%08lX EBX=%08lX ECX=%08lX EDX=%08lX "
+            "ESI=%08lX EDI=%08lX EBP=%08lX ESP=%08lX EFL=%08lX\n",
+            (unsigned long)gcSteps,
+            gState.SegmentRegs[FAST486_REG_CS].Selector,
+            (unsigned long)gState.InstPtr.Long,
+            (unsigned long)gState.GeneralRegs[FAST486_REG_EAX].Long,
+            (unsigned long)gState.GeneralRegs[FAST486_REG_EBX].Long,
+            (unsigned long)gState.GeneralRegs[FAST486_REG_ECX].Long,
+            (unsigned long)gState.GeneralRegs[FAST486_REG_EDX].Long,
+            (unsigned long)gState.GeneralRegs[FAST486_REG_ESI].Long,
+            (unsigned long)gState.GeneralRegs[FAST486_REG_EDI].Long,
+            (unsigned long)gState.GeneralRegs[FAST486_REG_EBP].Long,
+            (unsigned long)gState.GeneralRegs[FAST486_REG_ESP].Long,
+            (unsigned long)gState.Flags.Long);
+}
+
+/* Records or checks the trace line of the next instruction */
+static
+VOID
+TraceStep(const TEST_PROGRAM *pProgram, volatile BOOL *pbTraceFailed)
+{
+    char szLine[MAX_TRACE_LINE], szGolden[MAX_TRACE_LINE];
+
+    FormatTraceLine(szLine);
+
+    if (gfpRecord)
+        fputs(szLine, gfpRecord);
+
+    if (gfpGolden && !*pbTraceFailed)
+    {
+        if (!fgets(szGolden, sizeof(szGolden), gfpGolden))
+            strcpy(szGolden, "<end of trace>\n");
+
+        if (strcmp(szLine, szGolden) != 0)
+        {
+            printf("%s: trace differs at instruction %lu\n  expected %s  got      %s",
+                   pProgram->pszName, (unsigned long)gcSteps, szGolden, szLine);
+            *pbTraceFailed = TRUE;
+        }
+    }
+}
+
+/* Moves the golden trace past the lines of one program */
+static
+VOID
+SkipGoldenTrace(const TEST_PROGRAM *pProgram)
+{
+    char szLine[MAX_TRACE_LINE];
+    char szHeader[MAX_TRACE_LINE];
+
+    sprintf(szHeader, "# %s\n", pProgram->pszName);
+
+    while (fgets(szLine, sizeof(szLine), gfpGolden))
+    {
+        if (!strcmp(szLine, szHeader))
+            return;
+    }
+}
+
+static
+BOOL
+CheckGolden(const TEST_PROGRAM *pProgram)
+{
+    const GOLDEN_STATE *pGolden = pProgram->pGolden;
+    const ULONG aulActual[] =
+    {
+        gState.GeneralRegs[FAST486_REG_EAX].Long,
+        gState.GeneralRegs[FAST486_REG_EBX].Long,
+        gState.GeneralRegs[FAST486_REG_ECX].Long,
+        gState.GeneralRegs[FAST486_REG_EDX].Long,
+        gState.GeneralRegs[FAST486_REG_ESI].Long,
+        gState.GeneralRegs[FAST486_REG_EDI].Long,
+        gState.Flags.Long & FLAGS_MASK
+    };
+    const ULONG aulExpected[] =
+    {
+        pGolden->Eax, pGolden->Ebx, pGolden->Ecx,
+        pGolden->Edx, pGolden->Esi, pGolden->Edi,
+        pGolden->Flags & FLAGS_MASK
+    };
+    static const char *apszNames[] = { "EAX", "EBX", "ECX", "EDX", "ESI", "EDI", "EFL" };
+    PUCHAR pjData = &gajMemory[LOAD_SEGMENT * 16 + DATA_OFFSET];
+    BOOL bResult = TRUE;
+    ULONG i;
+
+    for (i = 0; i < sizeof(aulActual) / sizeof(aulActual[0]); i++)
+    {
+        if (aulActual[i] != aulExpected[i])
+        {
+            printf("%s: %s is %08lX, expected %08lX\n", pProgram->pszName, apszNames[i],
+                   (unsigned long)aulActual[i], (unsigned long)aulExpected[i]);
+            bResult = FALSE;
+        }
+    }
+
+#ifndef FAST486_NO_FPU
+    if ((gState.FpuStatus.Value & FPU_STATUS_MASK) != (pGolden->FpuStatus & FPU_STATUS_MASK))
+    {
+        printf("%s: FPU status is %04X, expected %04X\n", pProgram->pszName,
+               gState.FpuStatus.Value & FPU_STATUS_MASK, pGolden->FpuStatus & FPU_STATUS_MASK);
+        bResult = FALSE;
+    }
+
+    if (gState.FpuControl.Value != pGolden->FpuControl)
+    {
+        printf("%s: FPU control is %04X, expected %04X\n", pProgram->pszName,
+               gState.FpuControl.Value, pGolden->FpuControl);
+        bResult = FALSE;
+    }
+#endif
+
+    for (i = 0; i < DATA_SIZE; i++)
+    {
+        if (pjData[i] != pGolden->Data[i])
+        {
+            printf("%s: data byte %02lX is %02X, expected %02X\n", pProgram->pszName,
+                   (unsigned long)i, pjData[i], pGolden->Data[i]);
+            bResult = FALSE;
+        }
+    }
+
+    return bResult;
+}
+
+/* Single steps the program once, then runs it for the measurement */
+static
+BOOL
+RunProgram(const TEST_PROGRAM *pProgram, BOOL bCaches)
+{
+    volatile BOOL bTraceFailed = FALSE;
+    volatile ULONG cRuns = 0;
+    BOOL bResult = TRUE;
+    const char *pszResult;
+    char szResult[32];
+    double dStepMs, dRunMs;
+    clock_t Start;
+    ULONG cSteps;
+
+    if (pProgram->cjCode > MAX_PROGRAM)
+    {
+        printf("%s: the program is larger than %u bytes\n", pProgram->pszName, MAX_PROGRAM);
+        return FALSE;
+    }
+
+    if (gfpRecord)
+        fprintf(gfpRecord, "# %s\n", pProgram->pszName);
+    if (gfpGolden)
+        SkipGoldenTrace(pProgram);
+
+    LoadProgram(pProgram, bCaches);
+    gcSteps = 0;
+
+    Start = clock();
+    if (!setjmp(gHalt))
+    {
+        while (gcSteps < MAX_STEPS)
+        {
+            if (gfpRecord || gfpGolden)
+                TraceStep(pProgram, &bTraceFailed);
+
+            gcSteps++;
+            Fast486StepInto(&gState);
+        }
+    }
+    dStepMs = ElapsedMs(Start);
+    cSteps = gcSteps;
+
+    if (cSteps >= MAX_STEPS)
+    {
+        pszResult = "no halt";
+        bResult = FALSE;
+    }
+    else if (glInterrupt >= 0)
+    {
+        sprintf(szResult, "int %02lX", (unsigned long)glInterrupt);
+        pszResult = szResult;
+        bResult = FALSE;
+    }
+    else if (pProgram->pGolden && !CheckGolden(pProgram))
+    {
+        pszResult = "FAILED";
+        bResult = FALSE;
+    }
+    else
+    {
+        pszResult = pProgram->pGolden ? "passed" : "halted";
+    }
+
+    if (bTraceFailed)
+    {
+        pszResult = "trace";
+        bResult = FALSE;
+    }
+
+    /* Measure the speed without the stepping overhead */
+    dRunMs = 0;
+    if (cSteps < MAX_STEPS)
+    {
+        Start = clock();
+        do
+        {
+            LoadProgram(pProgram, bCaches);
+            if (!setjmp(gHalt)) Fast486Continue(&gState);
+            cRuns++;
+        } while (ElapsedMs(Start) < gulMinTimeMs);
+        dRunMs = ElapsedMs(Start);
+    }
+
+    printf("%-24.24s %-8s %12lu %10.2f %10.2f\n",
+           pProgram->pszName,
+           pszResult,
+           (unsigned long)cSteps,
+           dStepMs > 0 ? cSteps / (dStepMs * 1000.0) : 0,
+           dRunMs > 0 ? (double)cSteps * cRuns / (dRunMs * 1000.0) : 0);
+
+    return bResult;
+}
+
+static
+BOOL
+ReadProgram(const char *pszFile, TEST_PROGRAM *pProgram)
+{
+    FILE *fp;
+    PUCHAR pjCode;
+    size_t cjCode;
+
+    fp = fopen(pszFile, "rb");
+    if (!fp)
+        return FALSE;
+
+    pjCode = malloc(MAX_PROGRAM + 1);
+    cjCode = pjCode ? fread(pjCode, 1, MAX_PROGRAM + 1, fp) : 0;
+    fclose(fp);
+
+    pProgram->pszName = pszFile;
+    pProgram->pjCode = pjCode;
+    pProgram->cjCode = (ULONG)cjCode;
+    pProgram->pGolden = NULL;
+    return pjCode != NULL;
+}
+
+int
+main(int argc, char *argv[])
+{
+    TEST_PROGRAM *pPrograms;
+    ULONG cPrograms = 0, cFailures = 0, i;
+    BOOL bCaches = TRUE;
+    int iArg;
+
+    pPrograms = malloc(sizeof(TEST_PROGRAM) * argc);
+
+    for (iArg = 1; iArg < argc; iArg++)
+    {
+        if (!strcmp(argv[iArg], "-t") && iArg + 1 < argc)
+        {
+            gulMinTimeMs = atoi(argv[++iArg]);
+        }
+        else if (!strcmp(argv[iArg], "-n"))
+        {
+            bCaches = FALSE;
+        }
+        else if (!strcmp(argv[iArg], "-r") && iArg + 1 < argc && !gfpRecord)
+        {
+            gfpRecord = fopen(argv[++iArg], "w");
+            if (!gfpRecord) goto Usage;
+        }
+        else if (!strcmp(argv[iArg], "-g") && iArg + 1 < argc && !gfpGolden)
+        {
+            gfpGolden = fopen(argv[++iArg], "r");
+            if (!gfpGolden) goto Usage;
+        }
+        else if (argv[iArg][0] != '-' && ReadProgram(argv[iArg], &pPrograms[cPrograms]))
+        {
+            cPrograms++;
+        }
+        else
+        {
+            goto Usage;
+        }
+    }
+
+    printf("%-24s %-8s %12s %10s %10s\n",
+           "PROGRAM", "RESULT", "INSTRUCTIONS", "step MIPS", "run MIPS");
+
+    if (cPrograms == 0)
+    {
+        for (i = 0; i < sizeof(TestPrograms) / sizeof(TestPrograms[0]); i++)
+        {
+            if (!RunProgram(&TestPrograms[i], bCaches))
+                cFailures++;
+        }
+        cPrograms = i;
+    }
+    else
+    {
+        for (i = 0; i < cPrograms; i++)
+        {
+            if (!RunProgram(&pPrograms[i], bCaches))
+                cFailures++;
+        }
+    }
+
+    printf("%lu of %lu programs failed\n", (unsigned long)cFailures, (unsigned long)cPrograms);
+
+    if (gfpRecord) fclose(gfpRecord);
+    if (gfpGolden) fclose(gfpGolden);
+    return (int)cFailures;
+
+Usage:
+    printf("Usage: fast486bench [-t ms] [-n] [-r trace] [-g trace] [file ...]\n");
+    printf("Invalid argument or cannot open %s\n", argv[iArg]);
+    return -1;
+}
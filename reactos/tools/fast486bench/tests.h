@@ -0,0 +1,491 @@
+/* Generated by tests/mktests.sh from the test programs, do not edit */
+
+static const UCHAR AluCode[] =
+{
+    0xdb, 0xe3, 0x66, 0xbd, 0x00, 0x80, 0x00, 0x00, 0x66, 0x31, 0xc9, 0x66, 0x89, 0xc8, 0x66, 0xc1,
+    0xe0, 0x03, 0x66, 0x29, 0xc8, 0x66, 0x83, 0xc0, 0x03, 0x67, 0x88, 0x44, 0x0d, 0x00, 0x66, 0x41,
+    0x66, 0x81, 0xf9, 0x00, 0x01, 0x00, 0x00, 0x72, 0xe2, 0x66, 0x31, 0xc0, 0x66, 0x31, 0xdb, 0x66,
+    0x31, 0xc9, 0x66, 0x31, 0xd2, 0x66, 0x31, 0xf6, 0x66, 0x31, 0xff, 0xfc, 0x66, 0x83, 0xc0, 0x00,
+    0x66, 0xb8, 0xff, 0xff, 0xff, 0x7f, 0x66, 0x83, 0xc0, 0x01, 0x9f, 0x66, 0x89, 0xc3, 0x66, 0xb9,
+    0xfe, 0xff, 0xff, 0xff, 0x66, 0x83, 0xc1, 0x03, 0x66, 0x83, 0xd1, 0x10, 0x66, 0x19, 0xd2, 0x66,
+    0xbe, 0x05, 0x00, 0x00, 0x00, 0x66, 0x83, 0xee, 0x07, 0x66, 0x83, 0xdf, 0x00, 0x66, 0x81, 0xf7,
+    0x5a, 0x5a, 0x5a, 0x5a, 0x66, 0x81, 0xe7, 0xff, 0x00, 0xff, 0x00, 0x66, 0x81, 0xcf, 0x00, 0x00,
+    0x00, 0x01, 0x42, 0xfe, 0xc9, 0x3c, 0x55, 0x18, 0xc3, 0xf6, 0xc7, 0x80, 0x10, 0xfe, 0x66, 0x92,
+    0x04, 0x35, 0x27, 0x9f, 0x67, 0x66, 0x89, 0x45, 0x10, 0x2c, 0x47, 0x2f, 0x9f, 0x67, 0x66, 0x89,
+    0x45, 0x14, 0xb8, 0x09, 0x01, 0x04, 0x05, 0x37, 0x67, 0x89, 0x45, 0x18, 0xb8, 0x03, 0x02, 0x2c,
+    0x05, 0x3f, 0x67, 0x89, 0x45, 0x1a, 0xb0, 0x4d, 0xd4, 0x0a, 0x67, 0x89, 0x45, 0x1c, 0xd5, 0x0a,
+    0x67, 0x89, 0x45, 0x1e, 0xb8, 0x00, 0x80, 0x66, 0x98, 0x66, 0x99, 0x67, 0x66, 0x89, 0x55, 0x20,
+    0xb0, 0x80, 0x98, 0x99, 0x67, 0x89, 0x55, 0x24, 0x67, 0x66, 0x8d, 0x74, 0x98, 0x10, 0x66, 0x29,
+    0xfe, 0x66, 0x39, 0xf1, 0xc4, 0xc4, 0x00,
+};
+
+static const GOLDEN_STATE AluGolden =
+{
+    0xffffff80, 0x800096ff, 0x00000011, 0xffffffff,
+    0xfe5d5ae7, 0x01a500a5, 0x00000213,
+    0x0000, 0x037f,
+    {
+        0x03, 0x0a, 0x11, 0x18, 0x1f, 0x26, 0x2d, 0x34, 0x3b, 0x42, 0x49, 0x50, 0x57, 0x5e, 0x65, 0x6c,
+        0x36, 0x06, 0x00, 0x00, 0x89, 0x93, 0x00, 0x00, 0x04, 0x02, 0x08, 0x01, 0x07, 0x07, 0x4d, 0x00,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x0d, 0x14, 0x1b, 0x22, 0x29, 0x30, 0x37, 0x3e, 0x45, 0x4c,
+        0x53, 0x5a, 0x61, 0x68, 0x6f, 0x76, 0x7d, 0x84, 0x8b, 0x92, 0x99, 0xa0, 0xa7, 0xae, 0xb5, 0xbc,
+        0xc3, 0xca, 0xd1, 0xd8, 0xdf, 0xe6, 0xed, 0xf4, 0xfb, 0x02, 0x09, 0x10, 0x17, 0x1e, 0x25, 0x2c,
+        0x33, 0x3a, 0x41, 0x48, 0x4f, 0x56, 0x5d, 0x64, 0x6b, 0x72, 0x79, 0x80, 0x87, 0x8e, 0x95, 0x9c,
+        0xa3, 0xaa, 0xb1, 0xb8, 0xbf, 0xc6, 0xcd, 0xd4, 0xdb, 0xe2, 0xe9, 0xf0, 0xf7, 0xfe, 0x05, 0x0c,
+        0x13, 0x1a, 0x21, 0x28, 0x2f, 0x36, 0x3d, 0x44, 0x4b, 0x52, 0x59, 0x60, 0x67, 0x6e, 0x75, 0x7c,
+        0x83, 0x8a, 0x91, 0x98, 0x9f, 0xa6, 0xad, 0xb4, 0xbb, 0xc2, 0xc9, 0xd0, 0xd7, 0xde, 0xe5, 0xec,
+        0xf3, 0xfa, 0x01, 0x08, 0x0f, 0x16, 0x1d, 0x24, 0x2b, 0x32, 0x39, 0x40, 0x47, 0x4e, 0x55, 0x5c,
+        0x63, 0x6a, 0x71, 0x78, 0x7f, 0x86, 0x8d, 0x94, 0x9b, 0xa2, 0xa9, 0xb0, 0xb7, 0xbe, 0xc5, 0xcc,
+        0xd3, 0xda, 0xe1, 0xe8, 0xef, 0xf6, 0xfd, 0x04, 0x0b, 0x12, 0x19, 0x20, 0x27, 0x2e, 0x35, 0x3c,
+        0x43, 0x4a, 0x51, 0x58, 0x5f, 0x66, 0x6d, 0x74, 0x7b, 0x82, 0x89, 0x90, 0x97, 0x9e, 0xa5, 0xac,
+        0xb3, 0xba, 0xc1, 0xc8, 0xcf, 0xd6, 0xdd, 0xe4, 0xeb, 0xf2, 0xf9, 0x00, 0x07, 0x0e, 0x15, 0x1c,
+        0x23, 0x2a, 0x31, 0x38, 0x3f, 0x46, 0x4d, 0x54, 0x5b, 0x62, 0x69, 0x70, 0x77, 0x7e, 0x85, 0x8c,
+        0x93, 0x9a, 0xa1, 0xa8, 0xaf, 0xb6, 0xbd, 0xc4, 0xcb, 0xd2, 0xd9, 0xe0, 0xe7, 0xee, 0xf5, 0xfc,
+    }
+};
+
+static const UCHAR MoveCode[] =
+{
+    0xdb, 0xe3, 0x66, 0xbd, 0x00, 0x80, 0x00, 0x00, 0x66, 0x31, 0xc9, 0x66, 0x89, 0xc8, 0x66, 0xc1,
+    0xe0, 0x03, 0x66, 0x29, 0xc8, 0x66, 0x83, 0xc0, 0x03, 0x67, 0x88, 0x44, 0x0d, 0x00, 0x66, 0x41,
+    0x66, 0x81, 0xf9, 0x00, 0x01, 0x00, 0x00, 0x72, 0xe2, 0x66, 0x31, 0xc0, 0x66, 0x31, 0xdb, 0x66,
+    0x31, 0xc9, 0x66, 0x31, 0xd2, 0x66, 0x31, 0xf6, 0x66, 0x31, 0xff, 0xfc, 0x66, 0x83, 0xc0, 0x00,
+    0x67, 0x66, 0x8b, 0x45, 0x00, 0x67, 0x66, 0x89, 0x45, 0x10, 0x67, 0xc7, 0x45, 0x20, 0x34, 0x12,
+    0x67, 0xc6, 0x45, 0x22, 0x56, 0x67, 0x66, 0xc7, 0x45, 0x24, 0xef, 0xcd, 0xab, 0x89, 0x67, 0x66,
+    0x8d, 0x75, 0x40, 0x67, 0x66, 0x8d, 0xbd, 0x80, 0x00, 0x00, 0x00, 0x66, 0xb9, 0x09, 0x00, 0x00,
+    0x00, 0x67, 0xf3, 0xa4, 0x66, 0xb9, 0x03, 0x00, 0x00, 0x00, 0x67, 0x66, 0xf3, 0xa5, 0xfd, 0x67,
+    0x66, 0x8d, 0xbd, 0xff, 0x00, 0x00, 0x00, 0xb0, 0xaa, 0x66, 0xb9, 0x05, 0x00, 0x00, 0x00, 0x67,
+    0xf3, 0xaa, 0x67, 0x66, 0x8d, 0xb5, 0xfa, 0x00, 0x00, 0x00, 0x67, 0xad, 0xfc, 0x66, 0x89, 0xc2,
+    0x67, 0x66, 0x8d, 0x75, 0x20, 0x67, 0x66, 0x8d, 0x7d, 0x28, 0x66, 0xb9, 0x08, 0x00, 0x00, 0x00,
+    0x67, 0xf3, 0xa6, 0x66, 0x56, 0x66, 0x57, 0x67, 0x66, 0x8d, 0x7d, 0x50, 0xb8, 0x22, 0x11, 0x67,
+    0xab, 0x67, 0xaf, 0x67, 0x66, 0x89, 0x4d, 0x60, 0x66, 0x68, 0x78, 0x56, 0x34, 0x12, 0x66, 0x5b,
+    0x67, 0x66, 0x87, 0x5d, 0x30, 0x67, 0x86, 0x55, 0x31, 0x67, 0x66, 0x8d, 0x9d, 0x90, 0x00, 0x00,
+    0x00, 0xb0, 0x05, 0x67, 0xd7, 0x88, 0xc6, 0x66, 0x5f, 0x66, 0x5e, 0x66, 0x29, 0xee, 0x66, 0x29,
+    0xef, 0x67, 0x8b, 0x4d, 0x22, 0x66, 0x31, 0xdb, 0x67, 0x8a, 0x5d, 0x30, 0x66, 0x39, 0xca, 0xc4,
+    0xc4, 0x00,
+};
+
+static const GOLDEN_STATE MoveGolden =
+{
+    0x18111116, 0x00000078, 0x0000f856, 0x18111656,
+    0x00000021, 0x00000029, 0x00000206,
+    0x0000, 0x037f,
+    {
+        0x03, 0x0a, 0x11, 0x18, 0x1f, 0x26, 0x2d, 0x34, 0x3b, 0x42, 0x49, 0x50, 0x57, 0x5e, 0x65, 0x6c,
+        0x03, 0x0a, 0x11, 0x18, 0x8f, 0x96, 0x9d, 0xa4, 0xab, 0xb2, 0xb9, 0xc0, 0xc7, 0xce, 0xd5, 0xdc,
+        0x34, 0x12, 0x56, 0xf8, 0xef, 0xcd, 0xab, 0x89, 0x1b, 0x22, 0x29, 0x30, 0x37, 0x3e, 0x45, 0x4c,
+        0x78, 0xd9, 0x34, 0x12, 0x6f, 0x76, 0x7d, 0x84, 0x8b, 0x92, 0x99, 0xa0, 0xa7, 0xae, 0xb5, 0xbc,
+        0xc3, 0xca, 0xd1, 0xd8, 0xdf, 0xe6, 0xed, 0xf4, 0xfb, 0x02, 0x09, 0x10, 0x17, 0x1e, 0x25, 0x2c,
+        0x22, 0x11, 0x41, 0x48, 0x4f, 0x56, 0x5d, 0x64, 0x6b, 0x72, 0x79, 0x80, 0x87, 0x8e, 0x95, 0x9c,
+        0x07, 0x00, 0x00, 0x00, 0xbf, 0xc6, 0xcd, 0xd4, 0xdb, 0xe2, 0xe9, 0xf0, 0xf7, 0xfe, 0x05, 0x0c,
+        0x13, 0x1a, 0x21, 0x28, 0x2f, 0x36, 0x3d, 0x44, 0x4b, 0x52, 0x59, 0x60, 0x67, 0x6e, 0x75, 0x7c,
+        0xc3, 0xca, 0xd1, 0xd8, 0xdf, 0xe6, 0xed, 0xf4, 0xfb, 0x02, 0x09, 0x10, 0x17, 0x1e, 0x25, 0x2c,
+        0x33, 0x3a, 0x41, 0x48, 0x4f, 0x16, 0x1d, 0x24, 0x2b, 0x32, 0x39, 0x40, 0x47, 0x4e, 0x55, 0x5c,
+        0x63, 0x6a, 0x71, 0x78, 0x7f, 0x86, 0x8d, 0x94, 0x9b, 0xa2, 0xa9, 0xb0, 0xb7, 0xbe, 0xc5, 0xcc,
+        0xd3, 0xda, 0xe1, 0xe8, 0xef, 0xf6, 0xfd, 0x04, 0x0b, 0x12, 0x19, 0x20, 0x27, 0x2e, 0x35, 0x3c,
+        0x43, 0x4a, 0x51, 0x58, 0x5f, 0x66, 0x6d, 0x74, 0x7b, 0x82, 0x89, 0x90, 0x97, 0x9e, 0xa5, 0xac,
+        0xb3, 0xba, 0xc1, 0xc8, 0xcf, 0xd6, 0xdd, 0xe4, 0xeb, 0xf2, 0xf9, 0x00, 0x07, 0x0e, 0x15, 0x1c,
+        0x23, 0x2a, 0x31, 0x38, 0x3f, 0x46, 0x4d, 0x54, 0x5b, 0x62, 0x69, 0x70, 0x77, 0x7e, 0x85, 0x8c,
+        0x93, 0x9a, 0xa1, 0xa8, 0xaf, 0xb6, 0xbd, 0xc4, 0xcb, 0xd2, 0xd9, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+    }
+};
+
+static const UCHAR JumpCode[] =
+{
+    0xdb, 0xe3, 0x66, 0xbd, 0x00, 0x80, 0x00, 0x00, 0x66, 0x31, 0xc9, 0x66, 0x89, 0xc8, 0x66, 0xc1,
+    0xe0, 0x03, 0x66, 0x29, 0xc8, 0x66, 0x83, 0xc0, 0x03, 0x67, 0x88, 0x44, 0x0d, 0x00, 0x66, 0x41,
+    0x66, 0x81, 0xf9, 0x00, 0x01, 0x00, 0x00, 0x72, 0xe2, 0x66, 0x31, 0xc0, 0x66, 0x31, 0xdb, 0x66,
+    0x31, 0xc9, 0x66, 0x31, 0xd2, 0x66, 0x31, 0xf6, 0x66, 0x31, 0xff, 0xfc, 0x66, 0x83, 0xc0, 0x00,
+    0x66, 0xb9, 0x0a, 0x00, 0x00, 0x00, 0x66, 0x01, 0xc8, 0x67, 0xe2, 0xfa, 0x66, 0xbb, 0x01, 0x00,
+    0x00, 0x00, 0xe8, 0xae, 0x00, 0xe8, 0xab, 0x00, 0x66, 0xbe, 0xff, 0xff, 0xff, 0xff, 0x66, 0x83,
+    0xfe, 0x01, 0x7c, 0x04, 0x66, 0x83, 0xca, 0x01, 0x72, 0x04, 0x66, 0x83, 0xca, 0x02, 0x7f, 0x04,
+    0x66, 0x83, 0xca, 0x04, 0x77, 0x04, 0x66, 0x83, 0xca, 0x08, 0x78, 0x04, 0x66, 0x83, 0xca, 0x10,
+    0x7a, 0x04, 0x66, 0x83, 0xca, 0x20, 0x70, 0x04, 0x66, 0x83, 0xca, 0x40, 0x7e, 0x07, 0x66, 0x81,
+    0xca, 0x80, 0x00, 0x00, 0x00, 0x7d, 0x07, 0x66, 0x81, 0xca, 0x00, 0x01, 0x00, 0x00, 0x76, 0x07,
+    0x66, 0x81, 0xca, 0x00, 0x02, 0x00, 0x00, 0x73, 0x07, 0x66, 0x81, 0xca, 0x00, 0x04, 0x00, 0x00,
+    0x75, 0x07, 0x66, 0x81, 0xca, 0x00, 0x08, 0x00, 0x00, 0xb1, 0x7f, 0x80, 0xc1, 0x01, 0x71, 0x07,
+    0x66, 0x81, 0xca, 0x00, 0x10, 0x00, 0x00, 0x79, 0x07, 0x66, 0x81, 0xca, 0x00, 0x20, 0x00, 0x00,
+    0x66, 0x31, 0xc9, 0x67, 0xe3, 0x07, 0x66, 0x81, 0xca, 0x00, 0x40, 0x00, 0x00, 0x66, 0xb9, 0x05,
+    0x00, 0x00, 0x00, 0x66, 0xbf, 0x00, 0x00, 0x00, 0x00, 0x66, 0x47, 0x66, 0x83, 0xff, 0x03, 0x67,
+    0xe0, 0xf7, 0x66, 0x89, 0xce, 0xeb, 0x07, 0x66, 0x81, 0xca, 0x00, 0x80, 0x00, 0x00, 0x66, 0x39,
+    0xd8, 0xeb, 0x04, 0x66, 0x01, 0xdb, 0xc3, 0xc4, 0xc4, 0x00,
+};
+
+static const GOLDEN_STATE JumpGolden =
+{
+    0x00000037, 0x00000004, 0x00000002, 0x000012d2,
+    0x00000002, 0x00000003, 0x00000206,
+    0x0000, 0x037f,
+    {
+        0x03, 0x0a, 0x11, 0x18, 0x1f, 0x26, 0x2d, 0x34, 0x3b, 0x42, 0x49, 0x50, 0x57, 0x5e, 0x65, 0x6c,
+        0x73, 0x7a, 0x81, 0x88, 0x8f, 0x96, 0x9d, 0xa4, 0xab, 0xb2, 0xb9, 0xc0, 0xc7, 0xce, 0xd5, 0xdc,
+        0xe3, 0xea, 0xf1, 0xf8, 0xff, 0x06, 0x0d, 0x14, 0x1b, 0x22, 0x29, 0x30, 0x37, 0x3e, 0x45, 0x4c,
+        0x53, 0x5a, 0x61, 0x68, 0x6f, 0x76, 0x7d, 0x84, 0x8b, 0x92, 0x99, 0xa0, 0xa7, 0xae, 0xb5, 0xbc,
+        0xc3, 0xca, 0xd1, 0xd8, 0xdf, 0xe6, 0xed, 0xf4, 0xfb, 0x02, 0x09, 0x10, 0x17, 0x1e, 0x25, 0x2c,
+        0x33, 0x3a, 0x41, 0x48, 0x4f, 0x56, 0x5d, 0x64, 0x6b, 0x72, 0x79, 0x80, 0x87, 0x8e, 0x95, 0x9c,
+        0xa3, 0xaa, 0xb1, 0xb8, 0xbf, 0xc6, 0xcd, 0xd4, 0xdb, 0xe2, 0xe9, 0xf0, 0xf7, 0xfe, 0x05, 0x0c,
+        0x13, 0x1a, 0x21, 0x28, 0x2f, 0x36, 0x3d, 0x44, 0x4b, 0x52, 0x59, 0x60, 0x67, 0x6e, 0x75, 0x7c,
+        0x83, 0x8a, 0x91, 0x98, 0x9f, 0xa6, 0xad, 0xb4, 0xbb, 0xc2, 0xc9, 0xd0, 0xd7, 0xde, 0xe5, 0xec,
+        0xf3, 0xfa, 0x01, 0x08, 0x0f, 0x16, 0x1d, 0x24, 0x2b, 0x32, 0x39, 0x40, 0x47, 0x4e, 0x55, 0x5c,
+        0x63, 0x6a, 0x71, 0x78, 0x7f, 0x86, 0x8d, 0x94, 0x9b, 0xa2, 0xa9, 0xb0, 0xb7, 0xbe, 0xc5, 0xcc,
+        0xd3, 0xda, 0xe1, 0xe8, 0xef, 0xf6, 0xfd, 0x04, 0x0b, 0x12, 0x19, 0x20, 0x27, 0x2e, 0x35, 0x3c,
+        0x43, 0x4a, 0x51, 0x58, 0x5f, 0x66, 0x6d, 0x74, 0x7b, 0x82, 0x89, 0x90, 0x97, 0x9e, 0xa5, 0xac,
+        0xb3, 0xba, 0xc1, 0xc8, 0xcf, 0xd6, 0xdd, 0xe4, 0xeb, 0xf2, 0xf9, 0x00, 0x07, 0x0e, 0x15, 0x1c,
+        0x23, 0x2a, 0x31, 0x38, 0x3f, 0x46, 0x4d, 0x54, 0x5b, 0x62, 0x69, 0x70, 0x77, 0x7e, 0x85, 0x8c,
+        0x93, 0x9a, 0xa1, 0xa8, 0xaf, 0xb6, 0xbd, 0xc4, 0xcb, 0xd2, 0xd9, 0xe0, 0xe7, 0xee, 0xf5, 0xfc,
+    }
+};
+
+static const UCHAR GroupsCode[] =
+{
+    0xdb, 0xe3, 0x66, 0xbd, 0x00, 0x80, 0x00, 0x00, 0x66, 0x31, 0xc9, 0x66, 0x89, 0xc8, 0x66, 0xc1,
+    0xe0, 0x03, 0x66, 0x29, 0xc8, 0x66, 0x83, 0xc0, 0x03, 0x67, 0x88, 0x44, 0x0d, 0x00, 0x66, 0x41,
+    0x66, 0x81, 0xf9, 0x00, 0x01, 0x00, 0x00, 0x72, 0xe2, 0x66, 0x31, 0xc0, 0x66, 0x31, 0xdb, 0x66,
+    0x31, 0xc9, 0x66, 0x31, 0xd2, 0x66, 0x31, 0xf6, 0x66, 0x31, 0xff, 0xfc, 0x66, 0x83, 0xc0, 0x00,
+    0x66, 0xb8, 0x67, 0x45, 0x23, 0x81, 0x66, 0xc1, 0xc0, 0x04, 0x66, 0x89, 0xc3, 0x66, 0xd1, 0xcb,
+    0x66, 0xd1, 0xd3, 0x66, 0xc1, 0xdb, 0x03, 0x67, 0x66, 0x89, 0x5d, 0x10, 0x66, 0xb9, 0x00, 0x00,
+    0x00, 0x80, 0x66, 0xc1, 0xf9, 0x1f, 0x67, 0x66, 0x89, 0x4d, 0x14, 0x66, 0xba, 0xf0, 0x00, 0x00,
+    0x00, 0x66, 0xc1, 0xe2, 0x04, 0x66, 0xc1, 0xea, 0x02, 0xb1, 0x05, 0x66, 0xd3, 0xe2, 0x66, 0xd3,
+    0xfa, 0x67, 0x66, 0x89, 0x55, 0x18, 0x66, 0xb8, 0x78, 0x56, 0x34, 0x12, 0x66, 0xbb, 0xf0, 0xde,
+    0xbc, 0x9a, 0x66, 0xf7, 0xe3, 0x67, 0x66, 0x89, 0x45, 0x20, 0x67, 0x66, 0x89, 0x55, 0x24, 0x66,
+    0xb8, 0x78, 0x56, 0x34, 0x12, 0x66, 0xf7, 0xeb, 0x67, 0x66, 0x89, 0x45, 0x28, 0x67, 0x66, 0x89,
+    0x55, 0x2c, 0x66, 0x31, 0xd2, 0x66, 0xb8, 0x41, 0x42, 0x0f, 0x00, 0x66, 0xb9, 0x07, 0x00, 0x00,
+    0x00, 0x66, 0xf7, 0xf1, 0x67, 0x66, 0x89, 0x45, 0x30, 0x67, 0x66, 0x89, 0x55, 0x34, 0x66, 0xb8,
+    0x9c, 0xff, 0xff, 0xff, 0x66, 0x99, 0x66, 0xf7, 0xf9, 0x67, 0x66, 0x89, 0x45, 0x38, 0x67, 0x66,
+    0x89, 0x55, 0x3c, 0xb0, 0xc8, 0xb3, 0x03, 0xf6, 0xe3, 0x67, 0x89, 0x45, 0x40, 0xb0, 0xf9, 0xf6,
+    0xeb, 0x67, 0x89, 0x45, 0x42, 0xb8, 0xe8, 0x03, 0xb3, 0x07, 0xf6, 0xf3, 0x67, 0x89, 0x45, 0x44,
+    0x67, 0xfe, 0x45, 0x50, 0x67, 0x66, 0xff, 0x4d, 0x54, 0x67, 0xf7, 0x55, 0x58, 0x67, 0x66, 0xf7,
+    0x5d, 0x5c, 0x67, 0xd0, 0x45, 0x60, 0x67, 0xc1, 0x6d, 0x62, 0x03, 0x66, 0xbe, 0x78, 0x56, 0x34,
+    0x12, 0x66, 0xf7, 0xd6, 0x66, 0xbf, 0x10, 0x00, 0x00, 0x00, 0x66, 0xf7, 0xdf, 0xb1, 0x03, 0x66,
+    0xd3, 0xd6, 0x67, 0x66, 0x89, 0x75, 0x64, 0xba, 0x34, 0x12, 0xf7, 0xc2, 0x00, 0x10, 0x66, 0x29,
+    0xc7, 0xc4, 0xc4, 0x00,
+};
+
+static const GOLDEN_STATE GroupsGolden =
+{
+    0xffff068e, 0x9abcde07, 0x00000003, 0xffff1234,
+    0x6e5d4c3f, 0x0000f962, 0x00000212,
+    0x0000, 0x037f,
+    {
+        0x03, 0x0a, 0x11, 0x18, 0x1f, 0x26, 0x2d, 0x34, 0x3b, 0x42, 0x49, 0x50, 0x57, 0x5e, 0x65, 0x6c,
+        0xcf, 0x8a, 0x46, 0x02, 0xff, 0xff, 0xff, 0xff, 0xc0, 0x03, 0x00, 0x00, 0xc7, 0xce, 0xd5, 0xdc,
+        0x80, 0x20, 0x2d, 0x24, 0x4e, 0xea, 0x00, 0x0b, 0x80, 0x20, 0x2d, 0x24, 0xd6, 0x93, 0xcc, 0xf8,
+        0x09, 0x2e, 0x02, 0x00, 0x02, 0x00, 0x00, 0x00, 0xf2, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xff,
+        0x58, 0x02, 0xeb, 0xff, 0x8e, 0x06, 0xed, 0xf4, 0xfb, 0x02, 0x09, 0x10, 0x17, 0x1e, 0x25, 0x2c,
+        0x34, 0x3a, 0x41, 0x48, 0x4e, 0x56, 0x5d, 0x64, 0x94, 0x8d, 0x79, 0x80, 0x79, 0x71, 0x6a, 0x63,
+        0x47, 0xaa, 0x16, 0x17, 0x3f, 0x4c, 0x5d, 0x6e, 0xdb, 0xe2, 0xe9, 0xf0, 0xf7, 0xfe, 0x05, 0x0c,
+        0x13, 0x1a, 0x21, 0x28, 0x2f, 0x36, 0x3d, 0x44, 0x4b, 0x52, 0x59, 0x60, 0x67, 0x6e, 0x75, 0x7c,
+        0x83, 0x8a, 0x91, 0x98, 0x9f, 0xa6, 0xad, 0xb4, 0xbb, 0xc2, 0xc9, 0xd0, 0xd7, 0xde, 0xe5, 0xec,
+        0xf3, 0xfa, 0x01, 0x08, 0x0f, 0x16, 0x1d, 0x24, 0x2b, 0x32, 0x39, 0x40, 0x47, 0x4e, 0x55, 0x5c,
+        0x63, 0x6a, 0x71, 0x78, 0x7f, 0x86, 0x8d, 0x94, 0x9b, 0xa2, 0xa9, 0xb0, 0xb7, 0xbe, 0xc5, 0xcc,
+        0xd3, 0xda, 0xe1, 0xe8, 0xef, 0xf6, 0xfd, 0x04, 0x0b, 0x12, 0x19, 0x20, 0x27, 0x2e, 0x35, 0x3c,
+        0x43, 0x4a, 0x51, 0x58, 0x5f, 0x66, 0x6d, 0x74, 0x7b, 0x82, 0x89, 0x90, 0x97, 0x9e, 0xa5, 0xac,
+        0xb3, 0xba, 0xc1, 0xc8, 0xcf, 0xd6, 0xdd, 0xe4, 0xeb, 0xf2, 0xf9, 0x00, 0x07, 0x0e, 0x15, 0x1c,
+        0x23, 0x2a, 0x31, 0x38, 0x3f, 0x46, 0x4d, 0x54, 0x5b, 0x62, 0x69, 0x70, 0x77, 0x7e, 0x85, 0x8c,
+        0x93, 0x9a, 0xa1, 0xa8, 0xaf, 0xb6, 0xbd, 0xc4, 0xcb, 0xd2, 0xd9, 0xe0, 0xe7, 0xee, 0xf5, 0xfc,
+    }
+};
+
+static const UCHAR ExtraopsCode[] =
+{
+    0xdb, 0xe3, 0x66, 0xbd, 0x00, 0x80, 0x00, 0x00, 0x66, 0x31, 0xc9, 0x66, 0x89, 0xc8, 0x66, 0xc1,
+    0xe0, 0x03, 0x66, 0x29, 0xc8, 0x66, 0x83, 0xc0, 0x03, 0x67, 0x88, 0x44, 0x0d, 0x00, 0x66, 0x41,
+    0x66, 0x81, 0xf9, 0x00, 0x01, 0x00, 0x00, 0x72, 0xe2, 0x66, 0x31, 0xc0, 0x66, 0x31, 0xdb, 0x66,
+    0x31, 0xc9, 0x66, 0x31, 0xd2, 0x66, 0x31, 0xf6, 0x66, 0x31, 0xff, 0xfc, 0x66, 0x83, 0xc0, 0x00,
+    0x66, 0xb8, 0xf0, 0x00, 0x00, 0x00, 0x66, 0x0f, 0xbc, 0xd8, 0x66, 0x0f, 0xbd, 0xc8, 0x66, 0x0f,
+    0xba, 0xe0, 0x05, 0x0f, 0x92, 0xc2, 0x66, 0x0f, 0xba, 0xe8, 0x01, 0x66, 0x0f, 0xba, 0xf0, 0x04,
+    0x66, 0x0f, 0xba, 0xf8, 0x1f, 0x66, 0xbe, 0x03, 0x00, 0x00, 0x00, 0x66, 0x0f, 0xab, 0xf0, 0x67,
+    0x66, 0x89, 0x45, 0x10, 0x67, 0x66, 0x0f, 0xb6, 0x75, 0x20, 0x67, 0x66, 0x0f, 0xbe, 0x7d, 0x21,
+    0x67, 0x66, 0x89, 0x75, 0x14, 0x67, 0x66, 0x89, 0x7d, 0x18, 0x67, 0x66, 0x0f, 0xb7, 0x75, 0x22,
+    0x67, 0x66, 0x0f, 0xbf, 0x7d, 0x24, 0x67, 0x66, 0x89, 0x75, 0x1c, 0x67, 0x66, 0x89, 0x7d, 0x20,
+    0x66, 0x83, 0xfb, 0x03, 0x67, 0x0f, 0x9c, 0x45, 0x30, 0x67, 0x0f, 0x9f, 0x45, 0x31, 0x67, 0x0f,
+    0x94, 0x45, 0x32, 0x67, 0x0f, 0x95, 0x45, 0x33, 0x67, 0x0f, 0x92, 0x45, 0x34, 0x67, 0x0f, 0x97,
+    0x45, 0x35, 0x67, 0x0f, 0x98, 0x45, 0x36, 0x67, 0x0f, 0x9a, 0x45, 0x37, 0x66, 0xb8, 0x44, 0x33,
+    0x22, 0x11, 0x66, 0xbb, 0xdd, 0xcc, 0xbb, 0xaa, 0x66, 0x0f, 0xa4, 0xd8, 0x08, 0x67, 0x66, 0x89,
+    0x45, 0x38, 0xb1, 0x0c, 0x66, 0x0f, 0xad, 0xd8, 0x67, 0x66, 0x89, 0x45, 0x3c, 0x66, 0xb9, 0xd2,
+    0x04, 0x00, 0x00, 0x66, 0x0f, 0xaf, 0xcb, 0x67, 0x66, 0x89, 0x4d, 0x40, 0x66, 0x69, 0xf1, 0xe8,
+    0x03, 0x00, 0x00, 0x67, 0x0f, 0x92, 0x45, 0x68, 0x67, 0x66, 0x89, 0x75, 0x44, 0xb8, 0xfe, 0xff,
+    0x6b, 0xc0, 0x03, 0x67, 0x0f, 0x90, 0x45, 0x69, 0x66, 0xb8, 0xfe, 0xff, 0xff, 0xff, 0x66, 0x6b,
+    0xc0, 0xfd, 0x67, 0x0f, 0x92, 0x45, 0x6a, 0x66, 0xbf, 0x04, 0x03, 0x02, 0x01, 0x66, 0x0f, 0xcf,
+    0x66, 0xb8, 0x05, 0x00, 0x00, 0x00, 0x66, 0xb9, 0x09, 0x00, 0x00, 0x00, 0x66, 0x0f, 0xc1, 0xc1,
+    0x67, 0x66, 0x89, 0x45, 0x48, 0x67, 0x66, 0x89, 0x4d, 0x4c, 0x67, 0x66, 0x8b, 0x45, 0x50, 0x66,
+    0xbb, 0x77, 0x00, 0x00, 0x00, 0x67, 0x66, 0x0f, 0xb1, 0x5d, 0x50, 0x67, 0x66, 0x0f, 0xb1, 0x5d,
+    0x54, 0x67, 0x66, 0x89, 0x45, 0x58, 0xb0, 0x10, 0x0f, 0xb0, 0xda, 0x67, 0x89, 0x55, 0x5c, 0xb0,
+    0x12, 0x67, 0x0f, 0xc0, 0x45, 0x60, 0x67, 0x66, 0x0f, 0xba, 0x65, 0x61, 0x02, 0x66, 0x83, 0xd7,
+    0x00, 0x66, 0x39, 0xf8, 0xc4, 0xc4, 0x00,
+};
+
+static const GOLDEN_STATE ExtraopsGolden =
+{
+    0x645d56a3, 0x00000077, 0x0000000e, 0x00000001,
+    0x47e10910, 0x04030201, 0x00000202,
+    0x0000, 0x037f,
+    {
+        0x03, 0x0a, 0x11, 0x18, 0x1f, 0x26, 0x2d, 0x34, 0x3b, 0x42, 0x49, 0x50, 0x57, 0x5e, 0x65, 0x6c,
+        0xea, 0x00, 0x00, 0x80, 0xe3, 0x00, 0x00, 0x00, 0xea, 0xff, 0xff, 0xff, 0xf1, 0xf8, 0x00, 0x00,
+        0xff, 0x06, 0x00, 0x00, 0xff, 0x06, 0x0d, 0x14, 0x1b, 0x22, 0x29, 0x30, 0x37, 0x3e, 0x45, 0x4c,
+        0x00, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0xaa, 0x44, 0x33, 0x22, 0x34, 0x23, 0xd2, 0xcd,
+        0x4a, 0x81, 0x41, 0xfd, 0x10, 0x09, 0xe1, 0x47, 0x09, 0x00, 0x00, 0x00, 0x0e, 0x00, 0x00, 0x00,
+        0x77, 0x00, 0x00, 0x00, 0x4f, 0x56, 0x5d, 0x64, 0x4f, 0x56, 0x5d, 0x64, 0x01, 0x00, 0x95, 0x9c,
+        0xb5, 0xaa, 0xb1, 0xb8, 0xbf, 0xc6, 0xcd, 0xd4, 0x01, 0x00, 0x00, 0xf0, 0xf7, 0xfe, 0x05, 0x0c,
+        0x13, 0x1a, 0x21, 0x28, 0x2f, 0x36, 0x3d, 0x44, 0x4b, 0x52, 0x59, 0x60, 0x67, 0x6e, 0x75, 0x7c,
+        0x83, 0x8a, 0x91, 0x98, 0x9f, 0xa6, 0xad, 0xb4, 0xbb, 0xc2, 0xc9, 0xd0, 0xd7, 0xde, 0xe5, 0xec,
+        0xf3, 0xfa, 0x01, 0x08, 0x0f, 0x16, 0x1d, 0x24, 0x2b, 0x32, 0x39, 0x40, 0x47, 0x4e, 0x55, 0x5c,
+        0x63, 0x6a, 0x71, 0x78, 0x7f, 0x86, 0x8d, 0x94, 0x9b, 0xa2, 0xa9, 0xb0, 0xb7, 0xbe, 0xc5, 0xcc,
+        0xd3, 0xda, 0xe1, 0xe8, 0xef, 0xf6, 0xfd, 0x04, 0x0b, 0x12, 0x19, 0x20, 0x27, 0x2e, 0x35, 0x3c,
+        0x43, 0x4a, 0x51, 0x58, 0x5f, 0x66, 0x6d, 0x74, 0x7b, 0x82, 0x89, 0x90, 0x97, 0x9e, 0xa5, 0xac,
+        0xb3, 0xba, 0xc1, 0xc8, 0xcf, 0xd6, 0xdd, 0xe4, 0xeb, 0xf2, 0xf9, 0x00, 0x07, 0x0e, 0x15, 0x1c,
+        0x23, 0x2a, 0x31, 0x38, 0x3f, 0x46, 0x4d, 0x54, 0x5b, 0x62, 0x69, 0x70, 0x77, 0x7e, 0x85, 0x8c,
+        0x93, 0x9a, 0xa1, 0xa8, 0xaf, 0xb6, 0xbd, 0xc4, 0xcb, 0xd2, 0xd9, 0xe0, 0xe7, 0xee, 0xf5, 0xfc,
+    }
+};
+
+static const UCHAR FpuCode[] =
+{
+    0xdb, 0xe3, 0x66, 0xbd, 0x00, 0x80, 0x00, 0x00, 0x66, 0x31, 0xc9, 0x66, 0x89, 0xc8, 0x66, 0xc1,
+    0xe0, 0x03, 0x66, 0x29, 0xc8, 0x66, 0x83, 0xc0, 0x03, 0x67, 0x88, 0x44, 0x0d, 0x00, 0x66, 0x41,
+    0x66, 0x81, 0xf9, 0x00, 0x01, 0x00, 0x00, 0x72, 0xe2, 0x66, 0x31, 0xc0, 0x66, 0x31, 0xdb, 0x66,
+    0x31, 0xc9, 0x66, 0x31, 0xd2, 0x66, 0x31, 0xf6, 0x66, 0x31, 0xff, 0xfc, 0x66, 0x83, 0xc0, 0x00,
+    0xdb, 0xe2, 0xdb, 0xe0, 0xdb, 0xe1, 0x67, 0xd8, 0x45, 0x00, 0x66, 0xb8, 0x03, 0x00, 0x00, 0x00,
+    0x66, 0x83, 0xf8, 0x02, 0xc4, 0xc4, 0x00,
+};
+
+static const GOLDEN_STATE FpuGolden =
+{
+    0x00000003, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000202,
+    0x0041, 0x037f,
+    {
+        0x03, 0x0a, 0x11, 0x18, 0x1f, 0x26, 0x2d, 0x34, 0x3b, 0x42, 0x49, 0x50, 0x57, 0x5e, 0x65, 0x6c,
+        0x73, 0x7a, 0x81, 0x88, 0x8f, 0x96, 0x9d, 0xa4, 0xab, 0xb2, 0xb9, 0xc0, 0xc7, 0xce, 0xd5, 0xdc,
+        0xe3, 0xea, 0xf1, 0xf8, 0xff, 0x06, 0x0d, 0x14, 0x1b, 0x22, 0x29, 0x30, 0x37, 0x3e, 0x45, 0x4c,
+        0x53, 0x5a, 0x61, 0x68, 0x6f, 0x76, 0x7d, 0x84, 0x8b, 0x92, 0x99, 0xa0, 0xa7, 0xae, 0xb5, 0xbc,
+        0xc3, 0xca, 0xd1, 0xd8, 0xdf, 0xe6, 0xed, 0xf4, 0xfb, 0x02, 0x09, 0x10, 0x17, 0x1e, 0x25, 0x2c,
+        0x33, 0x3a, 0x41, 0x48, 0x4f, 0x56, 0x5d, 0x64, 0x6b, 0x72, 0x79, 0x80, 0x87, 0x8e, 0x95, 0x9c,
+        0xa3, 0xaa, 0xb1, 0xb8, 0xbf, 0xc6, 0xcd, 0xd4, 0xdb, 0xe2, 0xe9, 0xf0, 0xf7, 0xfe, 0x05, 0x0c,
+        0x13, 0x1a, 0x21, 0x28, 0x2f, 0x36, 0x3d, 0x44, 0x4b, 0x52, 0x59, 0x60, 0x67, 0x6e, 0x75, 0x7c,
+        0x83, 0x8a, 0x91, 0x98, 0x9f, 0xa6, 0xad, 0xb4, 0xbb, 0xc2, 0xc9, 0xd0, 0xd7, 0xde, 0xe5, 0xec,
+        0xf3, 0xfa, 0x01, 0x08, 0x0f, 0x16, 0x1d, 0x24, 0x2b, 0x32, 0x39, 0x40, 0x47, 0x4e, 0x55, 0x5c,
+        0x63, 0x6a, 0x71, 0x78, 0x7f, 0x86, 0x8d, 0x94, 0x9b, 0xa2, 0xa9, 0xb0, 0xb7, 0xbe, 0xc5, 0xcc,
+        0xd3, 0xda, 0xe1, 0xe8, 0xef, 0xf6, 0xfd, 0x04, 0x0b, 0x12, 0x19, 0x20, 0x27, 0x2e, 0x35, 0x3c,
+        0x43, 0x4a, 0x51, 0x58, 0x5f, 0x66, 0x6d, 0x74, 0x7b, 0x82, 0x89, 0x90, 0x97, 0x9e, 0xa5, 0xac,
+        0xb3, 0xba, 0xc1, 0xc8, 0xcf, 0xd6, 0xdd, 0xe4, 0xeb, 0xf2, 0xf9, 0x00, 0x07, 0x0e, 0x15, 0x1c,
+        0x23, 0x2a, 0x31, 0x38, 0x3f, 0x46, 0x4d, 0x54, 0x5b, 0x62, 0x69, 0x70, 0x77, 0x7e, 0x85, 0x8c,
+        0x93, 0x9a, 0xa1, 0xa8, 0xaf, 0xb6, 0xbd, 0xc4, 0xcb, 0xd2, 0xd9, 0xe0, 0xe7, 0xee, 0xf5, 0xfc,
+    }
+};
+
+static const UCHAR LoopCode[] =
+{
+    0xdb, 0xe3, 0x66, 0xbd, 0x00, 0x80, 0x00, 0x00, 0x66, 0x31, 0xc9, 0x66, 0x89, 0xc8, 0x66, 0xc1,
+    0xe0, 0x03, 0x66, 0x29, 0xc8, 0x66, 0x83, 0xc0, 0x03, 0x67, 0x88, 0x44, 0x0d, 0x00, 0x66, 0x41,
+    0x66, 0x81, 0xf9, 0x00, 0x01, 0x00, 0x00, 0x72, 0xe2, 0x66, 0x31, 0xc0, 0x66, 0x31, 0xdb, 0x66,
+    0x31, 0xc9, 0x66, 0x31, 0xd2, 0x66, 0x31, 0xf6, 0x66, 0x31, 0xff, 0xfc, 0x66, 0x83, 0xc0, 0x00,
+    0x66, 0xba, 0xc8, 0x00, 0x00, 0x00, 0x66, 0xb9, 0x88, 0x13, 0x00, 0x00, 0x66, 0x01, 0xc8, 0x66,
+    0x31, 0xd8, 0x66, 0xd1, 0xc3, 0x66, 0x46, 0x67, 0xe2, 0xf2, 0x66, 0x4a, 0x75, 0xe8, 0x66, 0x89,
+    0xc7, 0x66, 0x39, 0xde, 0xc4, 0xc4, 0x00,
+};
+
+static const GOLDEN_STATE LoopGolden =
+{
+    0x950a9a20, 0x00000000, 0x00000000, 0x00000000,
+    0x000f4240, 0x950a9a20, 0x00000202,
+    0x0000, 0x037f,
+    {
+        0x03, 0x0a, 0x11, 0x18, 0x1f, 0x26, 0x2d, 0x34, 0x3b, 0x42, 0x49, 0x50, 0x57, 0x5e, 0x65, 0x6c,
+        0x73, 0x7a, 0x81, 0x88, 0x8f, 0x96, 0x9d, 0xa4, 0xab, 0xb2, 0xb9, 0xc0, 0xc7, 0xce, 0xd5, 0xdc,
+        0xe3, 0xea, 0xf1, 0xf8, 0xff, 0x06, 0x0d, 0x14, 0x1b, 0x22, 0x29, 0x30, 0x37, 0x3e, 0x45, 0x4c,
+        0x53, 0x5a, 0x61, 0x68, 0x6f, 0x76, 0x7d, 0x84, 0x8b, 0x92, 0x99, 0xa0, 0xa7, 0xae, 0xb5, 0xbc,
+        0xc3, 0xca, 0xd1, 0xd8, 0xdf, 0xe6, 0xed, 0xf4, 0xfb, 0x02, 0x09, 0x10, 0x17, 0x1e, 0x25, 0x2c,
+        0x33, 0x3a, 0x41, 0x48, 0x4f, 0x56, 0x5d, 0x64, 0x6b, 0x72, 0x79, 0x80, 0x87, 0x8e, 0x95, 0x9c,
+        0xa3, 0xaa, 0xb1, 0xb8, 0xbf, 0xc6, 0xcd, 0xd4, 0xdb, 0xe2, 0xe9, 0xf0, 0xf7, 0xfe, 0x05, 0x0c,
+        0x13, 0x1a, 0x21, 0x28, 0x2f, 0x36, 0x3d, 0x44, 0x4b, 0x52, 0x59, 0x60, 0x67, 0x6e, 0x75, 0x7c,
+        0x83, 0x8a, 0x91, 0x98, 0x9f, 0xa6, 0xad, 0xb4, 0xbb, 0xc2, 0xc9, 0xd0, 0xd7, 0xde, 0xe5, 0xec,
+        0xf3, 0xfa, 0x01, 0x08, 0x0f, 0x16, 0x1d, 0x24, 0x2b, 0x32, 0x39, 0x40, 0x47, 0x4e, 0x55, 0x5c,
+        0x63, 0x6a, 0x71, 0x78, 0x7f, 0x86, 0x8d, 0x94, 0x9b, 0xa2, 0xa9, 0xb0, 0xb7, 0xbe, 0xc5, 0xcc,
+        0xd3, 0xda, 0xe1, 0xe8, 0xef, 0xf6, 0xfd, 0x04, 0x0b, 0x12, 0x19, 0x20, 0x27, 0x2e, 0x35, 0x3c,
+        0x43, 0x4a, 0x51, 0x58, 0x5f, 0x66, 0x6d, 0x74, 0x7b, 0x82, 0x89, 0x90, 0x97, 0x9e, 0xa5, 0xac,
+        0xb3, 0xba, 0xc1, 0xc8, 0xcf, 0xd6, 0xdd, 0xe4, 0xeb, 0xf2, 0xf9, 0x00, 0x07, 0x0e, 0x15, 0x1c,
+        0x23, 0x2a, 0x31, 0x38, 0x3f, 0x46, 0x4d, 0x54, 0x5b, 0x62, 0x69, 0x70, 0x77, 0x7e, 0x85, 0x8c,
+        0x93, 0x9a, 0xa1, 0xa8, 0xaf, 0xb6, 0xbd, 0xc4, 0xcb, 0xd2, 0xd9, 0xe0, 0xe7, 0xee, 0xf5, 0xfc,
+    }
+};
+
+static const UCHAR MemoryCode[] =
+{
+    0xdb, 0xe3, 0x66, 0xbd, 0x00, 0x80, 0x00, 0x00, 0x66, 0x31, 0xc9, 0x66, 0x89, 0xc8, 0x66, 0xc1,
+    0xe0, 0x03, 0x66, 0x29, 0xc8, 0x66, 0x83, 0xc0, 0x03, 0x67, 0x88, 0x44, 0x0d, 0x00, 0x66, 0x41,
+    0x66, 0x81, 0xf9, 0x00, 0x01, 0x00, 0x00, 0x72, 0xe2, 0x66, 0x31, 0xc0, 0x66, 0x31, 0xdb, 0x66,
+    0x31, 0xc9, 0x66, 0x31, 0xd2, 0x66, 0x31, 0xf6, 0x66, 0x31, 0xff, 0xfc, 0x66, 0x83, 0xc0, 0x00,
+    0x66, 0xba, 0x50, 0xc3, 0x00, 0x00, 0x66, 0x89, 0xd0, 0x66, 0x25, 0xf8, 0x00, 0x00, 0x00, 0x67,
+    0x66, 0x8b, 0x5c, 0x05, 0x00, 0x67, 0x66, 0x01, 0x5c, 0x05, 0x04, 0x67, 0x66, 0x31, 0x54, 0x05,
+    0x00, 0x66, 0x4a, 0x75, 0xe1, 0x66, 0xba, 0xd0, 0x07, 0x00, 0x00, 0x66, 0x89, 0xee, 0x67, 0x66,
+    0x8d, 0xbd, 0x80, 0x00, 0x00, 0x00, 0x66, 0xb9, 0x20, 0x00, 0x00, 0x00, 0x67, 0x66, 0xf3, 0xa5,
+    0x67, 0x66, 0xff, 0x45, 0x7c, 0x66, 0x4a, 0x75, 0xe2, 0x66, 0x29, 0xee, 0x66, 0x29, 0xef, 0x66,
+    0x39, 0xcb, 0xc4, 0xc4, 0x00,
+};
+
+static const GOLDEN_STATE MemoryGolden =
+{
+    0x00000000, 0x18110a02, 0x00000000, 0x00000000,
+    0x00000080, 0x00000100, 0x00000202,
+    0x0000, 0x037f,
+    {
+        0x03, 0x0a, 0x11, 0x18, 0x7c, 0xe6, 0x85, 0x85, 0x3b, 0x42, 0x49, 0x50, 0x37, 0x67, 0xb7, 0x2d,
+        0x73, 0x7a, 0x81, 0x88, 0xef, 0xdd, 0x9f, 0xbd, 0xab, 0xb2, 0xb9, 0xc0, 0xa7, 0xb6, 0xc0, 0x4d,
+        0xe3, 0xea, 0xf1, 0xf8, 0x5f, 0xcb, 0xdf, 0xdc, 0x1b, 0x22, 0x29, 0x30, 0x17, 0xe5, 0xfa, 0x48,
+        0x53, 0x5a, 0x61, 0x68, 0xcf, 0x5b, 0x1b, 0xd9, 0x8b, 0x92, 0x99, 0xa0, 0x87, 0x34, 0x3c, 0x69,
+        0xc3, 0xca, 0xd1, 0xd8, 0x3f, 0x85, 0x5b, 0xf9, 0xfb, 0x02, 0x09, 0x10, 0xf7, 0xfa, 0x7a, 0x64,
+        0x63, 0xf9, 0x41, 0x48, 0x8a, 0x35, 0x90, 0xfd, 0x6b, 0x72, 0x79, 0x80, 0xef, 0x9b, 0xb1, 0x80,
+        0xa3, 0xaa, 0xb1, 0xb8, 0x87, 0x75, 0x13, 0x4f, 0xdb, 0xe2, 0xe9, 0xf0, 0x9f, 0x67, 0x73, 0x1c,
+        0x13, 0x1a, 0x21, 0x28, 0xb7, 0x89, 0xce, 0xce, 0x4b, 0x52, 0x59, 0x60, 0x1f, 0x22, 0x2e, 0x9d,
+        0x03, 0x0a, 0x11, 0x18, 0x7c, 0xe6, 0x85, 0x85, 0x3b, 0x42, 0x49, 0x50, 0x37, 0x67, 0xb7, 0x2d,
+        0x73, 0x7a, 0x81, 0x88, 0xef, 0xdd, 0x9f, 0xbd, 0xab, 0xb2, 0xb9, 0xc0, 0xa7, 0xb6, 0xc0, 0x4d,
+        0xe3, 0xea, 0xf1, 0xf8, 0x5f, 0xcb, 0xdf, 0xdc, 0x1b, 0x22, 0x29, 0x30, 0x17, 0xe5, 0xfa, 0x48,
+        0x53, 0x5a, 0x61, 0x68, 0xcf, 0x5b, 0x1b, 0xd9, 0x8b, 0x92, 0x99, 0xa0, 0x87, 0x34, 0x3c, 0x69,
+        0xc3, 0xca, 0xd1, 0xd8, 0x3f, 0x85, 0x5b, 0xf9, 0xfb, 0x02, 0x09, 0x10, 0xf7, 0xfa, 0x7a, 0x64,
+        0x63, 0xf9, 0x41, 0x48, 0x8a, 0x35, 0x90, 0xfd, 0x6b, 0x72, 0x79, 0x80, 0xef, 0x9b, 0xb1, 0x80,
+        0xa3, 0xaa, 0xb1, 0xb8, 0x87, 0x75, 0x13, 0x4f, 0xdb, 0xe2, 0xe9, 0xf0, 0x9f, 0x67, 0x73, 0x1c,
+        0x13, 0x1a, 0x21, 0x28, 0xb7, 0x89, 0xce, 0xce, 0x4b, 0x52, 0x59, 0x60, 0x1e, 0x22, 0x2e, 0x9d,
+    }
+};
+
+static const UCHAR PagingCode[] =
+{
+    0xdb, 0xe3, 0x66, 0xbd, 0x00, 0x80, 0x00, 0x00, 0x66, 0x31, 0xc9, 0x66, 0x89, 0xc8, 0x66, 0xc1,
+    0xe0, 0x03, 0x66, 0x29, 0xc8, 0x66, 0x83, 0xc0, 0x03, 0x67, 0x88, 0x44, 0x0d, 0x00, 0x66, 0x41,
+    0x66, 0x81, 0xf9, 0x00, 0x01, 0x00, 0x00, 0x72, 0xe2, 0x66, 0x31, 0xc0, 0x66, 0x31, 0xdb, 0x66,
+    0x31, 0xc9, 0x66, 0x31, 0xd2, 0x66, 0x31, 0xf6, 0x66, 0x31, 0xff, 0xfc, 0x66, 0x83, 0xc0, 0x00,
+    0xfa, 0x66, 0x0f, 0x01, 0x16, 0x08, 0x06, 0x66, 0x0f, 0x01, 0x1e, 0x0e, 0x06, 0x0f, 0x20, 0xc0,
+    0x66, 0x83, 0xc8, 0x01, 0x0f, 0x22, 0xc0, 0x66, 0xea, 0x5f, 0x00, 0x00, 0x00, 0x08, 0x00, 0xb9,
+    0x10, 0x00, 0x00, 0x00, 0x8e, 0xd9, 0x8e, 0xc1, 0x8e, 0xd1, 0xbc, 0xf0, 0xff, 0x00, 0x00, 0xbf,
+    0x00, 0x20, 0x01, 0x00, 0x31, 0xc0, 0xb9, 0x1a, 0x00, 0x00, 0x00, 0xf3, 0xab, 0xc7, 0x05, 0x04,
+    0x20, 0x01, 0x00, 0xf0, 0xff, 0x00, 0x00, 0xc7, 0x05, 0x08, 0x20, 0x01, 0x00, 0x10, 0x00, 0x00,
+    0x00, 0xb9, 0x28, 0x00, 0x00, 0x00, 0x0f, 0x00, 0xd9, 0xbf, 0x00, 0x10, 0x01, 0x00, 0xba, 0x07,
+    0x00, 0x00, 0x00, 0xb9, 0x10, 0x01, 0x00, 0x00, 0x89, 0x17, 0x83, 0xc7, 0x04, 0x81, 0xc2, 0x00,
+    0x10, 0x00, 0x00, 0xe2, 0xf3, 0xb9, 0xf0, 0x02, 0x00, 0x00, 0xf3, 0xab, 0xbf, 0x00, 0x00, 0x01,
+    0x00, 0xc7, 0x07, 0x07, 0x10, 0x02, 0x00, 0x83, 0xc7, 0x04, 0xb9, 0xff, 0x03, 0x00, 0x00, 0xf3,
+    0xab, 0xc7, 0x05, 0xc0, 0x10, 0x01, 0x00, 0x07, 0x00, 0x03, 0x00, 0xc7, 0x05, 0xc8, 0x10, 0x01,
+    0x00, 0x07, 0x00, 0x03, 0x00, 0xc7, 0x05, 0xcc, 0x10, 0x01, 0x00, 0x05, 0x30, 0x03, 0x00, 0xc7,
+    0x05, 0xd0, 0x10, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc7, 0x05, 0xd4, 0x10, 0x01, 0x00, 0x03,
+    0x50, 0x03, 0x00, 0xc7, 0x05, 0x00, 0x00, 0x02, 0x00, 0x01, 0x00, 0xaa, 0xaa, 0xc7, 0x05, 0x00,
+    0x10, 0x02, 0x00, 0x02, 0x00, 0xbb, 0xbb, 0xc7, 0x05, 0x00, 0x30, 0x02, 0x00, 0x78, 0x56, 0x34,
+    0x12, 0xb9, 0x00, 0x00, 0x02, 0x00, 0x0f, 0x22, 0xd9, 0x0f, 0x20, 0xc1, 0x81, 0xc9, 0x00, 0x00,
+    0x00, 0x80, 0x0f, 0x22, 0xc1, 0x31, 0xc0, 0x8b, 0x0d, 0x00, 0x00, 0x02, 0x00, 0x81, 0x3d, 0xc0,
+    0x10, 0x01, 0x00, 0x27, 0x00, 0x03, 0x00, 0x74, 0x03, 0x83, 0xc8, 0x01, 0xff, 0x05, 0x00, 0x00,
+    0x02, 0x00, 0x81, 0x3d, 0xc0, 0x10, 0x01, 0x00, 0x67, 0x00, 0x03, 0x00, 0x74, 0x03, 0x83, 0xc8,
+    0x02, 0x83, 0x25, 0xc0, 0x10, 0x01, 0x00, 0xbf, 0x0f, 0x01, 0x3d, 0x00, 0x00, 0x02, 0x00, 0x8b,
+    0x0d, 0x00, 0x00, 0x02, 0x00, 0xff, 0x05, 0x00, 0x00, 0x02, 0x00, 0x81, 0x3d, 0xc0, 0x10, 0x01,
+    0x00, 0x67, 0x00, 0x03, 0x00, 0x74, 0x03, 0x83, 0xc8, 0x04, 0x81, 0x3d, 0x00, 0x00, 0x02, 0x00,
+    0x03, 0x00, 0xaa, 0xaa, 0x74, 0x03, 0x83, 0xc8, 0x08, 0x81, 0x3d, 0x00, 0x20, 0x02, 0x00, 0x03,
+    0x00, 0xaa, 0xaa, 0x74, 0x03, 0x83, 0xc8, 0x10, 0xc7, 0x05, 0xc8, 0x10, 0x01, 0x00, 0x07, 0x10,
+    0x03, 0x00, 0x0f, 0x01, 0x3d, 0x00, 0x20, 0x02, 0x00, 0x81, 0x3d, 0x00, 0x20, 0x02, 0x00, 0x02,
+    0x00, 0xbb, 0xbb, 0x74, 0x03, 0x83, 0xc8, 0x20, 0xc7, 0x05, 0xc8, 0x10, 0x01, 0x00, 0x07, 0x00,
+    0x03, 0x00, 0x0f, 0x20, 0xd9, 0x0f, 0x22, 0xd9, 0xc7, 0x05, 0x00, 0x20, 0x02, 0x00, 0x04, 0x00,
+    0xaa, 0xaa, 0x81, 0x3d, 0x00, 0x00, 0x02, 0x00, 0x04, 0x00, 0xaa, 0xaa, 0x74, 0x03, 0x83, 0xc8,
+    0x40, 0x81, 0x3d, 0x00, 0x10, 0x02, 0x00, 0x02, 0x00, 0xbb, 0xbb, 0x74, 0x05, 0x0d, 0x80, 0x00,
+    0x00, 0x00, 0xc7, 0x05, 0x40, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc7, 0x05, 0x4c, 0x04,
+    0x00, 0x00, 0x1c, 0x02, 0x00, 0x00, 0x8b, 0x0d, 0x23, 0x41, 0x02, 0x00, 0x83, 0x3d, 0x40, 0x04,
+    0x00, 0x00, 0x01, 0x75, 0x15, 0x81, 0x3d, 0x44, 0x04, 0x00, 0x00, 0x23, 0x41, 0x03, 0x00, 0x75,
+    0x09, 0x83, 0x3d, 0x48, 0x04, 0x00, 0x00, 0x00, 0x74, 0x05, 0x0d, 0x00, 0x01, 0x00, 0x00, 0xc7,
+    0x05, 0x40, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc7, 0x05, 0x4c, 0x04, 0x00, 0x00, 0x5d,
+    0x02, 0x00, 0x00, 0xc7, 0x05, 0xfc, 0x4f, 0x02, 0x00, 0x5a, 0x5a, 0x5a, 0x5a, 0x83, 0x3d, 0x40,
+    0x04, 0x00, 0x00, 0x01, 0x75, 0x15, 0x81, 0x3d, 0x44, 0x04, 0x00, 0x00, 0xfc, 0x4f, 0x03, 0x00,
+    0x75, 0x09, 0x83, 0x3d, 0x48, 0x04, 0x00, 0x00, 0x02, 0x74, 0x05, 0x0d, 0x00, 0x02, 0x00, 0x00,
+    0xc7, 0x05, 0x00, 0x30, 0x02, 0x00, 0x21, 0x43, 0x65, 0x87, 0x81, 0x3d, 0xcc, 0x10, 0x01, 0x00,
+    0x65, 0x30, 0x03, 0x00, 0x74, 0x05, 0x0d, 0x00, 0x04, 0x00, 0x00, 0x0f, 0x20, 0xc1, 0x81, 0xc9,
+    0x00, 0x00, 0x01, 0x00, 0x0f, 0x22, 0xc1, 0xc7, 0x05, 0x40, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xc7, 0x05, 0x4c, 0x04, 0x00, 0x00, 0xc5, 0x02, 0x00, 0x00, 0xc7, 0x05, 0x10, 0x30, 0x02,
+    0x00, 0x5a, 0x5a, 0x5a, 0x5a, 0x83, 0x3d, 0x40, 0x04, 0x00, 0x00, 0x01, 0x75, 0x15, 0x81, 0x3d,
+    0x44, 0x04, 0x00, 0x00, 0x10, 0x30, 0x03, 0x00, 0x75, 0x09, 0x83, 0x3d, 0x48, 0x04, 0x00, 0x00,
+    0x03, 0x74, 0x05, 0x0d, 0x00, 0x08, 0x00, 0x00, 0x0f, 0x20, 0xc1, 0x81, 0xe1, 0xff, 0xff, 0xfe,
+    0xff, 0x0f, 0x22, 0xc1, 0x6a, 0x23, 0x68, 0x00, 0xf0, 0x00, 0x00, 0x9c, 0x6a, 0x1b, 0x68, 0x04,
+    0x03, 0x00, 0x00, 0xcf, 0xb9, 0x23, 0x00, 0x00, 0x00, 0x8e, 0xd9, 0x8e, 0xc1, 0x81, 0x3d, 0x00,
+    0x30, 0x02, 0x00, 0x21, 0x43, 0x65, 0x87, 0x74, 0x05, 0x0d, 0x00, 0x10, 0x00, 0x00, 0xc7, 0x05,
+    0x40, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc7, 0x05, 0x4c, 0x04, 0x00, 0x00, 0x3c, 0x03,
+    0x00, 0x00, 0xc7, 0x05, 0x20, 0x30, 0x02, 0x00, 0x5a, 0x5a, 0x5a, 0x5a, 0x83, 0x3d, 0x40, 0x04,
+    0x00, 0x00, 0x01, 0x75, 0x15, 0x81, 0x3d, 0x44, 0x04, 0x00, 0x00, 0x20, 0x30, 0x03, 0x00, 0x75,
+    0x09, 0x83, 0x3d, 0x48, 0x04, 0x00, 0x00, 0x07, 0x74, 0x05, 0x0d, 0x00, 0x20, 0x00, 0x00, 0x81,
+    0x3d, 0x00, 0x30, 0x02, 0x00, 0x21, 0x43, 0x65, 0x87, 0x74, 0x05, 0x0d, 0x00, 0x40, 0x00, 0x00,
+    0xc7, 0x05, 0x40, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc7, 0x05, 0x4c, 0x04, 0x00, 0x00,
+    0x8a, 0x03, 0x00, 0x00, 0x8b, 0x0d, 0x00, 0x50, 0x02, 0x00, 0x83, 0x3d, 0x40, 0x04, 0x00, 0x00,
+    0x01, 0x75, 0x15, 0x81, 0x3d, 0x44, 0x04, 0x00, 0x00, 0x00, 0x50, 0x03, 0x00, 0x75, 0x09, 0x83,
+    0x3d, 0x48, 0x04, 0x00, 0x00, 0x05, 0x74, 0x05, 0x0d, 0x00, 0x80, 0x00, 0x00, 0xc7, 0x05, 0x40,
+    0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc7, 0x05, 0x4c, 0x04, 0x00, 0x00, 0xcb, 0x03, 0x00,
+    0x00, 0xc7, 0x05, 0x04, 0x40, 0x02, 0x00, 0x5a, 0x5a, 0x5a, 0x5a, 0x83, 0x3d, 0x40, 0x04, 0x00,
+    0x00, 0x01, 0x75, 0x15, 0x81, 0x3d, 0x44, 0x04, 0x00, 0x00, 0x04, 0x40, 0x03, 0x00, 0x75, 0x09,
+    0x83, 0x3d, 0x48, 0x04, 0x00, 0x00, 0x06, 0x74, 0x05, 0x0d, 0x00, 0x00, 0x01, 0x00, 0xcd, 0x30,
+    0x83, 0xc4, 0x14, 0xb9, 0x10, 0x00, 0x00, 0x00, 0x8e, 0xd9, 0x8e, 0xc1, 0x81, 0xfc, 0xf0, 0xff,
+    0x00, 0x00, 0x74, 0x05, 0x0d, 0x00, 0x00, 0x02, 0x00, 0x31, 0xdb, 0x31, 0xc9, 0x31, 0xd2, 0x31,
+    0xf6, 0x31, 0xff, 0x83, 0xc0, 0x00, 0xe9, 0xf9, 0x01, 0x00, 0x00, 0x8f, 0x05, 0x48, 0x04, 0x00,
+    0x00, 0xff, 0x05, 0x40, 0x04, 0x00, 0x00, 0x51, 0x0f, 0x20, 0xd1, 0x89, 0x0d, 0x44, 0x04, 0x00,
+    0x00, 0x8b, 0x0d, 0x4c, 0x04, 0x00, 0x00, 0x89, 0x4c, 0x24, 0x04, 0x59, 0xcf, 0x8d, 0x76, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0x01, 0x9a, 0xcf, 0x00,
+    0xff, 0xff, 0x00, 0x00, 0x01, 0x92, 0xcf, 0x00, 0xff, 0xff, 0x00, 0x00, 0x01, 0xfa, 0xcf, 0x00,
+    0xff, 0xff, 0x00, 0x00, 0x01, 0xf2, 0xcf, 0x00, 0x67, 0x00, 0x00, 0x20, 0x02, 0x89, 0x00, 0x00,
+    0x00, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00, 0x04, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0x08, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00, 0x0c, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0x10, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00, 0x14, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0x18, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00, 0x1c, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0x20, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00, 0x24, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0x28, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00, 0x2c, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0x30, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00, 0x34, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0x1b, 0x04, 0x08, 0x00, 0x00, 0x8e, 0x00, 0x00, 0x3c, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0x40, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00, 0x44, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0x48, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00, 0x4c, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0x50, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00, 0x54, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0x58, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00, 0x5c, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0x60, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00, 0x64, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0x68, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00, 0x6c, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0x70, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00, 0x74, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0x78, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00, 0x7c, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0x80, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00, 0x84, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0x88, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00, 0x8c, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0x90, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00, 0x94, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0x98, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00, 0x9c, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0xa0, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00, 0xa4, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0xa8, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00, 0xac, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0xb0, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00, 0xb4, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0xb8, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00, 0xbc, 0x00, 0x08, 0x00, 0x00, 0x8e, 0x0e, 0x00,
+    0xf0, 0x03, 0x08, 0x00, 0x00, 0xee, 0x00, 0x00, 0x2f, 0x00, 0x50, 0x04, 0x01, 0x00, 0x87, 0x01,
+    0x80, 0x04, 0x01, 0x00, 0xc4, 0xc4, 0x00,
+};
+
+static const GOLDEN_STATE PagingGolden =
+{
+    0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000246,
+    0x0000, 0x037f,
+    {
+        0x03, 0x0a, 0x11, 0x18, 0x1f, 0x26, 0x2d, 0x34, 0x3b, 0x42, 0x49, 0x50, 0x57, 0x5e, 0x65, 0x6c,
+        0x73, 0x7a, 0x81, 0x88, 0x8f, 0x96, 0x9d, 0xa4, 0xab, 0xb2, 0xb9, 0xc0, 0xc7, 0xce, 0xd5, 0xdc,
+        0xe3, 0xea, 0xf1, 0xf8, 0xff, 0x06, 0x0d, 0x14, 0x1b, 0x22, 0x29, 0x30, 0x37, 0x3e, 0x45, 0x4c,
+        0x53, 0x5a, 0x61, 0x68, 0x6f, 0x76, 0x7d, 0x84, 0x8b, 0x92, 0x99, 0xa0, 0xa7, 0xae, 0xb5, 0xbc,
+        0xc3, 0xca, 0xd1, 0xd8, 0xdf, 0xe6, 0xed, 0xf4, 0xfb, 0x02, 0x09, 0x10, 0x17, 0x1e, 0x25, 0x2c,
+        0x33, 0x3a, 0x41, 0x48, 0x4f, 0x56, 0x5d, 0x64, 0x6b, 0x72, 0x79, 0x80, 0x87, 0x8e, 0x95, 0x9c,
+        0xa3, 0xaa, 0xb1, 0xb8, 0xbf, 0xc6, 0xcd, 0xd4, 0xdb, 0xe2, 0xe9, 0xf0, 0xf7, 0xfe, 0x05, 0x0c,
+        0x13, 0x1a, 0x21, 0x28, 0x2f, 0x36, 0x3d, 0x44, 0x4b, 0x52, 0x59, 0x60, 0x67, 0x6e, 0x75, 0x7c,
+        0x83, 0x8a, 0x91, 0x98, 0x9f, 0xa6, 0xad, 0xb4, 0xbb, 0xc2, 0xc9, 0xd0, 0xd7, 0xde, 0xe5, 0xec,
+        0xf3, 0xfa, 0x01, 0x08, 0x0f, 0x16, 0x1d, 0x24, 0x2b, 0x32, 0x39, 0x40, 0x47, 0x4e, 0x55, 0x5c,
+        0x63, 0x6a, 0x71, 0x78, 0x7f, 0x86, 0x8d, 0x94, 0x9b, 0xa2, 0xa9, 0xb0, 0xb7, 0xbe, 0xc5, 0xcc,
+        0xd3, 0xda, 0xe1, 0xe8, 0xef, 0xf6, 0xfd, 0x04, 0x0b, 0x12, 0x19, 0x20, 0x27, 0x2e, 0x35, 0x3c,
+        0x43, 0x4a, 0x51, 0x58, 0x5f, 0x66, 0x6d, 0x74, 0x7b, 0x82, 0x89, 0x90, 0x97, 0x9e, 0xa5, 0xac,
+        0xb3, 0xba, 0xc1, 0xc8, 0xcf, 0xd6, 0xdd, 0xe4, 0xeb, 0xf2, 0xf9, 0x00, 0x07, 0x0e, 0x15, 0x1c,
+        0x23, 0x2a, 0x31, 0x38, 0x3f, 0x46, 0x4d, 0x54, 0x5b, 0x62, 0x69, 0x70, 0x77, 0x7e, 0x85, 0x8c,
+        0x93, 0x9a, 0xa1, 0xa8, 0xaf, 0xb6, 0xbd, 0xc4, 0xcb, 0xd2, 0xd9, 0xe0, 0xe7, 0xee, 0xf5, 0xfc,
+    }
+};
+
+static const TEST_PROGRAM TestPrograms[] =
+{
+    { "alu", AluCode, sizeof(AluCode), &AluGolden },
+    { "move", MoveCode, sizeof(MoveCode), &MoveGolden },
+    { "jump", JumpCode, sizeof(JumpCode), &JumpGolden },
+    { "groups", GroupsCode, sizeof(GroupsCode), &GroupsGolden },
+    { "extraops", ExtraopsCode, sizeof(ExtraopsCode), &ExtraopsGolden },
+    { "fpu", FpuCode, sizeof(FpuCode), &FpuGolden },
+    { "loop", LoopCode, sizeof(LoopCode), &LoopGolden },
+    { "memory", MemoryCode, sizeof(MemoryCode), &MemoryGolden },
+    { "paging", PagingCode, sizeof(PagingCode), &PagingGolden },
+};
@@ -0,0 +1,66 @@
+#!/bin/sh
+#
+# PROJECT:         ReactOS host tools
+# LICENSE:         GPL - See COPYING in the top level directory
+# PURPOSE:         Regenerates ../tests.h from the test programs
+# PROGRAMMERS:     ReactOS Team
+#
+# Needs GNU binutils and an x86 Linux host able to run 32-bit programs,
+# since the golden states are taken from the host processor.
+#
+
+TESTS="alu move jump groups extraops fpu loop memory paging"
+
+cd "$(dirname "$0")" || exit 1
+TMP=$(mktemp -d) || exit 1
+trap 'rm -rf "$TMP"' EXIT
+
+hexbytes()
+{
+    od -An -v -tx1 "$@" | sed -e 's/ \([0-9a-f][0-9a-f]\)/ 0x\1,/g' -e 's/^ /    /'
+}
+
+hexwords()
+{
+    od -An -v "$@" | sed -e 's/ \([0-9a-f][0-9a-f]*\)/ 0x\1,/g' -e 's/^ /    /'
+}
+
+{
+    echo "/* Generated by tests/mktests.sh from the test programs, do not edit */"
+
+    for TEST in $TESTS
+    do
+        NAME=$(echo "$TEST" | sed 's/^./\U&/')
+
+        as --32 --defsym EMULATED=1 -o "$TMP/$TEST.o" "$TEST.S" 2> /dev/null &&
+        ld -m elf_i386 -Ttext 0 --oformat binary -e 0 -o "$TMP/$TEST.bin" "$TMP/$TEST.o" &&
+        as --32 -o "$TMP/${TEST}_native.o" "$TEST.S" &&
+        ld -m elf_i386 -o "$TMP/${TEST}_native" "$TMP/${TEST}_native.o" &&
+        "$TMP/${TEST}_native" > "$TMP/$TEST.state" || exit 1
+
+        echo
+        echo "static const UCHAR ${NAME}Code[] ="
+        echo "{"
+        hexbytes "$TMP/$TEST.bin"
+        echo "};"
+        echo
+        echo "static const GOLDEN_STATE ${NAME}Golden ="
+        echo "{"
+        hexwords -tx4 -N28 "$TMP/$TEST.state"
+        hexwords -tx2 -j28 -N4 "$TMP/$TEST.state"
+        echo "    {"
+        hexbytes -j32 "$TMP/$TEST.state" | sed 's/^/    /'
+        echo "    }"
+        echo "};"
+    done
+
+    echo
+    echo "static const TEST_PROGRAM TestPrograms[] ="
+    echo "{"
+    for TEST in $TESTS
+    do
+        NAME=$(echo "$TEST" | sed 's/^./\U&/')
+        echo "    { \"$TEST\", ${NAME}Code, sizeof(${NAME}Code), &${NAME}Golden },"
+    done
+    echo "};"
+} > ../tests.h.tmp && mv ../tests.h.tmp ../tests.h
@@ -0,0 +1,40 @@
+/*
+ * PROJECT:         ReactOS host tools
+ * LICENSE:         GPL - See COPYING in the top level directory
+ * PURPOSE:         Stand-in for windef.h, enough to build lib/fast486 on the host
+ * PROGRAMMERS:     ReactOS Team
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+#include <typedefs.h>
+
+/* The emulator doesn't depend on the calling convention */
+#define FASTCALL
+
+#ifndef FORCEINLINE
+#define FORCEINLINE static inline
+#endif
+
+#define UNREFERENCED_PARAMETER(P) ((void)(P))
+#define C_ASSERT(e) typedef char __C_ASSERT__[(e) ? 1 : -1]
+
+#define RtlFillMemory(Destination, Length, Fill) memset(Destination, Fill, Length)
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+#define MINCHAR     0x80
+#define MAXCHAR     0x7F
+#define MINSHORT    0x8000
+#define MAXSHORT    0x7FFF
+#define MINLONG     0x80000000
+#define MAXLONG     0x7FFFFFFF
+
+#define DbgPrint    printf
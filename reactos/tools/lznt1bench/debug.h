@@ -0,0 +1,8 @@
+/*
+ * PROJECT:         ReactOS host tools
+ * LICENSE:         GPL - See COPYING in the top level directory
+ * PURPOSE:         Stand-in for debug.h, the host typedefs already provide DPRINT
+ * PROGRAMMERS:     ReactOS Team
+ */
+
+#pragma once
@@ -0,0 +1,249 @@
+/*
+ * PROJECT:         ReactOS host tools
+ * LICENSE:         GPL - See COPYING in the top level directory
+ * PURPOSE:         Benchmark and round trip test for the RTL LZNT1 engine
+ * PROGRAMMERS:     ReactOS Team
+ *
+ * Every input is compressed with both the standard and the maximum engine,
+ * then decompressed as a whole and in fragments. The results are checked
+ * against the input and the compression ratio and throughput are printed.
+ * Without files, a small built-in corpus is used. The process exit code is
+ * the number of inputs that didn't survive the round trip.
+ *
+ * Usage: lznt1bench [-t ms] [file ...]
+ */
+
+#include <rtl.h>
+#include <time.h>
+
+typedef struct
+{
+    const char *pszName;
+    PUCHAR pjData;
+    ULONG cjData;
+} INPUT;
+
+static ULONG gulMinTimeMs = 500;
+
+static
+double
+ElapsedMs(clock_t Start)
+{
+    return (double)(clock() - Start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+static
+double
+MBytesPerSecond(ULONG cjData, ULONG cIterations, double dMs)
+{
+    return dMs > 0 ? (double)cjData * cIterations / (dMs * 1000.0) : 0;
+}
+
+static
+BOOL
+ReadInput(const char *pszFile, INPUT *pInput)
+{
+    FILE *fp;
+    long lSize;
+
+    fp = fopen(pszFile, "rb");
+    if (!fp)
+        return FALSE;
+
+    fseek(fp, 0, SEEK_END);
+    lSize = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    pInput->pszName = pszFile;
+    pInput->cjData = (ULONG)lSize;
+    pInput->pjData = malloc(lSize ? lSize : 1);
+    if (!pInput->pjData || fread(pInput->pjData, 1, lSize, fp) != (size_t)lSize)
+    {
+        fclose(fp);
+        return FALSE;
+    }
+
+    fclose(fp);
+    return TRUE;
+}
+
+/* Text-like data, random bytes and zeros with a few islands */
+static
+ULONG
+CreateCorpus(INPUT *pInputs)
+{
+    static const char *apszWords[] =
+    {
+        "the ", "chunk ", "Rtl", "Compress", "Buffer", "(", ");\n", "    ",
+        "STATUS_SUCCESS", "return ", "if ", "NULL", "ULONG ", "=", "==", "\n"
+    };
+    const ULONG cjData = 1024 * 1024 + 123;
+    ULONG i, j, ulSeed = 12345;
+
+    for (i = 0; i < 3; i++)
+    {
+        pInputs[i].cjData = cjData;
+        pInputs[i].pjData = malloc(cjData);
+    }
+
+    pInputs[0].pszName = "<text>";
+    for (i = 0; i < cjData; )
+    {
+        const char *pszWord;
+        ulSeed = ulSeed * 1103515245 + 12345;
+        pszWord = apszWords[(ulSeed >> 16) % 16];
+        for (j = 0; pszWord[j] && i < cjData; j++)
+            pInputs[0].pjData[i++] = pszWord[j];
+    }
+
+    pInputs[1].pszName = "<random>";
+    for (i = 0; i < cjData; i++)
+    {
+        ulSeed = ulSeed * 1103515245 + 12345;
+        pInputs[1].pjData[i] = (UCHAR)(ulSeed >> 16);
+    }
+
+    pInputs[2].pszName = "<sparse>";
+    memset(pInputs[2].pjData, 0, cjData);
+    for (i = 0; i < cjData; i += 9973)
+        memcpy(pInputs[2].pjData + i, pInputs[1].pjData + i, min(100, cjData - i));
+
+    return 3;
+}
+
+/* Runs one input through one engine, returns FALSE if anything went wrong */
+static
+BOOL
+RunInput(const INPUT *pInput, USHORT usEngine)
+{
+    USHORT usFormat = COMPRESSION_FORMAT_LZNT1 | usEngine;
+    ULONG cjWorkSpace, cjFragmentWorkSpace, cjCompressed, cjFinal, cjMax;
+    ULONG cCompress = 0, cDecompress = 0, ulOffset, cjFragment;
+    PUCHAR pjCompressed, pjOutput, pjWorkSpace, pjFragmentWorkSpace;
+    double dCompressMs, dDecompressMs;
+    NTSTATUS Status;
+    clock_t Start;
+    BOOL bResult = TRUE;
+
+    RtlGetCompressionWorkSpaceSize(usFormat, &cjWorkSpace, &cjFragmentWorkSpace);
+    pjWorkSpace = malloc(cjWorkSpace);
+    pjFragmentWorkSpace = malloc(cjFragmentWorkSpace);
+
+    /* Incompressible data grows by one chunk header per 4KB */
+    cjMax = pInput->cjData + (pInput->cjData / 0x1000 + 2) * sizeof(USHORT);
+    pjCompressed = malloc(cjMax);
+    pjOutput = malloc(pInput->cjData + 1);
+
+    Start = clock();
+    do
+    {
+        Status = RtlCompressBuffer(usFormat, pInput->pjData, pInput->cjData,
+                                   pjCompressed, cjMax, 0x1000, &cjCompressed,
+                                   pjWorkSpace);
+        cCompress++;
+    } while (NT_SUCCESS(Status) && ElapsedMs(Start) < gulMinTimeMs);
+    dCompressMs = ElapsedMs(Start);
+
+    if (!NT_SUCCESS(Status))
+    {
+        printf("%s: RtlCompressBuffer failed with 0x%lx\n", pInput->pszName, (unsigned long)Status);
+        bResult = FALSE;
+        goto Cleanup;
+    }
+
+    Start = clock();
+    do
+    {
+        Status = RtlDecompressBuffer(usFormat, pjOutput, pInput->cjData,
+                                     pjCompressed, cjCompressed, &cjFinal);
+        cDecompress++;
+    } while (NT_SUCCESS(Status) && ElapsedMs(Start) < gulMinTimeMs);
+    dDecompressMs = ElapsedMs(Start);
+
+    if (!NT_SUCCESS(Status) || cjFinal != pInput->cjData ||
+        memcmp(pjOutput, pInput->pjData, cjFinal) != 0)
+    {
+        printf("%s: round trip failed (0x%lx, %lu of %lu bytes)\n", pInput->pszName,
+               (unsigned long)Status, (unsigned long)cjFinal, (unsigned long)pInput->cjData);
+        bResult = FALSE;
+    }
+
+    /* Fragments starting on and off chunk boundaries */
+    for (ulOffset = 0; bResult && ulOffset < pInput->cjData; ulOffset += 0x1000 * 37 + 1111)
+    {
+        cjFragment = min(pInput->cjData - ulOffset, 10000);
+        Status = RtlDecompressFragment(usFormat, pjOutput, cjFragment, pjCompressed,
+                                       cjCompressed, ulOffset, &cjFinal,
+                                       pjFragmentWorkSpace);
+        if (!NT_SUCCESS(Status) || cjFinal != cjFragment ||
+            memcmp(pjOutput, pInput->pjData + ulOffset, cjFinal) != 0)
+        {
+            printf("%s: fragment at %lu failed (0x%lx)\n", pInput->pszName,
+                   (unsigned long)ulOffset, (unsigned long)Status);
+            bResult = FALSE;
+        }
+    }
+
+    printf("%-24.24s %-8s %10lu %10lu %6.1f%% %12.1f %12.1f\n",
+           pInput->pszName,
+           usEngine == COMPRESSION_ENGINE_MAXIMUM ? "maximum" : "standard",
+           (unsigned long)pInput->cjData,
+           (unsigned long)cjCompressed,
+           pInput->cjData ? 100.0 * cjCompressed / pInput->cjData : 0,
+           MBytesPerSecond(pInput->cjData, cCompress, dCompressMs),
+           MBytesPerSecond(pInput->cjData, cDecompress, dDecompressMs));
+
+Cleanup:
+    free(pjOutput);
+    free(pjCompressed);
+    free(pjFragmentWorkSpace);
+    free(pjWorkSpace);
+    return bResult;
+}
+
+int
+main(int argc, char *argv[])
+{
+    INPUT *pInputs;
+    ULONG cInputs = 0, cFailures = 0, i;
+    int iArg;
+
+    pInputs = malloc(sizeof(INPUT) * (argc + 3));
+
+    for (iArg = 1; iArg < argc; iArg++)
+    {
+        if (!strcmp(argv[iArg], "-t") && iArg + 1 < argc)
+        {
+            gulMinTimeMs = atoi(argv[++iArg]);
+        }
+        else if (ReadInput(argv[iArg], &pInputs[cInputs]))
+        {
+            cInputs++;
+        }
+        else
+        {
+            printf("Usage: lznt1bench [-t ms] [file ...]\n");
+            printf("Cannot read %s\n", argv[iArg]);
+            return -1;
+        }
+    }
+
+    if (cInputs == 0)
+        cInputs = CreateCorpus(pInputs);
+
+    printf("%-24s %-8s %10s %10s %7s %12s %12s\n",
+           "INPUT", "ENGINE", "SIZE", "PACKED", "RATIO", "comp MB/s", "decomp MB/s");
+
+    for (i = 0; i < cInputs; i++)
+    {
+        if (!RunInput(&pInputs[i], COMPRESSION_ENGINE_STANDARD))
+            cFailures++;
+        if (!RunInput(&pInputs[i], COMPRESSION_ENGINE_MAXIMUM))
+            cFailures++;
+    }
+
+    printf("%lu of %lu runs failed the round trip\n",
+           (unsigned long)cFailures, (unsigned long)cInputs * 2);
+
+    return (int)cFailures;
+}
@@ -0,0 +1,71 @@
+/*
+ * PROJECT:         ReactOS host tools
+ * LICENSE:         GPL - See COPYING in the top level directory
+ * PURPOSE:         Stand-in for rtl.h, enough to build lib/rtl/compress.c on the host
+ * PROGRAMMERS:     ReactOS Team
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+#include <typedefs.h>
+
+#define UNREFERENCED_PARAMETER(P) ((void)(P))
+#define C_ASSERT(e) typedef char __C_ASSERT__[(e) ? 1 : -1]
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
+#ifndef FORCEINLINE
+#define FORCEINLINE static inline
+#endif
+
+#define STATUS_SUCCESS                  ((NTSTATUS)0x00000000)
+#define STATUS_NO_MORE_ENTRIES          ((NTSTATUS)0x8000001A)
+#define STATUS_NOT_IMPLEMENTED          ((NTSTATUS)0xC0000002)
+#define STATUS_INVALID_PARAMETER        ((NTSTATUS)0xC000000D)
+#define STATUS_BUFFER_TOO_SMALL         ((NTSTATUS)0xC0000023)
+#define STATUS_NOT_SUPPORTED            ((NTSTATUS)0xC00000BB)
+#define STATUS_BAD_COMPRESSION_BUFFER   ((NTSTATUS)0xC0000242)
+#define STATUS_UNSUPPORTED_COMPRESSION  ((NTSTATUS)0xC000025F)
+
+#define COMPRESSION_FORMAT_NONE         0x0000
+#define COMPRESSION_FORMAT_DEFAULT      0x0001
+#define COMPRESSION_FORMAT_LZNT1        0x0002
+#define COMPRESSION_ENGINE_STANDARD     0x0000
+#define COMPRESSION_ENGINE_MAXIMUM      0x0100
+
+#define RtlCompareMemory(Source1, Source2, Length) \
+    (memcmp(Source1, Source2, Length) ? 0 : (Length))
+
+typedef struct _COMPRESSED_DATA_INFO
+{
+    USHORT CompressionFormatAndEngine;
+    UCHAR CompressionUnitShift;
+    UCHAR ChunkShift;
+    UCHAR ClusterShift;
+    UCHAR Reserved;
+    USHORT NumberOfChunks;
+    ULONG CompressedChunkSizes[ANYSIZE_ARRAY];
+} COMPRESSED_DATA_INFO, *PCOMPRESSED_DATA_INFO;
+
+NTSTATUS NTAPI
+RtlCompressBuffer(USHORT CompressionFormatAndEngine, PUCHAR UncompressedBuffer,
+                  ULONG UncompressedBufferSize, PUCHAR CompressedBuffer,
+                  ULONG CompressedBufferSize, ULONG UncompressedChunkSize,
+                  PULONG FinalCompressedSize, PVOID WorkSpace);
+NTSTATUS NTAPI
+RtlDecompressBuffer(USHORT CompressionFormat, PUCHAR UncompressedBuffer,
+                    ULONG UncompressedBufferSize, PUCHAR CompressedBuffer,
+                    ULONG CompressedBufferSize, PULONG FinalUncompressedSize);
+NTSTATUS NTAPI
+RtlDecompressFragment(USHORT CompressionFormat, PUCHAR UncompressedFragment,
+                      ULONG UncompressedFragmentSize, PUCHAR CompressedBuffer,
+                      ULONG CompressedBufferSize, ULONG FragmentOffset,
+                      PULONG FinalUncompressedSize, PVOID WorkSpace);
+NTSTATUS NTAPI
+RtlGetCompressionWorkSpaceSize(USHORT CompressionFormatAndEngine,
+                               PULONG CompressBufferAndWorkSpaceSize,
+                               PULONG CompressFragmentWorkSpaceSize);
@@ -0,0 +1,49 @@
+/*
+ * PROJECT:         ReactOS host tools
+ * LICENSE:         GPL - See COPYING in the top level directory
+ * PURPOSE:         Stand-in for the lwIP port header, enough to build the lwIP core on the host
+ * PROGRAMMERS:     ReactOS Team
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+
+/* Unsigned int types */
+typedef unsigned char u8_t;
+typedef unsigned short u16_t;
+typedef unsigned int u32_t;
+
+/* Signed int types */
+typedef signed char s8_t;
+typedef signed short s16_t;
+typedef signed int s32_t;
+
+/* Memory pointer */
+typedef size_t mem_ptr_t;
+
+/* Printf formatters */
+#define U16_F "hu"
+#define S16_F "hd"
+#define X16_F "hx"
+#define U32_F "u"
+#define S32_F "d"
+#define X32_F "x"
+#define SZT_F "lu"
+
+/* Endianness, the host is little endian like every architecture ReactOS
+   supports. The C library may have defined it already */
+#ifndef BYTE_ORDER
+#define BYTE_ORDER LITTLE_ENDIAN
+#endif
+
+/* Diagnostics */
+#define LWIP_PLATFORM_DIAG(x) (printf x)
+#define LWIP_PLATFORM_ASSERT(x) \
+    do { fprintf(stderr, "lwIP assertion \"%s\" failed at %s:%d\n", x, __FILE__, __LINE__); abort(); } while (0)
+
+/* Compiler hints for packing structures */
+#define PACK_STRUCT_STRUCT
+#define PACK_STRUCT_USE_INCLUDES
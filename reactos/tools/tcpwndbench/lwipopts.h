@@ -0,0 +1,16 @@
+/*
+ * PROJECT:         ReactOS host tools
+ * LICENSE:         GPL - See COPYING in the top level directory
+ * PURPOSE:         The lwIP options of tcpip, without the operating system services
+ * PROGRAMMERS:     ReactOS Team
+ */
+
+/* The benchmark runs the stack from a single thread and calls the TCP
+   timer itself, on its own clock */
+#define NO_SYS                          1
+#define NO_SYS_NO_TIMERS                1
+
+#include "../../lib/drivers/lwip/src/include/lwipopts.h"
+
+#undef LWIP_NETIF_API
+#define LWIP_NETIF_API                  0
@@ -0,0 +1,361 @@
+/*
+ * PROJECT:         ReactOS host tools
+ * LICENSE:         GPL - See COPYING in the top level directory
+ * PURPOSE:         Bulk TCP throughput of the lwIP stack over a delayed link, for each receive window
+ * PROGRAMMERS:     ReactOS Team
+ *
+ * The lwIP core of tcpip is built with its lwipopts.h and connected to
+ * itself through two interfaces, 10.0.0.1 and 10.0.0.2. Every packet an
+ * interface sends goes through a link with a fixed rate and a fixed delay
+ * in each direction, on a simulated clock, so the results don't depend on
+ * the speed of the host.
+ *
+ * One connection sends as much data as it can to the other for each
+ * receive window, from 16 KB up to TCP_WND. A receive window smaller than
+ * TCP_WND is made by taking the difference off the window of the accepted
+ * connection, the way a smaller SO_RCVBUF would. Each line shows the
+ * throughput and what the window allows, which is the window per round
+ * trip or the link rate, whichever is lower.
+ *
+ * lwIP leaves slow start at 10 segments on the connecting side and then
+ * grows the congestion window by about half a segment per round trip, so
+ * the throughput is measured after 400 round trips of warm-up, when the
+ * congestion window no longer limits it.
+ *
+ * The windows above 64 KB need the window scale option, so it is checked
+ * that both ends agreed to TCP_RCV_SCALE, and that every window gets at
+ * least 80% of what it allows.
+ * The process exit code is the number of failed checks, capped at 255.
+ *
+ * Usage: tcpwndbench [-d delay ms] [-r rate Mbit/s] [-t seconds]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <typedefs.h>
+
+#include "lwip/init.h"
+#include "lwip/ip.h"
+#include "lwip/netif.h"
+#include "lwip/tcp_impl.h"
+
+#define BENCH_PORT          5001
+#define BENCH_CHUNK         0x8000
+#define WARMUP_RTTS         400
+
+typedef struct _PACKET
+{
+    struct _PACKET *Next;
+    ULONGLONG DueUs;
+    u16_t Length;
+    u8_t Data[1];
+} PACKET, *PPACKET;
+
+/* The link towards one interface */
+typedef struct _LINK
+{
+    struct netif Netif;
+    PPACKET Head;
+    PPACKET Tail;
+    ULONGLONG BusyUntilUs;
+} LINK, *PLINK;
+
+static ULONG gulDelayMs = 25;
+static ULONG gulRateMbps = 100;
+static ULONG gulSeconds = 5;
+static ULONG gcFailures = 0;
+
+static ULONGLONG gullNowUs;
+static LINK gLinks[2];
+static ip_addr_t gAddresses[2];
+
+static struct tcp_pcb *gpServer;
+static ULONG gulWindow;
+static ULONGLONG gullReceived;
+
+static u8_t gajData[BENCH_CHUNK];
+
+u32_t
+sys_now(void)
+{
+    return (u32_t)(gullNowUs / 1000);
+}
+
+static
+VOID
+Fail(const char *pszMessage, ULONG ulWindow)
+{
+    printf("FAILED: %s with a %lu KB window\n", pszMessage, (unsigned long)ulWindow / 1024);
+    gcFailures++;
+}
+
+/* Serializes the packet after the ones already on the link and delivers
+   it after the delay */
+static
+err_t
+LinkOutput(struct netif *netif, struct pbuf *p, ip_addr_t *ipaddr)
+{
+    PLINK Link = netif->state;
+    PPACKET Packet;
+    ULONGLONG ullStartUs;
+
+    Packet = malloc(sizeof(PACKET) + p->tot_len);
+    if (!Packet)
+        return ERR_MEM;
+
+    Packet->Next = NULL;
+    Packet->Length = pbuf_copy_partial(p, Packet->Data, p->tot_len, 0);
+
+    ullStartUs = LWIP_MAX(gullNowUs, Link->BusyUntilUs);
+    Link->BusyUntilUs = ullStartUs + LWIP_MAX((ULONGLONG)Packet->Length * 8 / gulRateMbps, 1);
+    Packet->DueUs = Link->BusyUntilUs + (ULONGLONG)gulDelayMs * 1000;
+
+    if (Link->Tail)
+        Link->Tail->Next = Packet;
+    else
+        Link->Head = Packet;
+    Link->Tail = Packet;
+
+    return ERR_OK;
+}
+
+static
+err_t
+LinkInit(struct netif *netif)
+{
+    netif->name[0] = 'b';
+    netif->name[1] = 'n';
+    netif->output = LinkOutput;
+    netif->mtu = 1500;
+    return ERR_OK;
+}
+
+static
+VOID
+LinkDeliver(PLINK Link)
+{
+    PPACKET Packet = Link->Head;
+    struct pbuf *p;
+
+    Link->Head = Packet->Next;
+    if (!Link->Head)
+        Link->Tail = NULL;
+
+    p = pbuf_alloc(PBUF_RAW, Packet->Length, PBUF_RAM);
+    if (p)
+    {
+        memcpy(p->payload, Packet->Data, Packet->Length);
+        ip_input(p, &Link->Netif);
+    }
+
+    free(Packet);
+}
+
+static
+VOID
+LinkFlush(PLINK Link)
+{
+    PPACKET Packet;
+
+    while ((Packet = Link->Head))
+    {
+        Link->Head = Packet->Next;
+        free(Packet);
+    }
+
+    Link->Tail = NULL;
+    Link->BusyUntilUs = 0;
+}
+
+static
+err_t
+ServerRecv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err)
+{
+    if (!p)
+        return ERR_OK;
+
+    gullReceived += p->tot_len;
+    tcp_recved(tpcb, p->tot_len);
+    pbuf_free(p);
+    return ERR_OK;
+}
+
+static
+err_t
+ServerAccept(void *arg, struct tcp_pcb *newpcb, err_t err)
+{
+    ULONG ulMax = TCP_WND_MAX(newpcb);
+
+    /* As if the application had left the rest of TCP_WND unread */
+    if (gulWindow < ulMax)
+    {
+        newpcb->rcv_wnd -= ulMax - gulWindow;
+        newpcb->rcv_ann_wnd = newpcb->rcv_wnd;
+    }
+
+    tcp_recv(newpcb, ServerRecv);
+    gpServer = newpcb;
+    return ERR_OK;
+}
+
+/* Queues as much data as the send buffer takes */
+static
+err_t
+ClientSend(void *arg, struct tcp_pcb *tpcb, u16_t len)
+{
+    ULONG ulLength;
+
+    while ((ulLength = LWIP_MIN(tcp_sndbuf(tpcb), BENCH_CHUNK)) > 0)
+    {
+        if (tcp_write(tpcb, gajData, (u16_t)ulLength, 0) != ERR_OK)
+            break;
+    }
+
+    return tcp_output(tpcb);
+}
+
+static
+err_t
+ClientConnected(void *arg, struct tcp_pcb *tpcb, err_t err)
+{
+    tcp_sent(tpcb, ClientSend);
+    return ClientSend(arg, tpcb, 0);
+}
+
+static
+VOID
+RunWindow(ULONG ulWindow)
+{
+    struct tcp_pcb *Listener, *Client;
+    ULONGLONG ullNextTimerUs, ullDueUs, ullEndUs, ullStartBytes = 0;
+    ULONGLONG ullRttUs, ullWarmupUs;
+    double dThroughput, dLimit;
+    PLINK Link;
+
+    gullNowUs = 0;
+    gulWindow = ulWindow;
+    gullReceived = 0;
+    gpServer = NULL;
+
+    Listener = tcp_new();
+    tcp_bind(Listener, &gAddresses[1], BENCH_PORT);
+    Listener = tcp_listen(Listener);
+    tcp_accept(Listener, ServerAccept);
+
+    Client = tcp_new();
+    tcp_bind(Client, &gAddresses[0], 0);
+    tcp_connect(Client, &gAddresses[1], BENCH_PORT, ClientConnected);
+
+    /* The time to send a full segment and get its ACK back */
+    ullRttUs = 2ULL * gulDelayMs * 1000 + (TCP_MSS + 2 * 40) * 8 / gulRateMbps;
+    if (!ullRttUs)
+        ullRttUs = 1;
+    ullWarmupUs = WARMUP_RTTS * ullRttUs;
+
+    ullNextTimerUs = TCP_TMR_INTERVAL * 1000;
+    ullEndUs = ullWarmupUs + (ULONGLONG)gulSeconds * 1000000;
+    while (gullNowUs < ullEndUs)
+    {
+        /* The next packet to arrive, or the TCP timer */
+        Link = NULL;
+        if (gLinks[0].Head)
+            Link = &gLinks[0];
+        if (gLinks[1].Head && (!Link || gLinks[1].Head->DueUs < Link->Head->DueUs))
+            Link = &gLinks[1];
+        if (Link && Link->Head->DueUs < ullNextTimerUs)
+            ullDueUs = Link->Head->DueUs;
+        else
+            ullDueUs = ullNextTimerUs;
+
+        if (gullNowUs < ullWarmupUs && ullDueUs >= ullWarmupUs)
+            ullStartBytes = gullReceived;
+        gullNowUs = ullDueUs;
+
+        if (ullDueUs == ullNextTimerUs)
+        {
+            ullNextTimerUs += TCP_TMR_INTERVAL * 1000;
+            tcp_tmr();
+        }
+        else
+        {
+            LinkDeliver(Link);
+        }
+    }
+
+    dLimit = (double)ulWindow * 8 / ullRttUs;
+    if (dLimit > gulRateMbps)
+        dLimit = gulRateMbps;
+    dThroughput = (double)(gullReceived - ullStartBytes) * 8 / ((double)gulSeconds * 1000000);
+
+    printf("%6lu KB %10.1f Mbit/s %10.1f Mbit/s\n",
+           (unsigned long)ulWindow / 1024, dThroughput, dLimit);
+
+    if (!gpServer)
+        Fail("No connection", ulWindow);
+    else if (!(Client->flags & TF_WND_SCALE) || Client->snd_scale != TCP_RCV_SCALE ||
+             !(gpServer->flags & TF_WND_SCALE) || gpServer->snd_scale != TCP_RCV_SCALE)
+        Fail("Window scaling wasn't agreed", ulWindow);
+    if (dThroughput < dLimit * 0.8)
+        Fail("Throughput is below 80% of the limit", ulWindow);
+
+    tcp_abort(Client);
+    if (gpServer)
+        tcp_abort(gpServer);
+    tcp_close(Listener);
+    LinkFlush(&gLinks[0]);
+    LinkFlush(&gLinks[1]);
+}
+
+int main(int argc, char *argv[])
+{
+    ip_addr_t Netmask;
+    ULONG ulWindow;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-d") && i + 1 < argc)
+            gulDelayMs = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-r") && i + 1 < argc)
+            gulRateMbps = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc)
+            gulSeconds = strtoul(argv[++i], NULL, 0);
+        else
+        {
+            printf("Usage: %s [-d delay ms] [-r rate Mbit/s] [-t seconds]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (!gulRateMbps || !gulSeconds)
+    {
+        printf("The rate and the time must not be zero\n");
+        return 1;
+    }
+
+    lwip_init();
+
+    /* Each interface only routes to its own address */
+    IP4_ADDR(&Netmask, 255, 255, 255, 255);
+    for (i = 0; i < 2; i++)
+    {
+        IP4_ADDR(&gAddresses[i], 10, 0, 0, i + 1);
+        netif_add(&gLinks[i].Netif, &gAddresses[i], &Netmask, &gAddresses[i],
+                  &gLinks[i], LinkInit, ip_input);
+        netif_set_up(&gLinks[i].Netif);
+    }
+
+    for (i = 0; i < (int)sizeof(gajData); i++)
+        gajData[i] = (u8_t)i;
+
+    printf("%lu ms delay each way at %lu Mbit/s, TCP_WND %u, TCP_RCV_SCALE %u\n",
+           (unsigned long)gulDelayMs, (unsigned long)gulRateMbps, TCP_WND, TCP_RCV_SCALE);
+    printf("%9s %17s %17s\n", "Window", "Throughput", "Limit");
+
+    for (ulWindow = 16 * 1024; ulWindow < TCP_WND; ulWindow *= 2)
+        RunWindow(ulWindow);
+    RunWindow(TCP_WND);
+
+    return LWIP_MIN(gcFailures, 255);
+}
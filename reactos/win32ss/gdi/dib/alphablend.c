@@ -8,6 +8,10 @@
 
 #include <win32k.h>
 
+#if defined(_M_AMD64)
+#include <emmintrin.h>
+#endif
+
 #define NDEBUG
 #include <debug.h>
 
@@ -29,6 +33,318 @@ Clamp8(ULONG val)
   return (val > 255) ? 255 : (UCHAR)val;
 }
 
+/* Exact val / 255 for 0 <= val <= 255 * 255 */
+static __inline ULONG
+DivBy255(ULONG val)
+{
+  return (val + 1 + (val >> 8)) >> 8;
+}
+
+/* Number of stretched source pixels gathered on the stack at a time */
+#define ALPHA_ROW_CHUNK 64
+
+typedef VOID (*PFN_ALPHA_ROW)(PVOID, const ULONG*, ULONG, ULONG, BOOLEAN);
+
+/*
+ * Blends one BGRA source pixel over a 32bpp destination value, giving the
+ * same result as the per-pixel loops below: the source is scaled by the
+ * constant alpha, the destination by (255 - Alpha), both truncated.
+ */
+static __inline ULONG
+AlphaBlendPixel(ULONG ulDst, ULONG ulSrc, ULONG Sca, BOOLEAN bSrcAlpha)
+{
+  NICEPIXEL32 DstPixel, SrcPixel;
+  ULONG Inv;
+
+  SrcPixel.ul = ulSrc;
+  if (Sca != 255)
+  {
+    SrcPixel.col.red = (UCHAR)DivBy255(SrcPixel.col.red * Sca);
+    SrcPixel.col.green = (UCHAR)DivBy255(SrcPixel.col.green * Sca);
+    SrcPixel.col.blue = (UCHAR)DivBy255(SrcPixel.col.blue * Sca);
+    SrcPixel.col.alpha = (UCHAR)DivBy255(SrcPixel.col.alpha * Sca);
+  }
+
+  Inv = 255 - (bSrcAlpha ? SrcPixel.col.alpha : Sca);
+  if (Inv == 0)
+    return SrcPixel.ul;
+  if (Inv == 255 && SrcPixel.ul == 0)
+    return ulDst;
+
+  DstPixel.ul = ulDst;
+  DstPixel.col.red = Clamp8(DivBy255(DstPixel.col.red * Inv) + SrcPixel.col.red);
+  DstPixel.col.green = Clamp8(DivBy255(DstPixel.col.green * Inv) + SrcPixel.col.green);
+  DstPixel.col.blue = Clamp8(DivBy255(DstPixel.col.blue * Inv) + SrcPixel.col.blue);
+  DstPixel.col.alpha = Clamp8(DivBy255(DstPixel.col.alpha * Inv) + SrcPixel.col.alpha);
+  return DstPixel.ul;
+}
+
+#if defined(_M_AMD64)
+/* Exact x / 255 on each 16-bit lane, x <= 255 * 255 */
+#define DivBy255_Sse2(x, One) \
+  _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16((x), (One)), _mm_srli_epi16((x), 8)), 8)
+
+/*
+ * SSE2 is part of the amd64 baseline and the XMM registers may be used in
+ * kernel mode there without saving them. On i386 KeSaveFloatingPointState
+ * only covers the x87 state, so that build keeps to the C loop.
+ */
+static VOID
+AlphaBlendRow32(PVOID pvDst, const ULONG *pulSrc, ULONG cx, ULONG Sca, BOOLEAN bSrcAlpha)
+{
+  PULONG pulDst = pvDst;
+  const __m128i Zero = _mm_setzero_si128();
+  const __m128i One = _mm_set1_epi16(1);
+  const __m128i Max = _mm_set1_epi16(255);
+  const __m128i Scale = _mm_set1_epi16((SHORT)Sca);
+  const __m128i AlphaMask = _mm_set1_epi32(0xFF000000);
+  __m128i Src, Dst, SrcLo, SrcHi, DstLo, DstHi, InvLo, InvHi;
+
+  InvLo = InvHi = _mm_set1_epi16((SHORT)(255 - Sca));
+
+  for (; cx >= 4; cx -= 4, pulSrc += 4, pulDst += 4)
+  {
+    Src = _mm_loadu_si128((const __m128i*)pulSrc);
+
+    if (bSrcAlpha)
+    {
+      /* Fully transparent (premultiplied) pixels leave the destination alone */
+      if (_mm_movemask_epi8(_mm_cmpeq_epi32(Src, Zero)) == 0xFFFF)
+        continue;
+
+      /* Opaque pixels at full constant alpha replace it */
+      if (Sca == 255 &&
+          _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(Src, AlphaMask), AlphaMask)) == 0xFFFF)
+      {
+        _mm_storeu_si128((__m128i*)pulDst, Src);
+        continue;
+      }
+    }
+
+    SrcLo = _mm_unpacklo_epi8(Src, Zero);
+    SrcHi = _mm_unpackhi_epi8(Src, Zero);
+    if (Sca != 255)
+    {
+      SrcLo = _mm_mullo_epi16(SrcLo, Scale);
+      SrcHi = _mm_mullo_epi16(SrcHi, Scale);
+      SrcLo = DivBy255_Sse2(SrcLo, One);
+      SrcHi = DivBy255_Sse2(SrcHi, One);
+    }
+
+    if (bSrcAlpha)
+    {
+      /* Broadcast each pixel's scaled alpha to its four lanes */
+      InvLo = _mm_sub_epi16(Max, _mm_shufflehi_epi16(_mm_shufflelo_epi16(SrcLo, 0xFF), 0xFF));
+      InvHi = _mm_sub_epi16(Max, _mm_shufflehi_epi16(_mm_shufflelo_epi16(SrcHi, 0xFF), 0xFF));
+    }
+
+    Dst = _mm_loadu_si128((const __m128i*)pulDst);
+    DstLo = _mm_mullo_epi16(_mm_unpacklo_epi8(Dst, Zero), InvLo);
+    DstHi = _mm_mullo_epi16(_mm_unpackhi_epi8(Dst, Zero), InvHi);
+    DstLo = _mm_add_epi16(DivBy255_Sse2(DstLo, One), SrcLo);
+    DstHi = _mm_add_epi16(DivBy255_Sse2(DstHi, One), SrcHi);
+
+    /* The unsigned saturation does the Clamp8 */
+    _mm_storeu_si128((__m128i*)pulDst, _mm_packus_epi16(DstLo, DstHi));
+  }
+
+  while (cx--)
+  {
+    *pulDst = AlphaBlendPixel(*pulDst, *pulSrc++, Sca, bSrcAlpha);
+    pulDst++;
+  }
+}
+#else
+static VOID
+AlphaBlendRow32(PVOID pvDst, const ULONG *pulSrc, ULONG cx, ULONG Sca, BOOLEAN bSrcAlpha)
+{
+  PULONG pulDst = pvDst;
+
+  while (cx--)
+  {
+    *pulDst = AlphaBlendPixel(*pulDst, *pulSrc++, Sca, bSrcAlpha);
+    pulDst++;
+  }
+}
+#endif
+
+static VOID
+AlphaBlendRow24(PVOID pvDst, const ULONG *pulSrc, ULONG cx, ULONG Sca, BOOLEAN bSrcAlpha)
+{
+  PUCHAR pjDst = pvDst;
+  ULONG ulDst;
+
+  while (cx--)
+  {
+    ulDst = pjDst[0] | (pjDst[1] << 8) | (pjDst[2] << 16);
+    ulDst = AlphaBlendPixel(ulDst, *pulSrc++, Sca, bSrcAlpha);
+    *pjDst++ = (UCHAR)ulDst;
+    *pjDst++ = (UCHAR)(ulDst >> 8);
+    *pjDst++ = (UCHAR)(ulDst >> 16);
+  }
+}
+
+/*
+ * The 16bpp rows expand the destination with the same tables and truncate
+ * the result with the same shifts as the EXLATEOBJ 565/555 <-> BGR
+ * translations the generic loop goes through.
+ */
+static VOID
+AlphaBlendRow565(PVOID pvDst, const ULONG *pulSrc, ULONG cx, ULONG Sca, BOOLEAN bSrcAlpha)
+{
+  PUSHORT pusDst = pvDst;
+  ULONG ulDst;
+
+  while (cx--)
+  {
+    ulDst = *pusDst;
+    ulDst = gajXlate5to8[ulDst & 0x1F] |
+            (gajXlate6to8[(ulDst >> 5) & 0x3F] << 8) |
+            (gajXlate5to8[(ulDst >> 11) & 0x1F] << 16);
+    ulDst = AlphaBlendPixel(ulDst, *pulSrc++, Sca, bSrcAlpha);
+    *pusDst++ = (USHORT)(((ulDst >> 3) & 0x1F) |
+                         ((ulDst >> 5) & 0x7E0) |
+                         ((ulDst >> 8) & 0xF800));
+  }
+}
+
+static VOID
+AlphaBlendRow555(PVOID pvDst, const ULONG *pulSrc, ULONG cx, ULONG Sca, BOOLEAN bSrcAlpha)
+{
+  PUSHORT pusDst = pvDst;
+  ULONG ulDst;
+
+  while (cx--)
+  {
+    ulDst = *pusDst;
+    ulDst = gajXlate5to8[ulDst & 0x1F] |
+            (gajXlate5to8[(ulDst >> 5) & 0x1F] << 8) |
+            (gajXlate5to8[(ulDst >> 10) & 0x1F] << 16);
+    ulDst = AlphaBlendPixel(ulDst, *pulSrc++, Sca, bSrcAlpha);
+    *pusDst++ = (USHORT)(((ulDst >> 3) & 0x1F) |
+                         ((ulDst >> 6) & 0x3E0) |
+                         ((ulDst >> 9) & 0x7C00));
+  }
+}
+
+/*
+ * Row based AlphaBlend for a 32bpp BGRA source onto 32, 24 and 16bpp
+ * destinations. The caller has already validated BlendFunc. Returns FALSE
+ * when the formats are not handled here, and the caller then falls back to
+ * its per-pixel loop. The results are identical to those loops, including
+ * the nearest-neighbour stretch.
+ */
+BOOLEAN
+DIB_AlphaBlendRows(SURFOBJ* Dest, SURFOBJ* Source, RECTL* DestRect,
+                   RECTL* SourceRect, XLATEOBJ* ColorTranslation,
+                   BLENDFUNCTION BlendFunc)
+{
+  ULONG aulSrc[ALPHA_ROW_CHUNK];
+  PFN_ALPHA_ROW pfnRow;
+  EXLATEOBJ* pexlo;
+  PBYTE pjDst, pjSrcRow;
+  const ULONG *pulSrcRow;
+  LONG cxDst, cyDst, cxSrc, cySrc, x, y, cx, cjDstPixel;
+  LONG SrcX, SrcY, StepX, StepY;
+  ULONG SrcXFrac, SrcYFrac, StepXFrac, StepYFrac, Chunk;
+  ULONG Sca = BlendFunc.SourceConstantAlpha;
+  BOOLEAN bSrcAlpha = (BlendFunc.AlphaFormat & AC_SRC_ALPHA) != 0;
+
+  if (Source->iBitmapFormat != BMF_32BPP)
+    return FALSE;
+
+  switch (Dest->iBitmapFormat)
+  {
+    case BMF_32BPP:
+    case BMF_24BPP:
+      /* The per-pixel loops blend the raw translated values */
+      if (ColorTranslation && !(ColorTranslation->flXlate & XO_TRIVIAL))
+        return FALSE;
+      pfnRow = (Dest->iBitmapFormat == BMF_32BPP) ? AlphaBlendRow32 : AlphaBlendRow24;
+      cjDstPixel = (Dest->iBitmapFormat == BMF_32BPP) ? 4 : 3;
+      break;
+
+    case BMF_16BPP:
+      if (!ColorTranslation)
+        return FALSE;
+      pexlo = CONTAINING_RECORD(ColorTranslation, EXLATEOBJ, xlo);
+      if (!(pexlo->ppalSrc->flFlags & PAL_BGR))
+        return FALSE;
+      if (pexlo->ppalDst->flFlags & PAL_RGB16_565)
+        pfnRow = AlphaBlendRow565;
+      else if (pexlo->ppalDst->flFlags & PAL_RGB16_555)
+        pfnRow = AlphaBlendRow555;
+      else
+        return FALSE;
+      cjDstPixel = 2;
+      break;
+
+    default:
+      return FALSE;
+  }
+
+  cxDst = DestRect->right - DestRect->left;
+  cyDst = DestRect->bottom - DestRect->top;
+  cxSrc = SourceRect->right - SourceRect->left;
+  cySrc = SourceRect->bottom - SourceRect->top;
+  if (cxDst <= 0 || cyDst <= 0 || cxSrc <= 0 || cySrc <= 0)
+    return FALSE;
+
+  /* Source coordinate n is (n * cxSrc) / cxDst, stepped without dividing */
+  StepX = cxSrc / cxDst;
+  StepXFrac = cxSrc % cxDst;
+  StepY = cySrc / cyDst;
+  StepYFrac = cySrc % cyDst;
+
+  pjDst = (PBYTE)Dest->pvScan0 + DestRect->top * Dest->lDelta +
+          DestRect->left * cjDstPixel;
+  SrcY = SourceRect->top;
+  SrcYFrac = 0;
+
+  for (y = 0; y < cyDst; y++)
+  {
+    pjSrcRow = (PBYTE)Source->pvScan0 + SrcY * Source->lDelta;
+    pulSrcRow = (const ULONG*)pjSrcRow + SourceRect->left;
+
+    if (cxSrc == cxDst)
+    {
+      pfnRow(pjDst, pulSrcRow, cxDst, Sca, bSrcAlpha);
+    }
+    else
+    {
+      SrcX = 0;
+      SrcXFrac = 0;
+      for (x = 0; x < cxDst; x += cx)
+      {
+        cx = min(cxDst - x, ALPHA_ROW_CHUNK);
+        for (Chunk = 0; Chunk < (ULONG)cx; Chunk++)
+        {
+          aulSrc[Chunk] = pulSrcRow[SrcX];
+          SrcX += StepX;
+          SrcXFrac += StepXFrac;
+          if (SrcXFrac >= (ULONG)cxDst)
+          {
+            SrcXFrac -= cxDst;
+            SrcX++;
+          }
+        }
+        pfnRow(pjDst + x * cjDstPixel, aulSrc, cx, Sca, bSrcAlpha);
+      }
+    }
+
+    pjDst += Dest->lDelta;
+    SrcY += StepY;
+    SrcYFrac += StepYFrac;
+    if (SrcYFrac >= (ULONG)cyDst)
+    {
+      SrcYFrac -= cyDst;
+      SrcY++;
+    }
+  }
+
+  return TRUE;
+}
+
 BOOLEAN
 DIB_XXBPP_AlphaBlend(SURFOBJ* Dest, SURFOBJ* Source, RECTL* DestRect,
                      RECTL* SourceRect, CLIPOBJ* ClipRegion,
@@ -76,6 +392,9 @@ DIB_XXBPP_AlphaBlend(SURFOBJ* Dest, SURFOBJ* Source, RECTL* DestRect,
     return FALSE;
   }
 
+  if (DIB_AlphaBlendRows(Dest, Source, DestRect, SourceRect, ColorTranslation, BlendFunc))
+    return TRUE;
+
   pexlo = CONTAINING_RECORD(ColorTranslation, EXLATEOBJ, xlo);
   EXLATEOBJ_vInitialize(&exloSrcRGB, pexlo->ppalSrc, &gpalRGB, 0, 0, 0);
   EXLATEOBJ_vInitialize(&exloDstRGB, pexlo->ppalDst, &gpalRGB, 0, 0, 0);
@@ -499,6 +499,9 @@ DIB_24BPP_AlphaBlend(SURFOBJ* Dest, SURFOBJ* Source, RECTL* DestRect,
       return FALSE;
    }
 
+   if (DIB_AlphaBlendRows(Dest, Source, DestRect, SourceRect, ColorTranslation, BlendFunc))
+      return TRUE;
+
    Dst = (PUCHAR)((ULONG_PTR)Dest->pvScan0 + (DestRect->top * Dest->lDelta) +
                              (DestRect->left * 3));
    //SrcBpp = BitsPerFormat(Source->iBitmapFormat);
@@ -13,12 +13,484 @@
 #define NDEBUG
 #include <debug.h>
 
+/* Pixels handled per pass of the scanline loops */
+#define STRETCH_CHUNK 128
+
+/* HALFTONE filter weights are fixed point with 12 fractional bits */
+#define STRETCH_WEIGHT_BITS 12
+#define STRETCH_WEIGHT_ONE (1 << STRETCH_WEIGHT_BITS)
+
+typedef struct _STRETCH_TAPS
+{
+  LONG iFirst;
+  ULONG cTaps;
+} STRETCH_TAPS, *PSTRETCH_TAPS;
+
+/*
+ * Reads cx pixels of scanline y. The x coordinates come from plX when it
+ * is given, otherwise they run contiguously from x.
+ */
+static VOID
+StretchReadRow(SURFOBJ *pso, LONG y, LONG x, const LONG *plX, ULONG cx, PULONG pulOut)
+{
+  PBYTE pjLine = (PBYTE)pso->pvScan0 + y * pso->lDelta;
+  PBYTE pj;
+  ULONG i;
+  LONG sx;
+
+#define STRETCH_X(i) (plX ? plX[i] : x + (LONG)(i))
+
+  switch (pso->iBitmapFormat)
+  {
+  case BMF_1BPP:
+    for (i = 0; i < cx; i++)
+    {
+      sx = STRETCH_X(i);
+      pulOut[i] = (pjLine[sx >> 3] >> (7 - (sx & 7))) & 1;
+    }
+    break;
+  case BMF_4BPP:
+    for (i = 0; i < cx; i++)
+    {
+      sx = STRETCH_X(i);
+      pulOut[i] = (pjLine[sx >> 1] >> ((1 - (sx & 1)) << 2)) & 0xF;
+    }
+    break;
+  case BMF_8BPP:
+    for (i = 0; i < cx; i++)
+      pulOut[i] = pjLine[STRETCH_X(i)];
+    break;
+  case BMF_16BPP:
+    for (i = 0; i < cx; i++)
+      pulOut[i] = ((PUSHORT)pjLine)[STRETCH_X(i)];
+    break;
+  case BMF_24BPP:
+    for (i = 0; i < cx; i++)
+    {
+      pj = pjLine + STRETCH_X(i) * 3;
+      pulOut[i] = pj[0] | (pj[1] << 8) | (pj[2] << 16);
+    }
+    break;
+  case BMF_32BPP:
+    for (i = 0; i < cx; i++)
+      pulOut[i] = ((PULONG)pjLine)[STRETCH_X(i)];
+    break;
+  }
+
+#undef STRETCH_X
+}
+
+static VOID
+StretchWriteRow(SURFOBJ *pso, LONG x, LONG y, ULONG cx, const ULONG *pulIn)
+{
+  PBYTE pjLine = (PBYTE)pso->pvScan0 + y * pso->lDelta;
+  PBYTE pj;
+  ULONG i;
+
+  switch (pso->iBitmapFormat)
+  {
+  case BMF_1BPP:
+    for (i = 0; i < cx; i++, x++)
+    {
+      if (pulIn[i] & 1)
+        pjLine[x >> 3] |= MASK1BPP(x);
+      else
+        pjLine[x >> 3] &= ~MASK1BPP(x);
+    }
+    break;
+  case BMF_4BPP:
+    for (i = 0; i < cx; i++, x++)
+    {
+      pj = pjLine + (x >> 1);
+      if (x & 1)
+        *pj = (*pj & 0xF0) | (BYTE)(pulIn[i] & 0xF);
+      else
+        *pj = (*pj & 0x0F) | (BYTE)((pulIn[i] & 0xF) << 4);
+    }
+    break;
+  case BMF_8BPP:
+    for (i = 0; i < cx; i++)
+      pjLine[x + i] = (BYTE)pulIn[i];
+    break;
+  case BMF_16BPP:
+    for (i = 0; i < cx; i++)
+      ((PUSHORT)pjLine)[x + i] = (USHORT)pulIn[i];
+    break;
+  case BMF_24BPP:
+    pj = pjLine + x * 3;
+    for (i = 0; i < cx; i++)
+    {
+      *pj++ = (BYTE)pulIn[i];
+      *pj++ = (BYTE)(pulIn[i] >> 8);
+      *pj++ = (BYTE)(pulIn[i] >> 16);
+    }
+    break;
+  case BMF_32BPP:
+    RtlCopyMemory((PULONG)pjLine + x, pulIn, cx * sizeof(ULONG));
+    break;
+  }
+}
+
+static BOOLEAN
+StretchIsRowFormat(ULONG iFormat)
+{
+  return iFormat >= BMF_1BPP && iFormat <= BMF_32BPP;
+}
+
+/*
+ * Nearest-neighbour stretch, one scanline at a time. The source column of
+ * every destination column is computed once per call, with the same
+ * arithmetic as the per-pixel loop. Returns FALSE for the cases left to
+ * that loop: masks, and source rectangles reaching outside the surface.
+ */
+static BOOLEAN
+StretchBltRows(SURFOBJ *DestSurf, SURFOBJ *SourceSurf, SURFOBJ *PatternSurface,
+               RECTL *DestRect, RECTL *SourceRect, BRUSHOBJ *Brush,
+               POINTL *BrushOrigin, XLATEOBJ *ColorTranslation, ROP4 ROP)
+{
+  ULONG aulSrc[STRETCH_CHUNK], aulPat[STRETCH_CHUNK], aulDst[STRETCH_CHUNK];
+  BOOL UsesSource = ROP4_USES_SOURCE(ROP);
+  BOOL UsesPattern = ROP4_USES_PATTERN(ROP);
+  BOOL UsesDest = ROP4_USES_DEST(ROP);
+  BOOL bSrcCopy = (ROP == ROP4_FROM_INDEX(R3_OPINDEX_SRCCOPY));
+  BOOL bXlate;
+  LONG DstWidth, DstHeight, SrcWidth, SrcHeight, SourceCy;
+  LONG DesY, sy, x, cx, Run, PatternX = 0, PatternY = 0, PatternStartX = 0;
+  PLONG plSrcX = NULL;
+  ULONG i, Pattern = 0, xxBPPMask;
+
+  if (!StretchIsRowFormat(DestSurf->iBitmapFormat))
+    return FALSE;
+
+  /* StretchReadRow leaves the buffer untouched for formats it can't read */
+  if (UsesPattern && PatternSurface && !StretchIsRowFormat(PatternSurface->iBitmapFormat))
+    return FALSE;
+
+  DstWidth = DestRect->right - DestRect->left;
+  DstHeight = DestRect->bottom - DestRect->top;
+  SrcWidth = SourceRect->right - SourceRect->left;
+  SrcHeight = SourceRect->bottom - SourceRect->top;
+  if (DstWidth <= 0 || DstHeight <= 0)
+    return FALSE;
+
+  switch (DestSurf->iBitmapFormat)
+  {
+  case BMF_1BPP: xxBPPMask = 0x1; break;
+  case BMF_4BPP: xxBPPMask = 0xF; break;
+  case BMF_8BPP: xxBPPMask = 0xFF; break;
+  case BMF_16BPP: xxBPPMask = 0xFFFF; break;
+  case BMF_24BPP: xxBPPMask = 0xFFFFFF; break;
+  default:
+    xxBPPMask = 0xFFFFFFFF;
+  }
+
+  if (UsesSource)
+  {
+    if (!StretchIsRowFormat(SourceSurf->iBitmapFormat))
+      return FALSE;
+
+    /* The mapping is monotonic, so checking both ends covers every pixel */
+    SourceCy = abs(SourceSurf->sizlBitmap.cy);
+    sy = SourceRect->top + (DstHeight - 1) * SrcHeight / DstHeight;
+    if (SourceRect->top < 0 || SourceRect->top >= SourceCy || sy < 0 || sy >= SourceCy)
+      return FALSE;
+    x = SourceRect->left + (DstWidth - 1) * SrcWidth / DstWidth;
+    if (SourceRect->left < 0 || SourceRect->left >= SourceSurf->sizlBitmap.cx ||
+        x < 0 || x >= SourceSurf->sizlBitmap.cx)
+      return FALSE;
+
+    plSrcX = EngAllocMem(0, DstWidth * sizeof(LONG), GDITAG_TEMP);
+    if (!plSrcX)
+      return FALSE;
+
+    for (x = 0; x < DstWidth; x++)
+      plSrcX[x] = SourceRect->left + x * SrcWidth / DstWidth;
+  }
+
+  bXlate = ColorTranslation && !(ColorTranslation->flXlate & XO_TRIVIAL);
+
+  if (UsesPattern)
+  {
+    if (PatternSurface)
+    {
+      PatternY = (DestRect->top - BrushOrigin->y) % PatternSurface->sizlBitmap.cy;
+      if (PatternY < 0)
+        PatternY += PatternSurface->sizlBitmap.cy;
+      PatternStartX = (DestRect->left - BrushOrigin->x) % PatternSurface->sizlBitmap.cx;
+      if (PatternStartX < 0)
+        PatternStartX += PatternSurface->sizlBitmap.cx;
+    }
+    else if (Brush)
+    {
+      Pattern = Brush->iSolidColor;
+    }
+  }
+
+  for (DesY = DestRect->top; DesY < DestRect->bottom; DesY++)
+  {
+    if (UsesSource)
+      sy = SourceRect->top + (DesY - DestRect->top) * SrcHeight / DstHeight;
+    PatternX = PatternStartX;
+
+    for (x = 0; x < DstWidth; x += cx)
+    {
+      cx = min(DstWidth - x, STRETCH_CHUNK);
+
+      if (UsesSource)
+      {
+        StretchReadRow(SourceSurf, sy, 0, plSrcX + x, cx, aulSrc);
+        if (bXlate)
+        {
+          for (i = 0; i < (ULONG)cx; i++)
+            aulSrc[i] = XLATEOBJ_iXlate(ColorTranslation, aulSrc[i]);
+        }
+      }
+
+      if (bSrcCopy)
+      {
+        for (i = 0; i < (ULONG)cx; i++)
+          aulSrc[i] &= xxBPPMask;
+        StretchWriteRow(DestSurf, DestRect->left + x, DesY, cx, aulSrc);
+        continue;
+      }
+
+      if (UsesPattern && PatternSurface)
+      {
+        /* Gather the pattern, wrapping at its right edge */
+        for (i = 0; i < (ULONG)cx; i += Run)
+        {
+          Run = min(cx - (LONG)i, PatternSurface->sizlBitmap.cx - PatternX);
+          StretchReadRow(PatternSurface, PatternY, PatternX, NULL, Run, aulPat + i);
+          PatternX = (PatternX + Run) % PatternSurface->sizlBitmap.cx;
+        }
+      }
+
+      if (UsesDest)
+        StretchReadRow(DestSurf, DesY, DestRect->left + x, NULL, cx, aulDst);
+
+      for (i = 0; i < (ULONG)cx; i++)
+      {
+        aulDst[i] = DIB_DoRop(ROP,
+                              UsesDest ? aulDst[i] : 0,
+                              UsesSource ? aulSrc[i] : 0,
+                              (UsesPattern && PatternSurface) ? aulPat[i] : Pattern) & xxBPPMask;
+      }
+      StretchWriteRow(DestSurf, DestRect->left + x, DesY, cx, aulDst);
+    }
+
+    if (PatternSurface)
+    {
+      PatternY++;
+      PatternY %= PatternSurface->sizlBitmap.cy;
+    }
+  }
+
+  if (plSrcX)
+    EngFreeMem(plSrcX);
+
+  return TRUE;
+}
+
+/*
+ * Builds the source taps of every destination pixel along one axis.
+ * Shrinking averages all source pixels the destination pixel covers, with
+ * partial pixels weighted by coverage. Enlarging interpolates linearly
+ * between the two source pixel centers around the destination center.
+ */
+static VOID
+StretchBuildTaps(LONG cSrc, LONG cDst, ULONG cMaxTaps, PSTRETCH_TAPS pTaps, PUSHORT pusWeights)
+{
+  LONGLONG llStart, llEnd, llCenter, llOverlap;
+  LONG d, i, iLast;
+  ULONG cTaps, ulSum, ulWeight;
+  PUSHORT pus;
+
+  for (d = 0; d < cDst; d++)
+  {
+    pus = pusWeights + d * cMaxTaps;
+
+    if (cSrc > cDst)
+    {
+      /* Source span of the destination pixel, in units of 1/cDst pixel */
+      llStart = (LONGLONG)d * cSrc;
+      llEnd = llStart + cSrc;
+      pTaps[d].iFirst = (LONG)(llStart / cDst);
+      iLast = (LONG)((llEnd - 1) / cDst);
+
+      cTaps = 0;
+      ulSum = 0;
+      for (i = pTaps[d].iFirst; i <= iLast; i++)
+      {
+        llOverlap = min(llEnd, (LONGLONG)(i + 1) * cDst) - max(llStart, (LONGLONG)i * cDst);
+        ulWeight = (ULONG)(llOverlap * STRETCH_WEIGHT_ONE / cSrc);
+        pus[cTaps++] = (USHORT)ulWeight;
+        ulSum += ulWeight;
+      }
+
+      /* Hand the rounding loss to the first tap so the weights add up to one */
+      pus[0] += (USHORT)(STRETCH_WEIGHT_ONE - ulSum);
+      pTaps[d].cTaps = cTaps;
+    }
+    else
+    {
+      /* Destination pixel center in source pixels, times 2 * cDst */
+      llCenter = (LONGLONG)(2 * d + 1) * cSrc - cDst;
+      if (llCenter < 0)
+        llCenter = 0;
+
+      i = (LONG)(llCenter / (2 * cDst));
+      ulWeight = (ULONG)((llCenter % (2 * cDst)) * STRETCH_WEIGHT_ONE / (2 * cDst));
+      if (i >= cSrc - 1)
+      {
+        i = cSrc - 1;
+        ulWeight = 0;
+      }
+
+      pTaps[d].iFirst = i;
+      pTaps[d].cTaps = ulWeight ? 2 : 1;
+      pus[0] = (USHORT)(STRETCH_WEIGHT_ONE - ulWeight);
+      pus[1] = (USHORT)ulWeight;
+    }
+  }
+}
+
+/*
+ * HALFTONE stretch for SRCCOPY onto 16, 24 and 32bpp surfaces. It filters
+ * in BGR: box filter when shrinking, bilinear when enlarging, applied
+ * vertically into an accumulator row and then horizontally. Returns FALSE
+ * when the blit has to use the nearest-neighbour paths instead.
+ */
+static BOOLEAN
+StretchBltHalftone(SURFOBJ *DestSurf, SURFOBJ *SourceSurf, RECTL *DestRect,
+                   RECTL *SourceRect, XLATEOBJ *ColorTranslation)
+{
+  EXLATEOBJ *pexlo;
+  EXLATEOBJ exloSrcBGR, exloBGRDst;
+  PSTRETCH_TAPS pTapsX, pTapsY;
+  PUSHORT pusWeightsX, pusWeightsY, pus;
+  PULONG pulAccum, pulSrcRow, pulDstRow, pulAcc;
+  PVOID pvBuffer;
+  LONG DstWidth, DstHeight, SrcWidth, SrcHeight, x, y;
+  ULONG cMaxTapsX, cMaxTapsY, cjWeightsX, cjWeightsY, t, ulWeight, ulColor;
+  ULONG Blue, Green, Red;
+  BOOL bSrcXlate, bDstXlate;
+
+  if (!ColorTranslation ||
+      (DestSurf->iBitmapFormat != BMF_16BPP &&
+       DestSurf->iBitmapFormat != BMF_24BPP &&
+       DestSurf->iBitmapFormat != BMF_32BPP) ||
+      !StretchIsRowFormat(SourceSurf->iBitmapFormat))
+  {
+    return FALSE;
+  }
+
+  /* Monochrome sources take their colors from the DC, leave them alone */
+  pexlo = CONTAINING_RECORD(ColorTranslation, EXLATEOBJ, xlo);
+  if (pexlo->ppalSrc->flFlags & PAL_MONOCHROME)
+    return FALSE;
+
+  DstWidth = DestRect->right - DestRect->left;
+  DstHeight = DestRect->bottom - DestRect->top;
+  SrcWidth = SourceRect->right - SourceRect->left;
+  SrcHeight = SourceRect->bottom - SourceRect->top;
+  if (DstWidth <= 0 || DstHeight <= 0 || SrcWidth <= 0 || SrcHeight <= 0 ||
+      SourceRect->left < 0 || SourceRect->top < 0 ||
+      SourceRect->right > SourceSurf->sizlBitmap.cx ||
+      SourceRect->bottom > abs(SourceSurf->sizlBitmap.cy))
+  {
+    return FALSE;
+  }
+
+  cMaxTapsX = (SrcWidth > DstWidth) ? (SrcWidth + DstWidth - 1) / DstWidth + 1 : 2;
+  cMaxTapsY = (SrcHeight > DstHeight) ? (SrcHeight + DstHeight - 1) / DstHeight + 1 : 2;
+  cjWeightsX = ALIGN_UP_BY(DstWidth * cMaxTapsX * sizeof(USHORT), sizeof(ULONG));
+  cjWeightsY = ALIGN_UP_BY(DstHeight * cMaxTapsY * sizeof(USHORT), sizeof(ULONG));
+
+  pvBuffer = EngAllocMem(0,
+                         (DstWidth + DstHeight) * sizeof(STRETCH_TAPS) +
+                         cjWeightsX + cjWeightsY +
+                         (SrcWidth * 4 + DstWidth) * sizeof(ULONG),
+                         GDITAG_TEMP);
+  if (!pvBuffer)
+    return FALSE;
+
+  pTapsX = pvBuffer;
+  pTapsY = pTapsX + DstWidth;
+  pusWeightsX = (PUSHORT)(pTapsY + DstHeight);
+  pusWeightsY = (PUSHORT)((PBYTE)pusWeightsX + cjWeightsX);
+  pulAccum = (PULONG)((PBYTE)pusWeightsY + cjWeightsY);
+  pulSrcRow = pulAccum + SrcWidth * 3;
+  pulDstRow = pulSrcRow + SrcWidth;
+
+  StretchBuildTaps(SrcWidth, DstWidth, cMaxTapsX, pTapsX, pusWeightsX);
+  StretchBuildTaps(SrcHeight, DstHeight, cMaxTapsY, pTapsY, pusWeightsY);
+
+  EXLATEOBJ_vInitialize(&exloSrcBGR, pexlo->ppalSrc, &gpalBGR, 0, 0, 0);
+  EXLATEOBJ_vInitialize(&exloBGRDst, &gpalBGR, pexlo->ppalDst, 0, 0, 0);
+  bSrcXlate = !(exloSrcBGR.xlo.flXlate & XO_TRIVIAL);
+  bDstXlate = !(exloBGRDst.xlo.flXlate & XO_TRIVIAL);
+
+  for (y = 0; y < DstHeight; y++)
+  {
+    /* Vertical pass: weighted sum of the source rows into the accumulator */
+    RtlZeroMemory(pulAccum, SrcWidth * 3 * sizeof(ULONG));
+    pus = pusWeightsY + y * cMaxTapsY;
+    for (t = 0; t < pTapsY[y].cTaps; t++)
+    {
+      ulWeight = pus[t];
+      StretchReadRow(SourceSurf, SourceRect->top + pTapsY[y].iFirst + t,
+                     SourceRect->left, NULL, SrcWidth, pulSrcRow);
+
+      pulAcc = pulAccum;
+      for (x = 0; x < SrcWidth; x++, pulAcc += 3)
+      {
+        ulColor = bSrcXlate ? XLATEOBJ_iXlate(&exloSrcBGR.xlo, pulSrcRow[x]) : pulSrcRow[x];
+        pulAcc[0] += (ulColor & 0xFF) * ulWeight;
+        pulAcc[1] += ((ulColor >> 8) & 0xFF) * ulWeight;
+        pulAcc[2] += ((ulColor >> 16) & 0xFF) * ulWeight;
+      }
+    }
+
+    /* Keep 8 fractional bits, so the horizontal pass fits in 32 bits */
+    for (x = 0; x < SrcWidth * 3; x++)
+      pulAccum[x] = (pulAccum[x] + (1 << (STRETCH_WEIGHT_BITS - 9))) >> (STRETCH_WEIGHT_BITS - 8);
+
+    /* Horizontal pass */
+    for (x = 0; x < DstWidth; x++)
+    {
+      pulAcc = pulAccum + pTapsX[x].iFirst * 3;
+      pus = pusWeightsX + x * cMaxTapsX;
+      Blue = Green = Red = 0;
+      for (t = 0; t < pTapsX[x].cTaps; t++, pulAcc += 3)
+      {
+        Blue += pus[t] * pulAcc[0];
+        Green += pus[t] * pulAcc[1];
+        Red += pus[t] * pulAcc[2];
+      }
+
+      Blue = (Blue + (1 << (STRETCH_WEIGHT_BITS + 7))) >> (STRETCH_WEIGHT_BITS + 8);
+      Green = (Green + (1 << (STRETCH_WEIGHT_BITS + 7))) >> (STRETCH_WEIGHT_BITS + 8);
+      Red = (Red + (1 << (STRETCH_WEIGHT_BITS + 7))) >> (STRETCH_WEIGHT_BITS + 8);
+      ulColor = Blue | (Green << 8) | (Red << 16);
+      pulDstRow[x] = bDstXlate ? XLATEOBJ_iXlate(&exloBGRDst.xlo, ulColor) : ulColor;
+    }
+
+    StretchWriteRow(DestSurf, DestRect->left, DestRect->top + y, DstWidth, pulDstRow);
+  }
+
+  EXLATEOBJ_vCleanup(&exloBGRDst);
+  EXLATEOBJ_vCleanup(&exloSrcBGR);
+  EngFreeMem(pvBuffer);
+
+  return TRUE;
+}
+
 BOOLEAN DIB_XXBPP_StretchBlt(SURFOBJ *DestSurf, SURFOBJ *SourceSurf, SURFOBJ *MaskSurf,
                             SURFOBJ *PatternSurface,
                             RECTL *DestRect, RECTL *SourceRect,
                             POINTL *MaskOrigin, BRUSHOBJ *Brush,
                             POINTL *BrushOrigin, XLATEOBJ *ColorTranslation,
-                            ROP4 ROP)
+                            ROP4 ROP, ULONG iMode)
 {
   LONG sx = 0;
   LONG sy = 0;
@@ -50,6 +522,21 @@ BOOLEAN DIB_XXBPP_StretchBlt(SURFOBJ *DestSurf, SURFOBJ *SourceSurf, SURFOBJ *Ma
 
   ASSERT(IS_VALID_ROP4(ROP));
 
+  if (!MaskSurf)
+  {
+    if (iMode == HALFTONE && ROP == ROP4_FROM_INDEX(R3_OPINDEX_SRCCOPY) &&
+        StretchBltHalftone(DestSurf, SourceSurf, DestRect, SourceRect, ColorTranslation))
+    {
+      return TRUE;
+    }
+
+    if (StretchBltRows(DestSurf, SourceSurf, PatternSurface, DestRect, SourceRect,
+                       Brush, BrushOrigin, ColorTranslation, ROP))
+    {
+      return TRUE;
+    }
+  }
+
   fnDest_GetPixel = DibFunctionsForBitmapFormat[DestSurf->iBitmapFormat].DIB_GetPixel;
   fnDest_PutPixel = DibFunctionsForBitmapFormat[DestSurf->iBitmapFormat].DIB_PutPixel;
 
@@ -12,6 +12,98 @@
 
 #include "DibLib_AllDstBPP.h"
 
+/* Solid fills store whole rows instead of going through the pixel macros */
+VOID
+FASTCALL
+Dib_BitBlt_PATCOPY_Solid_D8(PBLTDATA pBltData)
+{
+    ULONG cLines = pBltData->ulHeight;
+    PBYTE pjDestBase = pBltData->siDst.pjBase;
+
+    while (cLines--)
+    {
+        memset(pjDestBase, (UCHAR)pBltData->ulSolidColor, pBltData->ulWidth);
+        pjDestBase += pBltData->siDst.cjAdvanceY;
+    }
+}
+
+VOID
+FASTCALL
+Dib_BitBlt_PATCOPY_Solid_D16(PBLTDATA pBltData)
+{
+    ULONG cLines = pBltData->ulHeight;
+    USHORT usColor = (USHORT)pBltData->ulSolidColor;
+    PBYTE pjDestBase = pBltData->siDst.pjBase;
+#if !defined(_M_IX86) && !defined(_M_AMD64)
+    PUSHORT pusDest;
+    ULONG cRows;
+#endif
+
+    while (cLines--)
+    {
+#if defined(_M_IX86) || defined(_M_AMD64)
+        __stosw((PUSHORT)pjDestBase, usColor, pBltData->ulWidth);
+#else
+        pusDest = (PUSHORT)pjDestBase;
+        for (cRows = pBltData->ulWidth; cRows > 0; cRows--)
+            *pusDest++ = usColor;
+#endif
+        pjDestBase += pBltData->siDst.cjAdvanceY;
+    }
+}
+
+VOID
+FASTCALL
+Dib_BitBlt_PATCOPY_Solid_D24(PBLTDATA pBltData)
+{
+    ULONG cLines = pBltData->ulHeight, cjWidth, cjDone, cjCopy;
+    PBYTE pjDestBase = pBltData->siDst.pjBase;
+
+    cjWidth = pBltData->ulWidth * 3;
+
+    while (cLines--)
+    {
+        /* Write the first pixel, then keep doubling what is already written */
+        _WritePixel_24(pjDestBase, 0, pBltData->ulSolidColor);
+        for (cjDone = 3; cjDone < cjWidth; cjDone += cjCopy)
+        {
+            cjCopy = min(cjDone, cjWidth - cjDone);
+            memcpy(pjDestBase + cjDone, pjDestBase, cjCopy);
+        }
+        pjDestBase += pBltData->siDst.cjAdvanceY;
+    }
+}
+
+VOID
+FASTCALL
+Dib_BitBlt_PATCOPY_Solid_D32(PBLTDATA pBltData)
+{
+    ULONG cLines = pBltData->ulHeight;
+    ULONG ulColor = pBltData->ulSolidColor;
+    PBYTE pjDestBase = pBltData->siDst.pjBase;
+#if !defined(_M_IX86) && !defined(_M_AMD64)
+    PULONG pulDest;
+    ULONG cRows;
+#endif
+
+    while (cLines--)
+    {
+#if defined(_M_IX86) || defined(_M_AMD64)
+        __stosd((PULONG)pjDestBase, ulColor, pBltData->ulWidth);
+#else
+        pulDest = (PULONG)pjDestBase;
+        for (cRows = pBltData->ulWidth; cRows > 0; cRows--)
+            *pulDest++ = ulColor;
+#endif
+        pjDestBase += pBltData->siDst.cjAdvanceY;
+    }
+}
+
+#define Dib_BitBlt_PATCOPY_Solid_D8_manual 1
+#define Dib_BitBlt_PATCOPY_Solid_D16_manual 1
+#define Dib_BitBlt_PATCOPY_Solid_D24_manual 1
+#define Dib_BitBlt_PATCOPY_Solid_D32_manual 1
+
 #undef __FUNCTIONNAME
 #define __FUNCTIONNAME BitBlt_PATCOPY_Solid
 #define __USES_SOLID_BRUSH 1
@@ -1,6 +1,10 @@
 
 #include "DibLib.h"
 
+#if defined(_M_AMD64)
+#include <emmintrin.h>
+#endif
+
 VOID
 FASTCALL
 Dib_BitBlt_SRCCOPY_EqSurf(PBLTDATA pBltData)
@@ -16,7 +20,8 @@ Dib_BitBlt_SRCCOPY_EqSurf(PBLTDATA pBltData)
     cLines = pBltData->ulHeight;
     while (cLines--)
     {
-        memcpy(pjDestBase, pjSrcBase, cjWidth);
+        /* Source and target can overlap on the same surface */
+        memmove(pjDestBase, pjSrcBase, cjWidth);
         pjDestBase += pBltData->siDst.cjAdvanceY;
         pjSrcBase += pBltData->siSrc.cjAdvanceY;
     }
@@ -65,10 +70,307 @@ Dib_BitBlt_SRCCOPY_S32_D32_EqSurf(PBLTDATA pBltData)
 
 #include "DibLib_AllSrcBPP.h"
 
+/* Conversions between BGR and 555 / 565, same as the XLATEOBJ functions */
+#define _BGRto555(ulColor) ((((ulColor) >> 3) & 0x1F) | (((ulColor) >> 6) & 0x3E0) | (((ulColor) >> 9) & 0x7C00))
+#define _BGRto565(ulColor) ((((ulColor) >> 3) & 0x1F) | (((ulColor) >> 5) & 0x7E0) | (((ulColor) >> 8) & 0xF800))
+#define _555toBGR(ulColor) (gajXlate5to8[(ulColor) & 0x1F] | \
+                            (gajXlate5to8[((ulColor) >> 5) & 0x1F] << 8) | \
+                            (gajXlate5to8[((ulColor) >> 10) & 0x1F] << 16))
+#define _565toBGR(ulColor) (gajXlate5to8[(ulColor) & 0x1F] | \
+                            (gajXlate6to8[((ulColor) >> 5) & 0x3F] << 8) | \
+                            (gajXlate5to8[((ulColor) >> 11) & 0x1F] << 16))
+
+/* SSE2 is part of the amd64 baseline and the XMM registers may be used in
+   kernel mode there. The i386 build keeps to the generic versions. */
+#if defined(_M_AMD64)
+static
+VOID
+Dib_PackRows_BGRto16(PBLTDATA pBltData, BOOL b565)
+{
+    ULONG cLines, cRows, ulColor;
+    PULONG pulSource;
+    PUSHORT pusDest;
+    PBYTE pjDestBase = pBltData->siDst.pjBase;
+    PBYTE pjSrcBase = pBltData->siSrc.pjBase;
+    const __m128i BlueMask = _mm_set1_epi32(0x1F);
+    const __m128i GreenMask = _mm_set1_epi32(b565 ? 0x7E0 : 0x3E0);
+    const __m128i RedMask = _mm_set1_epi32(b565 ? 0xF800 : 0x7C00);
+    const __m128i GreenShift = _mm_cvtsi32_si128(b565 ? 5 : 6);
+    const __m128i RedShift = _mm_cvtsi32_si128(b565 ? 8 : 9);
+    __m128i Lo, Hi;
+
+#define PACK_BGR(x) \
+    _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32((x), 3), BlueMask), \
+                              _mm_and_si128(_mm_srl_epi32((x), GreenShift), GreenMask)), \
+                 _mm_and_si128(_mm_srl_epi32((x), RedShift), RedMask))
+
+    /* Loop all lines */
+    cLines = pBltData->ulHeight;
+    while (cLines--)
+    {
+        pulSource = (PULONG)pjSrcBase;
+        pusDest = (PUSHORT)pjDestBase;
+
+        /* Convert 8 pixels at a time */
+        for (cRows = pBltData->ulWidth; cRows >= 8; cRows -= 8)
+        {
+            Lo = PACK_BGR(_mm_loadu_si128((__m128i*)pulSource));
+            Hi = PACK_BGR(_mm_loadu_si128((__m128i*)(pulSource + 4)));
+
+            /* Sign extend the 16 bit values, so that the saturating pack keeps them */
+            Lo = _mm_srai_epi32(_mm_slli_epi32(Lo, 16), 16);
+            Hi = _mm_srai_epi32(_mm_slli_epi32(Hi, 16), 16);
+            _mm_storeu_si128((__m128i*)pusDest, _mm_packs_epi32(Lo, Hi));
+
+            pulSource += 8;
+            pusDest += 8;
+        }
+
+        /* Do the rest pixel by pixel */
+        while (cRows--)
+        {
+            ulColor = *pulSource++;
+            *pusDest++ = (USHORT)(b565 ? _BGRto565(ulColor) : _BGRto555(ulColor));
+        }
+
+        pjDestBase += pBltData->siDst.cjAdvanceY;
+        pjSrcBase += pBltData->siSrc.cjAdvanceY;
+    }
+
+#undef PACK_BGR
+}
+
+VOID
+FASTCALL
+Dib_BitBlt_SRCCOPY_BGRto555_S32_D16(PBLTDATA pBltData)
+{
+    Dib_PackRows_BGRto16(pBltData, FALSE);
+}
+
+VOID
+FASTCALL
+Dib_BitBlt_SRCCOPY_BGRto565_S32_D16(PBLTDATA pBltData)
+{
+    Dib_PackRows_BGRto16(pBltData, TRUE);
+}
+
+#define Dib_BitBlt_SRCCOPY_BGRto555_S32_D16_manual 1
+#define Dib_BitBlt_SRCCOPY_BGRto565_S32_D16_manual 1
+#endif
+
+#undef __DIB_FUNCTION_NAME
+#define __DIB_FUNCTION_NAME __DIB_FUNCTION_NAME_SRCDST
+
+/* Indexed sources, translated with a table that is built once per call */
+#undef __FUNCTIONNAME
+#define __FUNCTIONNAME BitBlt_SRCCOPY_Table
+#undef _DibXlate
+#define _DibXlate(pBltData, ulColor) ((pBltData)->pulXlate[ulColor])
+
+#define _SOURCE_BPP 1
+#include "DibLib_AllDstBPP.h"
+#undef _SOURCE_BPP
+
+#define _SOURCE_BPP 4
+#include "DibLib_AllDstBPP.h"
+#undef _SOURCE_BPP
+
+#define _SOURCE_BPP 8
+#include "DibLib_AllDstBPP.h"
+#undef _SOURCE_BPP
+
+/* 24 <-> 32 bpp without translation */
+#undef __FUNCTIONNAME
+#define __FUNCTIONNAME BitBlt_SRCCOPY_Trivial
+#undef _DibXlate
+#define _DibXlate(pBltData, ulColor) (ulColor)
+
+#define _SOURCE_BPP 24
+#define _DEST_BPP 32
+#include "DibLib_BitBlt.h"
+#undef _SOURCE_BPP
+#undef _DEST_BPP
+
+#define _SOURCE_BPP 32
+#define _DEST_BPP 24
+#include "DibLib_BitBlt.h"
+#undef _SOURCE_BPP
+#undef _DEST_BPP
+
+/* BGR to 555 / 565 */
+#undef __FUNCTIONNAME
+#define __FUNCTIONNAME BitBlt_SRCCOPY_BGRto555
+#undef _DibXlate
+#define _DibXlate(pBltData, ulColor) _BGRto555(ulColor)
+#define _DEST_BPP 16
+
+#define _SOURCE_BPP 24
+#include "DibLib_BitBlt.h"
+#undef _SOURCE_BPP
+
+#define _SOURCE_BPP 32
+#include "DibLib_BitBlt.h"
+#undef _SOURCE_BPP
+
+#undef __FUNCTIONNAME
+#define __FUNCTIONNAME BitBlt_SRCCOPY_BGRto565
+#undef _DibXlate
+#define _DibXlate(pBltData, ulColor) _BGRto565(ulColor)
+
+#define _SOURCE_BPP 24
+#include "DibLib_BitBlt.h"
+#undef _SOURCE_BPP
+
+#define _SOURCE_BPP 32
+#include "DibLib_BitBlt.h"
+#undef _SOURCE_BPP
+
+#undef _DEST_BPP
+
+/* 555 / 565 to BGR */
+#define _SOURCE_BPP 16
+
+#undef __FUNCTIONNAME
+#define __FUNCTIONNAME BitBlt_SRCCOPY_555toBGR
+#undef _DibXlate
+#define _DibXlate(pBltData, ulColor) _555toBGR(ulColor)
+
+#define _DEST_BPP 24
+#include "DibLib_BitBlt.h"
+#undef _DEST_BPP
+
+#define _DEST_BPP 32
+#include "DibLib_BitBlt.h"
+#undef _DEST_BPP
+
+#undef __FUNCTIONNAME
+#define __FUNCTIONNAME BitBlt_SRCCOPY_565toBGR
+#undef _DibXlate
+#define _DibXlate(pBltData, ulColor) _565toBGR(ulColor)
+
+#define _DEST_BPP 24
+#include "DibLib_BitBlt.h"
+#undef _DEST_BPP
+
+#define _DEST_BPP 32
+#include "DibLib_BitBlt.h"
+#undef _DEST_BPP
+
+#undef _SOURCE_BPP
+#undef _DibXlate
+#define _DibXlate(pBltData, ulColor) (pBltData->pfnXlate(pBltData->pxlo, ulColor))
+#undef __DIB_FUNCTION_NAME
+
+static
+PFN_DIBFUNCTION
+gapfnBitBlt_SRCCOPY_Table[7][4] =
+{
+    {0, 0, 0, 0},
+    {0, Dib_BitBlt_SRCCOPY_Table_S1_D1, Dib_BitBlt_SRCCOPY_Table_S4_D1, Dib_BitBlt_SRCCOPY_Table_S8_D1},
+    {0, Dib_BitBlt_SRCCOPY_Table_S1_D4, Dib_BitBlt_SRCCOPY_Table_S4_D4, Dib_BitBlt_SRCCOPY_Table_S8_D4},
+    {0, Dib_BitBlt_SRCCOPY_Table_S1_D8, Dib_BitBlt_SRCCOPY_Table_S4_D8, Dib_BitBlt_SRCCOPY_Table_S8_D8},
+    {0, Dib_BitBlt_SRCCOPY_Table_S1_D16, Dib_BitBlt_SRCCOPY_Table_S4_D16, Dib_BitBlt_SRCCOPY_Table_S8_D16},
+    {0, Dib_BitBlt_SRCCOPY_Table_S1_D24, Dib_BitBlt_SRCCOPY_Table_S4_D24, Dib_BitBlt_SRCCOPY_Table_S8_D24},
+    {0, Dib_BitBlt_SRCCOPY_Table_S1_D32, Dib_BitBlt_SRCCOPY_Table_S4_D32, Dib_BitBlt_SRCCOPY_Table_S8_D32},
+};
+
+/* Returns a version that does the translation without calling pfnXlate */
+static
+PFN_DIBFUNCTION
+Dib_SrcCopyConversion(PBLTDATA pBltData)
+{
+    ULONG iSrcFormat = pBltData->siSrc.iFormat;
+    ULONG iDstFormat = pBltData->siDst.iFormat;
+
+    switch (pBltData->iXlateType)
+    {
+        case DIB_XLATE_TRIVIAL:
+            if (iSrcFormat == BMF_24BPP && iDstFormat == BMF_32BPP)
+                return Dib_BitBlt_SRCCOPY_Trivial_S24_D32;
+            if (iSrcFormat == BMF_32BPP && iDstFormat == BMF_24BPP)
+                return Dib_BitBlt_SRCCOPY_Trivial_S32_D24;
+            break;
+
+        case DIB_XLATE_BGR_TO_555:
+            if (iDstFormat != BMF_16BPP)
+                break;
+            if (iSrcFormat == BMF_24BPP)
+                return Dib_BitBlt_SRCCOPY_BGRto555_S24_D16;
+            if (iSrcFormat == BMF_32BPP)
+                return Dib_BitBlt_SRCCOPY_BGRto555_S32_D16;
+            break;
+
+        case DIB_XLATE_BGR_TO_565:
+            if (iDstFormat != BMF_16BPP)
+                break;
+            if (iSrcFormat == BMF_24BPP)
+                return Dib_BitBlt_SRCCOPY_BGRto565_S24_D16;
+            if (iSrcFormat == BMF_32BPP)
+                return Dib_BitBlt_SRCCOPY_BGRto565_S32_D16;
+            break;
+
+        case DIB_XLATE_555_TO_BGR:
+            if (iSrcFormat != BMF_16BPP)
+                break;
+            if (iDstFormat == BMF_24BPP)
+                return Dib_BitBlt_SRCCOPY_555toBGR_S16_D24;
+            if (iDstFormat == BMF_32BPP)
+                return Dib_BitBlt_SRCCOPY_555toBGR_S16_D32;
+            break;
+
+        case DIB_XLATE_565_TO_BGR:
+            if (iSrcFormat != BMF_16BPP)
+                break;
+            if (iDstFormat == BMF_24BPP)
+                return Dib_BitBlt_SRCCOPY_565toBGR_S16_D24;
+            if (iDstFormat == BMF_32BPP)
+                return Dib_BitBlt_SRCCOPY_565toBGR_S16_D32;
+            break;
+    }
+
+    return NULL;
+}
+
 VOID
 FASTCALL
 Dib_BitBlt_SRCCOPY(PBLTDATA pBltData)
 {
+    ULONG iSrcFormat = pBltData->siSrc.iFormat;
+    ULONG iDstFormat = pBltData->siDst.iFormat;
+    ULONG aulXlate[256], i, cEntries;
+    PFN_DIBFUNCTION pfnSrcCopy;
+
+    /* Without translation, equal formats only need to copy the rows */
+    if ((iSrcFormat == iDstFormat) && (pBltData->iXlateType == DIB_XLATE_TRIVIAL))
+    {
+        gapfnBitBlt_SRCCOPY[iDstFormat][0](pBltData);
+        return;
+    }
+
+    /* Translate indexed sources through a table, unless there are fewer
+       pixels to copy than table entries */
+    if ((iSrcFormat >= BMF_1BPP) && (iSrcFormat <= BMF_8BPP) && (iDstFormat != 0))
+    {
+        cEntries = 1 << pBltData->siSrc.jBpp;
+        if (pBltData->ulWidth * pBltData->ulHeight >= cEntries)
+        {
+            for (i = 0; i < cEntries; i++)
+                aulXlate[i] = pBltData->pfnXlate(pBltData->pxlo, i);
+
+            pBltData->pulXlate = aulXlate;
+            gapfnBitBlt_SRCCOPY_Table[iDstFormat][iSrcFormat](pBltData);
+            pBltData->pulXlate = NULL;
+            return;
+        }
+    }
+
+    /* Check for a known color conversion */
+    pfnSrcCopy = Dib_SrcCopyConversion(pBltData);
+    if (pfnSrcCopy)
+    {
+        pfnSrcCopy(pBltData);
+        return;
+    }
+
     gapfnBitBlt_SRCCOPY[pBltData->siDst.iFormat][pBltData->siSrc.iFormat](pBltData);
 }
-
@@ -3,12 +3,17 @@
 #pragma warning(disable:4711)
 #endif
 
+#ifdef _DIBLIB_HOST
+/* Built as a host library by tools/diblibbench */
+#include <diblib_host.h>
+#else
 #define FASTCALL __fastcall
 
 #include <stdarg.h>
 #include <windef.h>
 #include <wingdi.h>
 #include <winddi.h>
+#endif
 
 #ifdef _OPTIMIZE_DIBLIB
 #ifdef _MSC_VER
@@ -23,6 +28,8 @@ ULONG
 (FASTCALL *PFN_XLATE)(XLATEOBJ* pxlo, ULONG ulColor);
 
 extern const BYTE ajShift4[2];
+extern const BYTE gajXlate5to8[32];
+extern const BYTE gajXlate6to8[64];
 
 #include "DibLib_interface.h"
 
@@ -41,16 +48,16 @@ extern const BYTE ajShift4[2];
 #define __DIB_FUNCTION_NAME_SRCDSTEQR2L(name, src_bpp, dst_bpp) __PASTE(__DIB_FUNCTION_NAME_SRCDST2(name, src_bpp, dst_bpp), _EqSurfR2L)
 
 #define _ReadPixel_1(pjSource, jShift) (((*(pjSource)) >> (jShift)) & 1)
-#define _WritePixel_1(pjDest, jShift, ulColor) (void)(*(pjDest) = (UCHAR)((*(pjDest) & ~(1<<(jShift))) | ((ulColor)<<(jShift))))
+#define _WritePixel_1(pjDest, jShift, ulColor) (void)(*(pjDest) = (UCHAR)((*(pjDest) & ~(1<<(jShift))) | (((ulColor) & 1)<<(jShift))))
 #define _NextPixel_1(ppj, pjShift)    (void)(((*(pjShift))--), (*(pjShift) &= 7), (*(ppj) += (*(pjShift) == 7)))
 #define _NextPixelR2L_1(ppj, pjShift) (void)(((*(pjShift))++), (*(pjShift) &= 7), (*(ppj) -= (*(pjShift) == 0)))
 #define _SHIFT_1(x) x
 #define _CALCSHIFT_1(pShift, x) (void)(*(pShift) = (7 - ((x) & 7)))
 
 #define _ReadPixel_4(pjSource, jShift) (((*(pjSource)) >> (jShift)) & 15)
-#define _WritePixel_4(pjDest, jShift, ulColor) (void)(*(pjDest) = (UCHAR)((*(pjDest) & ~(15<<(jShift))) | ((ulColor)<<(jShift))))
-#define _NextPixel_4(ppj, pjShift) (void)((*(ppj) += (*(pjShift) & 1)), (*(pjShift)) -= 4, *(pjShift) &= 7)
-#define _NextPixelR2L_4(ppj, pjShift) (void)((*(pjShift)) -= 4, *(pjShift) &= 7, (*(ppj) -= (*(pjShift) & 1)))
+#define _WritePixel_4(pjDest, jShift, ulColor) (void)(*(pjDest) = (UCHAR)((*(pjDest) & ~(15<<(jShift))) | (((ulColor) & 15)<<(jShift))))
+#define _NextPixel_4(ppj, pjShift) (void)((*(ppj) += (*(pjShift) == 0)), (*(pjShift)) -= 4, *(pjShift) &= 7)
+#define _NextPixelR2L_4(ppj, pjShift) (void)((*(pjShift)) -= 4, *(pjShift) &= 7, (*(ppj) -= (*(pjShift) == 0)))
 #define _SHIFT_4(x) x
 #define _CALCSHIFT_4(pShift, x) (void)(*(pShift) = ajShift4[(x) & 1])
 
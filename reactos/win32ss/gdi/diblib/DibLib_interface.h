@@ -12,6 +12,18 @@ typedef struct
     BYTE jBpp;
 } SURFINFO;
 
+/* Color translations the caller has identified, so that SRCCOPY can do
+   them row by row instead of calling pfnXlate for every pixel */
+enum
+{
+    DIB_XLATE_OTHER,
+    DIB_XLATE_TRIVIAL,
+    DIB_XLATE_BGR_TO_555,
+    DIB_XLATE_BGR_TO_565,
+    DIB_XLATE_555_TO_BGR,
+    DIB_XLATE_565_TO_BGR,
+};
+
 typedef struct
 {
     SURFINFO siSrc;
@@ -25,6 +37,8 @@ typedef struct
     ULONG ulPatHeight;
     XLATEOBJ *pxlo;
     PFN_XLATE pfnXlate;
+    ULONG iXlateType;
+    const ULONG *pulXlate;
     ULONG rop4;
     PFN_DOROP apfnDoRop[2];
     ULONG ulSolidColor;
@@ -1,8 +1,6 @@
 
 #include "DibLib.h"
 
-#define FASTCALL __fastcall
-
 ULONG FASTCALL DoRop_0(ULONG D, ULONG S, ULONG P)
 {
     return ROP_0(D,S,P);
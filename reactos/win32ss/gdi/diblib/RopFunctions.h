@@ -1,7 +1,7 @@
 
 typedef
 ULONG
-(__fastcall
+(FASTCALL
 *PFN_DOROP)(ULONG D, ULONG S, ULONG P);
 
 extern const PFN_DOROP gapfnRop[256];
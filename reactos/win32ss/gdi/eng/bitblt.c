@@ -600,6 +600,7 @@ IntEngBitBlt(
     BOOL bResult;
     RECTL rclClipped;
     RECTL rclSrc;
+    RECTL rclBounds;
     POINTL ptlBrush;
     PFN_DrvBitBlt pfnBitBlt;
 
@@ -682,6 +683,14 @@ IntEngBitBlt(
         pfnBitBlt = EngBitBlt;
     }
 
+    /* Narrow the clip bounds to what we draw, so that enumerating a
+       complex region skips the bands that are not touched */
+    if (pco && pco->iDComplexity == DC_COMPLEX)
+    {
+        rclBounds = pco->rclBounds;
+        pco->rclBounds = rclClipped;
+    }
+
     bResult = pfnBitBlt(psoTrg,
                         psoSrc,
                         psoMask,
@@ -694,6 +703,9 @@ IntEngBitBlt(
                         pptlBrush ? &ptlBrush : NULL,
                         Rop4);
 
+    if (pco && pco->iDComplexity == DC_COMPLEX)
+        pco->rclBounds = rclBounds;
+
     // FIXME: cleanup temp surface!
 
     return bResult;
@@ -703,6 +715,62 @@ IntEngBitBlt(
 
 /**** REACTOS FONT RENDERING CODE *********************************************/
 
+/* Blends a solid color into a surface with 8 bits per channel. The blend is
+   the same for every channel, so it is done in the surface's own channel
+   order, without translating every pixel to RGB and back */
+static VOID
+AlphaBltMaskRGB(SURFOBJ* psoDest,
+                SURFOBJ* psoMask,
+                RECTL* prclDest,
+                POINTL* pptlMask,
+                ULONG iSolidColor)
+{
+    LONG i, j, dx, dy;
+    ULONG cjPixel, c;
+    INT aiColor[3];
+    BYTE *pjMaskLine, *pjDestLine, *pjMask, *pjDest;
+
+    cjPixel = (psoDest->iBitmapFormat == BMF_32BPP) ? 4 : 3;
+    aiColor[0] = iSolidColor & 0xff;
+    aiColor[1] = (iSolidColor >> 8) & 0xff;
+    aiColor[2] = (iSolidColor >> 16) & 0xff;
+
+    dx = prclDest->right  - prclDest->left;
+    dy = prclDest->bottom - prclDest->top;
+
+    pjMaskLine = (PBYTE)psoMask->pvScan0 + (pptlMask->y * psoMask->lDelta) + pptlMask->x;
+    pjDestLine = (PBYTE)psoDest->pvScan0 + (prclDest->top * psoDest->lDelta) +
+                 (prclDest->left * cjPixel);
+
+    for (j = 0; j < dy; j++)
+    {
+        pjMask = pjMaskLine;
+        pjDest = pjDestLine;
+        for (i = 0; i < dx; i++)
+        {
+            if (*pjMask == 0xff)
+            {
+                pjDest[0] = (BYTE)aiColor[0];
+                pjDest[1] = (BYTE)aiColor[1];
+                pjDest[2] = (BYTE)aiColor[2];
+                if (cjPixel == 4) pjDest[3] = (BYTE)(iSolidColor >> 24);
+            }
+            else if (*pjMask > 0)
+            {
+                for (c = 0; c < 3; c++)
+                {
+                    pjDest[c] = (BYTE)((*pjMask * (aiColor[c] - pjDest[c]) >> 8) + pjDest[c]);
+                }
+                if (cjPixel == 4) pjDest[3] = 0;
+            }
+            pjMask++;
+            pjDest += cjPixel;
+        }
+        pjMaskLine += psoMask->lDelta;
+        pjDestLine += psoDest->lDelta;
+    }
+}
+
 /* renders the alpha mask bitmap */
 static BOOLEAN APIENTRY
 AlphaBltMask(SURFOBJ* psoDest,
@@ -720,6 +788,7 @@ AlphaBltMask(SURFOBJ* psoDest,
     int r, g, b;
     ULONG Background, BrushColor, NewColor;
     BYTE *tMask, *lMask;
+    PPALETTE ppalDest;
 
     ASSERT(psoSource == NULL);
     ASSERT(pptlSource == NULL);
@@ -729,6 +798,15 @@ AlphaBltMask(SURFOBJ* psoDest,
 
     if (psoMask != NULL)
     {
+        /* 24 and 32 bpp surfaces with 8 bit RGB or BGR channels are blended directly */
+        ppalDest = pxloBrush ? ((PEXLATEOBJ)pxloBrush)->ppalSrc : NULL;
+        if ((psoDest->iBitmapFormat == BMF_24BPP || psoDest->iBitmapFormat == BMF_32BPP) &&
+            ppalDest && (ppalDest->flFlags & (PAL_RGB | PAL_BGR)))
+        {
+            AlphaBltMaskRGB(psoDest, psoMask, prclDest, pptlMask, pbo ? pbo->iSolidColor : 0);
+            return TRUE;
+        }
+
         BrushColor = XLATEOBJ_iXlate(pxloBrush, pbo ? pbo->iSolidColor : 0);
         r = (int)GetRValue(BrushColor);
         g = (int)GetGValue(BrushColor);
@@ -95,6 +95,28 @@ CalculateCoordinates(
     }
 }
 
+static
+ULONG
+GetXlateType(
+    _In_ XLATEOBJ *pxlo)
+{
+    PFN_XLATE pfnXlate = XLATEOBJ_pfnXlate(pxlo);
+
+    /* Identify the translations that diblib can do row by row */
+    if ((pxlo->flXlate & XO_TRIVIAL) || (pfnXlate == EXLATEOBJ_iXlateTrivial))
+        return DIB_XLATE_TRIVIAL;
+    if (pfnXlate == EXLATEOBJ_iXlateBGRto555)
+        return DIB_XLATE_BGR_TO_555;
+    if (pfnXlate == EXLATEOBJ_iXlateBGRto565)
+        return DIB_XLATE_BGR_TO_565;
+    if (pfnXlate == EXLATEOBJ_iXlate555toBGR)
+        return DIB_XLATE_555_TO_BGR;
+    if (pfnXlate == EXLATEOBJ_iXlate565toBGR)
+        return DIB_XLATE_565_TO_BGR;
+
+    return DIB_XLATE_OTHER;
+}
+
 BOOL
 APIENTRY
 EngBitBlt(
@@ -141,6 +163,8 @@ EngBitBlt(
     if (!pxlo) pxlo = &gexloTrivial.xlo;
     bltdata.pxlo = pxlo;
     bltdata.pfnXlate = XLATEOBJ_pfnXlate(pxlo);
+    bltdata.iXlateType = GetXlateType(pxlo);
+    bltdata.pulXlate = NULL;
 
     /* Check if the ROP uses a source */
     if (ROP4_USES_SOURCE(rop4))
@@ -384,7 +408,7 @@ IntEngBitBlt(
     _In_ ROP4 rop4)
 {
     BOOL bResult;
-    RECTL rcClipped;
+    RECTL rcClipped, rclBounds;
     POINTL ptOffset, ptSrc, ptMask, ptBrush;
     SIZEL sizTrg;
     PFN_DrvBitBlt pfnBitBlt;
@@ -514,6 +538,14 @@ IntEngBitBlt(
         pfnBitBlt = EngBitBlt;
     }
 
+    /* Narrow the clip bounds to what we draw, so that enumerating a
+       complex region skips the bands that are not touched */
+    if (pco->iDComplexity == DC_COMPLEX)
+    {
+        rclBounds = pco->rclBounds;
+        pco->rclBounds = rcClipped;
+    }
+
     bResult = pfnBitBlt(psoTrg,
                         psoSrc,
                         psoMask,
@@ -526,6 +558,9 @@ IntEngBitBlt(
                         pptlBrush ? &ptBrush : NULL,
                         rop4);
 
+    if (pco->iDComplexity == DC_COMPLEX)
+        pco->rclBounds = rclBounds;
+
     // FIXME: cleanup temp surface!
 
     return bResult;
@@ -214,6 +214,55 @@ IntEngUpdateClipRegion(
     }
 }
 
+/*
+ * The rectangles come from a region, so they are in y-x banded order and
+ * bands don't overlap. Sorted top-down (CD_ANY keeps the region order, which
+ * is CD_RIGHTDOWN) both top and bottom grow along the array, sorted bottom-up
+ * they both shrink. Either way, the rectangles touching a range of scanlines
+ * are one contiguous run that can be found by binary search.
+ */
+static
+VOID
+IntEngClipFindRun(
+    _In_ XCLIPOBJ *Clip,
+    _In_ const RECTL *prclBounds,
+    _Out_ ULONG *piFirst,
+    _Out_ ULONG *piEnd)
+{
+    const RECTL *prcl = Clip->Rects;
+    ULONG iLow, iHigh, iMid;
+    BOOL bDown = (Clip->EnumOrder == CD_ANY ||
+                  Clip->EnumOrder == CD_RIGHTDOWN ||
+                  Clip->EnumOrder == CD_LEFTDOWN);
+
+    /* Skip the rectangles that come before the bounds */
+    iLow = 0;
+    iHigh = Clip->RectCount;
+    while (iLow < iHigh)
+    {
+        iMid = iLow + (iHigh - iLow) / 2;
+        if (bDown ? (prcl[iMid].bottom <= prclBounds->top)
+                  : (prcl[iMid].top >= prclBounds->bottom))
+            iLow = iMid + 1;
+        else
+            iHigh = iMid;
+    }
+    *piFirst = iLow;
+
+    /* And the ones after them */
+    iHigh = Clip->RectCount;
+    while (iLow < iHigh)
+    {
+        iMid = iLow + (iHigh - iLow) / 2;
+        if (bDown ? (prcl[iMid].top < prclBounds->bottom)
+                  : (prcl[iMid].bottom > prclBounds->top))
+            iLow = iMid + 1;
+        else
+            iHigh = iMid;
+    }
+    *piEnd = iLow;
+}
+
 /*
  * @implemented
  */
@@ -261,9 +310,7 @@ CLIPOBJ_cEnumStart(
 {
     XCLIPOBJ* Clip = CONTAINING_RECORD(pco, XCLIPOBJ, ClipObj);
     SORTCOMP CompareFunc;
-
-    Clip->EnumPos = 0;
-    Clip->EnumMax = (cMaxRects > 0) ? cMaxRects : Clip->RectCount;
+    ULONG iFirst, iEnd;
 
     if (CD_ANY != iDirection && Clip->EnumOrder != iDirection)
     {
@@ -300,13 +347,33 @@ CLIPOBJ_cEnumStart(
         Clip->EnumOrder = iDirection;
     }
 
+    /* Unless the caller wants the whole region, leave out what lies
+       outside the bounds. The engine narrows them to the drawing. */
+    if (!bAll && (Clip->RectCount > 1))
+    {
+        IntEngClipFindRun(Clip, &pco->rclBounds, &iFirst, &iEnd);
+    }
+    else
+    {
+        iFirst = 0;
+        iEnd = Clip->RectCount;
+    }
+
+    /* EnumMax is where the enumeration stops */
+    Clip->EnumPos = iFirst;
+    Clip->EnumMax = iEnd;
+    if ((cMaxRects > 0) && (iEnd - iFirst > cMaxRects))
+    {
+        Clip->EnumMax = iFirst + cMaxRects;
+    }
+
     /* Return the number of rectangles enumerated */
-    if ((cMaxRects > 0) && (Clip->RectCount > cMaxRects))
+    if ((cMaxRects > 0) && (iEnd - iFirst > cMaxRects))
     {
         return 0xFFFFFFFF;
     }
 
-    return Clip->RectCount;
+    return iEnd - iFirst;
 }
 
 /*
@@ -326,8 +393,11 @@ CLIPOBJ_bEnum(
 
     // Calculate how many rectangles we should copy
     nCopy = min( Clip->EnumMax - Clip->EnumPos,
-            min( Clip->RectCount - Clip->EnumPos,
-            (cj - sizeof(ULONG)) / sizeof(RECTL)));
+            (cj - sizeof(ULONG)) / sizeof(RECTL));
+
+    /* Callers read the count even when we return FALSE, the run can be
+       empty when nothing lies within the bounds */
+    pERects->c = nCopy;
 
     if(nCopy == 0)
     {
@@ -338,11 +408,9 @@ CLIPOBJ_bEnum(
     src = &Clip->Rects[Clip->EnumPos];
     RtlCopyMemory(pERects->arcl, src, nCopy * sizeof(RECTL));
 
-    pERects->c = nCopy;
-
     Clip->EnumPos+=nCopy;
 
-    return Clip->EnumPos < Clip->RectCount;
+    return Clip->EnumPos < Clip->EnumMax;
 }
 
 /* EOF */
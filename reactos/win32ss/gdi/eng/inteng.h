@@ -87,12 +87,13 @@ IntEngStretchBlt(SURFOBJ *DestObj,
                  CLIPOBJ *ClipRegion,
                  XLATEOBJ *ColorTranslation,
                  COLORADJUSTMENT *pca,
+                 ULONG iMode,
                  RECTL *DestRect,
                  RECTL *SourceRect,
                  POINTL *pMaskOrigin,
                  BRUSHOBJ *Brush,
                  POINTL *BrushOrigin,
-                 ULONG Mode);
+                 ROP4 Rop4);
 
 BOOL APIENTRY
 IntEngGradientFill(SURFOBJ *psoDest,
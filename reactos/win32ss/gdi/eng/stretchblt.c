@@ -20,7 +20,8 @@ typedef BOOLEAN (APIENTRY *PSTRETCHRECTFUNC)(SURFOBJ* OutputObj,
                                             POINTL* MaskOrigin,
                                             BRUSHOBJ* pbo,
                                             POINTL* BrushOrigin,
-                                            ROP4 Rop4);
+                                            ROP4 Rop4,
+                                            ULONG iMode);
 
 static BOOLEAN APIENTRY
 CallDibStretchBlt(SURFOBJ* psoDest,
@@ -32,7 +33,8 @@ CallDibStretchBlt(SURFOBJ* psoDest,
                   POINTL* MaskOrigin,
                   BRUSHOBJ* pbo,
                   POINTL* BrushOrigin,
-                  ROP4 Rop4)
+                  ROP4 Rop4,
+                  ULONG iMode)
 {
     POINTL RealBrushOrigin;
     SURFOBJ* psoPattern;
@@ -62,7 +64,7 @@ CallDibStretchBlt(SURFOBJ* psoDest,
     bResult = DibFunctionsForBitmapFormat[psoDest->iBitmapFormat].DIB_StretchBlt(
                psoDest, psoSource, Mask, psoPattern,
                OutputRect, InputRect, MaskOrigin, pbo, &RealBrushOrigin,
-               ColorTranslation, Rop4);
+               ColorTranslation, Rop4, iMode);
 
     return bResult;
 }
@@ -242,7 +244,7 @@ EngStretchBltROP(
         case DC_TRIVIAL:
             Ret = (*BltRectFunc)(psoOutput, psoInput, Mask,
                          ColorTranslation, &OutputRect, &InputRect, MaskOrigin,
-                         pbo, &AdjustedBrushOrigin, Rop4);
+                         pbo, &AdjustedBrushOrigin, Rop4, Mode);
             break;
         case DC_RECT:
             // Clip the blt to the clip rectangle
@@ -263,7 +265,8 @@ EngStretchBltROP(
                            MaskOrigin,
                            pbo,
                            &AdjustedBrushOrigin,
-                           Rop4);
+                           Rop4,
+                           Mode);
             }
             break;
         case DC_COMPLEX:
@@ -308,7 +311,8 @@ EngStretchBltROP(
                            MaskOrigin,
                            pbo,
                            &AdjustedBrushOrigin,
-                           Rop4);
+                           Rop4,
+                           Mode);
                     }
                 }
             }
@@ -366,6 +370,7 @@ IntEngStretchBlt(SURFOBJ *psoDest,
                  CLIPOBJ *ClipRegion,
                  XLATEOBJ *ColorTranslation,
                  COLORADJUSTMENT *pca,
+                 ULONG iMode,
                  RECTL *DestRect,
                  RECTL *SourceRect,
                  POINTL *pMaskOrigin,
@@ -491,7 +496,7 @@ IntEngStretchBlt(SURFOBJ *psoDest,
                                                  &OutputRect,
                                                  &InputRect,
                                                  &MaskOrigin,
-                                                 COLORONCOLOR,
+                                                 iMode,
                                                  pbo,
                                                  Rop4);
     }
@@ -508,7 +513,7 @@ IntEngStretchBlt(SURFOBJ *psoDest,
                                &OutputRect,
                                &InputRect,
                                &MaskOrigin,
-                               COLORONCOLOR,
+                               iMode,
                                pbo,
                                Rop4);
     }
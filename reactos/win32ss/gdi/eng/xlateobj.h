@@ -44,6 +44,39 @@ typedef struct _EXLATEOBJ
 } EXLATEOBJ, *PEXLATEOBJ;
 
 extern EXLATEOBJ gexloTrivial;
+extern const BYTE gajXlate5to8[32];
+extern const BYTE gajXlate6to8[64];
+
+/* Translation functions that callers can recognize to pick a faster path */
+ULONG
+FASTCALL
+EXLATEOBJ_iXlateTrivial(
+    _In_ PEXLATEOBJ pexlo,
+    _In_ ULONG iColor);
+
+ULONG
+FASTCALL
+EXLATEOBJ_iXlateBGRto555(
+    _In_ PEXLATEOBJ pexlo,
+    _In_ ULONG iColor);
+
+ULONG
+FASTCALL
+EXLATEOBJ_iXlateBGRto565(
+    _In_ PEXLATEOBJ pexlo,
+    _In_ ULONG iColor);
+
+ULONG
+FASTCALL
+EXLATEOBJ_iXlate555toBGR(
+    _In_ PEXLATEOBJ pexlo,
+    _In_ ULONG iColor);
+
+ULONG
+FASTCALL
+EXLATEOBJ_iXlate565toBGR(
+    _In_ PEXLATEOBJ pexlo,
+    _In_ ULONG iColor);
 
 _Notnull_
 FORCEINLINE
@@ -294,12 +294,12 @@ BOOL FASTCALL LoadTheSpoolerDrv(VOID);
 
 FORCEINLINE
 PVOID
-GdiAllocBatchCommand(
+GdiAllocBatchCommandEx(
     HDC hdc,
-    USHORT Cmd)
+    USHORT Cmd,
+    ULONG cjSize)
 {
     PTEB pTeb;
-    USHORT cjSize;
     PGDIBATCHHDR pHdr;
 
     /* Get a pointer to the TEB */
@@ -308,40 +308,27 @@ GdiAllocBatchCommand(
     /* Check if we have a valid environment */
     if (!pTeb || !pTeb->Win32ThreadInfo) return NULL;
 
-    /* Do we use a DC? */
-    if (hdc)
-    {
-        /* If the batch DC is NULL, we set this one as the new one */
-        if (!pTeb->GdiTebBatch.HDC) pTeb->GdiTebBatch.HDC = hdc;
+    /* Keep the entries aligned for the handles they carry */
+    cjSize = (cjSize + sizeof(ULONG_PTR) - 1) & ~(sizeof(ULONG_PTR) - 1);
 
-        /* If not, check if the batch DC equal to our DC */
-        else if (pTeb->GdiTebBatch.HDC != hdc) return NULL;
-    }
+    /* Unsupported operation or too large to ever fit */
+    if ((cjSize == 0) || (cjSize > GDIBATCHBUFSIZE)) return NULL;
 
-    /* Get the size of the entry */
-    if      (Cmd == GdiBCPatBlt) cjSize = 0;
-    else if (Cmd == GdiBCPolyPatBlt) cjSize = 0;
-    else if (Cmd == GdiBCTextOut) cjSize = 0;
-    else if (Cmd == GdiBCExtTextOut) cjSize = 0;
-    else if (Cmd == GdiBCSetBrushOrg) cjSize = sizeof(GDIBSSETBRHORG);
-    else if (Cmd == GdiBCExtSelClipRgn) cjSize = 0;
-    else if (Cmd == GdiBCSelObj) cjSize = sizeof(GDIBSOBJECT);
-    else if (Cmd == GdiBCDelRgn) cjSize = sizeof(GDIBSOBJECT);
-    else if (Cmd == GdiBCDelObj) cjSize = sizeof(GDIBSOBJECT);
-    else cjSize = 0;
-
-    /* Unsupported operation */
-    if (cjSize == 0) return NULL;
+    /* A batch only ever holds commands for one DC */
+    if (hdc && pTeb->GdiTebBatch.HDC && (pTeb->GdiTebBatch.HDC != hdc)) return NULL;
 
     /* Check if the buffer is full */
     if ((pTeb->GdiBatchCount >= GDI_BatchLimit) ||
         ((pTeb->GdiTebBatch.Offset + cjSize) > GDIBATCHBUFSIZE))
     {
         /* Call win32k, the kernel will call NtGdiFlushUserBatch to flush
-           the current batch */
+           the current batch. This also clears the batch DC. */
         NtGdiFlush();
     }
 
+    /* If the batch DC is NULL, we set this one as the new one */
+    if (hdc && !pTeb->GdiTebBatch.HDC) pTeb->GdiTebBatch.HDC = hdc;
+
     /* Get the head of the entry */
     pHdr = (PVOID)((PUCHAR)pTeb->GdiTebBatch.Buffer + pTeb->GdiTebBatch.Offset);
 
@@ -351,11 +338,33 @@ GdiAllocBatchCommand(
 
     /* Fill in the core fields */
     pHdr->Cmd = Cmd;
-    pHdr->Size = cjSize;
+    pHdr->Size = (SHORT)cjSize;
 
     return pHdr;
 }
 
+FORCEINLINE
+PVOID
+GdiAllocBatchCommand(
+    HDC hdc,
+    USHORT Cmd)
+{
+    ULONG cjSize;
+
+    /* Get the size of the entry, PolyPatBlt and TextOut are variable
+       sized and use GdiAllocBatchCommandEx directly */
+    if      (Cmd == GdiBCPatBlt) cjSize = sizeof(GDIBSPATBLT);
+    else if (Cmd == GdiBCExtTextOut) cjSize = sizeof(GDIBSEXTTEXTOUT);
+    else if (Cmd == GdiBCSetBrushOrg) cjSize = sizeof(GDIBSSETBRHORG);
+    else if (Cmd == GdiBCExtSelClipRgn) cjSize = sizeof(GDIBSEXTSELCLPRGN);
+    else if (Cmd == GdiBCSelObj) cjSize = sizeof(GDIBSOBJECT);
+    else if (Cmd == GdiBCDelRgn) cjSize = sizeof(GDIBSOBJECT);
+    else if (Cmd == GdiBCDelObj) cjSize = sizeof(GDIBSOBJECT);
+    else cjSize = 0;
+
+    return GdiAllocBatchCommandEx(hdc, Cmd, cjSize);
+}
+
 FORCEINLINE
 PDC_ATTR
 GdiGetDcAttr(HDC hdc)
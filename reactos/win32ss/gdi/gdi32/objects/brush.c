@@ -267,7 +267,39 @@ PatBlt(HDC hdc,
        int nHeight,
        DWORD dwRop)
 {
-    /* FIXME some part need be done in user mode */
+    PDC_ATTR pdcattr;
+    PGDIBSPATBLT pgO;
+
+    /* Only plain DCs without a DIB section can be batched, the caller
+       may touch the DIB bits directly after we return */
+    pdcattr = GdiGetDcAttr(hdc);
+    if (pdcattr &&
+        !(pdcattr->ulDirty_ & DC_DIBSECTION) &&
+        !ROP_USES_SOURCE(dwRop))
+    {
+        pgO = GdiAllocBatchCommand(hdc, GdiBCPatBlt);
+        if (pgO)
+        {
+            pdcattr->ulDirty_ |= DC_MODE_DIRTY;
+
+            pgO->nXLeft = nXLeft;
+            pgO->nYLeft = nYLeft;
+            pgO->nWidth = nWidth;
+            pgO->nHeight = nHeight;
+            pgO->hbrush = pdcattr->hbrush;
+            pgO->dwRop = dwRop;
+            pgO->crForegroundClr = pdcattr->crForegroundClr;
+            pgO->crBackgroundClr = pdcattr->crBackgroundClr;
+            pgO->crBrushClr = pdcattr->crBrushClr;
+            pgO->IcmBrushColor = pdcattr->IcmBrushColor;
+            pgO->ptlViewportOrg = pdcattr->ptlViewportOrg;
+            pgO->ulForegroundClr = pdcattr->ulForegroundClr;
+            pgO->ulBackgroundClr = pdcattr->ulBackgroundClr;
+            pgO->ulBrushClr = pdcattr->ulBrushClr;
+            return TRUE;
+        }
+    }
+
     return NtGdiPatBlt( hdc,  nXLeft,  nYLeft,  nWidth,  nHeight,  dwRop);
 }
 
@@ -279,7 +311,40 @@ PolyPatBlt(IN HDC hdc,
            IN DWORD Count,
            IN DWORD Mode)
 {
-    /* FIXME some part need be done in user mode */
+    PDC_ATTR pdcattr;
+    PGDIBSPPATBLT pgO;
+
+    pdcattr = GdiGetDcAttr(hdc);
+    if (pdcattr &&
+        !(pdcattr->ulDirty_ & DC_DIBSECTION) &&
+        !ROP_USES_SOURCE(rop4) &&
+        (Count > 0) &&
+        (Count <= (GDIBATCHBUFSIZE - FIELD_OFFSET(GDIBSPPATBLT, pRect)) / sizeof(PATRECT)))
+    {
+        pgO = GdiAllocBatchCommandEx(hdc,
+                                     GdiBCPolyPatBlt,
+                                     FIELD_OFFSET(GDIBSPPATBLT, pRect[Count]));
+        if (pgO)
+        {
+            pdcattr->ulDirty_ |= DC_MODE_DIRTY;
+
+            pgO->rop4 = rop4;
+            pgO->Mode = Mode;
+            pgO->Count = Count;
+            pgO->crForegroundClr = pdcattr->crForegroundClr;
+            pgO->crBackgroundClr = pdcattr->crBackgroundClr;
+            pgO->crBrushClr = pdcattr->crBrushClr;
+            pgO->ulForegroundClr = pdcattr->ulForegroundClr;
+            pgO->ulBackgroundClr = pdcattr->ulBackgroundClr;
+            pgO->ulBrushClr = pdcattr->ulBrushClr;
+            pgO->ptlViewportOrg = pdcattr->ptlViewportOrg;
+
+            /* POLYPATBLT and PATRECT share their layout */
+            RtlCopyMemory(pgO->pRect, pPoly, Count * sizeof(PATRECT));
+            return TRUE;
+        }
+    }
+
     return NtGdiPolyPatBlt(hdc, rop4, pPoly,Count,Mode);
 }
 
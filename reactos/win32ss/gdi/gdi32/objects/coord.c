@@ -402,7 +402,7 @@ SetViewportExtEx(HDC hdc,
     {
         if (NtCurrentTeb()->GdiTebBatch.HDC == hdc)
         {
-            if (Dc_Attr->ulDirty_ & DC_FONTTEXT_DIRTY)
+            if (Dc_Attr->ulDirty_ & (DC_MODE_DIRTY|DC_FONTTEXT_DIRTY))
             {
                 NtGdiFlush(); // Sync up Dc_Attr from Kernel space.
                 Dc_Attr->ulDirty_ &= ~(DC_MODE_DIRTY|DC_FONTTEXT_DIRTY);
@@ -542,7 +542,7 @@ SetWindowExtEx(
 
         if (NtCurrentTeb()->GdiTebBatch.HDC == hdc)
         {
-            if (pdcattr->ulDirty_ & DC_FONTTEXT_DIRTY)
+            if (pdcattr->ulDirty_ & (DC_MODE_DIRTY|DC_FONTTEXT_DIRTY))
             {
                 NtGdiFlush(); // Sync up Dc_Attr from Kernel space.
                 pdcattr->ulDirty_ &= ~(DC_MODE_DIRTY|DC_FONTTEXT_DIRTY);
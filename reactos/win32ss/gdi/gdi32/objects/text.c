@@ -45,7 +45,7 @@ TextOutW(
     LPCWSTR  lpString,
     int  cchString)
 {
-    return NtGdiExtTextOutW(hdc, nXStart, nYStart, 0, NULL, (LPWSTR)lpString, cchString, NULL, 0);
+    return ExtTextOutW(hdc, nXStart, nYStart, 0, NULL, lpString, cchString, NULL);
 }
 
 
@@ -364,6 +364,79 @@ ExtTextOutW(
     CONST INT	*lpDx
 )
 {
+    PDC_ATTR pdcattr;
+
+    /* Simple calls on plain DCs go into the batch. Spacing arrays and
+       TA_UPDATECP need the kernel right away, and DIB sections must be
+       up to date when we return */
+    pdcattr = GdiGetDcAttr(hdc);
+    if (pdcattr &&
+        !(pdcattr->ulDirty_ & DC_DIBSECTION) &&
+        !(pdcattr->lTextAlign & TA_UPDATECP) &&
+        !lpDx &&
+        (cchString <= (GDIBATCHBUFSIZE - FIELD_OFFSET(GDIBSTEXTOUT, String)) / sizeof(WCHAR)))
+    {
+        if (cchString > 0)
+        {
+            PGDIBSTEXTOUT pgO;
+
+            pgO = GdiAllocBatchCommandEx(hdc,
+                                         GdiBCTextOut,
+                                         FIELD_OFFSET(GDIBSTEXTOUT, String[cchString]));
+            if (pgO)
+            {
+                pdcattr->ulDirty_ |= DC_FONTTEXT_DIRTY;
+
+                pgO->crForegroundClr = pdcattr->crForegroundClr;
+                pgO->crBackgroundClr = pdcattr->crBackgroundClr;
+                pgO->lmBkMode = pdcattr->lBkMode;
+                pgO->ulForegroundClr = pdcattr->ulForegroundClr;
+                pgO->ulBackgroundClr = pdcattr->ulBackgroundClr;
+                pgO->x = X;
+                pgO->y = Y;
+                pgO->iCS_CP = 0; /* Same code page as the direct call */
+                pgO->cbCount = cchString;
+                pgO->Size = cchString * sizeof(WCHAR);
+                pgO->hlfntNew = pdcattr->hlfntNew;
+                pgO->flTextAlign = pdcattr->lTextAlign;
+                pgO->ptlViewportOrg = pdcattr->ptlViewportOrg;
+
+                /* The rectangle is only used together with these options */
+                if (lprc && (fuOptions & (ETO_OPAQUE | ETO_CLIPPED)))
+                {
+                    pgO->Options = fuOptions;
+                    pgO->Rect = *lprc;
+                }
+                else
+                {
+                    pgO->Options = fuOptions & ~(ETO_OPAQUE | ETO_CLIPPED);
+                    RtlZeroMemory(&pgO->Rect, sizeof(RECT));
+                }
+
+                RtlCopyMemory(pgO->String, lpString, cchString * sizeof(WCHAR));
+                return TRUE;
+            }
+        }
+        else if (lprc && (fuOptions & ETO_OPAQUE))
+        {
+            PGDIBSEXTTEXTOUT pgO;
+
+            /* No text, this only fills the rectangle with the background */
+            pgO = GdiAllocBatchCommand(hdc, GdiBCExtTextOut);
+            if (pgO)
+            {
+                pdcattr->ulDirty_ |= DC_FONTTEXT_DIRTY;
+
+                pgO->Count = 0;
+                pgO->Options = fuOptions;
+                pgO->Rect = *lprc;
+                pgO->ptlViewportOrg = pdcattr->ptlViewportOrg;
+                pgO->ulBackgroundClr = pdcattr->ulBackgroundClr;
+                return TRUE;
+            }
+        }
+    }
+
     return NtGdiExtTextOutW(hdc, X, Y, fuOptions, (LPRECT)lprc, (LPWSTR)lpString, cchString, (LPINT)lpDx, 0);
 }
 
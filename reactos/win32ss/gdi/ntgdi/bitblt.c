@@ -700,6 +700,7 @@ GreStretchBltMask(
                               &DCDest->co.ClipObj,
                               XlateObj,
                               &DCDest->dclevel.ca,
+                              pdcattr->jStretchBltMode,
                               &DestRect,
                               &SourceRect,
                               BitmapMask ? &MaskPoint : NULL,
@@ -1336,6 +1336,7 @@ NtGdiStretchDIBitsInternal(
                                &pdc->co.ClipObj,
                                &exlo.xlo,
                                &pdc->dclevel.ca,
+                               pdc->pdcattr->jStretchBltMode,
                                &rcDst,
                                &rcSrc,
                                NULL,
@@ -60,19 +60,43 @@ static BOOL RenderingEnabled = TRUE;
 #define IntUnLockFreeType \
   ExReleaseFastMutexUnsafeAndLeaveCriticalRegion(FreeTypeLock)
 
-#define MAX_FONT_CACHE 256
+/*
+ * Glyph bitmap cache. Glyphs are grouped by realization, that is by face,
+ * size, render mode and transformation, and hashed by glyph index inside
+ * their realization. All glyphs share one LRU list, which is trimmed to a
+ * memory budget. Everything is protected by the FreeType lock.
+ */
+#define FONT_CACHE_BUCKETS 64
+#define FONT_CACHE_DEFAULT_BUDGET (1024 * 1024)
 
-typedef struct _FONT_CACHE_ENTRY
+typedef struct _FONT_CACHE_REALIZATION
 {
     LIST_ENTRY ListEntry;
-    int GlyphIndex;
     FT_Face Face;
-    FT_BitmapGlyph BitmapGlyph;
-    int Height;
+    INT Height;
+    INT Width;
+    FT_Render_Mode RenderMode;
     MATRIX mxWorldToDevice;
+    ULONG NumGlyphs;
+    LIST_ENTRY Buckets[FONT_CACHE_BUCKETS];
+} FONT_CACHE_REALIZATION, *PFONT_CACHE_REALIZATION;
+
+typedef struct _FONT_CACHE_ENTRY
+{
+    LIST_ENTRY ListEntry;
+    LIST_ENTRY BucketEntry;
+    PFONT_CACHE_REALIZATION Realization;
+    INT GlyphIndex;
+    FT_BitmapGlyph BitmapGlyph;
+    SIZE_T Size;
 } FONT_CACHE_ENTRY, *PFONT_CACHE_ENTRY;
+
 static LIST_ENTRY FontCacheListHead;
-static UINT FontCacheNumEntries;
+static LIST_ENTRY FontCacheRealizationListHead;
+static SIZE_T FontCacheSize;
+static SIZE_T FontCacheBudget = FONT_CACHE_DEFAULT_BUDGET;
+static ULONG FontCacheHits;
+static ULONG FontCacheMisses;
 
 static PWCHAR ElfScripts[32] =   /* These are in the order of the fsCsb[0] bits */
 {
@@ -143,6 +167,22 @@ static const CHARSETINFO FontTci[MAXTCIINDEX] =
     { SYMBOL_CHARSET, CP_SYMBOL, {{0,0,0,0},{FS_SYMBOL,0}} }
 };
 
+static
+VOID
+IntLoadFontCacheSettings(VOID)
+{
+    HKEY hKey;
+    DWORD dwValue;
+
+    /* The glyph cache budget can be set in KB */
+    if (NT_SUCCESS(RegOpenKey(L"\\REGISTRY\\MACHINE\\Software\\Microsoft\\Windows NT\\CurrentVersion\\GRE_Initialize", &hKey)))
+    {
+        if (RegReadDWORD(hKey, L"GlyphCacheSize", &dwValue) && dwValue != 0)
+            FontCacheBudget = (SIZE_T)dwValue * 1024;
+        ZwClose(hKey);
+    }
+}
+
 BOOL FASTCALL
 InitFontSupport(VOID)
 {
@@ -150,7 +190,9 @@ InitFontSupport(VOID)
 
     InitializeListHead(&FontListHead);
     InitializeListHead(&FontCacheListHead);
-    FontCacheNumEntries = 0;
+    InitializeListHead(&FontCacheRealizationListHead);
+    FontCacheSize = 0;
+    IntLoadFontCacheSettings();
     /* Fast Mutexes must be allocated from non paged pool */
     FontListLock = ExAllocatePoolWithTag(NonPagedPool, sizeof(FAST_MUTEX), TAG_INTERNAL_SYNC);
     ExInitializeFastMutex(FontListLock);
@@ -1360,36 +1402,98 @@ SameScaleMatrix(
             FLOATOBJ_Equal(&pmx1->efM22, &pmx2->efM22));
 }
 
-FT_BitmapGlyph APIENTRY
-ftGdiGlyphCacheGet(
+static
+PFONT_CACHE_REALIZATION
+ftGdiGlyphCacheFindRealization(
     FT_Face Face,
-    INT GlyphIndex,
     INT Height,
+    INT Width,
+    FT_Render_Mode RenderMode,
     PMATRIX pmx)
 {
     PLIST_ENTRY CurrentEntry;
-    PFONT_CACHE_ENTRY FontEntry;
+    PFONT_CACHE_REALIZATION Realization;
+
+    /* Most strings are drawn with the same font as the one before, keep
+       the list in most recently used order */
+    CurrentEntry = FontCacheRealizationListHead.Flink;
+    while (CurrentEntry != &FontCacheRealizationListHead)
+    {
+        Realization = CONTAINING_RECORD(CurrentEntry, FONT_CACHE_REALIZATION, ListEntry);
+        if ((Realization->Face == Face) &&
+            (Realization->Height == Height) &&
+            (Realization->Width == Width) &&
+            (Realization->RenderMode == RenderMode) &&
+            (SameScaleMatrix(&Realization->mxWorldToDevice, pmx)))
+        {
+            if (CurrentEntry != FontCacheRealizationListHead.Flink)
+            {
+                RemoveEntryList(CurrentEntry);
+                InsertHeadList(&FontCacheRealizationListHead, CurrentEntry);
+            }
+            return Realization;
+        }
+        CurrentEntry = CurrentEntry->Flink;
+    }
+
+    return NULL;
+}
+
+static
+VOID
+ftGdiGlyphCacheRemoveEntry(
+    PFONT_CACHE_ENTRY Entry)
+{
+    PFONT_CACHE_REALIZATION Realization = Entry->Realization;
+
+    RemoveEntryList(&Entry->ListEntry);
+    RemoveEntryList(&Entry->BucketEntry);
+    FontCacheSize -= Entry->Size;
+    FT_Done_Glyph((FT_Glyph)Entry->BitmapGlyph);
+    ExFreePoolWithTag(Entry, TAG_FONT);
 
-    CurrentEntry = FontCacheListHead.Flink;
-    while (CurrentEntry != &FontCacheListHead)
+    /* Free the realization with its last glyph */
+    if (--Realization->NumGlyphs == 0)
     {
-        FontEntry = (PFONT_CACHE_ENTRY)CurrentEntry;
-        if ((FontEntry->Face == Face) &&
-            (FontEntry->GlyphIndex == GlyphIndex) &&
-            (FontEntry->Height == Height) &&
-            (SameScaleMatrix(&FontEntry->mxWorldToDevice, pmx)))
-            break;
-        CurrentEntry = CurrentEntry->Flink;
+        RemoveEntryList(&Realization->ListEntry);
+        ExFreePoolWithTag(Realization, TAG_FONT);
     }
+}
+
+FT_BitmapGlyph APIENTRY
+ftGdiGlyphCacheGet(
+    FT_Face Face,
+    INT GlyphIndex,
+    INT Height,
+    INT Width,
+    FT_Render_Mode RenderMode,
+    PMATRIX pmx)
+{
+    PFONT_CACHE_REALIZATION Realization;
+    PLIST_ENTRY ListHead, CurrentEntry;
+    PFONT_CACHE_ENTRY FontEntry;
 
-    if (CurrentEntry == &FontCacheListHead)
+    Realization = ftGdiGlyphCacheFindRealization(Face, Height, Width, RenderMode, pmx);
+    if (Realization)
     {
-        return NULL;
+        ListHead = &Realization->Buckets[GlyphIndex % FONT_CACHE_BUCKETS];
+        for (CurrentEntry = ListHead->Flink;
+             CurrentEntry != ListHead;
+             CurrentEntry = CurrentEntry->Flink)
+        {
+            FontEntry = CONTAINING_RECORD(CurrentEntry, FONT_CACHE_ENTRY, BucketEntry);
+            if (FontEntry->GlyphIndex == GlyphIndex)
+            {
+                RemoveEntryList(&FontEntry->ListEntry);
+                InsertHeadList(&FontCacheListHead, &FontEntry->ListEntry);
+                FontCacheHits++;
+                return FontEntry->BitmapGlyph;
+            }
+        }
     }
 
-    RemoveEntryList(CurrentEntry);
-    InsertHeadList(&FontCacheListHead, CurrentEntry);
-    return FontEntry->BitmapGlyph;
+    FontCacheMisses++;
+    return NULL;
 }
 
 FT_BitmapGlyph APIENTRY
@@ -1397,13 +1501,15 @@ ftGdiGlyphCacheSet(
     FT_Face Face,
     INT GlyphIndex,
     INT Height,
+    INT Width,
     PMATRIX pmx,
     FT_GlyphSlot GlyphSlot,
     FT_Render_Mode RenderMode)
 {
     FT_Glyph GlyphCopy;
-    INT error;
+    INT error, i;
     PFONT_CACHE_ENTRY NewEntry;
+    PFONT_CACHE_REALIZATION Realization;
     FT_Bitmap AlignedBitmap;
     FT_BitmapGlyph BitmapGlyph;
 
@@ -1443,22 +1549,54 @@ ftGdiGlyphCacheSet(
     FT_Bitmap_Done(GlyphSlot->library, &BitmapGlyph->bitmap);
     BitmapGlyph->bitmap = AlignedBitmap;
 
+    Realization = ftGdiGlyphCacheFindRealization(Face, Height, Width, RenderMode, pmx);
+    if (!Realization)
+    {
+        Realization = ExAllocatePoolWithTag(PagedPool, sizeof(FONT_CACHE_REALIZATION), TAG_FONT);
+        if (!Realization)
+        {
+            DPRINT1("Alloc failure caching glyph.\n");
+            ExFreePoolWithTag(NewEntry, TAG_FONT);
+            FT_Done_Glyph((FT_Glyph)BitmapGlyph);
+            return NULL;
+        }
+
+        Realization->Face = Face;
+        Realization->Height = Height;
+        Realization->Width = Width;
+        Realization->RenderMode = RenderMode;
+        Realization->mxWorldToDevice = *pmx;
+        Realization->NumGlyphs = 0;
+        for (i = 0; i < FONT_CACHE_BUCKETS; i++)
+            InitializeListHead(&Realization->Buckets[i]);
+        InsertHeadList(&FontCacheRealizationListHead, &Realization->ListEntry);
+    }
+
+    NewEntry->Realization = Realization;
     NewEntry->GlyphIndex = GlyphIndex;
-    NewEntry->Face = Face;
     NewEntry->BitmapGlyph = BitmapGlyph;
-    NewEntry->Height = Height;
-    NewEntry->mxWorldToDevice = *pmx;
+    NewEntry->Size = sizeof(FONT_CACHE_ENTRY) + sizeof(FT_BitmapGlyphRec) +
+                     abs(AlignedBitmap.pitch) * AlignedBitmap.rows;
 
     InsertHeadList(&FontCacheListHead, &NewEntry->ListEntry);
-    if (FontCacheNumEntries++ > MAX_FONT_CACHE)
+    InsertHeadList(&Realization->Buckets[GlyphIndex % FONT_CACHE_BUCKETS],
+                   &NewEntry->BucketEntry);
+    Realization->NumGlyphs++;
+    FontCacheSize += NewEntry->Size;
+
+    /* Drop the least recently used glyphs until we are within the budget,
+       but keep the new one, the caller is about to use it */
+    while (FontCacheSize > FontCacheBudget &&
+           FontCacheListHead.Blink != &NewEntry->ListEntry)
     {
-        NewEntry = (PFONT_CACHE_ENTRY)FontCacheListHead.Blink;
-        FT_Done_Glyph((FT_Glyph)NewEntry->BitmapGlyph);
-        RemoveTailList(&FontCacheListHead);
-        ExFreePoolWithTag(NewEntry, TAG_FONT);
-        FontCacheNumEntries--;
+        ftGdiGlyphCacheRemoveEntry(CONTAINING_RECORD(FontCacheListHead.Blink,
+                                                     FONT_CACHE_ENTRY,
+                                                     ListEntry));
     }
 
+    DPRINT("Glyph cache: %lu hits, %lu misses, %Iu bytes\n",
+           FontCacheHits, FontCacheMisses, FontCacheSize);
+
     return BitmapGlyph;
 }
 
@@ -2240,6 +2378,8 @@ TextIntGetTextExtentPoint(PDC dc,
 
         if (!(realglyph = ftGdiGlyphCacheGet(face, glyph_index,
                                              TextObj->logfont.elfEnumLogfontEx.elfLogFont.lfHeight,
+                                             TextObj->logfont.elfEnumLogfontEx.elfLogFont.lfWidth,
+                                             RenderMode,
                                              pmxWorldToDevice)))
         {
             error = FT_Load_Glyph(face, glyph_index, FT_LOAD_DEFAULT);
@@ -2253,6 +2393,7 @@ TextIntGetTextExtentPoint(PDC dc,
             realglyph = ftGdiGlyphCacheSet(face,
                                            glyph_index,
                                            TextObj->logfont.elfEnumLogfontEx.elfLogFont.lfHeight,
+                                           TextObj->logfont.elfEnumLogfontEx.elfLogFont.lfWidth,
                                            pmxWorldToDevice,
                                            glyph,
                                            RenderMode);
@@ -3182,6 +3323,157 @@ ScaleLong(LONG lValue, PFLOATOBJ pef)
     return lValue;
 }
 
+/*
+ * Glyphs of a string are collected into runs. Each run is merged into one
+ * coverage mask and drawn with a single mask blit, instead of creating a
+ * surface and doing a blit for every glyph.
+ */
+#define GLYPH_RUN_MAX_GLYPHS 32
+#define GLYPH_RUN_MAX_PIXELS (128 * 1024)
+
+typedef struct _GLYPH_RUN
+{
+    ULONG Count;
+    RECTL rclBounds;
+    FT_BitmapGlyph apGlyph[GLYPH_RUN_MAX_GLYPHS];
+    RECTL arclGlyph[GLYPH_RUN_MAX_GLYPHS];
+} GLYPH_RUN, *PGLYPH_RUN;
+
+static
+BOOL
+IntFlushGlyphRun(
+    PGLYPH_RUN Run,
+    PDC dc,
+    SURFOBJ *SurfObj,
+    XLATEOBJ *pxloRGB2Dst,
+    XLATEOBJ *pxloDst2RGB,
+    POINTL *BrushOrigin)
+{
+    SIZEL sizl;
+    HBITMAP hbmMask;
+    SURFOBJ *psoMask;
+    PRECTL prcl;
+    FT_Bitmap *pBitmap;
+    PBYTE pjSrc, pjDst;
+    LONG x, y, cx, cy;
+    ULONG i;
+    POINTL ptlMask = {0, 0};
+
+    if (Run->Count == 0)
+        return TRUE;
+
+    sizl.cx = Run->rclBounds.right - Run->rclBounds.left;
+    sizl.cy = Run->rclBounds.bottom - Run->rclBounds.top;
+
+    hbmMask = EngCreateBitmap(sizl, WIDTH_BYTES_ALIGN32(sizl.cx, 8),
+                              BMF_8BPP, BMF_TOPDOWN, NULL);
+    if (!hbmMask)
+    {
+        DPRINT1("Failed to create the glyph run mask\n");
+        Run->Count = 0;
+        return FALSE;
+    }
+
+    psoMask = EngLockSurface((HSURF)hbmMask);
+    if (!psoMask)
+    {
+        DPRINT1("Failed to lock the glyph run mask\n");
+        EngDeleteSurface((HSURF)hbmMask);
+        Run->Count = 0;
+        return FALSE;
+    }
+
+    /* Merge the glyphs, where they overlap the higher coverage wins */
+    for (i = 0; i < Run->Count; i++)
+    {
+        prcl = &Run->arclGlyph[i];
+        pBitmap = &Run->apGlyph[i]->bitmap;
+        cx = prcl->right - prcl->left;
+        cy = prcl->bottom - prcl->top;
+
+        pjSrc = pBitmap->buffer;
+        pjDst = (PBYTE)psoMask->pvScan0 +
+                (prcl->top - Run->rclBounds.top) * psoMask->lDelta +
+                (prcl->left - Run->rclBounds.left);
+
+        for (y = 0; y < cy; y++)
+        {
+            for (x = 0; x < cx; x++)
+            {
+                if (pjSrc[x] > pjDst[x])
+                    pjDst[x] = pjSrc[x];
+            }
+            pjSrc += pBitmap->pitch;
+            pjDst += psoMask->lDelta;
+        }
+    }
+
+    MouseSafetyOnDrawStart(dc->ppdev,
+                           Run->rclBounds.left,
+                           Run->rclBounds.top,
+                           Run->rclBounds.right,
+                           Run->rclBounds.bottom);
+    IntEngMaskBlt(SurfObj,
+                  psoMask,
+                  &dc->co.ClipObj,
+                  pxloRGB2Dst,
+                  pxloDst2RGB,
+                  &Run->rclBounds,
+                  &ptlMask,
+                  &dc->eboText.BrushObject,
+                  BrushOrigin);
+    MouseSafetyOnDrawEnd(dc->ppdev);
+
+    EngUnlockSurface(psoMask);
+    EngDeleteSurface((HSURF)hbmMask);
+
+    Run->Count = 0;
+    return TRUE;
+}
+
+static
+BOOL
+IntAddToGlyphRun(
+    PGLYPH_RUN Run,
+    FT_BitmapGlyph BitmapGlyph,
+    PRECTL prclGlyph,
+    PDC dc,
+    SURFOBJ *SurfObj,
+    XLATEOBJ *pxloRGB2Dst,
+    XLATEOBJ *pxloDst2RGB,
+    POINTL *BrushOrigin)
+{
+    RECTL rclBounds;
+
+    /* Nothing of this glyph is visible */
+    if (RECTL_bIsEmptyRect(prclGlyph))
+        return TRUE;
+
+    /* Start a new run when the run is full or its mask would get too big */
+    if (Run->Count > 0)
+    {
+        RECTL_bUnionRect(&rclBounds, &Run->rclBounds, prclGlyph);
+        if ((Run->Count == GLYPH_RUN_MAX_GLYPHS) ||
+            ((LONGLONG)(rclBounds.right - rclBounds.left) *
+             (rclBounds.bottom - rclBounds.top) > GLYPH_RUN_MAX_PIXELS))
+        {
+            if (!IntFlushGlyphRun(Run, dc, SurfObj, pxloRGB2Dst, pxloDst2RGB, BrushOrigin))
+                return FALSE;
+            rclBounds = *prclGlyph;
+        }
+    }
+    else
+    {
+        rclBounds = *prclGlyph;
+    }
+
+    Run->rclBounds = rclBounds;
+    Run->apGlyph[Run->Count] = BitmapGlyph;
+    Run->arclGlyph[Run->Count] = *prclGlyph;
+    Run->Count++;
+    return TRUE;
+}
+
 BOOL
 APIENTRY
 GreExtTextOutW(
@@ -3212,11 +3504,9 @@ GreExtTextOutW(
     LONGLONG TextLeft, RealXStart;
     ULONG TextTop, previous, BackgroundLeft;
     FT_Bool use_kerning;
-    RECTL DestRect, MaskRect;
+    RECTL DestRect;
     POINTL SourcePoint, BrushOrigin;
-    HBITMAP HSourceGlyph;
-    SURFOBJ *SourceGlyphSurf;
-    SIZEL bitSize;
+    GLYPH_RUN GlyphRun;
     FT_CharMap found = 0, charmap;
     INT yoff;
     FONTOBJ *FontObj;
@@ -3291,8 +3581,6 @@ GreExtTextOutW(
 
     SourcePoint.x = 0;
     SourcePoint.y = 0;
-    MaskRect.left = 0;
-    MaskRect.top = 0;
     BrushOrigin.x = 0;
     BrushOrigin.y = 0;
 
@@ -3448,6 +3736,8 @@ GreExtTextOutW(
 
             if (!(realglyph = ftGdiGlyphCacheGet(face, glyph_index,
                                                  TextObj->logfont.elfEnumLogfontEx.elfLogFont.lfHeight,
+                                                 TextObj->logfont.elfEnumLogfontEx.elfLogFont.lfWidth,
+                                                 RenderMode,
                                                  pmxWorldToDevice)))
             {
                 error = FT_Load_Glyph(face, glyph_index, FT_LOAD_DEFAULT);
@@ -3460,6 +3750,7 @@ GreExtTextOutW(
                 realglyph = ftGdiGlyphCacheSet(face,
                                                glyph_index,
                                                TextObj->logfont.elfEnumLogfontEx.elfLogFont.lfHeight,
+                                               TextObj->logfont.elfEnumLogfontEx.elfLogFont.lfWidth,
                                                pmxWorldToDevice,
                                                glyph,
                                                RenderMode);
@@ -3520,6 +3811,7 @@ GreExtTextOutW(
     /*
      * The main rendering loop.
      */
+    GlyphRun.Count = 0;
     for (i = 0; i < Count; i++)
     {
         if (fuOptions & ETO_GLYPH_INDEX)
@@ -3529,8 +3821,14 @@ GreExtTextOutW(
 
         if (!(realglyph = ftGdiGlyphCacheGet(face, glyph_index,
                                              TextObj->logfont.elfEnumLogfontEx.elfLogFont.lfHeight,
+                                             TextObj->logfont.elfEnumLogfontEx.elfLogFont.lfWidth,
+                                             RenderMode,
                                              pmxWorldToDevice)))
         {
+            /* Adding to the cache can evict the glyphs of the pending run */
+            IntFlushGlyphRun(&GlyphRun, dc, SurfObj, &exloRGB2Dst.xlo,
+                             &exloDst2RGB.xlo, &BrushOrigin);
+
             error = FT_Load_Glyph(face, glyph_index, FT_LOAD_DEFAULT);
             if (error)
             {
@@ -3543,6 +3841,7 @@ GreExtTextOutW(
             realglyph = ftGdiGlyphCacheSet(face,
                                            glyph_index,
                                            TextObj->logfont.elfEnumLogfontEx.elfLogFont.lfHeight,
+                                           TextObj->logfont.elfEnumLogfontEx.elfLogFont.lfWidth,
                                            pmxWorldToDevice,
                                            glyph,
                                            RenderMode);
@@ -3595,43 +3894,6 @@ GreExtTextOutW(
         DestRect.top = TextTop + yoff - realglyph->top;
         DestRect.bottom = DestRect.top + realglyph->bitmap.rows;
 
-        bitSize.cx = realglyph->bitmap.width;
-        bitSize.cy = realglyph->bitmap.rows;
-        MaskRect.right = realglyph->bitmap.width;
-        MaskRect.bottom = realglyph->bitmap.rows;
-
-        /*
-         * We should create the bitmap out of the loop at the biggest possible
-         * glyph size. Then use memset with 0 to clear it and sourcerect to
-         * limit the work of the transbitblt.
-         */
-
-        HSourceGlyph = EngCreateBitmap(bitSize, realglyph->bitmap.pitch,
-                                       BMF_8BPP, BMF_TOPDOWN,
-                                       realglyph->bitmap.buffer);
-        if ( !HSourceGlyph )
-        {
-            DPRINT1("WARNING: EngLockSurface() failed!\n");
-            // FT_Done_Glyph(realglyph);
-            IntUnLockFreeType;
-            DC_vFinishBlit(dc, NULL);
-            goto fail2;
-        }
-        SourceGlyphSurf = EngLockSurface((HSURF)HSourceGlyph);
-        if ( !SourceGlyphSurf )
-        {
-            EngDeleteSurface((HSURF)HSourceGlyph);
-            DPRINT1("WARNING: EngLockSurface() failed!\n");
-            IntUnLockFreeType;
-            DC_vFinishBlit(dc, NULL);
-            goto fail2;
-        }
-
-        /*
-         * Use the font data as a mask to paint onto the DCs surface using a
-         * brush.
-         */
-
         if (lprc && (fuOptions & ETO_CLIPPED) &&
                 DestRect.right >= lprc->right + dc->ptlDCOrig.x)
         {
@@ -3646,21 +3908,13 @@ GreExtTextOutW(
         {
             DestRect.bottom = lprc->bottom + dc->ptlDCOrig.y;
         }
-        MouseSafetyOnDrawStart(dc->ppdev, DestRect.left, DestRect.top, DestRect.right, DestRect.bottom);
-        IntEngMaskBlt(
-            SurfObj,
-            SourceGlyphSurf,
-            &dc->co.ClipObj,
-            &exloRGB2Dst.xlo,
-            &exloDst2RGB.xlo,
-            &DestRect,
-            (PPOINTL)&MaskRect,
-            &dc->eboText.BrushObject,
-            &BrushOrigin);
-        MouseSafetyOnDrawEnd(dc->ppdev) ;
-
-        EngUnlockSurface(SourceGlyphSurf);
-        EngDeleteSurface((HSURF)HSourceGlyph);
+        if (!IntAddToGlyphRun(&GlyphRun, realglyph, &DestRect, dc, SurfObj,
+                              &exloRGB2Dst.xlo, &exloDst2RGB.xlo, &BrushOrigin))
+        {
+            IntUnLockFreeType;
+            DC_vFinishBlit(dc, NULL);
+            goto fail2;
+        }
 
         if (DoBreak)
         {
@@ -3693,6 +3947,8 @@ GreExtTextOutW(
 
         String++;
     }
+    IntFlushGlyphRun(&GlyphRun, dc, SurfObj, &exloRGB2Dst.xlo,
+                     &exloDst2RGB.xlo, &BrushOrigin);
     IntUnLockFreeType;
 
     DC_vFinishBlit(dc, NULL) ;
@@ -59,15 +59,100 @@ SynchonizeDriver(FLONG Flags)
   return;
 }
 
+//
+// DC attributes a batched drawing command was recorded with. User mode
+// changes colors, brushes and text settings in the DC_ATTR without a
+// system call, so by the time the batch is flushed they may already
+// hold the values for a later command.
+//
+typedef struct _GDIBATCHSTATE
+{
+  COLORREF crForegroundClr;
+  COLORREF crBackgroundClr;
+  COLORREF crBrushClr;
+  ULONG ulForegroundClr;
+  ULONG ulBackgroundClr;
+  ULONG ulBrushClr;
+  HANDLE hbrush;
+  HANDLE hlfntNew;
+  LONG lTextAlign;
+  LONG lBkMode;
+} GDIBATCHSTATE, *PGDIBATCHSTATE;
+
+//
+// Capture the current state, so only the fields a record carries get
+// replaced.
+//
+static
+VOID
+FASTCALL
+GdiBatchInitState(PDC_ATTR pdcattr, PGDIBATCHSTATE pState)
+{
+  pState->crForegroundClr = pdcattr->crForegroundClr;
+  pState->crBackgroundClr = pdcattr->crBackgroundClr;
+  pState->crBrushClr      = pdcattr->crBrushClr;
+  pState->ulForegroundClr = pdcattr->ulForegroundClr;
+  pState->ulBackgroundClr = pdcattr->ulBackgroundClr;
+  pState->ulBrushClr      = pdcattr->ulBrushClr;
+  pState->hbrush          = pdcattr->hbrush;
+  pState->hlfntNew        = pdcattr->hlfntNew;
+  pState->lTextAlign      = pdcattr->lTextAlign;
+  pState->lBkMode         = pdcattr->lBkMode;
+}
+
+//
+// Exchange the recorded state with the one in the DC_ATTR. Called once
+// before executing a command and once after, to put things back.
+//
+static
+VOID
+FASTCALL
+GdiBatchSwapState(PDC_ATTR pdcattr, PGDIBATCHSTATE pState)
+{
+  GDIBATCHSTATE Old;
+
+  GdiBatchInitState(pdcattr, &Old);
+
+  if (Old.crForegroundClr != pState->crForegroundClr ||
+      Old.crBackgroundClr != pState->crBackgroundClr ||
+      Old.crBrushClr      != pState->crBrushClr ||
+      Old.ulForegroundClr != pState->ulForegroundClr ||
+      Old.ulBackgroundClr != pState->ulBackgroundClr ||
+      Old.ulBrushClr      != pState->ulBrushClr)
+  {
+     pdcattr->crForegroundClr = pState->crForegroundClr;
+     pdcattr->crBackgroundClr = pState->crBackgroundClr;
+     pdcattr->crBrushClr      = pState->crBrushClr;
+     pdcattr->ulForegroundClr = pState->ulForegroundClr;
+     pdcattr->ulBackgroundClr = pState->ulBackgroundClr;
+     pdcattr->ulBrushClr      = pState->ulBrushClr;
+     pdcattr->ulDirty_ |= DIRTY_FILL|DIRTY_LINE|DIRTY_TEXT|DIRTY_BACKGROUND;
+  }
+
+  if (Old.hbrush != pState->hbrush)
+  {
+     pdcattr->hbrush = pState->hbrush;
+     pdcattr->ulDirty_ |= DC_BRUSH_DIRTY;
+  }
+
+  pdcattr->hlfntNew = pState->hlfntNew;
+  pdcattr->lTextAlign = pState->lTextAlign;
+  pdcattr->lBkMode = pState->lBkMode;
+  pdcattr->jBkMode = (BYTE)pState->lBkMode;
+
+  *pState = Old;
+}
+
 //
 // Process the batch.
 //
 ULONG
 FASTCALL
-GdiFlushUserBatch(PDC dc, PGDIBATCHHDR pHdr)
+GdiFlushUserBatch(PDC dc, PGDIBATCHHDR pHdr, ULONG cjMax)
 {
   ULONG Cmd = 0, Size = 0;
   PDC_ATTR pdcattr = NULL;
+  GDIBATCHSTATE State;
 
   if (dc)
   {
@@ -86,19 +171,159 @@ GdiFlushUserBatch(PDC dc, PGDIBATCHHDR pHdr)
   }
   _SEH2_END;
 
+  /* A record running past the end of the buffer ends the batch */
+  if (Size < sizeof(GDIBATCHHDR) || Size > cjMax) return 0;
+
   switch(Cmd)
   {
      case GdiBCPatBlt:
+     {
+        PGDIBSPATBLT pgDPB;
+        DWORD dwRop;
+
+        if (!dc) break;
+        if (Size < sizeof(GDIBSPATBLT)) return 0;
+        pgDPB = (PGDIBSPATBLT) pHdr;
+
+        /* Same rules as NtGdiPatBlt */
+        dwRop = pgDPB->dwRop & 0x00FF0000;
+        dwRop |= dwRop << 8;
+        if (ROP4_USES_SOURCE(dwRop >> 16)) break;
+        if (dc->dclevel.pSurface == NULL) break;
+
+        GdiBatchInitState(pdcattr, &State);
+        State.crForegroundClr = pgDPB->crForegroundClr;
+        State.crBackgroundClr = pgDPB->crBackgroundClr;
+        State.crBrushClr      = pgDPB->crBrushClr;
+        State.ulForegroundClr = pgDPB->ulForegroundClr;
+        State.ulBackgroundClr = pgDPB->ulBackgroundClr;
+        State.ulBrushClr      = pgDPB->ulBrushClr;
+        State.hbrush          = pgDPB->hbrush;
+        GdiBatchSwapState(pdcattr, &State);
+
+        if (pdcattr->ulDirty_ & (DIRTY_FILL | DC_BRUSH_DIRTY))
+           DC_vUpdateFillBrush(dc);
+
+        IntPatBlt(dc,
+                  pgDPB->nXLeft,
+                  pgDPB->nYLeft,
+                  pgDPB->nWidth,
+                  pgDPB->nHeight,
+                  dwRop,
+                  &dc->eboFill);
+
+        GdiBatchSwapState(pdcattr, &State);
         break;
+     }
 
      case GdiBCPolyPatBlt:
+     {
+        PGDIBSPPATBLT pgDPB;
+        DWORD dwRop, Count;
+
+        if (!dc) break;
+        if (Size < FIELD_OFFSET(GDIBSPPATBLT, pRect)) return 0;
+        pgDPB = (PGDIBSPPATBLT) pHdr;
+
+        /* The buffer is shared with user mode, only read the count once */
+        Count = pgDPB->Count;
+        if (Count > (Size - FIELD_OFFSET(GDIBSPPATBLT, pRect)) / sizeof(PATRECT)) return 0;
+
+        dwRop = pgDPB->rop4 & 0x00FF0000;
+        dwRop |= dwRop << 8;
+        if (ROP4_USES_SOURCE(dwRop >> 16)) break;
+        if (dc->dclevel.pSurface == NULL) break;
+
+        GdiBatchInitState(pdcattr, &State);
+        State.crForegroundClr = pgDPB->crForegroundClr;
+        State.crBackgroundClr = pgDPB->crBackgroundClr;
+        State.crBrushClr      = pgDPB->crBrushClr;
+        State.ulForegroundClr = pgDPB->ulForegroundClr;
+        State.ulBackgroundClr = pgDPB->ulBackgroundClr;
+        State.ulBrushClr      = pgDPB->ulBrushClr;
+        GdiBatchSwapState(pdcattr, &State);
+
+        /* The DC lock is recursive, so this can lock it again by handle */
+        IntGdiPolyPatBlt(dc->BaseObject.hHmgr,
+                         dwRop,
+                         pgDPB->pRect,
+                         Count,
+                         pgDPB->Mode);
+
+        GdiBatchSwapState(pdcattr, &State);
         break;
+     }
 
      case GdiBCTextOut:
+     {
+        PGDIBSTEXTOUT pgO;
+        RECTL rcl;
+        UINT cbCount;
+
+        if (!dc) break;
+        if (Size < FIELD_OFFSET(GDIBSTEXTOUT, String)) return 0;
+        pgO = (PGDIBSTEXTOUT) pHdr;
+
+        cbCount = pgO->cbCount;
+        if (cbCount > (Size - FIELD_OFFSET(GDIBSTEXTOUT, String)) / sizeof(WCHAR)) return 0;
+
+        GdiBatchInitState(pdcattr, &State);
+        State.crForegroundClr = pgO->crForegroundClr;
+        State.crBackgroundClr = pgO->crBackgroundClr;
+        State.ulForegroundClr = pgO->ulForegroundClr;
+        State.ulBackgroundClr = pgO->ulBackgroundClr;
+        State.hlfntNew        = pgO->hlfntNew;
+        State.lTextAlign      = pgO->flTextAlign;
+        State.lBkMode         = pgO->lmBkMode;
+        GdiBatchSwapState(pdcattr, &State);
+
+        /* GreExtTextOutW converts the rectangle in place */
+        rcl = *(PRECTL)&pgO->Rect;
+
+        GreExtTextOutW(dc->BaseObject.hHmgr,
+                       pgO->x,
+                       pgO->y,
+                       pgO->Options,
+                       (pgO->Options & (ETO_OPAQUE | ETO_CLIPPED)) ? &rcl : NULL,
+                       pgO->String,
+                       cbCount,
+                       NULL,
+                       pgO->iCS_CP);
+
+        GdiBatchSwapState(pdcattr, &State);
         break;
+     }
 
      case GdiBCExtTextOut:
+     {
+        PGDIBSEXTTEXTOUT pgO;
+        RECTL rcl;
+
+        if (!dc) break;
+        if (Size < sizeof(GDIBSEXTTEXTOUT)) return 0;
+        pgO = (PGDIBSEXTTEXTOUT) pHdr;
+
+        /* Only the opaque rectangle is recorded, there is no string */
+        GdiBatchInitState(pdcattr, &State);
+        State.crBackgroundClr = pgO->ulBackgroundClr;
+        State.ulBackgroundClr = pgO->ulBackgroundClr;
+        GdiBatchSwapState(pdcattr, &State);
+
+        rcl = *(PRECTL)&pgO->Rect;
+
+        GreExtTextOutW(dc->BaseObject.hHmgr,
+                       0,
+                       0,
+                       pgO->Options,
+                       &rcl,
+                       NULL,
+                       0,
+                       NULL,
+                       0);
+
+        GdiBatchSwapState(pdcattr, &State);
         break;
+     }
 
      case GdiBCSetBrushOrg:
      {
@@ -111,7 +336,26 @@ GdiFlushUserBatch(PDC dc, PGDIBATCHHDR pHdr)
      }
 
      case GdiBCExtSelClipRgn:
+     {
+        PGDIBSEXTSELCLPRGN pgO;
+        PREGION prgn = NULL;
+
+        if (!dc) break;
+        if (Size < sizeof(GDIBSEXTSELCLPRGN)) return 0;
+        pgO = (PGDIBSEXTSELCLPRGN) pHdr;
+
+        /* The high bit of the mode says there is no region */
+        if (!(pgO->fnMode & 0x80000000))
+        {
+           prgn = IntSysCreateRectpRgn(pgO->left, pgO->top, pgO->right, pgO->bottom);
+           if (!prgn) break;
+        }
+
+        IntGdiExtSelectClipRgn(dc, prgn, pgO->fnMode & ~0x80000000);
+
+        if (prgn) REGION_Delete(prgn);
         break;
+     }
 
      case GdiBCSelObj:
      {
@@ -177,6 +421,7 @@ NtGdiFlushUserBatch(VOID)
     if (hDC || GdiBatchCount)
     {
       PCHAR pHdr = (PCHAR)&pTeb->GdiTebBatch.Buffer[0];
+      ULONG Offset = 0;
       PDC pDC = NULL;
 
       if (GDI_HANDLE_GET_TYPE(hDC) == GDILoObjType_LO_DC_TYPE && GreIsHandleValid(hDC))
@@ -188,10 +433,15 @@ NtGdiFlushUserBatch(VOID)
        for (; GdiBatchCount > 0; GdiBatchCount--)
        {
            ULONG Size;
+
+           // The header itself has to be inside the buffer.
+           if (Offset + sizeof(GDIBATCHHDR) > GDIBATCHBUFSIZE) break;
+
            // Process Gdi Batch!
-           Size = GdiFlushUserBatch(pDC, (PGDIBATCHHDR) pHdr);
+           Size = GdiFlushUserBatch(pDC, (PGDIBATCHHDR) pHdr, GDIBATCHBUFSIZE - Offset);
            if (!Size) break;
            pHdr += Size;
+           Offset += Size;
        }
 
        if (pDC)
@@ -53,6 +53,22 @@ GreMoveTo( HDC hdc,
 
 /* Shape functions */
 
+BOOL FASTCALL
+IntPatBlt(PDC pdc,
+          INT XLeft,
+          INT YLeft,
+          INT Width,
+          INT Height,
+          DWORD dwRop,
+          PEBRUSHOBJ pebo);
+
+BOOL FASTCALL
+IntGdiPolyPatBlt(HDC hDC,
+                 DWORD dwRop,
+                 PPATRECT pRects,
+                 INT cRects,
+                 ULONG Reserved);
+
 BOOL
 NTAPI
 GreGradientFill(
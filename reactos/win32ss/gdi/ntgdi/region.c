@@ -429,7 +429,7 @@ static __inline int xmemcheck(ROSRGNDATA *reg, PRECTL *rect, PRECTL *firstrect)
         COPY_RECTS(temp, *firstrect, reg->rdh.nCount);
 
         reg->rdh.nRgnSize = NewSize;
-        if (*firstrect != &reg->rdh.rcBound)
+        if (*firstrect != &reg->rdh.rcBound && *firstrect != reg->prclArena)
         {
             ExFreePoolWithTag(*firstrect, TAG_REGION);
         }
@@ -449,6 +449,10 @@ typedef void (FASTCALL *nonOverlapProcp)(PROSRGNDATA, PRECT, PRECT, INT, INT);
 
 #define RGN_DEFAULT_RECTS	2
 
+/* Region operations with results this small build them on the stack and
+   allocate the final buffer once, at its exact size */
+#define RGN_OP_ARENA_RECTS	16
+
 // Used to allocate buffers for points and link the buffers together
 
 typedef struct _POINTBLOCK
@@ -931,6 +935,7 @@ REGION_RegionOp(
     RECTL *r2BandEnd;                  /* End of current band in r2 */
     ULONG top;                        /* Top of non-overlapping band */
     ULONG bot;                        /* Bottom of non-overlapping band */
+    RECTL arclArena[RGN_OP_ARENA_RECTS]; /* Scratch space for small results */
 
     /*
      * Initialization:
@@ -963,11 +968,23 @@ REGION_RegionOp(
      */
     newReg->rdh.nRgnSize = max(reg1->rdh.nCount + 1,reg2->rdh.nCount) * 2 * sizeof(RECT);
 
-    newReg->Buffer = ExAllocatePoolWithTag(PagedPool, newReg->rdh.nRgnSize, TAG_REGION);
-    if (!newReg->Buffer)
+    if (newReg->rdh.nRgnSize <= sizeof(arclArena))
     {
-        newReg->rdh.nRgnSize = 0;
-        return;
+        /* Small enough to start out on the stack. This saves allocating
+           a guess now and a buffer of the right size at the end. */
+        newReg->rdh.nRgnSize = sizeof(arclArena);
+        newReg->Buffer = arclArena;
+        newReg->prclArena = arclArena;
+    }
+    else
+    {
+        newReg->prclArena = NULL;
+        newReg->Buffer = ExAllocatePoolWithTag(PagedPool, newReg->rdh.nRgnSize, TAG_REGION);
+        if (!newReg->Buffer)
+        {
+            newReg->rdh.nRgnSize = 0;
+            return;
+        }
     }
 
     /*
@@ -1144,6 +1161,40 @@ REGION_RegionOp(
         (void) REGION_Coalesce (newReg, prevBand, curBand);
     }
 
+    newReg->prclArena = NULL;
+    if (newReg->Buffer == arclArena)
+    {
+        /*
+         * The result never left the stack. Move it to the region's own
+         * storage, which is the bounds rectangle for a single rectangle
+         * (or none at all), same as REGION_AllocRgnWithHandle does.
+         */
+        if (newReg->rdh.nCount <= 1)
+        {
+            if (newReg->rdh.nCount == 1)
+                newReg->rdh.rcBound = arclArena[0];
+            newReg->Buffer = &newReg->rdh.rcBound;
+            newReg->rdh.nRgnSize = sizeof(RECT);
+        }
+        else
+        {
+            newReg->Buffer = ExAllocatePoolWithTag(PagedPool,
+                                                   newReg->rdh.nCount * sizeof(RECT),
+                                                   TAG_REGION);
+            if (newReg->Buffer)
+            {
+                newReg->rdh.nRgnSize = newReg->rdh.nCount * sizeof(RECT);
+                COPY_RECTS(newReg->Buffer, arclArena, newReg->rdh.nCount);
+            }
+            else
+            {
+                /* Out of memory, leave an empty region behind */
+                newReg->Buffer = &newReg->rdh.rcBound;
+                newReg->rdh.nRgnSize = sizeof(RECT);
+                newReg->rdh.nCount = 0;
+            }
+        }
+    }
     /*
      * A bit of cleanup. To keep regions from growing without bound,
      * we shrink the array of rectangles to match the new number of
@@ -1152,7 +1203,7 @@ REGION_RegionOp(
      * Only do this stuff if the number of rectangles allocated is more than
      * twice the number of rectangles in the region (a simple optimization...).
      */
-    if ((2 * newReg->rdh.nCount*sizeof(RECT) < newReg->rdh.nRgnSize && (newReg->rdh.nCount > 2)))
+    else if ((2 * newReg->rdh.nCount*sizeof(RECT) < newReg->rdh.nRgnSize && (newReg->rdh.nCount > 2)))
     {
         if (REGION_NOT_EMPTY(newReg))
         {
@@ -2509,6 +2560,84 @@ IntGdiPaintRgn(
     return bRet;
 }
 
+/*
+ * The rectangles of a region are kept in y-x banded order: sorted by top,
+ * with all rectangles of a band sharing top and bottom, and sorted by left
+ * inside a band. Bands never overlap, so bottom doesn't decrease along the
+ * buffer either, and left and right both increase inside a band. That is
+ * enough to binary search the buffer instead of walking it.
+ */
+
+/* Returns the index of the first rectangle at or after iStart that ends below Y */
+static
+ULONG
+FASTCALL
+REGION_FindBand(
+    PREGION prgn,
+    ULONG iStart,
+    LONG Y)
+{
+    ULONG iLow = iStart, iHigh = prgn->rdh.nCount, iMid;
+
+    while (iLow < iHigh)
+    {
+        iMid = iLow + (iHigh - iLow) / 2;
+        if (prgn->Buffer[iMid].bottom <= Y)
+            iLow = iMid + 1;
+        else
+            iHigh = iMid;
+    }
+
+    return iLow;
+}
+
+/* Returns the index of the first rectangle after the band starting at iBand */
+static
+ULONG
+FASTCALL
+REGION_FindBandEnd(
+    PREGION prgn,
+    ULONG iBand)
+{
+    ULONG iLow = iBand + 1, iHigh = prgn->rdh.nCount, iMid;
+    LONG Top = prgn->Buffer[iBand].top;
+
+    while (iLow < iHigh)
+    {
+        iMid = iLow + (iHigh - iLow) / 2;
+        if (prgn->Buffer[iMid].top == Top)
+            iLow = iMid + 1;
+        else
+            iHigh = iMid;
+    }
+
+    return iLow;
+}
+
+/* Returns the index of the first rectangle in [iBand, iBandEnd) that ends right of X */
+static
+ULONG
+FASTCALL
+REGION_FindInBand(
+    PREGION prgn,
+    ULONG iBand,
+    ULONG iBandEnd,
+    LONG X)
+{
+    ULONG iLow = iBand, iHigh = iBandEnd, iMid;
+
+    while (iLow < iHigh)
+    {
+        iMid = iLow + (iHigh - iLow) / 2;
+        if (prgn->Buffer[iMid].right <= X)
+            iLow = iMid + 1;
+        else
+            iHigh = iMid;
+    }
+
+    return iLow;
+}
+
 BOOL
 FASTCALL
 REGION_PtInRegion(
@@ -2516,17 +2645,20 @@ REGION_PtInRegion(
     INT X,
     INT Y)
 {
-    ULONG i;
-    PRECT r;
+    ULONG i, iEnd;
 
     if (prgn->rdh.nCount > 0 && INRECT(prgn->rdh.rcBound, X, Y))
     {
-        r =  prgn->Buffer;
-        for (i = 0; i < prgn->rdh.nCount; i++)
-        {
-            if (INRECT(r[i], X, Y))
-                return TRUE;
-        }
+        /* Find the band containing Y, if any */
+        i = REGION_FindBand(prgn, 0, Y);
+        if ((i == prgn->rdh.nCount) || (prgn->Buffer[i].top > Y))
+            return FALSE;
+
+        /* Then the rectangle in that band that could contain X */
+        iEnd = REGION_FindBandEnd(prgn, i);
+        i = REGION_FindInBand(prgn, i, iEnd, X);
+        if ((i < iEnd) && (prgn->Buffer[i].left <= X))
+            return TRUE;
     }
 
     return FALSE;
@@ -2539,7 +2671,7 @@ REGION_RectInRegion(
     const RECTL *rect
 )
 {
-    PRECTL pCurRect, pRectEnd;
+    ULONG i, iBandEnd, iRect;
     RECT rc;
 
     /* Swap the coordinates to make right >= left and bottom >= top */
@@ -2562,23 +2694,20 @@ REGION_RectInRegion(
     /* This is (just) a useful optimization */
     if ((Rgn->rdh.nCount > 0) && EXTENTCHECK(&Rgn->rdh.rcBound, &rc))
     {
-        for (pCurRect = Rgn->Buffer, pRectEnd = pCurRect +
-         Rgn->rdh.nCount; pCurRect < pRectEnd; pCurRect++)
-        {
-            if (pCurRect->bottom <= rc.top)
-            continue;             /* Not far enough down yet */
+        /* Skip the bands above the rectangle */
+        i = REGION_FindBand(Rgn, 0, rc.top);
 
-            if (pCurRect->top >= rc.bottom)
-                break;                /* Too far down */
-
-            if (pCurRect->right <= rc.left)
-                continue;              /* Not far enough over yet */
+        /* Check each band until we are too far down */
+        while ((i < Rgn->rdh.nCount) && (Rgn->Buffer[i].top < rc.bottom))
+        {
+            iBandEnd = REGION_FindBandEnd(Rgn, i);
 
-            if (pCurRect->left >= rc.right) {
-                continue;
-            }
+            /* The first rectangle ending right of rc.left is the only candidate */
+            iRect = REGION_FindInBand(Rgn, i, iBandEnd, rc.left);
+            if ((iRect < iBandEnd) && (Rgn->Buffer[iRect].left < rc.right))
+                return TRUE;
 
-            return TRUE;
+            i = iBandEnd;
         }
     }
     return FALSE;
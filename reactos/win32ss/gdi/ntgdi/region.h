@@ -14,6 +14,7 @@ typedef struct _ROSRGNDATA
 
   RGNDATAHEADER rdh;
   RECTL        *Buffer;
+  RECTL        *prclArena; /* Scratch buffer REGION_RegionOp builds into, never freed */
 } ROSRGNDATA, *PROSRGNDATA, *LPROSRGNDATA, REGION, *PREGION;
 
 
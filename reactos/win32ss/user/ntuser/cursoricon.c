@@ -1371,6 +1371,7 @@ UserDrawIconEx(
                                pdcClipObj,
                                &exlo.xlo,
                                NULL,
+                               COLORONCOLOR,
                                &rcDest,
                                &rcSrc,
                                NULL,
@@ -1401,6 +1402,7 @@ UserDrawIconEx(
                                    pdcClipObj,
                                    &exlo.xlo,
                                    NULL,
+                                   COLORONCOLOR,
                                    &rcDest,
                                    &rcSrc,
                                    NULL,
@@ -1430,6 +1432,7 @@ UserDrawIconEx(
                                    pdcClipObj,
                                    &exlo.xlo,
                                    NULL,
+                                   COLORONCOLOR,
                                    &rcDest,
                                    &rcSrc,
                                    NULL,
@@ -1369,6 +1369,7 @@ NoAlpha:
                                pdcClipObj,
                                &exlo.xlo,
                                NULL,
+                               COLORONCOLOR,
                                &rcDest,
                                &rcSrc,
                                NULL,
@@ -1399,6 +1400,7 @@ NoAlpha:
                                    pdcClipObj,
                                    &exlo.xlo,
                                    NULL,
+                                   COLORONCOLOR,
                                    &rcDest,
                                    &rcSrc,
                                    NULL,
@@ -1428,6 +1430,7 @@ NoAlpha:
                                    pdcClipObj,
                                    &exlo.xlo,
                                    NULL,
+                                   COLORONCOLOR,
                                    &rcDest,
                                    &rcSrc,
                                    NULL,
@@ -341,6 +341,10 @@ UserCreateThreadInfo(struct _ETHREAD *Thread)
     InitializeListHead(&ptiCurrent->WindowListHead);
     InitializeListHead(&ptiCurrent->W32CallbackListHead);
     InitializeListHead(&ptiCurrent->PostedMessagesListHead);
+    for (i = 0; i < QSPOSTCLASSES; i++)
+    {
+        InitializeListHead(&ptiCurrent->PostedClassListHead[i]);
+    }
     InitializeListHead(&ptiCurrent->SentMessagesListHead);
     InitializeListHead(&ptiCurrent->DispatchingMessagesHead);
     InitializeListHead(&ptiCurrent->LocalDispatchingMessagesHead);
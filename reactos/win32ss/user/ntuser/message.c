@@ -674,7 +674,7 @@ IntDispatchMessage(PMSG pMsg)
     {
         if (pMsg->message == WM_TIMER)
         {
-            if (ValidateTimerCallback(pti,pMsg->lParam))
+            if (ValidateTimerCallback(pti, Window, pMsg->wParam, pMsg->lParam))
             {
                 KeQueryTickCount(&TickCount);
                 Time = MsqCalculateMessageTime(&TickCount);
@@ -671,6 +671,57 @@ MsqDestroyMessage(PUSER_MESSAGE Message)
    ExFreeToPagedLookasideList(pgMessageLookasideList, Message);
 }
 
+/* First message of each posted message class, see PostedClassListHead */
+static const UINT MsqPostClassBase[QSPOSTCLASSES] =
+{
+   0,             // Window management, WM_NULL, WM_QUIT, nonclient mouse
+   WM_KEYFIRST,   // Keyboard
+   0x0110,        // WM_INITDIALOG, WM_COMMAND, WM_TIMER, menus...
+   WM_MOUSEFIRST, // Mouse
+   0x0300,        // Clipboard, DDE, pen and the rest below WM_USER
+   WM_USER,
+   WM_APP,
+   0xC000         // Registered messages and internal event messages
+};
+
+static UINT FASTCALL
+MsqPostClassFromMessage(UINT Msg)
+{
+   UINT Class = QSPOSTCLASSES - 1;
+
+   while (Msg < MsqPostClassBase[Class]) Class--;
+
+   return Class;
+}
+
+static VOID FASTCALL
+MsqInsertPostedMessage(PTHREADINFO pti, PUSER_MESSAGE Message, BOOLEAN Head)
+{
+   PLIST_ENTRY ClassList;
+
+   ClassList = &pti->PostedClassListHead[MsqPostClassFromMessage(Message->Msg.message)];
+
+   if (Head)
+   {
+      Message->Sequence = --pti->PostSeqHead;
+      InsertHeadList(&pti->PostedMessagesListHead, &Message->ListEntry);
+      InsertHeadList(ClassList, &Message->ClassEntry);
+   }
+   else
+   {
+      Message->Sequence = pti->PostSeqTail++;
+      InsertTailList(&pti->PostedMessagesListHead, &Message->ListEntry);
+      InsertTailList(ClassList, &Message->ClassEntry);
+   }
+}
+
+static VOID FASTCALL
+MsqRemovePostedMessage(PUSER_MESSAGE Message)
+{
+   RemoveEntryList(&Message->ListEntry);
+   RemoveEntryList(&Message->ClassEntry);
+}
+
 BOOLEAN FASTCALL
 co_MsqDispatchOneSentMessage(PTHREADINFO pti)
 {
@@ -841,16 +892,12 @@ MsqRemoveWindowMessagesFromQueue(PWND Window)
    {
       PostedMessage = CONTAINING_RECORD(CurrentEntry, USER_MESSAGE,
                                         ListEntry);
+      CurrentEntry = CurrentEntry->Flink;
       if (PostedMessage->Msg.hwnd == Window->head.h)
       {
-         RemoveEntryList(&PostedMessage->ListEntry);
+         MsqRemovePostedMessage(PostedMessage);
          ClearMsgBitsMask(pti, PostedMessage->QS_Flags);
          MsqDestroyMessage(PostedMessage);
-         CurrentEntry = pti->PostedMessagesListHead.Flink;
-      }
-      else
-      {
-         CurrentEntry = CurrentEntry->Flink;
       }
    }
 
@@ -1222,13 +1269,11 @@ MsqPostMessage(PTHREADINFO pti,
    if (dwQEvent)
    {
        ERR("Post Msg; System Qeued Event Message!\n");
-       InsertHeadList(&pti->PostedMessagesListHead,
-                      &Message->ListEntry);
+       MsqInsertPostedMessage(pti, Message, TRUE);
    }
    else if (!HardwareMessage)
    {
-       InsertTailList(&pti->PostedMessagesListHead,
-                      &Message->ListEntry);
+       MsqInsertPostedMessage(pti, Message, FALSE);
    }
    else
    {
@@ -1810,6 +1855,26 @@ co_MsqPeekHardwareMessage(IN PTHREADINFO pti,
     return Ret;
 }
 
+/*
+ MSDN:
+ 1: any window that belongs to the current thread, and any messages on the current thread's message queue whose hwnd value is NULL.
+ 2: retrieves only messages on the current thread's message queue whose hwnd value is NULL.
+ 3: handle to the window whose messages are to be retrieved.
+ */
+static __inline BOOL
+MsqIsPostedMessageMatch(PUSER_MESSAGE Message,
+                        PWND Window,
+                        UINT MsgFilterLow,
+                        UINT MsgFilterHigh,
+                        UINT QSflags)
+{
+   return ( ( !Window || // 1
+             ( Window == PWND_BOTTOM && Message->Msg.hwnd == NULL ) || // 2
+             ( Window != PWND_BOTTOM && Window->head.h == Message->Msg.hwnd ) ) && // 3
+             ( ( ( MsgFilterLow == 0 && MsgFilterHigh == 0 ) && Message->QS_Flags & QSflags ) ||
+               ( MsgFilterLow <= Message->Msg.message && MsgFilterHigh >= Message->Msg.message ) ) );
+}
+
 BOOLEAN APIENTRY
 MsqPeekMessage(IN PTHREADINFO pti,
                   IN BOOLEAN Remove,
@@ -1820,51 +1885,65 @@ MsqPeekMessage(IN PTHREADINFO pti,
                   OUT PMSG Message)
 {
    PLIST_ENTRY CurrentEntry;
-   PUSER_MESSAGE CurrentMessage;
+   PUSER_MESSAGE CurrentMessage, FoundMessage = NULL;
    PLIST_ENTRY ListHead;
-   BOOL Ret = FALSE;
-
-   CurrentEntry = pti->PostedMessagesListHead.Flink;
-   ListHead = &pti->PostedMessagesListHead;
+   UINT Class, LastClass;
 
-   if (IsListEmpty(CurrentEntry)) return FALSE;
+   if (IsListEmpty(&pti->PostedMessagesListHead)) return FALSE;
 
-   CurrentMessage = CONTAINING_RECORD(CurrentEntry, USER_MESSAGE,
-                                         ListEntry);
-   do
+   if (MsgFilterLow == 0 && MsgFilterHigh == 0)
    {
-      if (IsListEmpty(CurrentEntry)) break;
-      if (!CurrentMessage) break;
-      CurrentEntry = CurrentEntry->Flink;
-/*
- MSDN:
- 1: any window that belongs to the current thread, and any messages on the current thread's message queue whose hwnd value is NULL.
- 2: retrieves only messages on the current thread's message queue whose hwnd value is NULL.
- 3: handle to the window whose messages are to be retrieved.
- */
-      if ( ( !Window || // 1
-            ( Window == PWND_BOTTOM && CurrentMessage->Msg.hwnd == NULL ) || // 2
-            ( Window != PWND_BOTTOM && Window->head.h == CurrentMessage->Msg.hwnd ) ) && // 3
-            ( ( ( MsgFilterLow == 0 && MsgFilterHigh == 0 ) && CurrentMessage->QS_Flags & QSflags ) ||
-              ( MsgFilterLow <= CurrentMessage->Msg.message && MsgFilterHigh >= CurrentMessage->Msg.message ) ) )
+      /* No range, walk everything in posting order */
+      ListHead = &pti->PostedMessagesListHead;
+      for (CurrentEntry = ListHead->Flink; CurrentEntry != ListHead; CurrentEntry = CurrentEntry->Flink)
       {
-         *Message = CurrentMessage->Msg;
+         CurrentMessage = CONTAINING_RECORD(CurrentEntry, USER_MESSAGE, ListEntry);
+         if (MsqIsPostedMessageMatch(CurrentMessage, Window, 0, 0, QSflags))
+         {
+            FoundMessage = CurrentMessage;
+            break;
+         }
+      }
+   }
+   else
+   {
+      if (MsgFilterLow > MsgFilterHigh) return FALSE;
 
-         if (Remove)
+      /* Only the classes that overlap the range can hold a match. Each class
+         list is in posting order, so the oldest match is the first match of
+         the class lists, and a class can stop at the current best one. */
+      LastClass = MsqPostClassFromMessage(MsgFilterHigh);
+      for (Class = MsqPostClassFromMessage(MsgFilterLow); Class <= LastClass; Class++)
+      {
+         ListHead = &pti->PostedClassListHead[Class];
+         for (CurrentEntry = ListHead->Flink; CurrentEntry != ListHead; CurrentEntry = CurrentEntry->Flink)
          {
-             RemoveEntryList(&CurrentMessage->ListEntry);
-             ClearMsgBitsMask(pti, CurrentMessage->QS_Flags);
-             MsqDestroyMessage(CurrentMessage);
+            CurrentMessage = CONTAINING_RECORD(CurrentEntry, USER_MESSAGE, ClassEntry);
+            if (FoundMessage &&
+                (LONG)(CurrentMessage->Sequence - FoundMessage->Sequence) > 0)
+               break;
+
+            if (MsqIsPostedMessageMatch(CurrentMessage, Window, MsgFilterLow, MsgFilterHigh, QSflags))
+            {
+               FoundMessage = CurrentMessage;
+               break;
+            }
          }
-         Ret = TRUE;
-         break;
       }
-      CurrentMessage = CONTAINING_RECORD(CurrentEntry, USER_MESSAGE,
-                                         ListEntry);
    }
-   while (CurrentEntry != ListHead);
 
-   return Ret;
+   if (!FoundMessage) return FALSE;
+
+   *Message = FoundMessage->Msg;
+
+   if (Remove)
+   {
+      MsqRemovePostedMessage(FoundMessage);
+      ClearMsgBitsMask(pti, FoundMessage->QS_Flags);
+      MsqDestroyMessage(FoundMessage);
+   }
+
+   return TRUE;
 }
 
 NTSTATUS FASTCALL
@@ -1926,9 +2005,10 @@ MsqCleanupThreadMsgs(PTHREADINFO pti)
    /* cleanup posted messages */
    while (!IsListEmpty(&pti->PostedMessagesListHead))
    {
-      CurrentEntry = RemoveHeadList(&pti->PostedMessagesListHead);
+      CurrentEntry = pti->PostedMessagesListHead.Flink;
       CurrentMessage = CONTAINING_RECORD(CurrentEntry, USER_MESSAGE,
                                          ListEntry);
+      MsqRemovePostedMessage(CurrentMessage);
       MsqDestroyMessage(CurrentMessage);
    }
 
@@ -9,6 +9,8 @@
 typedef struct _USER_MESSAGE
 {
   LIST_ENTRY ListEntry;
+  LIST_ENTRY ClassEntry; // Posted messages only, see PostedClassListHead.
+  ULONG Sequence;        // Posted messages only, orders the class lists.
   MSG Msg;
   DWORD QS_Flags;
   LONG_PTR ExtraInfo;
@@ -14,7 +14,25 @@ DBG_DEFAULT_CHANNEL(UserTimer);
 /* GLOBALS *******************************************************************/
 
 static LIST_ENTRY TimersListHead;
-static LONG TimeLast = 0;
+static LIST_ENTRY TimersReadyListHead;
+
+/* Timers hashed by (pWnd, nID), used for lookups from SetTimer and KillTimer */
+#define TIMER_HASH_BUCKETS       64
+static LIST_ENTRY TimersHashTable[TIMER_HASH_BUCKETS];
+
+#define TimerHashBucket(pWnd, nID) \
+  (&TimersHashTable[(((ULONG_PTR)(pWnd) >> 4) ^ (ULONG_PTR)(nID)) & (TIMER_HASH_BUCKETS - 1)])
+
+/* Binary min-heap of the running timers, keyed by due time. It always has a
+   slot for every timer so queuing a timer never has to allocate. */
+#define TIMER_NOT_QUEUED         ((ULONG)-1)
+#define TIMER_HEAP_INITIAL_SIZE  64
+static PTIMER *TimerHeap;
+static ULONG TimerHeapCount;
+static ULONG TimerHeapSize;
+static ULONG TimerCount;
+
+#define TimerDueBefore(a, b) ((LONG)((ULONG)(a)->tDue - (ULONG)(b)->tDue) < 0)
 
 /* Windows 2000 has room for 32768 window-less timers */
 #define NUM_WINDOW_LESS_TIMERS   32768
@@ -46,19 +64,149 @@ ERESOURCE TimerLock;
 
 
 /* FUNCTIONS *****************************************************************/
+static
+VOID
+FASTCALL
+TimerHeapSet(ULONG Index, PTIMER pTmr)
+{
+  TimerHeap[Index] = pTmr;
+  pTmr->iHeap = Index;
+}
+
+static
+VOID
+FASTCALL
+TimerHeapSiftUp(ULONG Index)
+{
+  PTIMER pTmr = TimerHeap[Index];
+  ULONG Parent;
+
+  while (Index > 0)
+  {
+     Parent = (Index - 1) / 2;
+     if (!TimerDueBefore(pTmr, TimerHeap[Parent])) break;
+     TimerHeapSet(Index, TimerHeap[Parent]);
+     Index = Parent;
+  }
+  TimerHeapSet(Index, pTmr);
+}
+
+static
+VOID
+FASTCALL
+TimerHeapSiftDown(ULONG Index)
+{
+  PTIMER pTmr = TimerHeap[Index];
+  ULONG Child;
+
+  while ((Child = 2 * Index + 1) < TimerHeapCount)
+  {
+     if (Child + 1 < TimerHeapCount && TimerDueBefore(TimerHeap[Child + 1], TimerHeap[Child]))
+        Child++;
+     if (!TimerDueBefore(TimerHeap[Child], pTmr)) break;
+     TimerHeapSet(Index, TimerHeap[Child]);
+     Index = Child;
+  }
+  TimerHeapSet(Index, pTmr);
+}
+
+static
+VOID
+FASTCALL
+TimerQueue(PTIMER pTmr)
+{
+  ASSERT(pTmr->iHeap == TIMER_NOT_QUEUED);
+  ASSERT(TimerHeapCount < TimerHeapSize);
+
+  TimerHeapSet(TimerHeapCount++, pTmr);
+  TimerHeapSiftUp(pTmr->iHeap);
+}
+
+static
+VOID
+FASTCALL
+TimerDequeue(PTIMER pTmr)
+{
+  ULONG Index = pTmr->iHeap;
+  PTIMER pLast;
+
+  if (Index == TIMER_NOT_QUEUED) return;
+
+  pTmr->iHeap = TIMER_NOT_QUEUED;
+  pLast = TimerHeap[--TimerHeapCount];
+  if (pLast == pTmr) return;
+
+  TimerHeapSet(Index, pLast);
+  if (Index > 0 && TimerDueBefore(pLast, TimerHeap[(Index - 1) / 2]))
+     TimerHeapSiftUp(Index);
+  else
+     TimerHeapSiftDown(Index);
+}
+
+//
+// Arm the raw input thread's master timer for the earliest deadline.
+//
+static
+VOID
+FASTCALL
+TimerArmMaster(LONG Time)
+{
+  LARGE_INTEGER DueTime;
+  LONG Delta;
+
+  ASSERT(MasterTimer != NULL);
+
+  if (TimerHeapCount == 0)
+  {
+     // Nothing is running. KeSetTimer also clears the signal state so the
+     // raw input thread goes back to sleep until a timer is set.
+     Delta = USER_TIMER_MAXIMUM;
+  }
+  else
+  {
+     Delta = (LONG)((ULONG)TimerHeap[0]->tDue - (ULONG)Time);
+     if (Delta < 1) Delta = 1;
+  }
+
+  DueTime.QuadPart = Int32x32To64(Delta, -10000);
+  KeSetTimer(MasterTimer, DueTime, NULL);
+}
+
 static
 PTIMER
 FASTCALL
-CreateTimer(VOID)
+CreateTimer(PWND Window, UINT_PTR nID)
 {
   HANDLE Handle;
   PTIMER Ret = NULL;
+  PTIMER *NewHeap;
+  ULONG NewSize;
+
+  if (TimerCount == TimerHeapSize)
+  {
+     NewSize = TimerHeapSize * 2;
+     NewHeap = ExAllocatePoolWithTag(PagedPool, NewSize * sizeof(PTIMER), USERTAG_TIMER);
+     if (!NewHeap)
+     {
+        EngSetLastError(ERROR_NOT_ENOUGH_MEMORY);
+        return NULL;
+     }
+     RtlCopyMemory(NewHeap, TimerHeap, TimerHeapCount * sizeof(PTIMER));
+     ExFreePoolWithTag(TimerHeap, USERTAG_TIMER);
+     TimerHeap = NewHeap;
+     TimerHeapSize = NewSize;
+  }
 
   Ret = UserCreateObject(gHandleTable, NULL, NULL, &Handle, TYPE_TIMER, sizeof(TIMER));
   if (Ret)
   {
      Ret->head.h = Handle;
+     Ret->pWnd   = Window;
+     Ret->nID    = nID;
+     Ret->iHeap  = TIMER_NOT_QUEUED;
      InsertTailList(&TimersListHead, &Ret->ptmrList);
+     InsertTailList(TimerHashBucket(Window, nID), &Ret->ptmrHash);
+     TimerCount++;
   }
 
   return Ret;
@@ -74,6 +222,11 @@ RemoveTimer(PTIMER pTmr)
   {
      /* Set the flag, it will be removed when ready */
      RemoveEntryList(&pTmr->ptmrList);
+     RemoveEntryList(&pTmr->ptmrHash);
+     if (pTmr->flags & TMRF_READY)
+        RemoveEntryList(&pTmr->ptmrReady);
+     TimerDequeue(pTmr);
+     TimerCount--;
      if ((pTmr->pWnd == NULL) && (!(pTmr->flags & TMRF_SYSTEM))) // System timers are reusable.
      {
         UINT_PTR IDEvent;
@@ -97,14 +250,15 @@ FindTimer(PWND Window,
           UINT_PTR nID,
           UINT flags)
 {
-  PLIST_ENTRY pLE;
+  PLIST_ENTRY pLE, pBucket;
   PTIMER pTmr, RetTmr = NULL;
 
   TimerEnterExclusive();
-  pLE = TimersListHead.Flink;
-  while (pLE != &TimersListHead)
+  pBucket = TimerHashBucket(Window, nID);
+  pLE = pBucket->Flink;
+  while (pLE != pBucket)
   {
-    pTmr = CONTAINING_RECORD(pLE, TIMER, ptmrList);
+    pTmr = CONTAINING_RECORD(pLE, TIMER, ptmrHash);
 
     if ( pTmr->nID == nID &&
          pTmr->pWnd == Window &&
@@ -126,28 +280,42 @@ FASTCALL
 FindSystemTimer(PMSG pMsg)
 {
   PLIST_ENTRY pLE;
-  PTIMER pTmr = NULL;
+  PTIMER pTmr, RetTmr = NULL;
+  PWND Window = NULL;
+
+  if (pMsg->hwnd)
+     Window = ValidateHwndNoErr(pMsg->hwnd);
 
   TimerEnterExclusive();
+  /* The message normally comes from the timer itself, so try its own slot first */
+  if (Window || !pMsg->hwnd)
+  {
+     pTmr = FindTimer(Window, pMsg->wParam, TMRF_SYSTEM);
+     if (pTmr && pMsg->lParam == (LPARAM)pTmr->pfn)
+        RetTmr = pTmr;
+  }
+
   pLE = TimersListHead.Flink;
-  while (pLE != &TimersListHead)
+  while (!RetTmr && pLE != &TimersListHead)
   {
     pTmr = CONTAINING_RECORD(pLE, TIMER, ptmrList);
 
     if ( pMsg->lParam == (LPARAM)pTmr->pfn &&
          (pTmr->flags & TMRF_SYSTEM) )
-       break;
+       RetTmr = pTmr;
 
     pLE = pLE->Flink;
   }
   TimerLeave();
 
-  return pTmr;
+  return RetTmr;
 }
 
 BOOL
 FASTCALL
 ValidateTimerCallback(PTHREADINFO pti,
+                      PWND Window,
+                      WPARAM wParam,
                       LPARAM lParam)
 {
   PLIST_ENTRY pLE;
@@ -155,8 +323,17 @@ ValidateTimerCallback(PTHREADINFO pti,
   PTIMER pTmr;
 
   TimerEnterExclusive();
+  /* The message normally comes from the timer itself, so try its own slot first */
+  pTmr = FindTimer(Window, wParam, 0);
+  if ( pTmr &&
+       (lParam == (LPARAM)pTmr->pfn) &&
+       (pTmr->pti->ppi == pti->ppi) )
+  {
+     Ret = TRUE;
+  }
+
   pLE = TimersListHead.Flink;
-  while (pLE != &TimersListHead)
+  while (!Ret && pLE != &TimersListHead)
   {
     pTmr = CONTAINING_RECORD(pLE, TIMER, ptmrList);
     if ( (lParam == (LPARAM)pTmr->pfn) &&
@@ -164,7 +341,6 @@ ValidateTimerCallback(PTHREADINFO pti,
          (pTmr->pti->ppi == pti->ppi) )
     {
        Ret = TRUE;
-       break;
     }
     pLE = pLE->Flink;
   }
@@ -182,8 +358,8 @@ IntSetTimer( PWND Window,
 {
   PTIMER pTmr;
   UINT Ret = IDEvent;
-  LARGE_INTEGER DueTime;
-  DueTime.QuadPart = (LONGLONG)(-97656); // 1024hz .9765625 ms set to 10.0 ms
+  LARGE_INTEGER TickCount;
+  LONG Time;
 
 #if 0
   /* Windows NT/2k/XP behaviour */
@@ -213,6 +389,8 @@ IntSetTimer( PWND Window,
   if ((Window) && (IDEvent == 0))
      Ret = 1;
 
+  TimerEnterExclusive();
+
   pTmr = FindTimer(Window, IDEvent, Type);
 
   if ((!pTmr) && (Window == NULL) && (!(Type & TMRF_SYSTEM)))
@@ -224,6 +402,7 @@ IntSetTimer( PWND Window,
       if (IDEvent == (UINT_PTR) -1)
       {
          IntUnlockWindowlessTimerBitmap();
+         TimerLeave();
          ERR("Unable to find a free window-less timer id\n");
          EngSetLastError(ERROR_NO_SYSTEM_RESOURCES);
          ASSERT(FALSE);
@@ -238,8 +417,18 @@ IntSetTimer( PWND Window,
 
   if (!pTmr)
   {
-     pTmr = CreateTimer();
-     if (!pTmr) return 0;
+     pTmr = CreateTimer(Window, IDEvent);
+     if (!pTmr)
+     {
+        if ((Window == NULL) && (!(Type & TMRF_SYSTEM)))
+        {
+           IntLockWindowlessTimerBitmap();
+           RtlClearBit(&WindowLessTimersBitMap, NUM_WINDOW_LESS_TIMERS - IDEvent);
+           IntUnlockWindowlessTimerBitmap();
+        }
+        TimerLeave();
+        return 0;
+     }
 
      if (Window && (Type & TMRF_TIFROMWND))
         pTmr->pti = Window->head.pti->pEThread->Tcb.Win32Thread;
@@ -251,23 +440,30 @@ IntSetTimer( PWND Window,
            pTmr->pti = PsGetCurrentThreadWin32Thread();
      }
 
-     pTmr->pWnd    = Window;
-     pTmr->cmsCountdown = Elapse;
      pTmr->cmsRate = Elapse;
      pTmr->pfn     = TimerFunc;
-     pTmr->nID     = IDEvent;
      pTmr->flags   = Type|TMRF_INIT;
   }
   else
   {
-     pTmr->cmsCountdown = Elapse;
      pTmr->cmsRate = Elapse;
+     TimerDequeue(pTmr);
   }
 
-  ASSERT(MasterTimer != NULL);
-  // Start the timer thread!
-  if (TimersListHead.Flink == TimersListHead.Blink) // There is only one timer
-     KeSetTimer(MasterTimer, DueTime, NULL);
+  KeQueryTickCount(&TickCount);
+  Time = MsqCalculateMessageTime(&TickCount);
+  pTmr->tDue = (LONG)((ULONG)Time + Elapse);
+
+  if (!(pTmr->flags & TMRF_WAITING))
+  {
+     TimerQueue(pTmr);
+
+     // Start the timer thread early if this is the new first deadline.
+     if (pTmr->iHeap == 0)
+        TimerArmMaster(Time);
+  }
+
+  TimerLeave();
 
   return Ret;
 }
@@ -392,12 +588,12 @@ PostTimerMessages(PWND Window)
   pti = PsGetCurrentThreadWin32Thread();
 
   TimerEnterExclusive();
-  pLE = TimersListHead.Flink;
-  while(pLE != &TimersListHead)
+  pLE = TimersReadyListHead.Flink;
+  while(pLE != &TimersReadyListHead)
   {
-     pTmr = CONTAINING_RECORD(pLE, TIMER, ptmrList);
-     if ( (pTmr->flags & TMRF_READY) &&
-          (pTmr->pti == pti) &&
+     pTmr = CONTAINING_RECORD(pLE, TIMER, ptmrReady);
+     ASSERT(pTmr->flags & TMRF_READY);
+     if ( (pTmr->pti == pti) &&
           ((pTmr->pWnd == Window) || (Window == NULL)) )
         {
            Msg.hwnd    = (pTmr->pWnd) ? pTmr->pWnd->head.h : 0;
@@ -407,15 +603,9 @@ PostTimerMessages(PWND Window)
 
            MsqPostMessage(pti, &Msg, FALSE, (QS_POSTMESSAGE|QS_ALLPOSTMESSAGE), 0);
            pTmr->flags &= ~TMRF_READY;
+           RemoveEntryList(&pTmr->ptmrReady);
            ClearMsgBitsMask(pti, QS_TIMER);
            Hit = TRUE;
-           // Now move this entry to the end of the list so it will not be
-           // called again in the next msg loop.
-           if (pLE != &TimersListHead)
-           {
-              RemoveEntryList(&pTmr->ptmrList);
-              InsertTailList(&TimersListHead, &pTmr->ptmrList);
-           }
            break;
         }
 
@@ -431,78 +621,62 @@ VOID
 FASTCALL
 ProcessTimers(VOID)
 {
-  LARGE_INTEGER TickCount, DueTime;
+  LARGE_INTEGER TickCount;
   LONG Time;
-  PLIST_ENTRY pLE;
   PTIMER pTmr;
-  LONG TimerCount = 0;
+  LONG TimersFired = 0;
 
   TimerEnterExclusive();
-  pLE = TimersListHead.Flink;
   KeQueryTickCount(&TickCount);
   Time = MsqCalculateMessageTime(&TickCount);
 
-  DueTime.QuadPart = (LONGLONG)(-97656); // 1024hz .9765625 ms set to 10.0 ms
-
-  while(pLE != &TimersListHead)
+  // Only the timers that are due are touched, in deadline order.
+  while (TimerHeapCount &&
+         (LONG)((ULONG)TimerHeap[0]->tDue - (ULONG)Time) <= 0)
   {
-    pTmr = CONTAINING_RECORD(pLE, TIMER, ptmrList);
-    TimerCount++;
-    if (pTmr->flags & TMRF_WAITING)
-    {
-       pLE = pTmr->ptmrList.Flink;
-       pTmr = CONTAINING_RECORD(pLE, TIMER, ptmrList);
-       continue;
-    }
+    pTmr = TimerHeap[0];
+    TimerDequeue(pTmr);
+    TimersFired++;
 
-    if (pTmr->flags & TMRF_INIT)
-    {
-       pTmr->flags &= ~TMRF_INIT; // Skip this run.
-    }
-    else
+    pTmr->flags &= ~TMRF_INIT;
+    pTmr->tDue = (LONG)((ULONG)Time + pTmr->cmsRate);
+
+    ASSERT(pTmr->pti);
+    if ((!(pTmr->flags & TMRF_READY)) && (!(pTmr->pti->TIF_flags & TIF_INCLEANUP)))
     {
-       if (pTmr->cmsCountdown < 0)
-       {
-          ASSERT(pTmr->pti);
-          if ((!(pTmr->flags & TMRF_READY)) && (!(pTmr->pti->TIF_flags & TIF_INCLEANUP)))
-          {
-             if (pTmr->flags & TMRF_ONESHOT)
-                pTmr->flags |= TMRF_WAITING;
+       if (pTmr->flags & TMRF_ONESHOT)
+          pTmr->flags |= TMRF_WAITING;
+       else
+          TimerQueue(pTmr);
 
-             if (pTmr->flags & TMRF_RIT)
-             {
-                // Hard coded call here, inside raw input thread.
-                pTmr->pfn(NULL, WM_SYSTIMER, pTmr->nID, (LPARAM)pTmr);
-             }
-             else
-             {
-                pTmr->flags |= TMRF_READY; // Set timer ready to be ran.
-                // Set thread message queue for this timer.
-                if (pTmr->pti)
-                {  // Wakeup thread
-                   pTmr->pti->cTimersReady++;
-                   ASSERT(pTmr->pti->pEventQueueServer != NULL);
-                   MsqWakeQueue(pTmr->pti, QS_TIMER, TRUE);
-                }
-             }
-          }
-          pTmr->cmsCountdown = pTmr->cmsRate;
+       if (pTmr->flags & TMRF_RIT)
+       {
+          // Hard coded call here, inside raw input thread. The timer is
+          // already requeued, the callback is free to kill or reset it.
+          pTmr->pfn(NULL, WM_SYSTIMER, pTmr->nID, (LPARAM)pTmr);
        }
        else
-          pTmr->cmsCountdown -= Time - TimeLast;
+       {
+          pTmr->flags |= TMRF_READY; // Set timer ready to be ran.
+          InsertTailList(&TimersReadyListHead, &pTmr->ptmrReady);
+          // Set thread message queue for this timer.
+          if (pTmr->pti)
+          {  // Wakeup thread
+             pTmr->pti->cTimersReady++;
+             ASSERT(pTmr->pti->pEventQueueServer != NULL);
+             MsqWakeQueue(pTmr->pti, QS_TIMER, TRUE);
+          }
+       }
     }
-
-    pLE = pLE->Flink;
+    else
+       TimerQueue(pTmr);
   }
 
-  // Restart the timer thread!
-  ASSERT(MasterTimer != NULL);
-  KeSetTimer(MasterTimer, DueTime, NULL);
-
-  TimeLast = Time;
+  // Restart the timer thread for the next deadline!
+  TimerArmMaster(Time);
 
   TimerLeave();
-  TRACE("TimerCount = %d\n", TimerCount);
+  TRACE("TimersFired = %d of %u\n", TimersFired, TimerCount);
 }
 
 BOOL FASTCALL
@@ -535,12 +709,13 @@ DestroyTimersForWindow(PTHREADINFO pti, PWND Window)
 BOOL FASTCALL
 DestroyTimersForThread(PTHREADINFO pti)
 {
-   PLIST_ENTRY pLE = TimersListHead.Flink;
+   PLIST_ENTRY pLE;
    PTIMER pTmr;
    BOOL TimersRemoved = FALSE;
 
    TimerEnterExclusive();
 
+   pLE = TimersListHead.Flink;
    while(pLE != &TimersListHead)
    {
       pTmr = CONTAINING_RECORD(pLE, TIMER, ptmrList);
@@ -580,7 +755,7 @@ NTSTATUS
 NTAPI
 InitTimerImpl(VOID)
 {
-   ULONG BitmapBytes;
+   ULONG BitmapBytes, i;
 
    /* Allocate FAST_MUTEX from non paged pool */
    Mutex = ExAllocatePoolWithTag(NonPagedPool, sizeof(FAST_MUTEX), TAG_INTERNAL_SYNC);
@@ -605,8 +780,18 @@ InitTimerImpl(VOID)
    /* Yes we need this, since ExAllocatePoolWithTag isn't supposed to zero out allocated memory */
    RtlClearAllBits(&WindowLessTimersBitMap);
 
+   TimerHeapSize = TIMER_HEAP_INITIAL_SIZE;
+   TimerHeap = ExAllocatePoolWithTag(PagedPool, TimerHeapSize * sizeof(PTIMER), USERTAG_TIMER);
+   if (TimerHeap == NULL)
+   {
+      return STATUS_INSUFFICIENT_RESOURCES;
+   }
+
    ExInitializeResourceLite(&TimerLock);
    InitializeListHead(&TimersListHead);
+   InitializeListHead(&TimersReadyListHead);
+   for (i = 0; i < TIMER_HASH_BUCKETS; i++)
+      InitializeListHead(&TimersHashTable[i]);
 
    return STATUS_SUCCESS;
 }
@@ -690,10 +875,13 @@ NtUserValidateTimerCallback(
     LPARAM lParam)
 {
   BOOL Ret = FALSE;
+  PWND Window = NULL;
 
   UserEnterShared();
 
-  Ret = ValidateTimerCallback(PsGetCurrentThreadWin32Thread(), lParam);
+  if (hWnd) Window = ValidateHwndNoErr(hWnd);
+
+  Ret = ValidateTimerCallback(PsGetCurrentThreadWin32Thread(), Window, wParam, lParam);
 
   UserLeave();
   return Ret;
@@ -4,11 +4,14 @@ typedef struct _TIMER
 {
   HEAD           head;
   LIST_ENTRY     ptmrList;
+  LIST_ENTRY     ptmrHash;     // (pWnd, nID) hash bucket link.
+  LIST_ENTRY     ptmrReady;    // Ready list link, valid while TMRF_READY.
   PTHREADINFO    pti;
   PWND           pWnd;         // hWnd
   UINT_PTR       nID;          // Specifies a nonzero timer identifier.
-  INT            cmsCountdown; // uElapse
+  LONG           tDue;         // Message time the timer expires next.
   INT            cmsRate;      // uElapse
+  ULONG          iHeap;        // Slot in the due heap or TIMER_NOT_QUEUED.
   FLONG          flags;
   TIMERPROC      pfn;          // lpTimerFunc
 } TIMER, *PTIMER;
@@ -38,7 +41,7 @@ BOOL FASTCALL DestroyTimersForWindow(PTHREADINFO pti, PWND Window);
 BOOL FASTCALL IntKillTimer(PWND Window, UINT_PTR IDEvent, BOOL SystemTimer);
 UINT_PTR FASTCALL IntSetTimer(PWND Window, UINT_PTR IDEvent, UINT Elapse, TIMERPROC TimerFunc, INT Type);
 PTIMER FASTCALL FindSystemTimer(PMSG);
-BOOL FASTCALL ValidateTimerCallback(PTHREADINFO,LPARAM);
+BOOL FASTCALL ValidateTimerCallback(PTHREADINFO,PWND,WPARAM,LPARAM);
 VOID CALLBACK SystemTimerProc(HWND,UINT,UINT_PTR,DWORD);
 UINT_PTR FASTCALL SystemTimerSet(PWND,UINT_PTR,UINT,TIMERPROC);
 BOOL FASTCALL PostTimerMessages(PWND);
@@ -34,6 +34,7 @@
 #define W32PF_APIHOOKLOADED          (0x08000000)
 
 #define QSIDCOUNTS 7
+#define QSPOSTCLASSES 8
 
 typedef enum _QS_ROS_TYPES
 {
@@ -140,6 +141,12 @@ typedef struct _THREADINFO
     // Accounting of queue bit sets, the rest are flags. QS_TIMER QS_PAINT counts are handled in thread information.
     DWORD nCntsQBits[QSIDCOUNTS]; // QS_KEY QS_MOUSEMOVE QS_MOUSEBUTTON QS_POSTMESSAGE QS_SENDMESSAGE QS_HOTKEY
 
+    /* Posted messages split by message range, each in posting order, so a
+       filtered PeekMessage only visits the ranges it asks for. */
+    LIST_ENTRY PostedClassListHead[QSPOSTCLASSES];
+    ULONG PostSeqHead;
+    ULONG PostSeqTail;
+
     /* Messages that are currently dispatched by this message queue, required for cleanup */
     LIST_ENTRY LocalDispatchingMessagesHead;
     LIST_ENTRY WindowListHead;
@@ -0,0 +1,247 @@
+/*
+ * PROJECT:         ReactOS api tests
+ * LICENSE:         GPL - See COPYING in the top level directory
+ * PURPOSE:         Test for GdiAlphaBlend
+ * PROGRAMMERS:     ReactOS Team
+ */
+
+#include <apitest.h>
+
+#include <wingdi.h>
+#include <winuser.h>
+
+#define SRC_WIDTH 13
+#define SRC_HEIGHT 7
+#define DST_WIDTH 29
+#define DST_HEIGHT 11
+
+typedef struct
+{
+    ULONG cBitsPixel;
+    ULONG aulMasks[3];
+} DST_FORMAT;
+
+static const DST_FORMAT gaFormats[] =
+{
+    { 32, { 0 } },
+    { 24, { 0 } },
+    { 16, { 0xF800, 0x07E0, 0x001F } },
+    { 16, { 0x7C00, 0x03E0, 0x001F } },
+};
+
+static
+ULONG
+ReadPixel(PBYTE pjBits, ULONG cjLine, ULONG cBitsPixel, ULONG x, ULONG y)
+{
+    PBYTE pj = pjBits + y * cjLine + x * (cBitsPixel / 8);
+
+    if (cBitsPixel == 32) return *(PULONG)pj;
+    if (cBitsPixel == 24) return pj[0] | (pj[1] << 8) | (pj[2] << 16);
+    return *(PUSHORT)pj;
+}
+
+/* Expand a destination pixel to BGR. For 16bpp, GetPixel goes through the
+   same color translation the blend uses */
+static
+ULONG
+ExpandPixel(HDC hdc, const DST_FORMAT *pFormat, ULONG iColor, ULONG x, ULONG y)
+{
+    COLORREF crColor;
+
+    if (pFormat->cBitsPixel != 16) return iColor;
+
+    crColor = GetPixel(hdc, x, y);
+    return GetBValue(crColor) | (GetGValue(crColor) << 8) | (GetRValue(crColor) << 16);
+}
+
+static
+ULONG
+ReducePixel(const DST_FORMAT *pFormat, ULONG iColor)
+{
+    if (pFormat->cBitsPixel == 32) return iColor;
+    if (pFormat->cBitsPixel == 24) return iColor & 0xFFFFFF;
+
+    if (pFormat->aulMasks[1] == 0x07E0)
+    {
+        return ((iColor >> 3) & 0x1F) | ((iColor >> 5) & 0x7E0) | ((iColor >> 8) & 0xF800);
+    }
+
+    return ((iColor >> 3) & 0x1F) | ((iColor >> 6) & 0x3E0) | ((iColor >> 9) & 0x7C00);
+}
+
+static
+UCHAR
+Clamp8(ULONG ulValue)
+{
+    return (ulValue > 255) ? 255 : (UCHAR)ulValue;
+}
+
+/* Per-channel src-over, truncating like the per-pixel DIB implementation */
+static
+ULONG
+BlendPixel(ULONG ulDst, ULONG ulSrc, BLENDFUNCTION bf)
+{
+    ULONG i, ulResult = 0, Alpha, Sca = bf.SourceConstantAlpha;
+    ULONG aulSrc[4];
+
+    for (i = 0; i < 4; i++)
+        aulSrc[i] = (((ulSrc >> (i * 8)) & 0xFF) * Sca) / 255;
+
+    Alpha = (bf.AlphaFormat & AC_SRC_ALPHA) ? aulSrc[3] : Sca;
+
+    for (i = 0; i < 4; i++)
+    {
+        ulResult |= Clamp8((((ulDst >> (i * 8)) & 0xFF) * (255 - Alpha)) / 255 +
+                           aulSrc[i]) << (i * 8);
+    }
+
+    return ulResult;
+}
+
+static
+void
+Test_AlphaBlend_Format(
+    const DST_FORMAT *pFormat,
+    ULONG cxDst,
+    ULONG cyDst,
+    BLENDFUNCTION bf)
+{
+    struct
+    {
+        BITMAPINFOHEADER bmiHeader;
+        ULONG aulMasks[3];
+    } bmi;
+    HDC hdcSrc, hdcDst;
+    HBITMAP hbmpSrc, hbmpDst;
+    PULONG pulSrc, pulExpanded;
+    PBYTE pjDst, pjExpected;
+    ULONG cjLine, x, y, xSrc, ySrc, ulSrc, ulDst, ulExpected, cErrors = 0;
+    BOOL ret;
+
+    hdcSrc = CreateCompatibleDC(NULL);
+    hdcDst = CreateCompatibleDC(NULL);
+
+    ZeroMemory(&bmi, sizeof(bmi));
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = SRC_WIDTH;
+    bmi.bmiHeader.biHeight = -SRC_HEIGHT;
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+    hbmpSrc = CreateDIBSection(hdcSrc, (BITMAPINFO*)&bmi, DIB_RGB_COLORS, (PVOID*)&pulSrc, NULL, 0);
+    ok(hbmpSrc != NULL, "Failed to create source bitmap\n");
+
+    bmi.bmiHeader.biWidth = DST_WIDTH;
+    bmi.bmiHeader.biHeight = -DST_HEIGHT;
+    bmi.bmiHeader.biBitCount = (WORD)pFormat->cBitsPixel;
+    if (pFormat->aulMasks[0])
+    {
+        bmi.bmiHeader.biCompression = BI_BITFIELDS;
+        memcpy(bmi.aulMasks, pFormat->aulMasks, sizeof(bmi.aulMasks));
+    }
+    hbmpDst = CreateDIBSection(hdcDst, (BITMAPINFO*)&bmi, DIB_RGB_COLORS, (PVOID*)&pjDst, NULL, 0);
+    ok(hbmpDst != NULL, "Failed to create destination bitmap\n");
+    if (!hbmpSrc || !hbmpDst)
+    {
+        goto Cleanup;
+    }
+
+    SelectObject(hdcSrc, hbmpSrc);
+    SelectObject(hdcDst, hbmpDst);
+
+    /* Opaque, transparent and partially transparent premultiplied pixels */
+    for (x = 0; x < SRC_WIDTH * SRC_HEIGHT; x++)
+    {
+        ULONG Alpha = (x % 5 == 0) ? 0 : (x % 5 == 1) ? 255 : (x * 37) & 0xFF;
+        ULONG Color = x * 0x9E3779B1;
+        pulSrc[x] = (Alpha << 24) |
+                    ((((Color >> 16) & 0xFF) * Alpha / 255) << 16) |
+                    ((((Color >> 8) & 0xFF) * Alpha / 255) << 8) |
+                    ((Color & 0xFF) * Alpha / 255);
+    }
+
+    cjLine = ((DST_WIDTH * pFormat->cBitsPixel + 31) & ~31) / 8;
+    for (x = 0; x < cjLine * DST_HEIGHT; x++)
+        pjDst[x] = (BYTE)(x * 13 + 7);
+
+    pjExpected = HeapAlloc(GetProcessHeap(), 0, cjLine * DST_HEIGHT);
+    memcpy(pjExpected, pjDst, cjLine * DST_HEIGHT);
+
+    pulExpanded = HeapAlloc(GetProcessHeap(), 0, DST_WIDTH * DST_HEIGHT * sizeof(ULONG));
+    for (y = 0; y < DST_HEIGHT; y++)
+    {
+        for (x = 0; x < DST_WIDTH; x++)
+        {
+            pulExpanded[y * DST_WIDTH + x] =
+                ExpandPixel(hdcDst, pFormat, ReadPixel(pjDst, cjLine, pFormat->cBitsPixel, x, y), x, y);
+        }
+    }
+
+    GdiFlush();
+    ret = GdiAlphaBlend(hdcDst, 1, 2, cxDst, cyDst, hdcSrc, 0, 0, SRC_WIDTH, SRC_HEIGHT, bf);
+    ok(ret == TRUE, "GdiAlphaBlend failed for %lu bpp\n", pFormat->cBitsPixel);
+    GdiFlush();
+
+    for (y = 0; y < DST_HEIGHT; y++)
+    {
+        for (x = 0; x < DST_WIDTH; x++)
+        {
+            ulExpected = ReadPixel(pjExpected, cjLine, pFormat->cBitsPixel, x, y);
+
+            if (x >= 1 && x < 1 + cxDst && y >= 2 && y < 2 + cyDst)
+            {
+                xSrc = ((x - 1) * SRC_WIDTH) / cxDst;
+                ySrc = ((y - 2) * SRC_HEIGHT) / cyDst;
+                ulSrc = pulSrc[ySrc * SRC_WIDTH + xSrc];
+                ulDst = pulExpanded[y * DST_WIDTH + x];
+                ulExpected = ReducePixel(pFormat, BlendPixel(ulDst, ulSrc, bf));
+            }
+
+            if (ReadPixel(pjDst, cjLine, pFormat->cBitsPixel, x, y) != ulExpected)
+            {
+                if (cErrors++ == 0)
+                {
+                    ok(0, "%lu bpp, %lux%lu, sca %u, format %u: pixel (%lu,%lu) is 0x%lx, expected 0x%lx\n",
+                       pFormat->cBitsPixel, cxDst, cyDst, bf.SourceConstantAlpha, bf.AlphaFormat, x, y,
+                       ReadPixel(pjDst, cjLine, pFormat->cBitsPixel, x, y), ulExpected);
+                }
+            }
+        }
+    }
+    ok(cErrors == 0, "%lu pixels differ\n", cErrors);
+
+    HeapFree(GetProcessHeap(), 0, pulExpanded);
+    HeapFree(GetProcessHeap(), 0, pjExpected);
+
+Cleanup:
+    DeleteDC(hdcSrc);
+    DeleteDC(hdcDst);
+    if (hbmpSrc) DeleteObject(hbmpSrc);
+    if (hbmpDst) DeleteObject(hbmpDst);
+}
+
+START_TEST(GdiAlphaBlend)
+{
+    static const BYTE ajSca[] = { 255, 128, 1 };
+    BLENDFUNCTION bf = { AC_SRC_OVER, 0, 255, AC_SRC_ALPHA };
+    ULONG i, j;
+
+    for (i = 0; i < sizeof(gaFormats) / sizeof(gaFormats[0]); i++)
+    {
+        for (j = 0; j < sizeof(ajSca); j++)
+        {
+            bf.SourceConstantAlpha = ajSca[j];
+
+            /* Unstretched, enlarged and shrunk */
+            bf.AlphaFormat = AC_SRC_ALPHA;
+            Test_AlphaBlend_Format(&gaFormats[i], SRC_WIDTH, SRC_HEIGHT, bf);
+            Test_AlphaBlend_Format(&gaFormats[i], 27, 9, bf);
+            Test_AlphaBlend_Format(&gaFormats[i], 5, 3, bf);
+
+            /* Constant alpha only */
+            bf.AlphaFormat = 0;
+            Test_AlphaBlend_Format(&gaFormats[i], SRC_WIDTH, SRC_HEIGHT, bf);
+            Test_AlphaBlend_Format(&gaFormats[i], 27, 9, bf);
+        }
+    }
+}
@@ -0,0 +1,131 @@
+/*
+ * PROJECT:         ReactOS api tests
+ * LICENSE:         GPL - See COPYING in the top level directory
+ * PURPOSE:         Test for PtInRegion and RectInRegion on complex regions
+ * PROGRAMMERS:     ReactOS Team
+ */
+
+#include <apitest.h>
+
+#include <stdlib.h>
+#include <wingdi.h>
+
+#define BAND_COUNT 50
+#define RECTS_PER_BAND 20
+#define RECT_COUNT (BAND_COUNT * RECTS_PER_BAND)
+
+static RECT garc[RECT_COUNT];
+
+/* Bands of separate rectangles, shifted a little from band to band so
+   that nothing coalesces */
+static
+HRGN
+CreateBandedRegion(void)
+{
+    HRGN hrgn, hrgnRect;
+    ULONG iBand, i, n = 0;
+
+    hrgn = CreateRectRgn(0, 0, 0, 0);
+    for (iBand = 0; iBand < BAND_COUNT; iBand++)
+    {
+        for (i = 0; i < RECTS_PER_BAND; i++, n++)
+        {
+            SetRect(&garc[n],
+                    i * 50 + (iBand % 3),
+                    iBand * 20,
+                    i * 50 + 30 + (iBand % 3),
+                    iBand * 20 + 15);
+            hrgnRect = CreateRectRgnIndirect(&garc[n]);
+            CombineRgn(hrgn, hrgn, hrgnRect, RGN_OR);
+            DeleteObject(hrgnRect);
+        }
+    }
+
+    return hrgn;
+}
+
+static
+BOOL
+RefPtInRegion(LONG x, LONG y)
+{
+    ULONG i;
+
+    for (i = 0; i < RECT_COUNT; i++)
+    {
+        if (x >= garc[i].left && x < garc[i].right &&
+            y >= garc[i].top && y < garc[i].bottom)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+static
+BOOL
+RefRectInRegion(const RECT *prc)
+{
+    RECT rcTemp;
+    ULONG i;
+
+    for (i = 0; i < RECT_COUNT; i++)
+    {
+        if (IntersectRect(&rcTemp, &garc[i], prc))
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+START_TEST(PtInRegion)
+{
+    HRGN hrgn;
+    RECT rc;
+    LONG x, y;
+    ULONG i, cPtErrors = 0, cRectErrors = 0;
+    BOOL bResult, bExpected;
+
+    hrgn = CreateBandedRegion();
+    ok(hrgn != NULL, "Failed to create the region\n");
+    if (!hrgn) return;
+
+    /* Every rectangle has to stay separate for the search to be exercised */
+    ok_long(GetRegionData(hrgn, 0, NULL), sizeof(RGNDATAHEADER) + RECT_COUNT * sizeof(RECT));
+
+    /* The corners and the edges just outside of a few rectangles */
+    for (i = 0; i < RECT_COUNT; i += 97)
+    {
+        ok_int(PtInRegion(hrgn, garc[i].left, garc[i].top), TRUE);
+        ok_int(PtInRegion(hrgn, garc[i].right - 1, garc[i].bottom - 1), TRUE);
+        ok_int(PtInRegion(hrgn, garc[i].right, garc[i].top), FALSE);
+        ok_int(PtInRegion(hrgn, garc[i].left, garc[i].bottom), FALSE);
+        ok_int(PtInRegion(hrgn, garc[i].left - 1, garc[i].top), FALSE);
+        ok_int(PtInRegion(hrgn, garc[i].left, garc[i].top - 1), FALSE);
+    }
+
+    srand(1);
+    for (i = 0; i < 20000; i++)
+    {
+        x = rand() % 1100 - 20;
+        y = rand() % 1040 - 20;
+
+        bExpected = RefPtInRegion(x, y);
+        bResult = PtInRegion(hrgn, x, y);
+        if (bResult != bExpected && cPtErrors++ == 0)
+            ok(0, "PtInRegion(%ld, %ld) returned %d, expected %d\n", x, y, bResult, bExpected);
+
+        SetRect(&rc, x, y, x + 1 + rand() % 60, y + 1 + rand() % 40);
+        bExpected = RefRectInRegion(&rc);
+        bResult = RectInRegion(hrgn, &rc);
+        if (bResult != bExpected && cRectErrors++ == 0)
+        {
+            ok(0, "RectInRegion(%ld, %ld, %ld, %ld) returned %d, expected %d\n",
+               rc.left, rc.top, rc.right, rc.bottom, bResult, bExpected);
+        }
+    }
+    ok(cPtErrors == 0, "%lu PtInRegion results differ\n", cPtErrors);
+    ok(cRectErrors == 0, "%lu RectInRegion results differ\n", cRectErrors);
+
+    DeleteObject(hrgn);
+}
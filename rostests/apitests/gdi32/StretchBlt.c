@@ -0,0 +1,410 @@
+/*
+ * PROJECT:         ReactOS api tests
+ * LICENSE:         GPL - See COPYING in the top level directory
+ * PURPOSE:         Test for StretchBlt with SRCCOPY and pattern ROPs
+ * PROGRAMMERS:     ReactOS Team
+ */
+
+#include <apitest.h>
+
+#include <wingdi.h>
+#include <winuser.h>
+#include <math.h>
+
+#define SRC_WIDTH 11
+#define SRC_HEIGHT 7
+#define DST_WIDTH 37
+#define DST_HEIGHT 19
+#define PAT_SIZE 8
+
+static
+ULONG
+DoRop3(UCHAR jRop, ULONG ulDst, ULONG ulSrc, ULONG ulPat)
+{
+    ULONG i, ulResult = 0;
+
+    /* Bit i of the ROP is the result for pattern bit 2, source bit 1 and
+       destination bit 0 of i */
+    for (i = 0; i < 8; i++)
+    {
+        if (jRop & (1 << i))
+        {
+            ulResult |= ((i & 4) ? ulPat : ~ulPat) &
+                        ((i & 2) ? ulSrc : ~ulSrc) &
+                        ((i & 1) ? ulDst : ~ulDst);
+        }
+    }
+
+    return ulResult;
+}
+
+static
+HBITMAP
+CreateDIB32(HDC hdc, LONG cx, LONG cy, PULONG *ppulBits)
+{
+    BITMAPINFO bmi;
+
+    ZeroMemory(&bmi, sizeof(bmi));
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = cx;
+    bmi.bmiHeader.biHeight = -cy;
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    return CreateDIBSection(hdc, &bmi, DIB_RGB_COLORS, (PVOID*)ppulBits, NULL, 0);
+}
+
+static
+void
+Test_StretchBlt_PatternRop(DWORD dwRop, INT iMode, LONG cxDst, LONG cyDst)
+{
+    struct
+    {
+        BITMAPINFOHEADER bmiHeader;
+        ULONG aulBits[PAT_SIZE * PAT_SIZE];
+    } PackedDIB;
+    HDC hdcSrc, hdcDst;
+    HBITMAP hbmpSrc, hbmpDst;
+    HBRUSH hbr, hbrOld;
+    PULONG pulSrc, pulDst, pulExpected;
+    ULONG x, y, ulSrc, ulPat, ulExpected, cErrors = 0;
+    BOOL ret;
+
+    hdcSrc = CreateCompatibleDC(NULL);
+    hdcDst = CreateCompatibleDC(NULL);
+    hbmpSrc = CreateDIB32(hdcSrc, SRC_WIDTH, SRC_HEIGHT, &pulSrc);
+    hbmpDst = CreateDIB32(hdcDst, DST_WIDTH, DST_HEIGHT, &pulDst);
+    ok(hbmpSrc != NULL && hbmpDst != NULL, "Failed to create bitmaps\n");
+    if (!hbmpSrc || !hbmpDst)
+    {
+        goto Cleanup;
+    }
+
+    SelectObject(hdcSrc, hbmpSrc);
+    SelectObject(hdcDst, hbmpDst);
+
+    ZeroMemory(&PackedDIB, sizeof(PackedDIB));
+    PackedDIB.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    PackedDIB.bmiHeader.biWidth = PAT_SIZE;
+    PackedDIB.bmiHeader.biHeight = -PAT_SIZE;
+    PackedDIB.bmiHeader.biPlanes = 1;
+    PackedDIB.bmiHeader.biBitCount = 32;
+    PackedDIB.bmiHeader.biCompression = BI_RGB;
+    for (x = 0; x < PAT_SIZE * PAT_SIZE; x++)
+        PackedDIB.aulBits[x] = (x * 0x2F1D3B) & 0xFFFFFF;
+
+    hbr = CreateDIBPatternBrushPt(&PackedDIB, DIB_RGB_COLORS);
+    ok(hbr != NULL, "Failed to create the pattern brush\n");
+    if (!hbr)
+    {
+        goto Cleanup;
+    }
+
+    for (x = 0; x < SRC_WIDTH * SRC_HEIGHT; x++)
+        pulSrc[x] = (x * 0x9E3779) & 0xFFFFFF;
+    for (x = 0; x < DST_WIDTH * DST_HEIGHT; x++)
+        pulDst[x] = (x * 0x3C6EF3) & 0xFFFFFF;
+
+    pulExpected = HeapAlloc(GetProcessHeap(), 0, DST_WIDTH * DST_HEIGHT * sizeof(ULONG));
+    memcpy(pulExpected, pulDst, DST_WIDTH * DST_HEIGHT * sizeof(ULONG));
+
+    hbrOld = SelectObject(hdcDst, hbr);
+    SetBrushOrgEx(hdcDst, 0, 0, NULL);
+    SetStretchBltMode(hdcDst, iMode);
+
+    GdiFlush();
+    ret = StretchBlt(hdcDst, 2, 3, cxDst, cyDst, hdcSrc, 0, 0, SRC_WIDTH, SRC_HEIGHT, dwRop);
+    ok(ret == TRUE, "StretchBlt failed for rop 0x%lx\n", dwRop);
+    GdiFlush();
+
+    for (y = 3; y < 3 + (ULONG)cyDst; y++)
+    {
+        for (x = 2; x < 2 + (ULONG)cxDst; x++)
+        {
+            /* Nearest neighbour, the pattern is aligned to the brush origin */
+            ulSrc = pulSrc[((y - 3) * SRC_HEIGHT / cyDst) * SRC_WIDTH + (x - 2) * SRC_WIDTH / cxDst];
+            ulPat = PackedDIB.aulBits[(y % PAT_SIZE) * PAT_SIZE + x % PAT_SIZE];
+            pulExpected[y * DST_WIDTH + x] =
+                DoRop3((UCHAR)(dwRop >> 16), pulExpected[y * DST_WIDTH + x], ulSrc, ulPat);
+        }
+    }
+
+    for (y = 0; y < DST_HEIGHT; y++)
+    {
+        for (x = 0; x < DST_WIDTH; x++)
+        {
+            ulExpected = pulExpected[y * DST_WIDTH + x] & 0xFFFFFF;
+            if ((pulDst[y * DST_WIDTH + x] & 0xFFFFFF) != ulExpected)
+            {
+                if (cErrors++ == 0)
+                {
+                    ok(0, "rop 0x%lx, mode %d, %ldx%ld: pixel (%lu,%lu) is 0x%lx, expected 0x%lx\n",
+                       dwRop, iMode, cxDst, cyDst, x, y,
+                       pulDst[y * DST_WIDTH + x] & 0xFFFFFF, ulExpected);
+                }
+            }
+        }
+    }
+    ok(cErrors == 0, "%lu pixels differ\n", cErrors);
+
+    HeapFree(GetProcessHeap(), 0, pulExpected);
+    SelectObject(hdcDst, hbrOld);
+    DeleteObject(hbr);
+
+Cleanup:
+    DeleteDC(hdcSrc);
+    DeleteDC(hdcDst);
+    if (hbmpSrc) DeleteObject(hbmpSrc);
+    if (hbmpDst) DeleteObject(hbmpDst);
+}
+
+static
+HBITMAP
+CreateDIBBpp(HDC hdc, LONG cx, LONG cy, USHORT cBitsPixel, PVOID *ppvBits)
+{
+    struct
+    {
+        BITMAPINFOHEADER bmiHeader;
+        RGBQUAD bmiColors[256];
+    } bmi;
+    ULONG i;
+
+    ZeroMemory(&bmi, sizeof(bmi));
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = cx;
+    bmi.bmiHeader.biHeight = -cy;
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = cBitsPixel;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    /* Distinct colors, so that no two indices are the same color */
+    for (i = 0; i < 256; i++)
+    {
+        bmi.bmiColors[i].rgbBlue = (BYTE)i;
+        bmi.bmiColors[i].rgbGreen = (BYTE)(i * 7);
+        bmi.bmiColors[i].rgbRed = (BYTE)(255 - i);
+    }
+
+    return CreateDIBSection(hdc, (BITMAPINFO*)&bmi, DIB_RGB_COLORS, ppvBits, NULL, 0);
+}
+
+static
+ULONG
+GetDIBPixel(PVOID pvBits, LONG cx, USHORT cBitsPixel, LONG x, LONG y)
+{
+    PBYTE pj = (PBYTE)pvBits + y * ((cx * cBitsPixel + 31) / 32 * 4) + x * cBitsPixel / 8;
+
+    switch (cBitsPixel)
+    {
+        case 8: return pj[0];
+        case 16: return *(PUSHORT)pj;
+        case 24: return pj[0] | (pj[1] << 8) | (pj[2] << 16);
+        default: return *(PULONG)pj & 0xFFFFFF;
+    }
+}
+
+static
+void
+SetDIBPixel(PVOID pvBits, LONG cx, USHORT cBitsPixel, LONG x, LONG y, ULONG ulColor)
+{
+    PBYTE pj = (PBYTE)pvBits + y * ((cx * cBitsPixel + 31) / 32 * 4) + x * cBitsPixel / 8;
+
+    switch (cBitsPixel)
+    {
+        case 8: pj[0] = (BYTE)ulColor; break;
+        case 16: *(PUSHORT)pj = (USHORT)ulColor; break;
+        case 24: pj[0] = (BYTE)ulColor; pj[1] = (BYTE)(ulColor >> 8); pj[2] = (BYTE)(ulColor >> 16); break;
+        default: *(PULONG)pj = ulColor; break;
+    }
+}
+
+/* Blue, green and red of the source are linear in x and y, in units of
+   the 5 bit channels of a 16bpp pixel */
+static
+double
+SourceChannel(ULONG iChannel, double x, double y)
+{
+    switch (iChannel)
+    {
+        case 0: return 2 * x + 1;
+        case 1: return 3 * y + 2;
+        default: return x + 2 * y + 3;
+    }
+}
+
+static
+ULONG
+SourcePixel(USHORT cBitsPixel, LONG x, LONG y)
+{
+    ULONG i, ulColor = 0;
+
+    if (cBitsPixel == 8)
+        return (x * 7 + y * 13) & 0xFF;
+
+    for (i = 0; i < 3; i++)
+    {
+        if (cBitsPixel == 16)
+            ulColor |= (ULONG)SourceChannel(i, x, y) << (i * 5);
+        else
+            ulColor |= ((ULONG)SourceChannel(i, x, y) * 8) << (i * 8);
+    }
+
+    return ulColor;
+}
+
+/* The source position of the center of a destination pixel, kept inside
+   the source */
+static
+double
+SourcePosition(LONG iDst, LONG cDst, LONG cSrc)
+{
+    double dPos = (iDst + 0.5) * cSrc / cDst - 0.5;
+
+    if (dPos < 0)
+        return 0;
+    if (dPos > cSrc - 1)
+        return cSrc - 1;
+    return dPos;
+}
+
+static
+void
+Test_StretchBlt_SrcCopy(USHORT cBitsPixel, INT iMode, LONG cxDst, LONG cyDst)
+{
+    HDC hdcSrc, hdcDst;
+    HBITMAP hbmpSrc, hbmpDst;
+    PVOID pvSrc, pvDst;
+    PULONG pulExpected;
+    ULONG ulPixel, ulExpected, i, cErrors = 0;
+    LONG x, y, lDiff, lMaxDiff = 0;
+    double dExpected;
+    BOOL bInside, ret;
+
+    hdcSrc = CreateCompatibleDC(NULL);
+    hdcDst = CreateCompatibleDC(NULL);
+    hbmpSrc = CreateDIBBpp(hdcSrc, SRC_WIDTH, SRC_HEIGHT, cBitsPixel, &pvSrc);
+    hbmpDst = CreateDIBBpp(hdcDst, DST_WIDTH, DST_HEIGHT, cBitsPixel, &pvDst);
+    ok(hbmpSrc != NULL && hbmpDst != NULL, "Failed to create bitmaps\n");
+    if (!hbmpSrc || !hbmpDst)
+    {
+        goto Cleanup;
+    }
+
+    SelectObject(hdcSrc, hbmpSrc);
+    SelectObject(hdcDst, hbmpDst);
+
+    pulExpected = HeapAlloc(GetProcessHeap(), 0, DST_WIDTH * DST_HEIGHT * sizeof(ULONG));
+    for (y = 0; y < SRC_HEIGHT; y++)
+        for (x = 0; x < SRC_WIDTH; x++)
+            SetDIBPixel(pvSrc, SRC_WIDTH, cBitsPixel, x, y, SourcePixel(cBitsPixel, x, y));
+    for (y = 0; y < DST_HEIGHT; y++)
+    {
+        for (x = 0; x < DST_WIDTH; x++)
+        {
+            ulPixel = ((y * DST_WIDTH + x) * 0x3C6EF3) & ((cBitsPixel < 24) ? (1 << cBitsPixel) - 1 : 0xFFFFFF);
+            SetDIBPixel(pvDst, DST_WIDTH, cBitsPixel, x, y, ulPixel);
+            pulExpected[y * DST_WIDTH + x] = GetDIBPixel(pvDst, DST_WIDTH, cBitsPixel, x, y);
+        }
+    }
+
+    SetStretchBltMode(hdcDst, iMode);
+    SetBrushOrgEx(hdcDst, 0, 0, NULL);
+
+    GdiFlush();
+    ret = StretchBlt(hdcDst, 2, 3, cxDst, cyDst, hdcSrc, 0, 0, SRC_WIDTH, SRC_HEIGHT, SRCCOPY);
+    ok(ret == TRUE, "StretchBlt failed for %u bpp\n", cBitsPixel);
+    GdiFlush();
+
+    for (y = 0; y < DST_HEIGHT; y++)
+    {
+        for (x = 0; x < DST_WIDTH; x++)
+        {
+            ulPixel = GetDIBPixel(pvDst, DST_WIDTH, cBitsPixel, x, y);
+            bInside = (x >= 2 && x < 2 + cxDst && y >= 3 && y < 3 + cyDst);
+
+            if (bInside && iMode == HALFTONE)
+            {
+                /* Any filter that averages the pixels around the source
+                   position reproduces a linear gradient. Compare each
+                   channel, allowing for rounding */
+                for (i = 0; i < 3; i++)
+                {
+                    dExpected = SourceChannel(i,
+                                              SourcePosition(x - 2, cxDst, SRC_WIDTH),
+                                              SourcePosition(y - 3, cyDst, SRC_HEIGHT));
+                    if (cBitsPixel == 16)
+                        lDiff = (LONG)floor(fabs(((ulPixel >> (i * 5)) & 0x1F) - dExpected) + 0.5);
+                    else
+                        lDiff = (LONG)floor(fabs(((ulPixel >> (i * 8)) & 0xFF) - dExpected * 8) + 0.5);
+                    if (lDiff > lMaxDiff)
+                        lMaxDiff = lDiff;
+                    if (lDiff > ((cBitsPixel == 16) ? 1 : 3) && cErrors++ == 0)
+                    {
+                        ok(0, "%u bpp, halftone, %ldx%ld: pixel (%ld,%ld) is 0x%lx, channel %lu is off by %ld\n",
+                           cBitsPixel, cxDst, cyDst, x, y, ulPixel, i, lDiff);
+                    }
+                }
+                continue;
+            }
+
+            /* Nearest neighbour, the rest of the destination stays as it was */
+            if (bInside)
+                ulExpected = SourcePixel(cBitsPixel, (x - 2) * SRC_WIDTH / cxDst, (y - 3) * SRC_HEIGHT / cyDst);
+            else
+                ulExpected = pulExpected[y * DST_WIDTH + x];
+
+            if (ulPixel != ulExpected && cErrors++ == 0)
+            {
+                ok(0, "%u bpp, mode %d, %ldx%ld: pixel (%ld,%ld) is 0x%lx, expected 0x%lx\n",
+                   cBitsPixel, iMode, cxDst, cyDst, x, y, ulPixel, ulExpected);
+            }
+        }
+    }
+    ok(cErrors == 0, "%u bpp, mode %d, %ldx%ld: %lu errors, largest channel difference %ld\n",
+       cBitsPixel, iMode, cxDst, cyDst, cErrors, lMaxDiff);
+
+    HeapFree(GetProcessHeap(), 0, pulExpected);
+
+Cleanup:
+    DeleteDC(hdcSrc);
+    DeleteDC(hdcDst);
+    if (hbmpSrc) DeleteObject(hbmpSrc);
+    if (hbmpDst) DeleteObject(hbmpDst);
+}
+
+START_TEST(StretchBlt)
+{
+    /* Source and pattern, pattern only and all three operands */
+    static const DWORD adwRops[] = { MERGECOPY, PATINVERT, 0x00B8074A };
+    static const INT aiModes[] = { COLORONCOLOR, HALFTONE };
+    static const USHORT ausBitsPixel[] = { 8, 16, 24, 32 };
+    ULONG i, j;
+
+    for (i = 0; i < sizeof(adwRops) / sizeof(adwRops[0]); i++)
+    {
+        for (j = 0; j < sizeof(aiModes) / sizeof(aiModes[0]); j++)
+        {
+            /* Unstretched, enlarged and shrunk */
+            Test_StretchBlt_PatternRop(adwRops[i], aiModes[j], SRC_WIDTH, SRC_HEIGHT);
+            Test_StretchBlt_PatternRop(adwRops[i], aiModes[j], 33, 15);
+            Test_StretchBlt_PatternRop(adwRops[i], aiModes[j], 5, 3);
+        }
+    }
+
+    for (i = 0; i < sizeof(ausBitsPixel) / sizeof(ausBitsPixel[0]); i++)
+    {
+        for (j = 0; j < sizeof(aiModes) / sizeof(aiModes[0]); j++)
+        {
+            /* HALFTONE dithers palette surfaces, so there is no exact image to expect */
+            if (ausBitsPixel[i] == 8 && aiModes[j] == HALFTONE)
+                continue;
+
+            /* Unstretched, enlarged, shrunk and both at once */
+            Test_StretchBlt_SrcCopy(ausBitsPixel[i], aiModes[j], SRC_WIDTH, SRC_HEIGHT);
+            Test_StretchBlt_SrcCopy(ausBitsPixel[i], aiModes[j], 33, 15);
+            Test_StretchBlt_SrcCopy(ausBitsPixel[i], aiModes[j], 5, 3);
+            Test_StretchBlt_SrcCopy(ausBitsPixel[i], aiModes[j], 30, 4);
+        }
+    }
+}
@@ -25,6 +25,7 @@ extern void func_EngDeleteSemaphore(void);
 extern void func_EngReleaseSemaphore(void);
 extern void func_ExcludeClipRect(void);
 extern void func_ExtCreatePen(void);
+extern void func_GdiAlphaBlend(void);
 extern void func_GdiConvertBitmap(void);
 extern void func_GdiConvertBrush(void);
 extern void func_GdiConvertDC(void);
@@ -51,6 +52,7 @@ extern void func_GetTextFace(void);
 extern void func_MaskBlt(void);
 extern void func_OffsetClipRgn(void);
 extern void func_PatBlt(void);
+extern void func_PtInRegion(void);
 extern void func_Rectangle(void);
 extern void func_SelectObject(void);
 extern void func_SetBrushOrgEx(void);
@@ -62,6 +64,7 @@ extern void func_SetPixel(void);
 extern void func_SetSysColors(void);
 extern void func_SetWindowExtEx(void);
 extern void func_SetWorldTransform(void);
+extern void func_StretchBlt(void);
 
 const struct test winetest_testlist[] =
 {
@@ -87,6 +90,7 @@ const struct test winetest_testlist[] =
     { "EngReleaseSemaphore", func_EngReleaseSemaphore },
     { "ExcludeClipRect", func_ExcludeClipRect },
     { "ExtCreatePen", func_ExtCreatePen },
+    { "GdiAlphaBlend", func_GdiAlphaBlend },
     { "GdiConvertBitmap", func_GdiConvertBitmap },
     { "GdiConvertBrush", func_GdiConvertBrush },
     { "GdiConvertDC", func_GdiConvertDC },
@@ -113,6 +117,7 @@ const struct test winetest_testlist[] =
     { "MaskBlt", func_MaskBlt },
     { "OffsetClipRgn", func_OffsetClipRgn },
     { "PatBlt", func_PatBlt },
+    { "PtInRegion", func_PtInRegion },
     { "Rectangle", func_Rectangle },
     { "SelectObject", func_SelectObject },
     { "SetBrushOrgEx", func_SetBrushOrgEx },
@@ -124,6 +129,7 @@ const struct test winetest_testlist[] =
     { "SetSysColors", func_SetSysColors },
     { "SetWindowExtEx", func_SetWindowExtEx },
     { "SetWorldTransform", func_SetWorldTransform },
+    { "StretchBlt", func_StretchBlt },
 
     { 0, 0 }
 };
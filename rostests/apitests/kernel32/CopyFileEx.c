@@ -0,0 +1,230 @@
+/*
+ * PROJECT:         ReactOS api tests
+ * LICENSE:         GPLv2+ - See COPYING in the top level directory
+ * PURPOSE:         Test for CopyFileEx
+ * PROGRAMMERS:     ReactOS Team
+ */
+
+#include <apitest.h>
+
+#include <windows.h>
+
+/* CopyFileEx reads files of less than 32 MB in buffers of this size */
+#define COPY_BUFFER_SIZE 0x100000
+
+typedef struct _PROGRESS_CONTEXT
+{
+    LARGE_INTEGER TotalFileSize;
+    LARGE_INTEGER LastTransferred;
+    ULONG cCalls;
+    ULONG cCancelAt;
+} PROGRESS_CONTEXT, *PPROGRESS_CONTEXT;
+
+static WCHAR SourceName[MAX_PATH];
+static WCHAR DestName[MAX_PATH];
+
+static
+BYTE
+PatternByte(ULONG i)
+{
+    return (BYTE)(i * 7 + i / 251);
+}
+
+static
+BOOL
+CreateSourceFile(ULONG cjSize)
+{
+    static BYTE ajBuffer[0x10000];
+    HANDLE hFile;
+    ULONG i, cjChunk;
+    DWORD cjWritten;
+    BOOL ret = TRUE;
+
+    hFile = CreateFileW(SourceName, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    ok(hFile != INVALID_HANDLE_VALUE, "Failed to create the source, error %lu\n", GetLastError());
+    if (hFile == INVALID_HANDLE_VALUE)
+        return FALSE;
+
+    for (i = 0; i < cjSize && ret; i += cjChunk)
+    {
+        cjChunk = min(cjSize - i, sizeof(ajBuffer));
+        for (cjWritten = 0; cjWritten < cjChunk; cjWritten++)
+            ajBuffer[cjWritten] = PatternByte(i + cjWritten);
+
+        ret = WriteFile(hFile, ajBuffer, cjChunk, &cjWritten, NULL) && cjWritten == cjChunk;
+        ok(ret, "Failed to write the source, error %lu\n", GetLastError());
+    }
+
+    CloseHandle(hFile);
+    return ret;
+}
+
+static
+void
+CheckDestFile(ULONG cjSize, DWORD dwFlags)
+{
+    static BYTE ajBuffer[0x10000];
+    HANDLE hFile;
+    LARGE_INTEGER FileSize;
+    ULONG i, j, cErrors = 0;
+    DWORD cjRead;
+
+    hFile = CreateFileW(DestName, GENERIC_READ, 0, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    ok(hFile != INVALID_HANDLE_VALUE, "Failed to open the destination, error %lu\n", GetLastError());
+    if (hFile == INVALID_HANDLE_VALUE)
+        return;
+
+    ok(GetFileSizeEx(hFile, &FileSize), "GetFileSizeEx failed, error %lu\n", GetLastError());
+    ok(FileSize.QuadPart == cjSize, "Size %lu, flags 0x%lx: destination has %I64u bytes\n",
+       cjSize, dwFlags, FileSize.QuadPart);
+
+    for (i = 0; i < cjSize; i += cjRead)
+    {
+        if (!ReadFile(hFile, ajBuffer, sizeof(ajBuffer), &cjRead, NULL) || cjRead == 0)
+        {
+            ok(0, "Size %lu, flags 0x%lx: reading at %lu failed, error %lu\n",
+               cjSize, dwFlags, i, GetLastError());
+            break;
+        }
+
+        for (j = 0; j < cjRead && i + j < cjSize; j++)
+        {
+            if (ajBuffer[j] != PatternByte(i + j) && cErrors++ == 0)
+            {
+                ok(0, "Size %lu, flags 0x%lx: byte %lu is 0x%x, expected 0x%x\n",
+                   cjSize, dwFlags, i + j, ajBuffer[j], PatternByte(i + j));
+            }
+        }
+    }
+    ok(cErrors == 0, "Size %lu, flags 0x%lx: %lu bytes differ\n", cjSize, dwFlags, cErrors);
+
+    CloseHandle(hFile);
+}
+
+static
+DWORD
+CALLBACK
+ProgressRoutine(LARGE_INTEGER TotalFileSize,
+                LARGE_INTEGER TotalBytesTransferred,
+                LARGE_INTEGER StreamSize,
+                LARGE_INTEGER StreamBytesTransferred,
+                DWORD dwStreamNumber,
+                DWORD dwCallbackReason,
+                HANDLE hSourceFile,
+                HANDLE hDestinationFile,
+                LPVOID lpData)
+{
+    PPROGRESS_CONTEXT Context = lpData;
+
+    if (Context->cCalls == 0)
+        ok(dwCallbackReason == CALLBACK_STREAM_SWITCH, "First callback reason is %lu\n", dwCallbackReason);
+    else
+        ok(dwCallbackReason == CALLBACK_CHUNK_FINISHED, "Callback reason is %lu\n", dwCallbackReason);
+
+    ok(TotalFileSize.QuadPart == Context->TotalFileSize.QuadPart,
+       "TotalFileSize is %I64u, expected %I64u\n", TotalFileSize.QuadPart, Context->TotalFileSize.QuadPart);
+    ok(TotalBytesTransferred.QuadPart >= Context->LastTransferred.QuadPart &&
+       TotalBytesTransferred.QuadPart <= TotalFileSize.QuadPart,
+       "Call %lu: %I64u bytes transferred after %I64u, of %I64u\n",
+       Context->cCalls, TotalBytesTransferred.QuadPart,
+       Context->LastTransferred.QuadPart, TotalFileSize.QuadPart);
+
+    Context->LastTransferred = TotalBytesTransferred;
+    if (++Context->cCalls == Context->cCancelAt)
+        return PROGRESS_CANCEL;
+
+    return PROGRESS_CONTINUE;
+}
+
+static
+void
+Test_Copy(ULONG cjSize, DWORD dwFlags)
+{
+    PROGRESS_CONTEXT Context;
+    BOOL ret;
+
+    if (!CreateSourceFile(cjSize))
+        return;
+
+    ZeroMemory(&Context, sizeof(Context));
+    Context.TotalFileSize.QuadPart = cjSize;
+
+    ret = CopyFileExW(SourceName, DestName, ProgressRoutine, &Context, NULL, dwFlags);
+    ok(ret, "Size %lu, flags 0x%lx: CopyFileExW failed, error %lu\n", cjSize, dwFlags, GetLastError());
+    if (ret)
+        CheckDestFile(cjSize, dwFlags);
+
+    ok(Context.cCalls > 0, "Size %lu, flags 0x%lx: no progress reported\n", cjSize, dwFlags);
+    ok(Context.LastTransferred.QuadPart == cjSize,
+       "Size %lu, flags 0x%lx: last progress was %I64u bytes\n",
+       cjSize, dwFlags, Context.LastTransferred.QuadPart);
+
+    DeleteFileW(DestName);
+}
+
+static
+void
+Test_Cancel(DWORD dwFlags)
+{
+    PROGRESS_CONTEXT Context;
+    BOOL ret;
+
+    if (!CreateSourceFile(5 * COPY_BUFFER_SIZE))
+        return;
+
+    /* The first chunk is reported by the second call */
+    ZeroMemory(&Context, sizeof(Context));
+    Context.TotalFileSize.QuadPart = 5 * COPY_BUFFER_SIZE;
+    Context.cCancelAt = 2;
+
+    SetLastError(0xdeadbeef);
+    ret = CopyFileExW(SourceName, DestName, ProgressRoutine, &Context, NULL, dwFlags);
+    ok(ret == FALSE, "Flags 0x%lx: CopyFileExW returned %d\n", dwFlags, ret);
+    ok(GetLastError() == ERROR_REQUEST_ABORTED, "Flags 0x%lx: error %lu\n", dwFlags, GetLastError());
+    ok(Context.cCalls == 2, "Flags 0x%lx: %lu calls\n", dwFlags, Context.cCalls);
+    ok(Context.LastTransferred.QuadPart < Context.TotalFileSize.QuadPart,
+       "Flags 0x%lx: cancelled after %I64u bytes\n", dwFlags, Context.LastTransferred.QuadPart);
+    ok(GetFileAttributesW(DestName) == INVALID_FILE_ATTRIBUTES,
+       "Flags 0x%lx: the destination was left behind\n", dwFlags);
+
+    DeleteFileW(DestName);
+}
+
+START_TEST(CopyFileEx)
+{
+    static const DWORD adwFlags[] = { 0, COPY_FILE_NO_BUFFERING };
+    WCHAR TempPath[MAX_PATH], Root[4];
+    DWORD dwSectorsPerCluster, cjSector, dwFreeClusters, dwClusters;
+    ULONG acjSizes[4], i, j;
+
+    if (!GetTempPathW(MAX_PATH, TempPath) ||
+        !GetTempFileNameW(TempPath, L"cfx", 0, SourceName) ||
+        !GetTempFileNameW(TempPath, L"cfx", 0, DestName))
+    {
+        skip("No temporary files, error %lu\n", GetLastError());
+        return;
+    }
+
+    lstrcpynW(Root, TempPath, 4);
+    if (!GetDiskFreeSpaceW(Root, &dwSectorsPerCluster, &cjSector, &dwFreeClusters, &dwClusters))
+        cjSector = 512;
+
+    /* Empty, less than a sector, one buffer, and several buffers with a
+       partial one at the end */
+    acjSizes[0] = 0;
+    acjSizes[1] = cjSector - 1;
+    acjSizes[2] = COPY_BUFFER_SIZE;
+    acjSizes[3] = 5 * COPY_BUFFER_SIZE + 12345;
+
+    DeleteFileW(DestName);
+    for (i = 0; i < sizeof(adwFlags) / sizeof(adwFlags[0]); i++)
+    {
+        for (j = 0; j < sizeof(acjSizes) / sizeof(acjSizes[0]); j++)
+            Test_Copy(acjSizes[j], adwFlags[i]);
+
+        Test_Cancel(adwFlags[i]);
+    }
+
+    DeleteFileW(SourceName);
+    DeleteFileW(DestName);
+}
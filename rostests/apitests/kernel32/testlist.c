@@ -3,6 +3,7 @@
 #define STANDALONE
 #include <apitest.h>
 
+extern void func_CopyFileEx(void);
 extern void func_dosdev(void);
 extern void func_FindFiles(void);
 extern void func_GetCurrentDirectory(void);
@@ -16,6 +17,7 @@ extern void func_SetUnhandledExceptionFilter(void);
 
 const struct test winetest_testlist[] =
 {
+    { "CopyFileEx",                  func_CopyFileEx },
     { "dosdev",                      func_dosdev },
     { "FindFiles",                   func_FindFiles },
     { "GetCurrentDirectory",         func_GetCurrentDirectory },
@@ -411,6 +411,13 @@ Test_RtlFindClearBits(void)
     ok_int(RtlFindClearBits(&BitMapHeader, 10, 0), -1);
     Buffer[1] = 0xFF303F30;
     ok_int(RtlFindClearBits(&BitMapHeader, 1, 56), 1);
+
+    Buffer[0] = 0;
+    Buffer[1] = 0;
+    ok_int(RtlFindClearBits(&BitMapHeader, 64, 0), 0);
+    ok_int(RtlFindClearBits(&BitMapHeader, 64, 5), 0);
+    ok_int(RtlFindClearBits(&BitMapHeader, 32, 32), 32);
+    ok_int(RtlFindClearBits(&BitMapHeader, 33, 32), 0);
     FreeGuarded(Buffer);
 }
 
@@ -602,11 +609,85 @@ Test_RtlFindLastBackwardRunClear(void)
 void
 Test_RtlFindClearRuns(void)
 {
+    RTL_BITMAP BitMapHeader;
+    RTL_BITMAP_RUN Runs[4];
+    ULONG *Buffer;
+    ULONG i;
+
+    Buffer = AllocateGuarded(2 * sizeof(*Buffer));
+    Buffer[0] = 0x060F874D;
+    Buffer[1] = 0x3F303F30;
+
+    RtlInitializeBitMap(&BitMapHeader, Buffer, 0);
+    ok_int(RtlFindClearRuns(&BitMapHeader, Runs, 4, FALSE), 0);
+    ok_int(RtlFindClearRuns(&BitMapHeader, Runs, 4, TRUE), 0);
+
+    RtlInitializeBitMap(&BitMapHeader, Buffer, 64);
+    ok_int(RtlFindClearRuns(&BitMapHeader, Runs, 0, TRUE), 0);
+    ok_int(RtlFindClearRuns(&BitMapHeader, Runs, 3, FALSE), 3);
+    ok_int(Runs[0].StartingIndex, 1);
+    ok_int(Runs[0].NumberOfBits, 1);
+    ok_int(Runs[1].StartingIndex, 4);
+    ok_int(Runs[1].NumberOfBits, 2);
+    ok_int(Runs[2].StartingIndex, 7);
+    ok_int(Runs[2].NumberOfBits, 1);
+
+    /* The longest runs are returned in no particular order */
+    ok_int(RtlFindClearRuns(&BitMapHeader, Runs, 3, TRUE), 3);
+    ok_int(Runs[0].NumberOfBits + Runs[1].NumberOfBits + Runs[2].NumberOfBits, 9 + 6 + 5);
+    for (i = 0; i < 3; i++)
+    {
+        ok(Runs[i].StartingIndex == 20 || Runs[i].StartingIndex == 27 ||
+           Runs[i].StartingIndex == 46, "Runs[%lu].StartingIndex = %lu\n",
+           i, Runs[i].StartingIndex);
+    }
+
+    RtlInitializeBitMap(&BitMapHeader, Buffer, 32);
+    ok_int(RtlFindClearRuns(&BitMapHeader, Runs, 2, TRUE), 2);
+    ok_int(Runs[0].NumberOfBits + Runs[1].NumberOfBits, 5 + 5);
+    ok_int(Runs[0].StartingIndex + Runs[1].StartingIndex, 20 + 27);
+
+    Buffer[0] = 0;
+    Buffer[1] = 0;
+    RtlInitializeBitMap(&BitMapHeader, Buffer, 64);
+    ok_int(RtlFindClearRuns(&BitMapHeader, Runs, 4, TRUE), 1);
+    ok_int(Runs[0].StartingIndex, 0);
+    ok_int(Runs[0].NumberOfBits, 64);
+    FreeGuarded(Buffer);
 }
 
 void
 Test_RtlFindLongestRunClear(void)
 {
+    RTL_BITMAP BitMapHeader;
+    ULONG *Buffer;
+    ULONG Index;
+
+    Buffer = AllocateGuarded(2 * sizeof(*Buffer));
+    Buffer[0] = 0x060F874D;
+    Buffer[1] = 0x3F303F30;
+
+    Index = -1;
+    RtlInitializeBitMap(&BitMapHeader, Buffer, 0);
+    ok_int(RtlFindLongestRunClear(&BitMapHeader, &Index), 0);
+
+    RtlInitializeBitMap(&BitMapHeader, Buffer, 64);
+    ok_int(RtlFindLongestRunClear(&BitMapHeader, &Index), 9);
+    ok_int(Index, 27);
+
+    RtlInitializeBitMap(&BitMapHeader, Buffer, 30);
+    ok_int(RtlFindLongestRunClear(&BitMapHeader, &Index), 5);
+    ok_int(Index, 20);
+
+    Buffer[1] = 0;
+    RtlInitializeBitMap(&BitMapHeader, Buffer, 64);
+    ok_int(RtlFindLongestRunClear(&BitMapHeader, &Index), 37);
+    ok_int(Index, 27);
+
+    Buffer[0] = 0xFFFFFFFF;
+    Buffer[1] = 0xFFFFFFFF;
+    ok_int(RtlFindLongestRunClear(&BitMapHeader, &Index), 0);
+    FreeGuarded(Buffer);
 }
 
 
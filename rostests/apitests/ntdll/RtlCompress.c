@@ -0,0 +1,171 @@
+/*
+ * PROJECT:         ReactOS api tests
+ * LICENSE:         GPL - See COPYING in the top level directory
+ * PURPOSE:         Test for the LZNT1 compression routines
+ * PROGRAMMERS:     ReactOS Team
+ */
+
+#include <apitest.h>
+
+#define WIN32_NO_STATUS
+#include <ndk/rtlfuncs.h>
+
+static const UCHAR WineCompressed[] =
+{
+    0x06, 0xb0, 0x10, 'W', 'i', 'n', 'e', 0x05, 0x30
+};
+
+/* Two stored chunks, the first of which is short and padded with zeros */
+static const UCHAR MultipleChunks[] =
+{
+    0x03, 0x30, 'W', 'i', 'n', 'e',
+    0x03, 0x30, 'W', 'i', 'n', 'e'
+};
+
+static
+VOID
+TestKnownData(PVOID WorkSpace)
+{
+    UCHAR Compressed[64];
+    UCHAR Uncompressed[0x1100];
+    ULONG FinalSize;
+    NTSTATUS Status;
+
+    FinalSize = 0xdeadbeef;
+    Status = RtlCompressBuffer(COMPRESSION_FORMAT_LZNT1, (PUCHAR)"WineWineWine", 12,
+                               Compressed, sizeof(Compressed), 0x1000, &FinalSize, WorkSpace);
+    ok(Status == STATUS_SUCCESS, "Status = %lx\n", Status);
+    ok(FinalSize == sizeof(WineCompressed), "FinalSize = %lu\n", FinalSize);
+    ok(!memcmp(Compressed, WineCompressed, sizeof(WineCompressed)), "Unexpected compressed data\n");
+
+    FinalSize = 0xdeadbeef;
+    Status = RtlDecompressBuffer(COMPRESSION_FORMAT_LZNT1, Uncompressed, sizeof(Uncompressed),
+                                 (PUCHAR)WineCompressed, sizeof(WineCompressed), &FinalSize);
+    ok(Status == STATUS_SUCCESS, "Status = %lx\n", Status);
+    ok(FinalSize == 12, "FinalSize = %lu\n", FinalSize);
+    ok(!memcmp(Uncompressed, "WineWineWine", 12), "Unexpected uncompressed data\n");
+
+    /* A buffer which is too small gets the beginning of the data */
+    FinalSize = 0xdeadbeef;
+    Status = RtlDecompressBuffer(COMPRESSION_FORMAT_LZNT1, Uncompressed, 6,
+                                 (PUCHAR)WineCompressed, sizeof(WineCompressed), &FinalSize);
+    ok(Status == STATUS_SUCCESS, "Status = %lx\n", Status);
+    ok(FinalSize == 6, "FinalSize = %lu\n", FinalSize);
+
+    memset(Uncompressed, 0x55, sizeof(Uncompressed));
+    FinalSize = 0xdeadbeef;
+    Status = RtlDecompressBuffer(COMPRESSION_FORMAT_LZNT1, Uncompressed, sizeof(Uncompressed),
+                                 (PUCHAR)MultipleChunks, sizeof(MultipleChunks), &FinalSize);
+    ok(Status == STATUS_SUCCESS, "Status = %lx\n", Status);
+    ok(FinalSize == 0x1004, "FinalSize = %lu\n", FinalSize);
+    ok(!memcmp(Uncompressed, "Wine", 4), "Unexpected first chunk\n");
+    ok(Uncompressed[4] == 0 && Uncompressed[0xfff] == 0, "Chunk not padded\n");
+    ok(!memcmp(Uncompressed + 0x1000, "Wine", 4), "Unexpected second chunk\n");
+
+    /* Match before the start of the chunk */
+    Compressed[0] = 0x03;
+    Compressed[1] = 0xb0;
+    Compressed[2] = 0x02;
+    Compressed[3] = 'W';
+    Compressed[4] = 0x00;
+    Compressed[5] = 0x10;
+    Status = RtlDecompressBuffer(COMPRESSION_FORMAT_LZNT1, Uncompressed, sizeof(Uncompressed),
+                                 Compressed, 6, &FinalSize);
+    ok(Status == STATUS_BAD_COMPRESSION_BUFFER, "Status = %lx\n", Status);
+
+    Status = RtlDecompressBuffer(COMPRESSION_FORMAT_NONE, Uncompressed, sizeof(Uncompressed),
+                                 (PUCHAR)WineCompressed, sizeof(WineCompressed), &FinalSize);
+    ok(Status == STATUS_INVALID_PARAMETER, "Status = %lx\n", Status);
+}
+
+static
+VOID
+TestRoundTrip(USHORT Engine, PVOID WorkSpace, PVOID FragmentWorkSpace)
+{
+    const ULONG Size = 5 * 0x1000 + 123;
+    PUCHAR Data, Compressed, Uncompressed;
+    ULONG CompressedSize, FinalSize, Offset, i;
+    NTSTATUS Status;
+
+    Data = HeapAlloc(GetProcessHeap(), 0, Size);
+    Compressed = HeapAlloc(GetProcessHeap(), 0, Size + 0x100);
+    Uncompressed = HeapAlloc(GetProcessHeap(), 0, Size);
+    if (!Data || !Compressed || !Uncompressed)
+    {
+        skip("Out of memory\n");
+        goto Cleanup;
+    }
+
+    /* Compressible text, random bytes and a chunk of zeros */
+    for (i = 0; i < Size; i++)
+    {
+        if (i < 2 * 0x1000)
+            Data[i] = "ReactOS LZNT1 "[i % 14] + (i % 97 == 0);
+        else if (i < 3 * 0x1000)
+            Data[i] = (UCHAR)(i * 2654435761U >> 24);
+        else if (i < 4 * 0x1000)
+            Data[i] = 0;
+        else
+            Data[i] = (UCHAR)(i / 7);
+    }
+
+    Status = RtlCompressBuffer(COMPRESSION_FORMAT_LZNT1 | Engine, Data, Size,
+                               Compressed, 100, 0x1000, &CompressedSize, WorkSpace);
+    ok(Status == STATUS_BUFFER_TOO_SMALL, "Status = %lx\n", Status);
+
+    CompressedSize = 0xdeadbeef;
+    Status = RtlCompressBuffer(COMPRESSION_FORMAT_LZNT1 | Engine, Data, Size,
+                               Compressed, Size + 0x100, 0x1000, &CompressedSize, WorkSpace);
+    ok(Status == STATUS_SUCCESS, "Status = %lx\n", Status);
+    ok(CompressedSize < Size, "CompressedSize = %lu\n", CompressedSize);
+
+    FinalSize = 0xdeadbeef;
+    Status = RtlDecompressBuffer(COMPRESSION_FORMAT_LZNT1, Uncompressed, Size,
+                                 Compressed, CompressedSize, &FinalSize);
+    ok(Status == STATUS_SUCCESS, "Status = %lx\n", Status);
+    ok(FinalSize == Size, "FinalSize = %lu\n", FinalSize);
+    ok(!memcmp(Uncompressed, Data, Size), "Round trip failed\n");
+
+    for (Offset = 0; Offset < Size; Offset += 0x1000 + 0x555)
+    {
+        FinalSize = 0xdeadbeef;
+        Status = RtlDecompressFragment(COMPRESSION_FORMAT_LZNT1, Uncompressed, 0x1800,
+                                       Compressed, CompressedSize, Offset, &FinalSize,
+                                       FragmentWorkSpace);
+        ok(Status == STATUS_SUCCESS, "Status = %lx\n", Status);
+        ok(FinalSize == min(0x1800, Size - Offset), "Offset %lu: FinalSize = %lu\n", Offset, FinalSize);
+        ok(!memcmp(Uncompressed, Data + Offset, FinalSize), "Offset %lu: wrong fragment\n", Offset);
+    }
+
+Cleanup:
+    HeapFree(GetProcessHeap(), 0, Uncompressed);
+    HeapFree(GetProcessHeap(), 0, Compressed);
+    HeapFree(GetProcessHeap(), 0, Data);
+}
+
+START_TEST(RtlCompress)
+{
+    ULONG WorkSpaceSize, FragmentWorkSpaceSize;
+    PVOID WorkSpace, FragmentWorkSpace;
+    NTSTATUS Status;
+
+    Status = RtlGetCompressionWorkSpaceSize(COMPRESSION_FORMAT_LZNT1 | COMPRESSION_ENGINE_MAXIMUM,
+                                            &WorkSpaceSize, &FragmentWorkSpaceSize);
+    ok(Status == STATUS_SUCCESS, "Status = %lx\n", Status);
+    ok(FragmentWorkSpaceSize == 0x1000, "FragmentWorkSpaceSize = %lu\n", FragmentWorkSpaceSize);
+
+    WorkSpace = HeapAlloc(GetProcessHeap(), 0, WorkSpaceSize);
+    FragmentWorkSpace = HeapAlloc(GetProcessHeap(), 0, FragmentWorkSpaceSize);
+    if (!WorkSpace || !FragmentWorkSpace)
+    {
+        skip("Out of memory\n");
+        return;
+    }
+
+    TestKnownData(WorkSpace);
+    TestRoundTrip(COMPRESSION_ENGINE_STANDARD, WorkSpace, FragmentWorkSpace);
+    TestRoundTrip(COMPRESSION_ENGINE_MAXIMUM, WorkSpace, FragmentWorkSpace);
+
+    HeapFree(GetProcessHeap(), 0, FragmentWorkSpace);
+    HeapFree(GetProcessHeap(), 0, WorkSpace);
+}
@@ -0,0 +1,156 @@
+/*
+ * PROJECT:         ReactOS api tests
+ * LICENSE:         GPL - See COPYING in the top level directory
+ * PURPOSE:         Test for the Rtl condition variables
+ * PROGRAMMERS:     ReactOS Team
+ */
+
+#include <apitest.h>
+
+#define WIN32_NO_STATUS
+#include <ndk/rtlfuncs.h>
+
+#define WAITER_COUNT 4
+
+static RTL_CRITICAL_SECTION gcs;
+static RTL_CONDITION_VARIABLE gcv;
+static ULONG gcWaiting, gcWakeups, gcTokens, gcDone;
+
+static
+DWORD
+WINAPI
+WaiterThread(PVOID pvParam)
+{
+    NTSTATUS Status;
+
+    RtlEnterCriticalSection(&gcs);
+    gcWaiting++;
+
+    /* Wait for a token, going back to sleep on any wake that brings none */
+    while (gcTokens == 0)
+    {
+        Status = RtlSleepConditionVariableCS(&gcv, &gcs, NULL);
+        ok_ntstatus(Status, STATUS_SUCCESS);
+        gcWakeups++;
+    }
+
+    gcTokens--;
+    gcDone++;
+    RtlLeaveCriticalSection(&gcs);
+
+    return 0;
+}
+
+/* Returns with the critical section held once every waiter is queued */
+static
+VOID
+WaitForWaiters(ULONG cWaiters)
+{
+    for (;;)
+    {
+        RtlEnterCriticalSection(&gcs);
+        if (gcWaiting == cWaiters)
+            return;
+        RtlLeaveCriticalSection(&gcs);
+        Sleep(10);
+    }
+}
+
+static
+VOID
+Test_Timeout(VOID)
+{
+    LARGE_INTEGER Timeout;
+    NTSTATUS Status;
+    DWORD dwStart, dwElapsed;
+
+    RtlInitializeConditionVariable(&gcv);
+
+    /* A wake without waiters is not remembered */
+    RtlWakeConditionVariable(&gcv);
+    RtlWakeAllConditionVariable(&gcv);
+
+    RtlEnterCriticalSection(&gcs);
+
+    Timeout.QuadPart = -100 * 10000LL;
+    dwStart = GetTickCount();
+    Status = RtlSleepConditionVariableCS(&gcv, &gcs, &Timeout);
+    dwElapsed = GetTickCount() - dwStart;
+    ok_ntstatus(Status, STATUS_TIMEOUT);
+    ok(dwElapsed >= 80, "Returned after %lu ms\n", dwElapsed);
+
+    /* The lock is held again after the timeout */
+    ok(gcs.OwningThread == UlongToHandle(GetCurrentThreadId()),
+       "OwningThread = %p\n", gcs.OwningThread);
+
+    /* A zero timeout returns right away */
+    Timeout.QuadPart = 0;
+    Status = RtlSleepConditionVariableCS(&gcv, &gcs, &Timeout);
+    ok_ntstatus(Status, STATUS_TIMEOUT);
+
+    RtlLeaveCriticalSection(&gcs);
+}
+
+static
+VOID
+Test_Wake(VOID)
+{
+    HANDLE ahThreads[WAITER_COUNT];
+    DWORD dwResult;
+    ULONG i;
+
+    RtlInitializeConditionVariable(&gcv);
+    gcWaiting = gcWakeups = gcTokens = gcDone = 0;
+
+    for (i = 0; i < WAITER_COUNT; i++)
+    {
+        ahThreads[i] = CreateThread(NULL, 0, WaiterThread, NULL, 0, NULL);
+        ok(ahThreads[i] != NULL, "CreateThread failed with %lu\n", GetLastError());
+        if (!ahThreads[i])
+        {
+            skip("Not enough threads, skipping the wake tests\n");
+            RtlEnterCriticalSection(&gcs);
+            gcTokens = WAITER_COUNT;
+            RtlWakeAllConditionVariable(&gcv);
+            RtlLeaveCriticalSection(&gcs);
+            if (i) WaitForMultipleObjects(i, ahThreads, TRUE, 5000);
+            while (i--) CloseHandle(ahThreads[i]);
+            return;
+        }
+    }
+
+    /* Wake-one releases exactly one waiter */
+    WaitForWaiters(WAITER_COUNT);
+    gcTokens = 1;
+    RtlWakeConditionVariable(&gcv);
+    RtlLeaveCriticalSection(&gcs);
+
+    Sleep(200);
+
+    RtlEnterCriticalSection(&gcs);
+    ok_long(gcWakeups, 1);
+    ok_long(gcDone, 1);
+
+    /* Wake-all releases everybody else */
+    gcTokens = WAITER_COUNT - 1;
+    RtlWakeAllConditionVariable(&gcv);
+    RtlLeaveCriticalSection(&gcs);
+
+    dwResult = WaitForMultipleObjects(WAITER_COUNT, ahThreads, TRUE, 5000);
+    ok_long(dwResult, WAIT_OBJECT_0);
+    ok_long(gcDone, WAITER_COUNT);
+    ok_long(gcWakeups, WAITER_COUNT);
+
+    for (i = 0; i < WAITER_COUNT; i++)
+        CloseHandle(ahThreads[i]);
+}
+
+START_TEST(RtlConditionVariable)
+{
+    RtlInitializeCriticalSection(&gcs);
+
+    Test_Timeout();
+    Test_Wake();
+
+    RtlDeleteCriticalSection(&gcs);
+}
@@ -0,0 +1,398 @@
+/*
+ * PROJECT:         ReactOS api tests
+ * LICENSE:         GPL - See COPYING in the top level directory
+ * PURPOSE:         Test for the Rtl heap front end and batch allocations
+ * PROGRAMMERS:     ReactOS Team
+ */
+
+#include <apitest.h>
+
+#define WIN32_NO_STATUS
+#include <ndk/rtlfuncs.h>
+
+#define BENCH_THREADS    4
+#define BENCH_SLOTS      256
+#define BENCH_ITERATIONS 200000
+#define BENCH_BATCH      64
+#define BENCH_BATCHES    5000
+
+static
+ULONG
+QueryFrontEnd(PVOID Heap)
+{
+    NTSTATUS Status;
+    ULONG FrontEnd = 0xdeadbeef;
+    SIZE_T ReturnLength = 0;
+
+    Status = RtlQueryHeapInformation(Heap, HeapCompatibilityInformation, &FrontEnd, sizeof(FrontEnd), &ReturnLength);
+    ok(Status == STATUS_SUCCESS, "Status = %lx\n", Status);
+    ok(ReturnLength == sizeof(ULONG), "ReturnLength = %lu\n", (ULONG)ReturnLength);
+    return FrontEnd;
+}
+
+static
+PVOID
+CreateLfhHeap(VOID)
+{
+    NTSTATUS Status;
+    PVOID Heap;
+    ULONG FrontEnd = 2;
+
+    Heap = RtlCreateHeap(HEAP_GROWABLE, NULL, 0, 0, NULL, NULL);
+    ok(Heap != NULL, "RtlCreateHeap failed\n");
+    if (!Heap) return NULL;
+
+    Status = RtlSetHeapInformation(Heap, HeapCompatibilityInformation, &FrontEnd, sizeof(FrontEnd));
+    ok(Status == STATUS_SUCCESS, "Status = %lx\n", Status);
+    return Heap;
+}
+
+static
+VOID
+TestFrontEnd(VOID)
+{
+    NTSTATUS Status;
+    PVOID Heap;
+    ULONG FrontEnd;
+    PUCHAR Blocks[128], Block;
+    SIZE_T Size, i;
+    BOOLEAN Ret;
+
+    /* Unserialized heaps can't have the front end */
+    Heap = RtlCreateHeap(HEAP_GROWABLE | HEAP_NO_SERIALIZE, NULL, 0, 0, NULL, NULL);
+    ok(Heap != NULL, "RtlCreateHeap failed\n");
+    if (Heap)
+    {
+        FrontEnd = 2;
+        Status = RtlSetHeapInformation(Heap, HeapCompatibilityInformation, &FrontEnd, sizeof(FrontEnd));
+        ok(!NT_SUCCESS(Status), "Status = %lx\n", Status);
+        ok(QueryFrontEnd(Heap) != 2, "Front end enabled\n");
+        RtlDestroyHeap(Heap);
+    }
+
+    Heap = CreateLfhHeap();
+    if (!Heap) return;
+    ok(QueryFrontEnd(Heap) == 2, "Front end not enabled\n");
+
+    /* Every small size, the sizes are exact and blocks don't overlap */
+    for (Size = 0; Size < 1024; Size += 8)
+    {
+        for (i = 0; i < sizeof(Blocks) / sizeof(Blocks[0]); i++)
+        {
+            Blocks[i] = RtlAllocateHeap(Heap, 0, Size + (i & 7));
+            ok(Blocks[i] != NULL, "Allocation of %lu failed\n", (ULONG)(Size + (i & 7)));
+            if (!Blocks[i]) return;
+            ok(RtlSizeHeap(Heap, 0, Blocks[i]) == Size + (i & 7), "Size = %lu, expected %lu\n",
+               (ULONG)RtlSizeHeap(Heap, 0, Blocks[i]), (ULONG)(Size + (i & 7)));
+            memset(Blocks[i], (UCHAR)i, Size + (i & 7));
+        }
+
+        for (i = 0; i < sizeof(Blocks) / sizeof(Blocks[0]); i++)
+        {
+            if (Size + (i & 7))
+                ok(Blocks[i][0] == (UCHAR)i && Blocks[i][Size + (i & 7) - 1] == (UCHAR)i, "Block %lu was overwritten\n", (ULONG)i);
+            Ret = RtlFreeHeap(Heap, 0, Blocks[i]);
+            ok(Ret == TRUE, "RtlFreeHeap failed\n");
+        }
+    }
+
+    /* Zeroed allocations come back zeroed, even when the block is reused */
+    Block = RtlAllocateHeap(Heap, 0, 100);
+    memset(Block, 0xcc, 100);
+    RtlFreeHeap(Heap, 0, Block);
+    Block = RtlAllocateHeap(Heap, HEAP_ZERO_MEMORY, 100);
+    for (i = 0; i < 100; i++)
+    {
+        if (Block[i]) break;
+    }
+    ok(i == 100, "Byte %lu is not zero\n", (ULONG)i);
+
+    /* Reallocation keeps the data, within a bucket, across buckets and to the back end */
+    memset(Block, 0x5a, 100);
+    Block = RtlReAllocateHeap(Heap, 0, Block, 102);
+    ok(Block != NULL && RtlSizeHeap(Heap, 0, Block) == 102, "In place reallocation failed\n");
+    Block = RtlReAllocateHeap(Heap, HEAP_ZERO_MEMORY, Block, 600);
+    ok(Block != NULL && RtlSizeHeap(Heap, 0, Block) == 600, "Reallocation failed\n");
+    Block = RtlReAllocateHeap(Heap, 0, Block, 20000);
+    ok(Block != NULL && RtlSizeHeap(Heap, 0, Block) == 20000, "Reallocation failed\n");
+    if (Block)
+    {
+        ok(Block[0] == 0x5a && Block[99] == 0x5a, "Data was lost\n");
+        ok(Block[102] == 0 && Block[599] == 0, "Data was not zeroed\n");
+        RtlFreeHeap(Heap, 0, Block);
+    }
+
+    ok(RtlValidateHeap(Heap, 0, NULL), "Heap is corrupted\n");
+    RtlDestroyHeap(Heap);
+}
+
+static
+VOID
+TestMultipleOnHeap(PVOID Heap)
+{
+    PUCHAR Blocks[200];
+    ULONG Count, i, j;
+
+    /* Every block is usable and has the requested size */
+    Count = RtlMultipleAllocateHeap(Heap, 0, 40, 200, (PVOID *)Blocks);
+    ok(Count == 200, "Count = %lu\n", Count);
+    if (Count != 200) return;
+    for (i = 0; i < Count; i++)
+    {
+        ok(Blocks[i] != NULL, "Block %lu is NULL\n", i);
+        ok(RtlSizeHeap(Heap, 0, Blocks[i]) == 40, "Size = %lu\n", (ULONG)RtlSizeHeap(Heap, 0, Blocks[i]));
+        memset(Blocks[i], (UCHAR)i, 40);
+    }
+    for (i = 0; i < Count; i++)
+    {
+        for (j = 0; j < 40; j++)
+        {
+            if (Blocks[i][j] != (UCHAR)i) break;
+        }
+        ok(j == 40, "Block %lu was overwritten at %lu\n", i, j);
+    }
+    ok(RtlValidateHeap(Heap, 0, NULL), "Heap is corrupted\n");
+
+    /* NULL entries count as freed */
+    Blocks[10] = NULL;
+    Count = RtlMultipleFreeHeap(Heap, 0, 200, (PVOID *)Blocks);
+    ok(Count == 200, "Count = %lu\n", Count);
+    ok(RtlValidateHeap(Heap, 0, NULL), "Heap is corrupted\n");
+
+    /* Zeroed batches, freed backwards and with a single block in between */
+    Count = RtlMultipleAllocateHeap(Heap, HEAP_ZERO_MEMORY, 300, 100, (PVOID *)Blocks);
+    ok(Count == 100, "Count = %lu\n", Count);
+    if (Count != 100) return;
+    for (i = 0; i < Count; i++)
+    {
+        for (j = 0; j < 300; j++)
+        {
+            if (Blocks[i][j]) break;
+        }
+        ok(j == 300, "Block %lu is not zero at %lu\n", i, j);
+    }
+    for (i = 0; i < Count / 2; i++)
+    {
+        PUCHAR Block = Blocks[i];
+        Blocks[i] = Blocks[Count - 1 - i];
+        Blocks[Count - 1 - i] = Block;
+    }
+    RtlFreeHeap(Heap, 0, Blocks[50]);
+    Blocks[50] = NULL;
+    Count = RtlMultipleFreeHeap(Heap, 0, 100, (PVOID *)Blocks);
+    ok(Count == 100, "Count = %lu\n", Count);
+    ok(RtlValidateHeap(Heap, 0, NULL), "Heap is corrupted\n");
+
+    /* Blocks bigger than the dedicated lists */
+    Count = RtlMultipleAllocateHeap(Heap, 0, 5000, 50, (PVOID *)Blocks);
+    ok(Count == 50, "Count = %lu\n", Count);
+    for (i = 0; i < Count; i++)
+    {
+        ok(RtlSizeHeap(Heap, 0, Blocks[i]) == 5000, "Size = %lu\n", (ULONG)RtlSizeHeap(Heap, 0, Blocks[i]));
+        memset(Blocks[i], 0x55, 5000);
+    }
+    ok(RtlValidateHeap(Heap, 0, NULL), "Heap is corrupted\n");
+    Count = RtlMultipleFreeHeap(Heap, 0, Count, (PVOID *)Blocks);
+    ok(Count == 50, "Count = %lu\n", Count);
+    ok(RtlValidateHeap(Heap, 0, NULL), "Heap is corrupted\n");
+}
+
+static
+VOID
+TestMultiple(VOID)
+{
+    PVOID Heap;
+
+    Heap = RtlCreateHeap(HEAP_GROWABLE, NULL, 0, 0, NULL, NULL);
+    ok(Heap != NULL, "RtlCreateHeap failed\n");
+    if (Heap)
+    {
+        TestMultipleOnHeap(Heap);
+        RtlDestroyHeap(Heap);
+    }
+
+    Heap = RtlCreateHeap(HEAP_GROWABLE | HEAP_NO_SERIALIZE, NULL, 0, 0, NULL, NULL);
+    ok(Heap != NULL, "RtlCreateHeap failed\n");
+    if (Heap)
+    {
+        TestMultipleOnHeap(Heap);
+        RtlDestroyHeap(Heap);
+    }
+
+    Heap = CreateLfhHeap();
+    if (Heap)
+    {
+        TestMultipleOnHeap(Heap);
+        RtlDestroyHeap(Heap);
+    }
+}
+
+typedef struct _BENCH_CONTEXT
+{
+    PVOID Heap;
+    ULONG Seed;
+    BOOLEAN Batched;
+} BENCH_CONTEXT, *PBENCH_CONTEXT;
+
+static
+DWORD
+WINAPI
+BenchThread(PVOID Parameter)
+{
+    PBENCH_CONTEXT Context = Parameter;
+    PVOID Slots[BENCH_SLOTS] = { NULL };
+    ULONG i, Slot;
+
+    for (i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        Slot = RtlRandom(&Context->Seed) % BENCH_SLOTS;
+        if (Slots[Slot])
+        {
+            RtlFreeHeap(Context->Heap, 0, Slots[Slot]);
+            Slots[Slot] = NULL;
+        }
+        else
+        {
+            Slots[Slot] = RtlAllocateHeap(Context->Heap, 0, 8 + RtlRandom(&Context->Seed) % 256);
+        }
+    }
+
+    for (Slot = 0; Slot < BENCH_SLOTS; Slot++)
+        RtlFreeHeap(Context->Heap, 0, Slots[Slot]);
+
+    return 0;
+}
+
+static
+DWORD
+RunBenchmark(PVOID Heap)
+{
+    BENCH_CONTEXT Context[BENCH_THREADS];
+    HANDLE Threads[BENCH_THREADS];
+    DWORD Start, i;
+
+    Start = GetTickCount();
+    for (i = 0; i < BENCH_THREADS; i++)
+    {
+        Context[i].Heap = Heap;
+        Context[i].Seed = i + 1;
+        Threads[i] = CreateThread(NULL, 0, BenchThread, &Context[i], 0, NULL);
+        ok(Threads[i] != NULL, "CreateThread failed\n");
+    }
+
+    WaitForMultipleObjects(BENCH_THREADS, Threads, TRUE, INFINITE);
+    for (i = 0; i < BENCH_THREADS; i++)
+        CloseHandle(Threads[i]);
+
+    return GetTickCount() - Start;
+}
+
+static
+DWORD
+WINAPI
+BatchThread(PVOID Parameter)
+{
+    PBENCH_CONTEXT Context = Parameter;
+    PVOID Nodes[BENCH_BATCH];
+    ULONG i, j;
+
+    for (i = 0; i < BENCH_BATCHES; i++)
+    {
+        if (Context->Batched)
+        {
+            RtlMultipleAllocateHeap(Context->Heap, 0, 48, BENCH_BATCH, Nodes);
+            RtlMultipleFreeHeap(Context->Heap, 0, BENCH_BATCH, Nodes);
+        }
+        else
+        {
+            for (j = 0; j < BENCH_BATCH; j++)
+                Nodes[j] = RtlAllocateHeap(Context->Heap, 0, 48);
+            for (j = 0; j < BENCH_BATCH; j++)
+                RtlFreeHeap(Context->Heap, 0, Nodes[j]);
+        }
+    }
+
+    return 0;
+}
+
+static
+VOID
+RunBatchBenchmark(BOOLEAN Batched)
+{
+    HEAP_LOCK Lock;
+    PVOID Heap;
+    BENCH_CONTEXT Context[BENCH_THREADS];
+    HANDLE Threads[BENCH_THREADS];
+    DWORD Start, Time, i;
+    ULONG Waits;
+
+    /* With our own lock, its debug info tells how often the heap had to wait for it */
+    RtlInitializeCriticalSection(&Lock.CriticalSection);
+    Heap = RtlCreateHeap(HEAP_GROWABLE, NULL, 0, 0, &Lock, NULL);
+    ok(Heap != NULL, "RtlCreateHeap failed\n");
+    if (!Heap)
+    {
+        RtlDeleteCriticalSection(&Lock.CriticalSection);
+        return;
+    }
+
+    Start = GetTickCount();
+    for (i = 0; i < BENCH_THREADS; i++)
+    {
+        Context[i].Heap = Heap;
+        Context[i].Batched = Batched;
+        Threads[i] = CreateThread(NULL, 0, BatchThread, &Context[i], 0, NULL);
+        ok(Threads[i] != NULL, "CreateThread failed\n");
+    }
+
+    WaitForMultipleObjects(BENCH_THREADS, Threads, TRUE, INFINITE);
+    Time = GetTickCount() - Start;
+    for (i = 0; i < BENCH_THREADS; i++)
+        CloseHandle(Threads[i]);
+
+    ok(RtlValidateHeap(Heap, 0, NULL), "Heap is corrupted\n");
+    Waits = Lock.CriticalSection.DebugInfo ? Lock.CriticalSection.DebugInfo->ContentionCount : 0;
+    RtlDestroyHeap(Heap);
+    RtlDeleteCriticalSection(&Lock.CriticalSection);
+
+    /* Uncontended entries aren't counted anywhere, so only the waits are reported */
+    trace("%s: %lu ms, %lu.%02lu lock waits per %u nodes\n",
+          Batched ? "RtlMultiple*Heap" : "RtlAllocateHeap/RtlFreeHeap", Time,
+          Waits / (BENCH_THREADS * BENCH_BATCHES),
+          (Waits % (BENCH_THREADS * BENCH_BATCHES)) * 100 / (BENCH_THREADS * BENCH_BATCHES),
+          BENCH_BATCH);
+}
+
+static
+VOID
+TestBenchmark(VOID)
+{
+    PVOID Heap;
+    DWORD BackEnd, FrontEnd;
+
+    Heap = RtlCreateHeap(HEAP_GROWABLE, NULL, 0, 0, NULL, NULL);
+    ok(Heap != NULL, "RtlCreateHeap failed\n");
+    if (!Heap) return;
+    BackEnd = RunBenchmark(Heap);
+    ok(RtlValidateHeap(Heap, 0, NULL), "Heap is corrupted\n");
+    RtlDestroyHeap(Heap);
+
+    Heap = CreateLfhHeap();
+    if (!Heap) return;
+    FrontEnd = RunBenchmark(Heap);
+    ok(RtlValidateHeap(Heap, 0, NULL), "Heap is corrupted\n");
+    RtlDestroyHeap(Heap);
+
+    trace("%u threads, %u alloc/free each: back end %lu ms, front end %lu ms\n",
+          BENCH_THREADS, BENCH_ITERATIONS, BackEnd, FrontEnd);
+
+    RunBatchBenchmark(FALSE);
+    RunBatchBenchmark(TRUE);
+}
+
+START_TEST(RtlHeap)
+{
+    TestFrontEnd();
+    TestMultiple();
+    TestBenchmark();
+}
@@ -19,6 +19,8 @@ extern void func_NtQueryVolumeInformationFile(void);
 extern void func_NtSaveKey(void);
 extern void func_NtSystemInformation(void);
 extern void func_RtlBitmap(void);
+extern void func_RtlCompress(void);
+extern void func_RtlConditionVariable(void);
 extern void func_RtlDetermineDosPathNameType(void);
 extern void func_RtlDoesFileExists(void);
 extern void func_RtlDosPathNameToNtPathName_U(void);
@@ -29,6 +31,7 @@ extern void func_RtlGetFullPathName_Ustr(void);
 extern void func_RtlGetFullPathName_UstrEx(void);
 extern void func_RtlGetLengthWithoutTrailingPathSeperators(void);
 extern void func_RtlGetLongestNtPathLength(void);
+extern void func_RtlHeap(void);
 extern void func_RtlInitializeBitMap(void);
 extern void func_RtlMemoryStream(void);
 extern void func_TimerResolution(void);
@@ -51,6 +54,8 @@ const struct test winetest_testlist[] =
     { "NtSaveKey",                      func_NtSaveKey},
     { "NtSystemInformation",            func_NtSystemInformation },
     { "RtlBitmapApi",                   func_RtlBitmap },
+    { "RtlCompress",                    func_RtlCompress },
+    { "RtlConditionVariable",           func_RtlConditionVariable },
     { "RtlDetermineDosPathNameType",    func_RtlDetermineDosPathNameType },
     { "RtlDoesFileExists",              func_RtlDoesFileExists },
     { "RtlDosPathNameToNtPathName_U",   func_RtlDosPathNameToNtPathName_U },
@@ -61,6 +66,7 @@ const struct test winetest_testlist[] =
     { "RtlGetFullPathName_UstrEx",      func_RtlGetFullPathName_UstrEx },
     { "RtlGetLengthWithoutTrailingPathSeperators", func_RtlGetLengthWithoutTrailingPathSeperators },
     { "RtlGetLongestNtPathLength",      func_RtlGetLongestNtPathLength },
+    { "RtlHeap",                        func_RtlHeap },
     { "RtlInitializeBitMap",            func_RtlInitializeBitMap },
     { "RtlMemoryStream",                func_RtlMemoryStream },
     { "TimerResolution",                func_TimerResolution },
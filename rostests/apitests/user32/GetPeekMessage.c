@@ -29,6 +29,65 @@ void Test_PeekMessage(HWND hWnd)
     ok(GetLastError() == ERROR_INVALID_WINDOW_HANDLE, "GetLastError() = %lu\n", GetLastError());
 }
 
+#define POSTED_PER_ROUND 5000
+#define POSTED_ROUNDS 20
+
+void Test_PeekMessageFilters(void)
+{
+    MSG msg;
+    UINT i, Round, Count;
+    WPARAM LastUser, LastApp;
+    DWORD Start, Elapsed;
+
+    /* Make sure we have a queue */
+    PeekMessage(&msg, NULL, 0, 0, PM_NOREMOVE);
+
+    Start = GetTickCount();
+    for (Round = 0; Round < POSTED_ROUNDS; Round++)
+    {
+        /* Stay below the default posted message quota of Windows */
+        for (i = 0; i < POSTED_PER_ROUND; i++)
+        {
+            if (!PostThreadMessage(GetCurrentThreadId(), (i % 10) ? WM_USER + 1 : WM_APP + 1, i, 0))
+                break;
+        }
+        ok(i == POSTED_PER_ROUND, "Posted %u messages\n", i);
+
+        /* Nothing in this range, must not remove anything */
+        ok(PeekMessage(&msg, NULL, WM_KEYFIRST, WM_KEYLAST, PM_REMOVE) == FALSE, "Got message 0x%x\n", msg.message);
+        ok(PeekMessage(&msg, NULL, WM_USER + 2, WM_USER + 2, PM_REMOVE) == FALSE, "Got message 0x%x\n", msg.message);
+
+        /* The narrow filter sees only its messages, oldest first */
+        Count = 0;
+        LastApp = 0;
+        while (PeekMessage(&msg, NULL, WM_APP + 1, WM_APP + 1, PM_REMOVE))
+        {
+            ok(msg.message == WM_APP + 1, "Got message 0x%x\n", msg.message);
+            ok(Count == 0 || msg.wParam > LastApp, "Got %lu after %lu\n", (ULONG)msg.wParam, (ULONG)LastApp);
+            LastApp = msg.wParam;
+            Count++;
+        }
+        ok(Count == POSTED_PER_ROUND / 10, "Got %u WM_APP messages\n", Count);
+
+        /* A range spanning several message classes still returns them in posting order */
+        PostThreadMessage(GetCurrentThreadId(), WM_APP + 2, POSTED_PER_ROUND, 0);
+        Count = 0;
+        LastUser = 0;
+        while (PeekMessage(&msg, NULL, WM_USER, WM_APP + 2, PM_REMOVE))
+        {
+            ok(Count == 0 || msg.wParam > LastUser, "Got %lu after %lu\n", (ULONG)msg.wParam, (ULONG)LastUser);
+            LastUser = msg.wParam;
+            Count++;
+        }
+        ok(Count == POSTED_PER_ROUND - POSTED_PER_ROUND / 10 + 1, "Got %u messages\n", Count);
+        ok(LastUser == POSTED_PER_ROUND, "Last message was %lu\n", (ULONG)LastUser);
+
+        ok(PeekMessage(&msg, NULL, 0, 0, PM_REMOVE) == FALSE, "Got message 0x%x\n", msg.message);
+    }
+    Elapsed = GetTickCount() - Start;
+    trace("Posted and peeked %u messages in %lu ms\n", POSTED_PER_ROUND * POSTED_ROUNDS, Elapsed);
+}
+
 START_TEST(GetPeekMessage)
 {
     HWND hWnd = CreateWindowExW(0, L"EDIT", L"miau", 0, CW_USEDEFAULT, CW_USEDEFAULT,
@@ -39,4 +98,5 @@ START_TEST(GetPeekMessage)
 
     Test_GetMessage(hWnd);
     Test_PeekMessage(hWnd);
+    Test_PeekMessageFilters();
 }
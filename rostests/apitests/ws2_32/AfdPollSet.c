@@ -0,0 +1,264 @@
+/*
+ * PROJECT:         ReactOS api tests
+ * LICENSE:         GPLv2+ - See COPYING in the top level directory
+ * PURPOSE:         Test for the AFD poll set IOCTLs
+ */
+
+#include <apitest.h>
+
+#include <stdio.h>
+#include <ntstatus.h>
+#include "ws2_32.h"
+#include <ndk/exfuncs.h>
+#include <ndk/iofuncs.h>
+#include <ndk/obfuncs.h>
+#include <tdi.h>
+#include <afd/shared.h>
+
+static
+NTSTATUS
+PollSetControl(
+    SOCKET PollSet,
+    ULONG Operation,
+    SOCKET Socket,
+    ULONG Events,
+    PVOID Context)
+{
+    AFD_POLL_SET_CONTROL_INFO Info;
+    IO_STATUS_BLOCK IoStatus;
+
+    Info.Operation = Operation;
+    Info.Handle = Socket;
+    Info.Events = Events;
+    Info.Context = Context;
+
+    /* Control requests never pend */
+    return NtDeviceIoControlFile((HANDLE)PollSet,
+                                 NULL,
+                                 NULL,
+                                 NULL,
+                                 &IoStatus,
+                                 IOCTL_AFD_POLL_SET_CONTROL,
+                                 &Info,
+                                 sizeof(Info),
+                                 NULL,
+                                 0);
+}
+
+static
+NTSTATUS
+PollSetWait(
+    SOCKET PollSet,
+    LONG TimeoutMs,
+    PAFD_POLL_SET_WAIT_INFO Info,
+    ULONG InfoSize,
+    PULONG_PTR Information)
+{
+    IO_STATUS_BLOCK IoStatus;
+    HANDLE Event;
+    NTSTATUS Status;
+
+    Status = NtCreateEvent(&Event, EVENT_ALL_ACCESS, NULL, NotificationEvent, FALSE);
+    if (!NT_SUCCESS(Status))
+        return Status;
+
+    Info->Timeout.QuadPart = Int32x32To64(TimeoutMs, -10000);
+    Info->EventCount = (InfoSize - FIELD_OFFSET(AFD_POLL_SET_WAIT_INFO, Events)) / sizeof(AFD_POLL_SET_EVENT);
+
+    IoStatus.Information = 0;
+    Status = NtDeviceIoControlFile((HANDLE)PollSet,
+                                   Event,
+                                   NULL,
+                                   NULL,
+                                   &IoStatus,
+                                   IOCTL_AFD_POLL_SET_WAIT,
+                                   Info,
+                                   InfoSize,
+                                   Info,
+                                   InfoSize);
+    if (Status == STATUS_PENDING)
+    {
+        WaitForSingleObject(Event, INFINITE);
+        Status = IoStatus.Status;
+    }
+
+    *Information = IoStatus.Information;
+    NtClose(Event);
+    return Status;
+}
+
+static
+int
+CreateConnectedPair(SOCKET *Client, SOCKET *Server)
+{
+    SOCKET Listener;
+    struct sockaddr_in sa;
+    int Length = sizeof(sa);
+
+    *Client = *Server = INVALID_SOCKET;
+
+    Listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    ok(Listener != INVALID_SOCKET, "socket failed, error %d\n", WSAGetLastError());
+    if (Listener == INVALID_SOCKET)
+        return 0;
+
+    ZeroMemory(&sa, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    sa.sin_port = 0;
+
+    if (bind(Listener, (struct sockaddr *)&sa, sizeof(sa)) == SOCKET_ERROR ||
+        getsockname(Listener, (struct sockaddr *)&sa, &Length) == SOCKET_ERROR ||
+        listen(Listener, 1) == SOCKET_ERROR)
+    {
+        ok(0, "Listener setup failed, error %d\n", WSAGetLastError());
+        closesocket(Listener);
+        return 0;
+    }
+
+    *Client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    ok(*Client != INVALID_SOCKET, "socket failed, error %d\n", WSAGetLastError());
+    if (*Client != INVALID_SOCKET &&
+        connect(*Client, (struct sockaddr *)&sa, sizeof(sa)) != SOCKET_ERROR)
+    {
+        *Server = accept(Listener, NULL, NULL);
+    }
+
+    closesocket(Listener);
+    ok(*Server != INVALID_SOCKET, "accept failed, error %d\n", WSAGetLastError());
+    if (*Server == INVALID_SOCKET)
+    {
+        if (*Client != INVALID_SOCKET)
+            closesocket(*Client);
+        return 0;
+    }
+
+    return 1;
+}
+
+static
+void
+Test_PollSet(void)
+{
+    struct
+    {
+        AFD_POLL_SET_WAIT_INFO Info;
+        AFD_POLL_SET_EVENT MoreEvents[3];
+    } Wait;
+    SOCKET PollSet, Client, Server;
+    NTSTATUS Status;
+    ULONG_PTR Information;
+    ULONG ExpectedSize;
+    char Buffer[4];
+    int iResult;
+
+    PollSet = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    ok(PollSet != INVALID_SOCKET, "socket failed, error %d\n", WSAGetLastError());
+    if (PollSet == INVALID_SOCKET)
+        return;
+
+    if (!CreateConnectedPair(&Client, &Server))
+    {
+        closesocket(PollSet);
+        return;
+    }
+
+    /* A set can't watch itself */
+    Status = PollSetControl(PollSet, AFD_POLL_SET_ADD, PollSet, AFD_EVENT_RECEIVE, NULL);
+    ok_hex(Status, STATUS_INVALID_HANDLE);
+
+    /* Nothing to modify or remove yet */
+    Status = PollSetControl(PollSet, AFD_POLL_SET_MODIFY, Server, AFD_EVENT_RECEIVE, NULL);
+    ok_hex(Status, STATUS_NOT_FOUND);
+    Status = PollSetControl(PollSet, AFD_POLL_SET_REMOVE, Server, 0, NULL);
+    ok_hex(Status, STATUS_NOT_FOUND);
+
+    /* An empty output buffer is rejected */
+    Status = PollSetWait(PollSet, 0, &Wait.Info, FIELD_OFFSET(AFD_POLL_SET_WAIT_INFO, Events), &Information);
+    ok_hex(Status, STATUS_INVALID_PARAMETER);
+
+    Status = PollSetControl(PollSet, AFD_POLL_SET_ADD, Server, AFD_EVENT_RECEIVE, (PVOID)0x1234);
+    ok_hex(Status, STATUS_SUCCESS);
+    Status = PollSetControl(PollSet, AFD_POLL_SET_ADD, Server, AFD_EVENT_RECEIVE, NULL);
+    ok_hex(Status, STATUS_OBJECT_NAME_COLLISION);
+
+    /* No data has been sent, so the wait has to time out */
+    Status = PollSetWait(PollSet, 100, &Wait.Info, sizeof(Wait), &Information);
+    ok_hex(Status, STATUS_TIMEOUT);
+    ok_int(Wait.Info.EventCount, 0);
+
+    iResult = send(Client, "test", 4, 0);
+    ok_int(iResult, 4);
+
+    ExpectedSize = FIELD_OFFSET(AFD_POLL_SET_WAIT_INFO, Events) + sizeof(AFD_POLL_SET_EVENT);
+    Status = PollSetWait(PollSet, 5000, &Wait.Info, sizeof(Wait), &Information);
+    ok_hex(Status, STATUS_SUCCESS);
+    ok_int(Wait.Info.EventCount, 1);
+    ok_int((ULONG)Information, ExpectedSize);
+    ok(Wait.Info.Events[0].Context == (PVOID)0x1234, "Context = %p\n", Wait.Info.Events[0].Context);
+    ok(Wait.Info.Events[0].Handle == Server, "Handle = %p\n", (PVOID)Wait.Info.Events[0].Handle);
+    ok_hex(Wait.Info.Events[0].Events, AFD_EVENT_RECEIVE);
+
+    /* Readiness is level triggered: unread data keeps reporting */
+    Status = PollSetWait(PollSet, 0, &Wait.Info, sizeof(Wait), &Information);
+    ok_hex(Status, STATUS_SUCCESS);
+    ok_int(Wait.Info.EventCount, 1);
+
+    /* Once the data has been consumed the set goes quiet again */
+    iResult = recv(Server, Buffer, sizeof(Buffer), 0);
+    ok_int(iResult, 4);
+    Status = PollSetWait(PollSet, 100, &Wait.Info, sizeof(Wait), &Information);
+    ok_hex(Status, STATUS_TIMEOUT);
+    ok_int(Wait.Info.EventCount, 0);
+
+    /* Modifying an entry changes what gets reported for it */
+    Status = PollSetControl(PollSet, AFD_POLL_SET_MODIFY, Server, AFD_EVENT_RECEIVE, (PVOID)0x5678);
+    ok_hex(Status, STATUS_SUCCESS);
+    iResult = send(Client, "test", 4, 0);
+    ok_int(iResult, 4);
+    Status = PollSetWait(PollSet, 5000, &Wait.Info, sizeof(Wait), &Information);
+    ok_hex(Status, STATUS_SUCCESS);
+    ok_int(Wait.Info.EventCount, 1);
+    ok(Wait.Info.Events[0].Context == (PVOID)0x5678, "Context = %p\n", Wait.Info.Events[0].Context);
+    ok_hex(Wait.Info.Events[0].Events, AFD_EVENT_RECEIVE);
+    iResult = recv(Server, Buffer, sizeof(Buffer), 0);
+    ok_int(iResult, 4);
+
+    /* A connected client is writable, an entry added while ready is reported right away */
+    Status = PollSetControl(PollSet, AFD_POLL_SET_ADD, Client, AFD_EVENT_SEND, (PVOID)0x9abc);
+    ok_hex(Status, STATUS_SUCCESS);
+    Status = PollSetWait(PollSet, 0, &Wait.Info, sizeof(Wait), &Information);
+    ok_hex(Status, STATUS_SUCCESS);
+    ok_int(Wait.Info.EventCount, 1);
+    ok(Wait.Info.Events[0].Context == (PVOID)0x9abc, "Context = %p\n", Wait.Info.Events[0].Context);
+    ok(Wait.Info.Events[0].Handle == Client, "Handle = %p\n", (PVOID)Wait.Info.Events[0].Handle);
+    ok_hex(Wait.Info.Events[0].Events, AFD_EVENT_SEND);
+    Status = PollSetControl(PollSet, AFD_POLL_SET_REMOVE, Client, 0, NULL);
+    ok_hex(Status, STATUS_SUCCESS);
+
+    /* Removed entries are no longer reported */
+    Status = PollSetControl(PollSet, AFD_POLL_SET_REMOVE, Server, 0, NULL);
+    ok_hex(Status, STATUS_SUCCESS);
+    Status = PollSetWait(PollSet, 100, &Wait.Info, sizeof(Wait), &Information);
+    ok_hex(Status, STATUS_TIMEOUT);
+    ok_int(Wait.Info.EventCount, 0);
+
+    closesocket(Client);
+    closesocket(Server);
+    closesocket(PollSet);
+}
+
+START_TEST(AfdPollSet)
+{
+    WSADATA wdata;
+    int iResult;
+
+    iResult = WSAStartup(MAKEWORD(2, 2), &wdata);
+    ok(iResult == 0, "WSAStartup failed, iResult == %d\n", iResult);
+    if (iResult != 0)
+        return;
+
+    Test_PollSet();
+
+    WSACleanup();
+}
@@ -0,0 +1,117 @@
+/*
+ * PROJECT:         ReactOS api tests
+ * LICENSE:         GPLv2+ - See COPYING in the top level directory
+ * PURPOSE:         Test for setsockopt
+ */
+
+#include <apitest.h>
+
+#include <string.h>
+
+#include "ws2_32.h"
+
+static
+int
+CreateConnectedPair(SOCKET Client, SOCKET *Server)
+{
+    SOCKET Listener;
+    struct sockaddr_in sa;
+    int Length = sizeof(sa);
+
+    *Server = INVALID_SOCKET;
+
+    Listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    ok(Listener != INVALID_SOCKET, "socket failed, error %d\n", WSAGetLastError());
+    if (Listener == INVALID_SOCKET)
+        return 0;
+
+    ZeroMemory(&sa, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    sa.sin_port = 0;
+
+    if (bind(Listener, (struct sockaddr *)&sa, sizeof(sa)) != SOCKET_ERROR &&
+        getsockname(Listener, (struct sockaddr *)&sa, &Length) != SOCKET_ERROR &&
+        listen(Listener, 1) != SOCKET_ERROR &&
+        connect(Client, (struct sockaddr *)&sa, sizeof(sa)) != SOCKET_ERROR)
+    {
+        *Server = accept(Listener, NULL, NULL);
+    }
+
+    ok(*Server != INVALID_SOCKET, "Connection failed, error %d\n", WSAGetLastError());
+    closesocket(Listener);
+    return *Server != INVALID_SOCKET;
+}
+
+static
+void
+Test_ReceiveBuffer(void)
+{
+    SOCKET Client, Server;
+    DWORD Size;
+    int Length, iResult;
+    char Buffer[16];
+
+    Client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    ok(Client != INVALID_SOCKET, "socket failed, error %d\n", WSAGetLastError());
+    if (Client == INVALID_SOCKET)
+        return;
+
+    /* The option is a DWORD */
+    Size = 0x10000;
+    iResult = setsockopt(Client, SOL_SOCKET, SO_RCVBUF, (char *)&Size, sizeof(Size) - 1);
+    ok(iResult == SOCKET_ERROR, "iResult = %d\n", iResult);
+    ok(WSAGetLastError() == WSAEFAULT, "Error = %d\n", WSAGetLastError());
+
+    /* Before connect, the new size is used */
+    iResult = setsockopt(Client, SOL_SOCKET, SO_RCVBUF, (char *)&Size, sizeof(Size));
+    ok(iResult == 0, "setsockopt failed, error %d\n", WSAGetLastError());
+    Size = 0;
+    Length = sizeof(Size);
+    iResult = getsockopt(Client, SOL_SOCKET, SO_RCVBUF, (char *)&Size, &Length);
+    ok(iResult == 0, "getsockopt failed, error %d\n", WSAGetLastError());
+    ok(Length == sizeof(Size), "Length = %d\n", Length);
+    ok(Size == 0x10000, "Size = %lu\n", Size);
+
+    if (!CreateConnectedPair(Client, &Server))
+    {
+        closesocket(Client);
+        return;
+    }
+
+    /* After connect, changing it doesn't fail */
+    Size = 0x2000;
+    iResult = setsockopt(Client, SOL_SOCKET, SO_RCVBUF, (char *)&Size, sizeof(Size));
+    ok(iResult == 0, "setsockopt failed, error %d\n", WSAGetLastError());
+    Size = 0;
+    Length = sizeof(Size);
+    iResult = getsockopt(Client, SOL_SOCKET, SO_RCVBUF, (char *)&Size, &Length);
+    ok(iResult == 0, "getsockopt failed, error %d\n", WSAGetLastError());
+    ok(Size != 0, "Size = %lu\n", Size);
+
+    /* And the connection still works */
+    iResult = send(Server, "ReactOS", 8, 0);
+    ok(iResult == 8, "send returned %d, error %d\n", iResult, WSAGetLastError());
+    iResult = recv(Client, Buffer, sizeof(Buffer), 0);
+    ok(iResult == 8, "recv returned %d, error %d\n", iResult, WSAGetLastError());
+    if (iResult == 8)
+        ok(!strcmp(Buffer, "ReactOS"), "Buffer = %s\n", Buffer);
+
+    closesocket(Server);
+    closesocket(Client);
+}
+
+START_TEST(setsockopt)
+{
+    WSADATA wdata;
+    int iResult;
+
+    iResult = WSAStartup(MAKEWORD(2, 2), &wdata);
+    ok(iResult == 0, "WSAStartup failed, iResult == %d\n", iResult);
+    if (iResult != 0)
+        return;
+
+    Test_ReceiveBuffer();
+
+    WSACleanup();
+}
@@ -3,18 +3,22 @@
 #define STANDALONE
 #include <apitest.h>
 
+extern void func_AfdPollSet(void);
 extern void func_getaddrinfo(void);
 extern void func_ioctlsocket(void);
 extern void func_recv(void);
+extern void func_setsockopt(void);
 extern void func_WSAStartup(void);
 extern void func_nostartup(void);
 
 const struct test winetest_testlist[] =
 {
+    { "AfdPollSet", func_AfdPollSet },
     { "getaddrinfo", func_getaddrinfo },
     { "ioctlsocket", func_ioctlsocket },
     { "nostartup", func_nostartup },
     { "recv", func_recv },
+    { "setsockopt", func_setsockopt },
     { "WSAStartup", func_WSAStartup },
     { 0, 0 }
 };